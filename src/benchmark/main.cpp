@@ -0,0 +1,351 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <openvic-simulation/dataloader/Dataloader.hpp>
+#include <openvic-simulation/GameManager.hpp>
+#include <openvic-simulation/utility/Logger.hpp>
+#include <openvic-simulation/utility/PhaseProfiler.hpp>
+#include <openvic-simulation/utility/ThreadPool.hpp>
+
+// Included last so its min and max macros cannot affect the headers above.
+#ifdef _WIN32
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace OpenVic;
+
+/* Counts every allocation made through the global operator new. The array and nothrow forms call this one by default,
+ * and the over-aligned forms are left alone as they are not replaced and so still pair with their own deletes. */
+static std::atomic<size_t> allocation_count = 0;
+
+void* operator new(size_t size) {
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	void* ptr = std::malloc(size > 0 ? size : 1);
+	if (ptr == nullptr) {
+		throw std::bad_alloc {};
+	}
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+static size_t get_allocation_count() {
+	return allocation_count.load(std::memory_order_relaxed);
+}
+
+// Peak resident set size of the process in bytes, 0 if unknown.
+static size_t get_peak_rss() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.PeakWorkingSetSize;
+	}
+	return 0;
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+#ifdef __APPLE__
+	return usage.ru_maxrss;
+#else
+	return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+static uint64_t nanoseconds_since(std::chrono::steady_clock::time_point start_time) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+static constexpr size_t DEFAULT_DAYS = 365;
+
+static void print_help(std::ostream& stream, char const* program_name) {
+	stream
+		<< "Usage: " << program_name << " [-h] [-d <days>] [-w <days>] [-o <path>] [-j <count>] [-c <path>] [-b <path>] [path]+\n"
+		<< "    -h : Print this help message and exit the program.\n"
+		<< "    -d : Simulate the following number of timed days (default " << DEFAULT_DAYS << ").\n"
+		<< "    -w : Simulate the following number of untimed warm up days first (default 0).\n"
+		<< "    -o : Write the JSON results to the following file (instead of standard output).\n"
+		<< "    -j : Use the following number of worker threads for the simulation (0 for one per hardware thread).\n"
+		<< "    -c : Use the following file as a definitions cache, created if missing or out of date.\n"
+		<< "    -b : Use the following path as the base directory (instead of searching for one).\n"
+		<< "    -s : Use the following path as a hint to search for a base directory.\n"
+		<< "Any following paths are read as mod directories, with priority starting at one above the base directory.\n"
+		<< "(Paths with spaces need to be enclosed in \"quotes\").\n";
+}
+
+struct benchmark_results_t {
+	std::string bookmark;
+	std::string start_date, end_date;
+	size_t warm_up_days = 0, days = 0, worker_count = 0;
+	uint64_t load_definitions_ns = 0, setup_instance_ns = 0, simulation_ns = 0;
+	size_t peak_rss_bytes = 0;
+	PhaseProfiler profiler { get_allocation_count };
+};
+
+/* The mean number of allocations per run of the named phase, or 0 if it never ran. Market orders are placed during
+ * map_tick and executed during market, so these two phases' counts are reported on their own as the figures for the
+ * market's allocations per tick, which can be compared between versions by running each with the same bookmark. */
+static uint64_t get_mean_allocations(PhaseProfiler const& profiler, std::string_view phase_name) {
+	for (PhaseProfiler::phase_t const& phase : profiler.get_phases()) {
+		if (phase.name == phase_name) {
+			return PhaseProfiler::get_statistics(phase).mean_allocations;
+		}
+	}
+	return 0;
+}
+
+static void write_json(std::ostream& stream, benchmark_results_t const& results) {
+	// Every string written is an identifier, date or phase name, none of which need escaping.
+	stream
+		<< "{\n"
+		<< "\t\"bookmark\": \"" << results.bookmark << "\",\n"
+		<< "\t\"start_date\": \"" << results.start_date << "\",\n"
+		<< "\t\"end_date\": \"" << results.end_date << "\",\n"
+		<< "\t\"warm_up_days\": " << results.warm_up_days << ",\n"
+		<< "\t\"days\": " << results.days << ",\n"
+		<< "\t\"worker_count\": " << results.worker_count << ",\n"
+		<< "\t\"load_definitions_ns\": " << results.load_definitions_ns << ",\n"
+		<< "\t\"setup_instance_ns\": " << results.setup_instance_ns << ",\n"
+		<< "\t\"simulation_ns\": " << results.simulation_ns << ",\n"
+		<< "\t\"peak_rss_bytes\": " << results.peak_rss_bytes << ",\n"
+		<< "\t\"market_allocations_per_tick\": {\n"
+		<< "\t\t\"map_tick\": " << get_mean_allocations(results.profiler, "map_tick") << ",\n"
+		<< "\t\t\"market\": " << get_mean_allocations(results.profiler, "market") << "\n"
+		<< "\t},\n"
+		<< "\t\"phases\": [";
+
+	std::vector<PhaseProfiler::phase_t> const& phases = results.profiler.get_phases();
+	for (size_t index = 0; index < phases.size(); ++index) {
+		const PhaseProfiler::statistics_t statistics = PhaseProfiler::get_statistics(phases[index]);
+		stream
+			<< (index > 0 ? "," : "") << "\n\t\t{\n"
+			<< "\t\t\t\"name\": \"" << phases[index].name << "\",\n"
+			<< "\t\t\t\"runs\": " << statistics.run_count << ",\n"
+			<< "\t\t\t\"total_ns\": " << statistics.total_ns << ",\n"
+			<< "\t\t\t\"mean_ns\": " << statistics.mean_ns << ",\n"
+			<< "\t\t\t\"min_ns\": " << statistics.min_ns << ",\n"
+			<< "\t\t\t\"p50_ns\": " << statistics.p50_ns << ",\n"
+			<< "\t\t\t\"p90_ns\": " << statistics.p90_ns << ",\n"
+			<< "\t\t\t\"p99_ns\": " << statistics.p99_ns << ",\n"
+			<< "\t\t\t\"max_ns\": " << statistics.max_ns << ",\n"
+			<< "\t\t\t\"total_allocations\": " << statistics.total_allocations << ",\n"
+			<< "\t\t\t\"mean_allocations\": " << statistics.mean_allocations << ",\n"
+			<< "\t\t\t\"max_allocations\": " << statistics.max_allocations << "\n"
+			<< "\t\t}";
+	}
+
+	stream << "\n\t]\n}\n";
+}
+
+static bool run_benchmark(
+	Dataloader::path_vector_t const& roots, fs::path const& cache_path, size_t warm_up_days, size_t days,
+	benchmark_results_t& results
+) {
+	bool ret = true;
+
+	GameManager game_manager { nullptr, nullptr };
+
+	std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+	ret &= game_manager.set_roots(roots);
+	game_manager.set_definitions_cache_path(cache_path);
+	ret &= game_manager.load_definitions(
+		[](std::string_view key, Dataloader::locale_t locale, std::string_view localisation) -> bool {
+			return true;
+		}
+	);
+	results.load_definitions_ns = nanoseconds_since(start_time);
+
+	Bookmark const* bookmark =
+		game_manager.get_definition_manager().get_history_manager().get_bookmark_manager().get_bookmark_by_index(0);
+	if (bookmark == nullptr) {
+		Logger::error("No bookmark to benchmark!");
+		return false;
+	}
+	results.bookmark = bookmark->get_identifier();
+
+	start_time = std::chrono::steady_clock::now();
+	ret &= game_manager.setup_instance(bookmark);
+	ret &= game_manager.start_game_session();
+	results.setup_instance_ns = nanoseconds_since(start_time);
+
+	InstanceManager* instance_manager = game_manager.get_instance_manager();
+	if (instance_manager == nullptr) {
+		Logger::error("Instance manager not available!");
+		return false;
+	}
+
+	for (size_t day = 0; day < warm_up_days; ++day) {
+		ret &= instance_manager->advance_day();
+	}
+
+	results.start_date = instance_manager->get_today().to_string();
+	results.warm_up_days = warm_up_days;
+	results.days = days;
+	results.worker_count = ThreadPool::get_instance().get_worker_count();
+
+	instance_manager->set_phase_profiler(&results.profiler);
+	start_time = std::chrono::steady_clock::now();
+	for (size_t day = 0; day < days; ++day) {
+		ret &= instance_manager->advance_day();
+	}
+	results.simulation_ns = nanoseconds_since(start_time);
+	instance_manager->set_phase_profiler(nullptr);
+
+	results.end_date = instance_manager->get_today().to_string();
+	results.peak_rss_bytes = get_peak_rss();
+
+	return ret;
+}
+
+/*
+	$ program [-h] [-d <days>] [-w <days>] [-o <path>] [-j <count>] [-c <path>] [-b] [path]+
+*/
+
+int main(int argc, char const* argv[]) {
+	/* Info messages are logged every tick, so only warnings and errors are printed. These go to standard error, leaving
+	 * standard output for the results. */
+	Logger::set_info_func([](std::string&& str) {});
+	Logger::set_warning_func([](std::string&& str) {
+		std::cerr << "[WARNING] " << str;
+	});
+	Logger::set_error_func([](std::string&& str) {
+		std::cerr << "[ERROR] " << str;
+	});
+	Logger::set_async(true);
+
+	char const* program_name = StringUtils::get_filename(argc > 0 ? argv[0] : nullptr, "<program>");
+	fs::path root;
+	fs::path cache_path;
+	fs::path output_path;
+	size_t warm_up_days = 0, days = DEFAULT_DAYS;
+	int argn = 0;
+
+	/* Reads the next argument as a count. If it is missing or invalid, an error message and the help text are
+	 * displayed, along with returning false to signify the program should exit.
+	 */
+	const auto _read_count = [&argn, argc, argv, program_name](std::string_view command, size_t& count) -> bool {
+		if (++argn < argc) {
+			char* end = nullptr;
+			count = std::strtoul(argv[argn], &end, 10);
+			if (end != argv[argn] && *end == '\0') {
+				return true;
+			}
+			std::cerr << "Invalid count \"" << argv[argn] << "\" after command line argument \"" << command << "\"." << std::endl;
+		} else {
+			std::cerr << "Missing count after command line argument \"" << command << "\"." << std::endl;
+		}
+		print_help(std::cerr, program_name);
+		return false;
+	};
+
+	/* Reads the next argument and converts it to a path via path_transform, as in the headless program. */
+	const auto _read_path = [&argn, argc, argv, program_name](
+		std::string_view command, fs::path& path, auto path_transform) -> bool {
+		if (path.empty()) {
+			if (++argn < argc) {
+				path = path_transform(argv[argn]);
+				if (!path.empty()) {
+					return true;
+				}
+				std::cerr << "Empty path after command line argument \"" << command << "\"." << std::endl;
+			} else {
+				std::cerr << "Missing path after command line argument \"" << command << "\"." << std::endl;
+			}
+		} else {
+			std::cerr << "Duplicate command line argument \"" << command << "\"." << std::endl;
+		}
+		print_help(std::cerr, program_name);
+		return false;
+	};
+
+	while (++argn < argc) {
+		char const* arg = argv[argn];
+		if (strcmp(arg, "-h") == 0) {
+			print_help(std::cout, program_name);
+			return 0;
+		} else if (strcmp(arg, "-d") == 0) {
+			if (!_read_count("-d", days)) {
+				return -1;
+			}
+		} else if (strcmp(arg, "-w") == 0) {
+			if (!_read_count("-w", warm_up_days)) {
+				return -1;
+			}
+		} else if (strcmp(arg, "-j") == 0) {
+			size_t worker_count = 0;
+			if (!_read_count("-j", worker_count)) {
+				return -1;
+			}
+			ThreadPool::get_instance().set_worker_count(worker_count);
+		} else if (strcmp(arg, "-o") == 0) {
+			if (!_read_path("-o", output_path, std::identity {})) {
+				return -1;
+			}
+		} else if (strcmp(arg, "-c") == 0) {
+			if (!_read_path("-c", cache_path, std::identity {})) {
+				return -1;
+			}
+		} else if (strcmp(arg, "-b") == 0) {
+			if (!_read_path("-b", root, std::identity {})) {
+				return -1;
+			}
+		} else if (strcmp(arg, "-s") == 0) {
+			if (!_read_path("-s", root, Dataloader::search_for_game_path)) {
+				return -1;
+			}
+		} else {
+			break;
+		}
+	}
+	if (root.empty()) {
+		root = Dataloader::search_for_game_path();
+		if (root.empty()) {
+			std::cerr << "Search for base directory path failed!" << std::endl;
+			print_help(std::cerr, program_name);
+			return -1;
+		}
+	}
+	Dataloader::path_vector_t roots { root };
+	while (argn < argc) {
+		static const fs::path mod_directory = "mod";
+		roots.emplace_back(root / mod_directory / argv[argn++]);
+	}
+
+	benchmark_results_t results;
+	const bool ret = run_benchmark(roots, cache_path, warm_up_days, days, results);
+
+	Logger::set_async(false);
+
+	if (output_path.empty()) {
+		write_json(std::cout, results);
+	} else {
+		std::ofstream output_file { output_path };
+		write_json(output_file, results);
+		if (output_file.fail()) {
+			std::cerr << "Failed to write results to " << output_path << std::endl;
+			return -1;
+		}
+	}
+
+	return ret ? 0 : -1;
+}
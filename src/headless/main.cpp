@@ -7,14 +7,17 @@
 #include <openvic-simulation/pop/Pop.hpp>
 #include <openvic-simulation/testing/Testing.hpp>
 #include <openvic-simulation/utility/Logger.hpp>
+#include <openvic-simulation/utility/ThreadPool.hpp>
 
 using namespace OpenVic;
 
 static void print_help(std::ostream& stream, char const* program_name) {
 	stream
-		<< "Usage: " << program_name << " [-h] [-t] [-b <path>] [path]+\n"
+		<< "Usage: " << program_name << " [-h] [-t] [-j <count>] [-c <path>] [-b <path>] [path]+\n"
 		<< "    -h : Print this help message and exit the program.\n"
 		<< "    -t : Run tests after loading defines.\n"
+		<< "    -j : Use the following number of worker threads for the simulation (0 for one per hardware thread).\n"
+		<< "    -c : Use the following file as a cache of the loaded map images, created if missing or out of date.\n"
 		<< "    -b : Use the following path as the base directory (instead of searching for one).\n"
 		<< "    -s : Use the following path as a hint to search for a base directory.\n"
 		<< "Any following paths are read as mod directories, with priority starting at one above the base directory.\n"
@@ -55,7 +58,7 @@ static void print_rgo(ProvinceInstance const& province) {
 	}
 }
 
-static bool run_headless(Dataloader::path_vector_t const& roots, bool run_tests) {
+static bool run_headless(Dataloader::path_vector_t const& roots, fs::path const& cache_path, bool run_tests) {
 	bool ret = true;
 
 	GameManager game_manager { []() {
@@ -64,6 +67,7 @@ static bool run_headless(Dataloader::path_vector_t const& roots, bool run_tests)
 
 	Logger::info("===== Loading definitions... =====");
 	ret &= game_manager.set_roots(roots);
+	game_manager.set_definitions_cache_path(cache_path);
 	ret &= game_manager.load_definitions(
 		[](std::string_view key, Dataloader::locale_t locale, std::string_view localisation) -> bool {
 			return true;
@@ -133,14 +137,16 @@ static bool run_headless(Dataloader::path_vector_t const& roots, bool run_tests)
 }
 
 /*
-	$ program [-h] [-t] [-b] [path]+
+	$ program [-h] [-t] [-j <count>] [-c <path>] [-b] [path]+
 */
 
 int main(int argc, char const* argv[]) {
 	Logger::set_logger_funcs();
+	Logger::set_async(true);
 
 	char const* program_name = StringUtils::get_filename(argc > 0 ? argv[0] : nullptr, "<program>");
 	fs::path root;
+	fs::path cache_path;
 	bool run_tests = false;
 	int argn = 0;
 
@@ -176,6 +182,29 @@ int main(int argc, char const* argv[]) {
 			return 0;
 		} else if (strcmp(arg, "-t") == 0) {
 			run_tests = true;
+		} else if (strcmp(arg, "-j") == 0) {
+			if (++argn < argc) {
+				char* end = nullptr;
+				const unsigned long worker_count = std::strtoul(argv[argn], &end, 10);
+				if (end == argv[argn] || *end != '\0') {
+					std::cerr << "Invalid worker count \"" << argv[argn] << "\" after command line argument \"-j\"." << std::endl;
+					print_help(std::cerr, program_name);
+					return -1;
+				}
+				ThreadPool::get_instance().set_worker_count(worker_count);
+			} else {
+				std::cerr << "Missing worker count after command line argument \"-j\"." << std::endl;
+				print_help(std::cerr, program_name);
+				return -1;
+			}
+		} else if (strcmp(arg, "-c") == 0) {
+			if (++argn < argc) {
+				cache_path = argv[argn];
+			} else {
+				std::cerr << "Missing path after command line argument \"-c\"." << std::endl;
+				print_help(std::cerr, program_name);
+				return -1;
+			}
 		} else if (strcmp(arg, "-b") == 0) {
 			if (!_read("-b", "base directory", std::identity {})) {
 				return -1;
@@ -204,7 +233,10 @@ int main(int argc, char const* argv[]) {
 
 	std::cout << "!!! HEADLESS SIMULATION START !!!" << std::endl;
 
-	const bool ret = run_headless(roots, run_tests);
+	const bool ret = run_headless(roots, cache_path, run_tests);
+
+	// Prints any queued messages before the summary, so the counts are final.
+	Logger::set_async(false);
 
 	std::cout << "!!! HEADLESS SIMULATION END !!!" << std::endl;
 
@@ -19,6 +19,10 @@ bool GameManager::set_roots(Dataloader::path_vector_t const& roots) {
 	return true;
 }
 
+void GameManager::set_definitions_cache_path(fs::path const& definitions_cache_path) {
+	dataloader.set_definitions_cache_path(definitions_cache_path);
+}
+
 bool GameManager::load_definitions(Dataloader::localisation_callback_t localisation_callback) {
 	if (definitions_loaded) {
 		Logger::error("Cannot load definitions - already loaded!");
@@ -35,6 +35,9 @@ namespace OpenVic {
 
 		bool set_roots(Dataloader::path_vector_t const& roots);
 
+		/* See Dataloader::set_definitions_cache_path, must be called before load_definitions to have any effect. */
+		void set_definitions_cache_path(fs::path const& definitions_cache_path);
+
 		bool load_definitions(Dataloader::localisation_callback_t localisation_callback);
 
 		bool setup_instance(Bookmark const* bookmark);
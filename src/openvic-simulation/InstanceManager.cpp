@@ -50,14 +50,28 @@ void InstanceManager::update_gamestate() {
 	}
 	currently_updating_gamestate = true;
 
+	const PhaseProfiler::scope_t gamestate_scope { phase_profiler, "gamestate" };
+
 	Logger::info("Update: ", today);
 
-	update_modifier_sums();
+	{
+		const PhaseProfiler::scope_t scope { phase_profiler, "modifier_sums" };
+		update_modifier_sums();
+	}
 
 	// Update gamestate...
-	map_instance.update_gamestate(today, definition_manager.get_define_manager());
-	country_instance_manager.update_gamestate(*this);
-	unit_instance_manager.update_gamestate();
+	{
+		const PhaseProfiler::scope_t scope { phase_profiler, "map_gamestate" };
+		map_instance.update_gamestate(today, definition_manager.get_define_manager());
+	}
+	{
+		const PhaseProfiler::scope_t scope { phase_profiler, "country_gamestate" };
+		country_instance_manager.update_gamestate(*this);
+	}
+	{
+		const PhaseProfiler::scope_t scope { phase_profiler, "unit_gamestate" };
+		unit_instance_manager.update_gamestate();
+	}
 
 	gamestate_updated();
 	gamestate_needs_update = false;
@@ -69,6 +83,8 @@ void InstanceManager::update_gamestate() {
  * SS-98, SS-101
  */
 void InstanceManager::tick() {
+	const PhaseProfiler::scope_t tick_scope { phase_profiler, "tick" };
+
 	country_instance_manager.country_manager_reset_before_tick();
 
 	today++;
@@ -76,13 +92,29 @@ void InstanceManager::tick() {
 	Logger::info("Tick: ", today);
 
 	// Tick...
-	map_instance.map_tick(today);
-	country_instance_manager.country_manager_tick(*this);
-	unit_instance_manager.tick();
-	market_instance.execute_orders();
+	{
+		const PhaseProfiler::scope_t scope { phase_profiler, "map_tick" };
+		map_instance.map_tick(today);
+	}
+	{
+		const PhaseProfiler::scope_t scope { phase_profiler, "country_tick" };
+		country_instance_manager.country_manager_tick(*this);
+	}
+	{
+		const PhaseProfiler::scope_t scope { phase_profiler, "unit_tick" };
+		unit_instance_manager.tick();
+	}
+	{
+		const PhaseProfiler::scope_t scope { phase_profiler, "market" };
+		market_instance.execute_orders();
 
-	if (today.is_month_start()) {
-		market_instance.record_price_history();
+		if (today.is_month_start()) {
+			market_instance.record_price_history();
+		}
+	}
+	{
+		const PhaseProfiler::scope_t scope { phase_profiler, "events" };
+		event_scheduler.tick(*this);
 	}
 
 	set_gamestate_needs_update();
@@ -104,7 +136,9 @@ bool InstanceManager::setup() {
 		definition_manager.get_define_manager().get_pops_defines(),
 		definition_manager.get_pop_manager().get_stratas(),
 		definition_manager.get_pop_manager().get_pop_types(),
-		definition_manager.get_politics_manager().get_ideology_manager().get_ideologies()
+		definition_manager.get_politics_manager().get_ideology_manager().get_ideologies(),
+		definition_manager.get_pop_manager().get_culture_manager().get_cultures(),
+		definition_manager.get_pop_manager().get_religion_manager().get_religions()
 	);
 	ret &= country_instance_manager.generate_country_instances(
 		definition_manager.get_economy_manager().get_building_type_manager().get_building_types(),
@@ -115,13 +149,21 @@ bool InstanceManager::setup() {
 		definition_manager.get_politics_manager().get_government_type_manager().get_government_types(),
 		definition_manager.get_crime_manager().get_crime_modifiers(),
 		definition_manager.get_pop_manager().get_pop_types(),
+		definition_manager.get_pop_manager().get_culture_manager().get_cultures(),
+		definition_manager.get_pop_manager().get_religion_manager().get_religions(),
 		good_instance_manager.get_good_instances(),
+		definition_manager.get_economy_manager().get_production_type_manager().get_production_types(),
 		definition_manager.get_military_manager().get_unit_type_manager().get_regiment_types(),
 		definition_manager.get_military_manager().get_unit_type_manager().get_ship_types(),
 		definition_manager.get_pop_manager().get_stratas(),
 		game_rules_manager,
 		good_instance_manager
 	);
+	country_relation_manager.setup(country_instance_manager.get_country_instance_count());
+	country_instance_manager.get_triggered_modifier_cache().setup(
+		definition_manager.get_modifier_manager().get_triggered_modifiers()
+	);
+	event_scheduler.setup(definition_manager.get_event_manager());
 
 	game_instance_setup = true;
 
@@ -175,7 +217,9 @@ bool InstanceManager::load_bookmark(Bookmark const* new_bookmark) {
 		map_instance,
 		definition_manager.get_pop_manager().get_stratas(),
 		definition_manager.get_pop_manager().get_pop_types(),
-		definition_manager.get_politics_manager().get_ideology_manager().get_ideologies()
+		definition_manager.get_politics_manager().get_ideology_manager().get_ideologies(),
+		definition_manager.get_pop_manager().get_culture_manager().get_cultures(),
+		definition_manager.get_pop_manager().get_religion_manager().get_religions()
 	);
 
 	if (ret) {
@@ -227,6 +271,17 @@ bool InstanceManager::set_today_and_update(Date new_today) {
 	return true;
 }
 
+bool InstanceManager::advance_day() {
+	if (!is_game_session_started()) {
+		Logger::error("Cannot advance day - game session not started!");
+		return false;
+	}
+
+	tick();
+	update_gamestate();
+	return true;
+}
+
 bool InstanceManager::expand_province_building(ProvinceInstance* province, size_t building_index) {
 	set_gamestate_needs_update();
 	if (province == nullptr) {
@@ -246,6 +301,7 @@ void InstanceManager::update_modifier_sums() {
 	// full copy of all the modifiers affecting them in their modifier sum, but provinces only having their directly/locally
 	// applied modifiers in their modifier sum, hence requiring owner country modifier effect values to be looked up when
 	// determining the value of a global effect on the province.
+	country_instance_manager.update_triggered_modifiers(*this);
 	country_instance_manager.update_modifier_sums(
 		today, definition_manager.get_modifier_manager().get_static_modifier_cache()
 	);
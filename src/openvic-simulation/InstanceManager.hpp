@@ -10,10 +10,12 @@
 #include "openvic-simulation/map/MapInstance.hpp"
 #include "openvic-simulation/map/Mapmode.hpp"
 #include "openvic-simulation/military/UnitInstanceGroup.hpp"
+#include "openvic-simulation/misc/EventScheduler.hpp"
 #include "openvic-simulation/misc/SimulationClock.hpp"
 #include "openvic-simulation/politics/PoliticsInstanceManager.hpp"
 #include "openvic-simulation/types/Date.hpp"
 #include "openvic-simulation/types/FlagStrings.hpp"
+#include "openvic-simulation/utility/PhaseProfiler.hpp"
 
 namespace OpenVic {
 	struct DefinitionManager;
@@ -40,6 +42,7 @@ namespace OpenVic {
 		 * e.g. if we want to remove military units from the province they're in when they're destructed. */
 		MapInstance PROPERTY_REF(map_instance);
 		SimulationClock PROPERTY_REF(simulation_clock);
+		EventScheduler PROPERTY_REF(event_scheduler);
 		ConsoleInstance PROPERTY_REF(console_instance);
 
 		bool PROPERTY_CUSTOM_PREFIX(game_instance_setup, is, false);
@@ -51,6 +54,9 @@ namespace OpenVic {
 		gamestate_updated_func_t gamestate_updated;
 		bool gamestate_needs_update = false, currently_updating_gamestate = false;
 
+		/* If set, the phases of every tick and gamestate update are timed with this. */
+		PhaseProfiler* PROPERTY_RW(phase_profiler, nullptr);
+
 		void update_modifier_sums();
 		void set_gamestate_needs_update();
 		void update_gamestate();
@@ -75,6 +81,10 @@ namespace OpenVic {
 
 		bool set_today_and_update(Date new_today);
 
+		/* Ticks the simulation forward one day and updates the gamestate, regardless of the simulation clock's speed
+		 * and pause state, e.g. for benchmarking. */
+		bool advance_day();
+
 		bool expand_province_building(ProvinceInstance* province, size_t building_index);
 	};
 }
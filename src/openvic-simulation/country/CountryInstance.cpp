@@ -1,5 +1,6 @@
 #include "CountryInstance.hpp"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "openvic-simulation/country/CountryDefinition.hpp"
@@ -10,6 +11,7 @@
 #include "openvic-simulation/map/Crime.hpp"
 #include "openvic-simulation/map/MapInstance.hpp"
 #include "openvic-simulation/misc/GameRulesManager.hpp"
+#include "openvic-simulation/modifier/Modifier.hpp"
 #include "openvic-simulation/modifier/ModifierEffectCache.hpp"
 #include "openvic-simulation/modifier/StaticModifierCache.hpp"
 #include "openvic-simulation/politics/Ideology.hpp"
@@ -17,6 +19,7 @@
 #include "openvic-simulation/research/Technology.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
 #include "openvic-simulation/types/SliderValue.hpp"
+#include "openvic-simulation/utility/CompilerFeatureTesting.hpp"
 
 using namespace OpenVic;
 
@@ -35,7 +38,10 @@ CountryInstance::CountryInstance(
 	decltype(government_flag_overrides)::keys_type const& government_type_keys,
 	decltype(crime_unlock_levels)::keys_type const& crime_keys,
 	decltype(pop_type_distribution)::keys_type const& pop_type_keys,
+	decltype(culture_distribution)::keys_type const& culture_keys,
+	decltype(religion_distribution)::keys_type const& religion_keys,
 	decltype(goods_data)::keys_type const& good_instances_keys,
+	production_type_keys_t const& production_type_keys,
 	decltype(regiment_type_unlock_levels)::keys_type const& regiment_type_unlock_levels_keys,
 	decltype(ship_type_unlock_levels)::keys_type const& ship_type_unlock_levels_keys,
 	decltype(tax_rate_by_strata)::keys_type const& strata_keys,
@@ -73,9 +79,12 @@ CountryInstance::CountryInstance(
 	pop_type_distribution { &pop_type_keys },
 	ideology_distribution { &ideology_keys },
 	vote_distribution { nullptr },
+	culture_distribution { &culture_keys },
+	religion_distribution { &religion_keys },
 
 	/* Trade */
 	goods_data { &good_instances_keys },
+	economy_report_lock { std::make_unique<std::mutex>() },
 
 	/* Diplomacy */
 
@@ -85,6 +94,13 @@ CountryInstance::CountryInstance(
 
 	// Exclude PROVINCE (local) modifier effects from the country's modifier sum
 	modifier_sum.set_this_excluded_targets(ModifierEffect::target_t::PROVINCE);
+	persistent_modifier_sum.set_this_excluded_targets(ModifierEffect::target_t::PROVINCE);
+
+	for (good_data_t& good_data : goods_data.get_values()) {
+		good_data.need_consumption_per_pop_type.set_keys(&pop_type_keys);
+		good_data.input_consumption_per_production_type.set_keys(&production_type_keys);
+		good_data.production_per_production_type.set_keys(&production_type_keys);
+	}
 
 	update_country_definition_based_attributes();
 
@@ -187,23 +203,11 @@ fixed_point_t CountryInstance::get_party_support(CountryParty const& party) cons
 }
 
 fixed_point_t CountryInstance::get_culture_proportion(Culture const& culture) const {
-	const decltype(culture_distribution)::const_iterator it = culture_distribution.find(&culture);
-
-	if (it != culture_distribution.end()) {
-		return it->second;
-	} else {
-		return fixed_point_t::_0();
-	}
+	return culture_distribution[culture];
 }
 
 fixed_point_t CountryInstance::get_religion_proportion(Religion const& religion) const {
-	const decltype(religion_distribution)::const_iterator it = religion_distribution.find(&religion);
-
-	if (it != religion_distribution.end()) {
-		return it->second;
-	} else {
-		return fixed_point_t::_0();
-	}
+	return religion_distribution[religion];
 }
 
 #define ADD_AND_REMOVE(item) \
@@ -251,7 +255,23 @@ bool CountryInstance::set_upper_house(Ideology const* ideology, fixed_point_t po
 
 bool CountryInstance::set_ruling_party(CountryParty const& new_ruling_party) {
 	if (ruling_party != &new_ruling_party) {
+		if (ruling_party != nullptr) {
+			for (Issue const* issue : ruling_party->get_policies().get_values()) {
+				if (issue != nullptr) {
+					_remove_persistent_modifier(*issue);
+				}
+			}
+		}
+		// The ruling party's issues here could be null as they're stored in an IndexedMap which has
+		// values for every IssueGroup regardless of whether or not they have a policy set.
+		for (Issue const* issue : new_ruling_party.get_policies().get_values()) {
+			if (issue != nullptr) {
+				_add_persistent_modifier(*issue);
+			}
+		}
+
 		ruling_party = &new_ruling_party;
+		politics_revision++;
 
 		return update_rule_set();
 	} else {
@@ -271,7 +291,9 @@ bool CountryInstance::add_reform(Reform const& new_reform) {
 			total_administrative_multiplier += new_reform.get_administrative_multiplier();
 		}
 
+		_replace_persistent_modifier(reform, &new_reform);
 		reform = &new_reform;
+		politics_revision++;
 
 		// TODO - if new_reform.get_reform_group().is_uncivilised() ?
 		// TODO - new_reform.get_on_execute_trigger() / new_reform.get_on_execute_effect() ?
@@ -327,9 +349,11 @@ bool CountryInstance::add_unit_instance_group(UnitInstanceGroup& group) {
 
 	switch (group.get_branch()) {
 	case LAND:
+		group.country_list_index = armies.size();
 		armies.push_back(static_cast<ArmyInstance*>(&group));
 		return true;
 	case NAVAL:
+		group.country_list_index = navies.size();
 		navies.push_back(static_cast<NavyInstance*>(&group));
 		return true;
 	default:
@@ -345,11 +369,13 @@ bool CountryInstance::remove_unit_instance_group(UnitInstanceGroup const& group)
 	const auto remove_from_vector = [this, &group]<UnitType::branch_t Branch>(
 		std::vector<UnitInstanceGroupBranched<Branch>*>& unit_instance_groups
 	) -> bool {
-		const typename std::vector<UnitInstanceGroupBranched<Branch>*>::const_iterator it =
-			std::find(unit_instance_groups.begin(), unit_instance_groups.end(), &group);
+		const size_t index = group.country_list_index;
 
-		if (it != unit_instance_groups.end()) {
-			unit_instance_groups.erase(it);
+		// The last group is moved into the removed group's place, so removal is O(1) but does not preserve order.
+		if (index < unit_instance_groups.size() && unit_instance_groups[index] == &group) {
+			unit_instance_groups[index] = unit_instance_groups.back();
+			unit_instance_groups[index]->country_list_index = index;
+			unit_instance_groups.pop_back();
 			return true;
 		} else {
 			Logger::error(
@@ -674,7 +700,16 @@ bool CountryInstance::modify_technology_unlock(
 		return false;
 	}
 
+	const bool technology_was_unlocked = unlock_level > 0;
 	unlock_level += unlock_level_change;
+	if (technology_was_unlocked != (unlock_level > 0)) {
+		technology_revision++;
+		if (technology_was_unlocked) {
+			_remove_persistent_modifier(technology);
+		} else {
+			_add_persistent_modifier(technology);
+		}
+	}
 
 	bool ret = true;
 
@@ -727,10 +762,13 @@ bool CountryInstance::modify_invention_unlock(
 	const bool invention_was_unlocked = unlock_level > 0;
 	unlock_level += unlock_level_change;
 	if (invention_was_unlocked != (unlock_level > 0)) {
+		technology_revision++;
 		if (invention_was_unlocked) {
 			inventions_count--;
+			_remove_persistent_modifier(invention);
 		} else {
 			inventions_count++;
+			_add_persistent_modifier(invention);
 		}
 	}
 
@@ -861,9 +899,16 @@ bool CountryInstance::apply_history_to_country(CountryHistoryEntry const& entry,
 	if (entry.get_capital()) {
 		capital = &instance_manager.get_map_instance().get_province_instance_from_definition(**entry.get_capital());
 	}
-	set_optional(government_type, entry.get_government_type());
+	if (entry.get_government_type()) {
+		government_type = *entry.get_government_type();
+		politics_revision++;
+	}
 	set_optional(plurality, entry.get_plurality());
-	set_optional(national_value, entry.get_national_value());
+	if (entry.get_national_value()) {
+		_replace_persistent_modifier(national_value, *entry.get_national_value());
+		national_value = *entry.get_national_value();
+		politics_revision++;
+	}
 	if (entry.is_civilised()) {
 		country_status = *entry.is_civilised() ? COUNTRY_STATUS_CIVILISED : COUNTRY_STATUS_UNCIVILISED;
 	}
@@ -871,7 +916,11 @@ bool CountryInstance::apply_history_to_country(CountryHistoryEntry const& entry,
 	for (Reform const* reform : entry.get_reforms()) {
 		ret &= add_reform(*reform);
 	}
-	set_optional(tech_school, entry.get_tech_school());
+	if (entry.get_tech_school()) {
+		_replace_persistent_modifier(tech_school, *entry.get_tech_school());
+		tech_school = *entry.get_tech_school();
+		politics_revision++;
+	}
 	constexpr auto set_bool_map_to_indexed_map =
 		[]<typename T>(IndexedMap<T, bool>& target, ordered_map<T const*, bool> source) {
 			for (auto const& [key, value] : source) {
@@ -1003,7 +1052,7 @@ void CountryInstance::_update_population() {
 
 	pop_type_distribution.clear();
 	ideology_distribution.clear();
-	issue_distribution.clear();
+	zero_fixed_point_map(issue_distribution);
 	vote_distribution.clear();
 	culture_distribution.clear();
 	religion_distribution.clear();
@@ -1036,6 +1085,7 @@ void CountryInstance::_update_population() {
 		culture_distribution += state->get_culture_distribution();
 		religion_distribution += state->get_religion_distribution();
 	}
+	erase_zero_values(issue_distribution);
 
 	if (total_population > 0) {
 		national_literacy /= total_population;
@@ -1249,32 +1299,41 @@ static constexpr Modifier const& get_country_status_static_effect(
 	}
 }
 
-void CountryInstance::update_modifier_sum(Date today, StaticModifierCache const& static_modifier_cache) {
-	// Update sum of national modifiers
-	modifier_sum.clear();
+void CountryInstance::_add_persistent_modifier(Modifier const& modifier) {
+	persistent_modifier_sum.add_modifier(modifier);
+}
 
-	// Add static modifiers
-	modifier_sum.add_modifier(static_modifier_cache.get_base_modifier());
-	modifier_sum.add_modifier(get_country_status_static_effect(country_status, static_modifier_cache));
-	if (is_disarmed()) {
-		modifier_sum.add_modifier(static_modifier_cache.get_disarming());
+void CountryInstance::_remove_persistent_modifier(Modifier const& modifier) {
+	if (!persistent_modifier_sum.remove_modifier(modifier)) {
+		Logger::error(
+			"Attempted to remove modifier ", modifier.get_identifier(), " from country ", get_identifier(),
+			"'s persistent modifier sum, but it was never added!"
+		);
 	}
-	modifier_sum.add_modifier(static_modifier_cache.get_war_exhaustion(), war_exhaustion);
-	modifier_sum.add_modifier(static_modifier_cache.get_infamy(), infamy);
-	modifier_sum.add_modifier(static_modifier_cache.get_literacy(), national_literacy);
-	modifier_sum.add_modifier(static_modifier_cache.get_plurality(), plurality);
-	modifier_sum.add_modifier(is_at_war() ? static_modifier_cache.get_war() : static_modifier_cache.get_peace());
-	// TODO - difficulty modifiers, debt_default_to, bad_debtor, generalised_debt_default,
-	//        total_occupation, total_blockaded, in_bankruptcy
+}
+
+void CountryInstance::_replace_persistent_modifier(Modifier const* old_modifier, Modifier const* new_modifier) {
+	if (old_modifier != new_modifier) {
+		if (old_modifier != nullptr) {
+			_remove_persistent_modifier(*old_modifier);
+		}
+		if (new_modifier != nullptr) {
+			_add_persistent_modifier(*new_modifier);
+		}
+	}
+}
 
-	// TODO - handle triggered modifiers
+void CountryInstance::_build_persistent_modifier_sum(ModifierSum& target) const {
+	target.clear();
+	target.set_this_source(persistent_modifier_sum.get_this_source());
+	target.set_this_excluded_targets(persistent_modifier_sum.get_this_excluded_targets());
 
 	if (ruling_party != nullptr) {
 		for (Issue const* issue : ruling_party->get_policies().get_values()) {
 			// The ruling party's issues here could be null as they're stored in an IndexedMap which has
 			// values for every IssueGroup regardless of whether or not they have a policy set.
 			if (issue != nullptr) {
-				modifier_sum.add_modifier(*issue);
+				target.add_modifier(*issue);
 			}
 		}
 	}
@@ -1283,39 +1342,121 @@ void CountryInstance::update_modifier_sum(Date today, StaticModifierCache const&
 		// The country's reforms here could be null as they're stored in an IndexedMap which has
 		// values for every ReformGroup regardless of whether or not they have a reform set.
 		if (reform != nullptr) {
-			modifier_sum.add_modifier(*reform);
+			target.add_modifier(*reform);
 		}
 	}
 
 	if (tech_school != nullptr) {
-		modifier_sum.add_modifier(*tech_school);
+		target.add_modifier(*tech_school);
 	}
 
 	for (Technology const& technology : *technology_unlock_levels.get_keys()) {
 		if (is_technology_unlocked(technology)) {
-			modifier_sum.add_modifier(technology);
+			target.add_modifier(technology);
 		}
 	}
 
 	for (Invention const& invention : *invention_unlock_levels.get_keys()) {
 		if (is_invention_unlocked(invention)) {
-			modifier_sum.add_modifier(invention);
+			target.add_modifier(invention);
+		}
+	}
+
+	for (ModifierInstance const& modifier : event_modifiers) {
+		target.add_modifier(*modifier.get_modifier());
+	}
+
+	for (TriggeredModifier const* modifier : triggered_modifiers) {
+		target.add_modifier(*modifier);
+	}
+
+	if (national_value != nullptr) {
+		target.add_modifier(*national_value);
+	}
+}
+
+bool CountryInstance::check_persistent_modifier_sum() const {
+	ModifierSum rebuilt_modifier_sum;
+	_build_persistent_modifier_sum(rebuilt_modifier_sum);
+
+	if (!persistent_modifier_sum.is_equivalent_to(rebuilt_modifier_sum)) {
+		Logger::error(
+			"Persistent modifier sum of country ", get_identifier(), " differs from a full rebuild: ",
+			persistent_modifier_sum.get_modifiers().size(), " maintained entries vs ",
+			rebuilt_modifier_sum.get_modifiers().size(), " rebuilt entries"
+		);
+		return false;
+	}
+	return true;
+}
+
+void CountryInstance::add_event_modifier(Modifier const& modifier, Date expiry_date) {
+	const decltype(event_modifiers)::iterator it = std::find_if(
+		event_modifiers.begin(), event_modifiers.end(),
+		[&modifier](ModifierInstance const& event_modifier) -> bool {
+			return event_modifier.get_modifier() == &modifier;
 		}
+	);
+
+	if (it != event_modifiers.end()) {
+		*it = { modifier, expiry_date };
+	} else {
+		event_modifiers.emplace_back(modifier, expiry_date);
+		_add_persistent_modifier(modifier);
 	}
+}
 
-	// Erase expired event modifiers and add non-expired ones to the sum
+void CountryInstance::update_triggered_modifiers(
+	InstanceManager const& instance_manager, TriggeredModifierCache const& triggered_modifier_cache
+) {
+	std::vector<size_t> changed;
+	triggered_modifier_cache.update_country(instance_manager, *this, triggered_modifier_state, changed);
+
+	for (const size_t trigger_index : changed) {
+		TriggeredModifier const& modifier = triggered_modifier_cache.get_triggered_modifier(trigger_index);
+		if (triggered_modifier_state.is_active(trigger_index)) {
+			triggered_modifiers.emplace(&modifier);
+			_add_persistent_modifier(modifier);
+		} else {
+			triggered_modifiers.erase(&modifier);
+			_remove_persistent_modifier(modifier);
+		}
+	}
+}
+
+void CountryInstance::update_modifier_sum(Date today, StaticModifierCache const& static_modifier_cache) {
+	// Erase expired event modifiers, removing only their contributions from the persistent sum
 	std::erase_if(event_modifiers, [this, today](ModifierInstance const& modifier) -> bool {
 		if (today <= modifier.get_expiry_date()) {
-			modifier_sum.add_modifier(*modifier.get_modifier());
 			return false;
 		} else {
+			_remove_persistent_modifier(*modifier.get_modifier());
 			return true;
 		}
 	});
 
-	if (national_value != nullptr) {
-		modifier_sum.add_modifier(*national_value);
+#ifdef DEV_ENABLED
+	check_persistent_modifier_sum();
+#endif
+
+	// Update sum of national modifiers, starting from those that only change on discrete events
+	modifier_sum = persistent_modifier_sum;
+
+	// Add static modifiers
+	modifier_sum.add_modifier(static_modifier_cache.get_base_modifier());
+	modifier_sum.add_modifier(get_country_status_static_effect(country_status, static_modifier_cache));
+	if (is_disarmed()) {
+		modifier_sum.add_modifier(static_modifier_cache.get_disarming());
 	}
+	modifier_sum.add_modifier(static_modifier_cache.get_war_exhaustion(), war_exhaustion);
+	modifier_sum.add_modifier(static_modifier_cache.get_infamy(), infamy);
+	modifier_sum.add_modifier(static_modifier_cache.get_literacy(), national_literacy);
+	modifier_sum.add_modifier(static_modifier_cache.get_plurality(), plurality);
+	modifier_sum.add_modifier(is_at_war() ? static_modifier_cache.get_war() : static_modifier_cache.get_peace());
+	// TODO - difficulty modifiers, debt_default_to, bad_debtor, generalised_debt_default,
+	//        total_occupation, total_blockaded, in_bankruptcy
+
+	// Triggered modifiers are already in the persistent sum, see update_triggered_modifiers
 
 	// TODO - calculate stats for each unit type (locked and unlocked)
 }
@@ -1362,8 +1503,8 @@ void CountryInstance::update_gamestate(InstanceManager& instance_manager) {
 	DefineManager const& define_manager = definition_manager.get_define_manager();
 
 	// Order of updates might need to be changed/functions split up to account for dependencies
-	// Updates population stats (including research and leadership points from pops)
-	_update_population();
+	// Population stats (including research and leadership points from pops) have already been updated by
+	// CountryInstanceManager::update_gamestate
 	// Calculates industrial power
 	_update_production(define_manager);
 	// Calculates daily research points and predicts research completion date
@@ -1460,11 +1601,11 @@ void CountryInstance::country_tick(InstanceManager& instance_manager) {
 }
 
 CountryInstance::good_data_t::good_data_t()
-	: lock { std::make_unique<std::mutex>() }
-	{ }
+	: need_consumption_per_pop_type { nullptr },
+	input_consumption_per_production_type { nullptr },
+	production_per_production_type { nullptr } {}
 
 void CountryInstance::good_data_t::clear_daily_recorded_data() {
-	const std::lock_guard<std::mutex> lock_guard { *lock };
 	stockpile_change_yesterday
 		= exported_amount
 		= government_needs
@@ -1475,48 +1616,165 @@ void CountryInstance::good_data_t::clear_daily_recorded_data() {
 		= pop_demand
 		= available_amount
 		= fixed_point_t::_0();
-	need_consumption_per_pop_type.clear();
-	input_consumption_per_production_type.clear();
-	production_per_production_type.clear();
+	need_consumption_per_pop_type.fill(fixed_point_t::_0());
+	input_consumption_per_production_type.fill(fixed_point_t::_0());
+	production_per_production_type.fill(fixed_point_t::_0());
+}
+
+namespace OpenVic {
+	/* Economy reports made by one thread for one country, laid out as a row of cells per good:
+	 * [pop demand, factory demand, need consumption per pop type..., input consumption per production type...,
+	 *  production per production type...]. Only touched cells are added to the country and reset when flushing. */
+	struct economy_report_buffer_t {
+		enum struct report_t { POP_DEMAND, FACTORY_DEMAND, NEED_CONSUMPTION, INPUT_CONSUMPTION, PRODUCTION };
+
+	private:
+		CountryInstance* country = nullptr;
+		size_t pop_type_count = 0, production_type_count = 0;
+		std::vector<fixed_point_t> cells;
+		// May contain duplicates if a cell's value returns to zero, which are harmless as flushing resets cells to zero.
+		std::vector<size_t> touched_cells;
+
+		constexpr size_t get_need_consumption_offset() const {
+			return 2;
+		}
+		constexpr size_t get_input_consumption_offset() const {
+			return get_need_consumption_offset() + pop_type_count;
+		}
+		constexpr size_t get_production_offset() const {
+			return get_input_consumption_offset() + production_type_count;
+		}
+		constexpr size_t get_row_size() const {
+			return get_production_offset() + production_type_count;
+		}
+
+		constexpr size_t get_offset(report_t report, size_t type_index) const {
+			using enum report_t;
+
+			switch (report) {
+			case POP_DEMAND:        return 0;
+			case FACTORY_DEMAND:    return 1;
+			case NEED_CONSUMPTION:  return get_need_consumption_offset() + type_index;
+			case INPUT_CONSUMPTION: return get_input_consumption_offset() + type_index;
+			default:                return get_production_offset() + type_index;
+			}
+		}
+
+		void set_country(CountryInstance& new_country) {
+			if (country == &new_country) {
+				return;
+			}
+
+			flush();
+			country = &new_country;
+
+			// Every country's goods data has the same shape, so this only resizes on a thread's first report
+			CountryInstance::good_data_t const& good_data = new_country.goods_data.get_values().front();
+			pop_type_count = good_data.need_consumption_per_pop_type.size();
+			production_type_count = good_data.input_consumption_per_production_type.size();
+			cells.resize(new_country.goods_data.size() * get_row_size());
+		}
+
+	public:
+		void add(
+			CountryInstance& reporting_country, GoodDefinition const& good, report_t report, size_t type_index,
+			fixed_point_t quantity
+		) {
+			set_country(reporting_country);
+
+			const size_t cell = good.get_index() * get_row_size() + get_offset(report, type_index);
+			if (cells[cell] == fixed_point_t::_0()) {
+				touched_cells.push_back(cell);
+			}
+			cells[cell] += quantity;
+		}
+
+		void flush() {
+			if (country == nullptr) {
+				return;
+			}
+
+			if (!touched_cells.empty()) {
+				const std::lock_guard<std::mutex> lock_guard { *country->economy_report_lock };
+
+				const size_t row_size = get_row_size();
+				for (const size_t cell : touched_cells) {
+					fixed_point_t& value = cells[cell];
+					if (value == fixed_point_t::_0()) {
+						continue;
+					}
+
+					CountryInstance::good_data_t& good_data = country->goods_data[cell / row_size];
+					const size_t offset = cell % row_size;
+
+					if (offset == get_offset(report_t::POP_DEMAND, 0)) {
+						good_data.pop_demand += value;
+					} else if (offset == get_offset(report_t::FACTORY_DEMAND, 0)) {
+						good_data.factory_demand += value;
+					} else if (offset < get_input_consumption_offset()) {
+						good_data.need_consumption_per_pop_type[offset - get_need_consumption_offset()] += value;
+					} else if (offset < get_production_offset()) {
+						good_data.input_consumption_per_production_type[offset - get_input_consumption_offset()] += value;
+					} else {
+						good_data.production_per_production_type[offset - get_production_offset()] += value;
+					}
+
+					value = fixed_point_t::_0();
+				}
+
+				touched_cells.clear();
+			}
+
+			country = nullptr;
+		}
+	};
 }
 
+static thread_local economy_report_buffer_t economy_report_buffer;
+
 void CountryInstance::report_pop_need_consumption(PopType const& pop_type, GoodDefinition const& good, const fixed_point_t quantity) {
-	good_data_t& good_data = get_good_data(good);
-	const std::lock_guard<std::mutex> lock_guard { *good_data.lock };
-	good_data.need_consumption_per_pop_type[&pop_type] += quantity;
+	economy_report_buffer.add(
+		*this, good, economy_report_buffer_t::report_t::NEED_CONSUMPTION, pop_type.get_index(), quantity
+	);
 }
 void CountryInstance::report_pop_need_demand(PopType const& pop_type, GoodDefinition const& good, const fixed_point_t quantity) {
-	good_data_t& good_data = get_good_data(good);
-	const std::lock_guard<std::mutex> lock_guard { *good_data.lock };
-	good_data.pop_demand += quantity;
+	economy_report_buffer.add(*this, good, economy_report_buffer_t::report_t::POP_DEMAND, 0, quantity);
 }
 void CountryInstance::report_input_consumption(ProductionType const& production_type, GoodDefinition const& good, const fixed_point_t quantity) {
-	good_data_t& good_data = get_good_data(good);
-	const std::lock_guard<std::mutex> lock_guard { *good_data.lock };
-	good_data.input_consumption_per_production_type[&production_type] += quantity;
+	economy_report_buffer.add(
+		*this, good, economy_report_buffer_t::report_t::INPUT_CONSUMPTION,
+		get_good_data(good).input_consumption_per_production_type.get_index_from_item(production_type), quantity
+	);
 }
 void CountryInstance::report_input_demand(ProductionType const& production_type, GoodDefinition const& good, const fixed_point_t quantity) {
 	if (production_type.get_template_type() == ProductionType::template_type_t::ARTISAN) {
 		switch (game_rules_manager.get_artisanal_input_demand_category()) {
 			case demand_category::FactoryNeeds: break;
 			case demand_category::PopNeeds: {
-				good_data_t& good_data = get_good_data(good);
-				const std::lock_guard<std::mutex> lock_guard { *good_data.lock };
-				good_data.pop_demand += quantity;
+				economy_report_buffer.add(*this, good, economy_report_buffer_t::report_t::POP_DEMAND, 0, quantity);
 				return;
 			}
 			default: return; //demand_category::None
 		}
 	}
 
-	good_data_t& good_data = get_good_data(good);
-	const std::lock_guard<std::mutex> lock_guard { *good_data.lock };
-	good_data.factory_demand += quantity;
+	economy_report_buffer.add(*this, good, economy_report_buffer_t::report_t::FACTORY_DEMAND, 0, quantity);
 }
 void CountryInstance::report_output(ProductionType const& production_type, const fixed_point_t quantity) {
-	good_data_t& good_data = get_good_data(production_type.get_output_good());
-	const std::lock_guard<std::mutex> lock_guard { *good_data.lock };
-	good_data.production_per_production_type[&production_type] += quantity;
+	GoodDefinition const& good = production_type.get_output_good();
+	economy_report_buffer.add(
+		*this, good, economy_report_buffer_t::report_t::PRODUCTION,
+		get_good_data(good).production_per_production_type.get_index_from_item(production_type), quantity
+	);
+}
+void CountryInstance::flush_economy_reports() {
+	economy_report_buffer.flush();
+}
+
+void CountryInstance::report_pop_need_consumption_after_trade(
+	PopType const& pop_type, GoodDefinition const& good, const fixed_point_t quantity
+) {
+	get_good_data(good).need_consumption_per_pop_type[pop_type] += quantity;
 }
 
 CountryInstance::good_data_t& CountryInstance::get_good_data(GoodInstance const& good_instance) {
@@ -1672,7 +1930,10 @@ bool CountryInstanceManager::generate_country_instances(
 	decltype(CountryInstance::government_flag_overrides)::keys_type const& government_type_keys,
 	decltype(CountryInstance::crime_unlock_levels)::keys_type const& crime_keys,
 	decltype(CountryInstance::pop_type_distribution)::keys_type const& pop_type_keys,
+	decltype(CountryInstance::culture_distribution)::keys_type const& culture_keys,
+	decltype(CountryInstance::religion_distribution)::keys_type const& religion_keys,
 	decltype(CountryInstance::goods_data)::keys_type const& good_instances_keys,
+	CountryInstance::production_type_keys_t const& production_type_keys,
 	decltype(CountryInstance::regiment_type_unlock_levels)::keys_type const& regiment_type_unlock_levels_keys,
 	decltype(CountryInstance::ship_type_unlock_levels)::keys_type const& ship_type_unlock_levels_keys,
 	decltype(CountryInstance::tax_rate_by_strata):: keys_type const& strata_keys,
@@ -1695,7 +1956,10 @@ bool CountryInstanceManager::generate_country_instances(
 			government_type_keys,
 			crime_keys,
 			pop_type_keys,
+			culture_keys,
+			religion_keys,
 			good_instances_keys,
+			production_type_keys,
 			regiment_type_unlock_levels_keys,
 			ship_type_unlock_levels_keys,
 			strata_keys,
@@ -1706,6 +1970,7 @@ bool CountryInstanceManager::generate_country_instances(
 			// after changing between its constructor call and now due to being std::move'd into the registry.
 			CountryInstance& country_instance = get_back_country_instance();
 			country_instance.modifier_sum.set_this_source(&country_instance);
+			country_instance.persistent_modifier_sum.set_this_source(&country_instance);
 
 			country_definition_to_instance_map[country_definition] = &country_instance;
 		} else {
@@ -1800,6 +2065,17 @@ bool CountryInstanceManager::apply_history_to_countries(
 	return ret;
 }
 
+void CountryInstanceManager::update_triggered_modifiers(InstanceManager const& instance_manager) {
+	// Each country only changes its own state, while triggers may read other countries' state but never their
+	// triggered modifiers or modifier sums, so countries can be updated in parallel.
+	parallel_for_each(
+		country_instances.get_items(),
+		[this, &instance_manager](CountryInstance& country) -> void {
+			country.update_triggered_modifiers(instance_manager, triggered_modifier_cache);
+		}
+	);
+}
+
 void CountryInstanceManager::update_modifier_sums(Date today, StaticModifierCache const& static_modifier_cache) {
 	for (CountryInstance& country : country_instances.get_items()) {
 		country.update_modifier_sum(today, static_modifier_cache);
@@ -1807,7 +2083,17 @@ void CountryInstanceManager::update_modifier_sums(Date today, StaticModifierCach
 }
 
 void CountryInstanceManager::update_gamestate(InstanceManager& instance_manager) {
-	for (CountryInstance& country : country_instances.get_items()) {
+	// The state -> country rollups only read each country's own states, so unlike the rest of the country update,
+	// which looks at neighbours, rankings and other countries' stats, they can run in parallel.
+	auto& countries = country_instances.get_items();
+	parallel_for_each(
+		countries,
+		[](CountryInstance& country) -> void {
+			country._update_population();
+		}
+	);
+
+	for (CountryInstance& country : countries) {
 		country.update_gamestate(instance_manager);
 	}
 
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
 #include "openvic-simulation/modifier/ModifierSum.hpp"
+#include "openvic-simulation/modifier/TriggeredModifierCache.hpp"
 #include "openvic-simulation/politics/Ideology.hpp"
 #include "openvic-simulation/politics/Rule.hpp"
 #include "openvic-simulation/pop/PopType.hpp"
@@ -53,6 +56,7 @@ namespace OpenVic {
 	 * but can be swapped with other CountryInstance's CountryDefinition when switching tags. */
 	struct CountryInstance : FlagStrings, HasIndex<> {
 		friend struct CountryInstanceManager;
+		friend struct economy_report_buffer_t;
 
 		/*
 			Westernisation Progress vs Status for Uncivilised Countries:
@@ -113,7 +117,14 @@ namespace OpenVic {
 
 		// The total/resultant modifier affecting this country, including owned province contributions.
 		ModifierSum PROPERTY(modifier_sum);
+		// National modifiers which only change on discrete events (policies, reforms, technologies, inventions, tech school,
+		// national value and event modifiers), added and removed as those events happen rather than summed up every day.
+		// Copied into modifier_sum at the start of each update_modifier_sum.
+		ModifierSum persistent_modifier_sum;
 		std::vector<ModifierInstance> PROPERTY(event_modifiers);
+		// Triggered modifiers whose triggers currently hold, included in persistent_modifier_sum.
+		ordered_set<TriggeredModifier const*> PROPERTY(triggered_modifiers);
+		TriggeredModifierCache::country_state_t triggered_modifier_state;
 
 		/* Production */
 		fixed_point_t PROPERTY(industrial_power);
@@ -141,6 +152,8 @@ namespace OpenVic {
 		IndexedMap<Technology, unlock_level_t> PROPERTY(technology_unlock_levels);
 		IndexedMap<Invention, unlock_level_t> PROPERTY(invention_unlock_levels);
 		int32_t PROPERTY(inventions_count, 0);
+		// Incremented whenever a technology or invention is unlocked or locked.
+		uint32_t PROPERTY(technology_revision, 0);
 		Technology const* PROPERTY(current_research, nullptr);
 		fixed_point_t PROPERTY(invested_research_points);
 		fixed_point_t PROPERTY(current_research_cost);
@@ -159,6 +172,8 @@ namespace OpenVic {
 		CountryParty const* PROPERTY(ruling_party, nullptr);
 		IndexedMap<Ideology, fixed_point_t> PROPERTY(upper_house);
 		IndexedMap<ReformGroup, Reform const*> PROPERTY(reforms);
+		// Incremented whenever the ruling party, reforms, government type, national value or tech school change.
+		uint32_t PROPERTY(politics_revision, 0);
 		fixed_point_t PROPERTY(total_administrative_multiplier);
 		RuleSet PROPERTY(rule_set);
 		// TODO - national issue support distribution (for just voters and for everyone)
@@ -190,15 +205,14 @@ namespace OpenVic {
 		IndexedMap<Ideology, fixed_point_t> PROPERTY(ideology_distribution);
 		fixed_point_map_t<Issue const*> PROPERTY(issue_distribution);
 		IndexedMap<CountryParty, fixed_point_t> PROPERTY(vote_distribution);
-		fixed_point_map_t<Culture const*> PROPERTY(culture_distribution);
-		fixed_point_map_t<Religion const*> PROPERTY(religion_distribution);
+		IndexedMap<Culture, fixed_point_t> PROPERTY(culture_distribution);
+		IndexedMap<Religion, fixed_point_t> PROPERTY(religion_distribution);
 		size_t PROPERTY(national_focus_capacity, 0);
 		// TODO - national foci
 
 		/* Trade */
 	public:
 		struct good_data_t {
-			std::unique_ptr<std::mutex> lock;
 			fixed_point_t stockpile_amount;
 			fixed_point_t stockpile_change_yesterday; // positive if we bought, negative if we sold
 
@@ -216,20 +230,24 @@ namespace OpenVic {
 			fixed_point_t pop_demand;
 			fixed_point_t available_amount;
 
-			ordered_map<PopType const*, fixed_point_t> need_consumption_per_pop_type;
-			ordered_map<ProductionType const*, fixed_point_t> input_consumption_per_production_type;
-			ordered_map<ProductionType const*, fixed_point_t> production_per_production_type;
+			// Dense over every pop/production type, most values are zero as only a few types relate to each good.
+			IndexedMap<PopType, fixed_point_t> need_consumption_per_pop_type;
+			IndexedMap<ProductionType, fixed_point_t> input_consumption_per_production_type;
+			IndexedMap<ProductionType, fixed_point_t> production_per_production_type;
 
 			good_data_t();
 			good_data_t(good_data_t&&) = default;
 			good_data_t& operator=(good_data_t&&) = default;
 
-			//thread safe
 			void clear_daily_recorded_data();
 		};
 
+		using production_type_keys_t = decltype(good_data_t::input_consumption_per_production_type)::keys_type;
+
 	private:
 		IndexedMap<GoodInstance, good_data_t> PROPERTY(goods_data);
+		// Held while adding a thread's buffered economy reports to goods_data, see flush_economy_reports.
+		std::unique_ptr<std::mutex> economy_report_lock;
 
 		/* Diplomacy */
 		fixed_point_t PROPERTY(prestige);
@@ -297,7 +315,10 @@ namespace OpenVic {
 			decltype(government_flag_overrides)::keys_type const& government_type_keys,
 			decltype(crime_unlock_levels)::keys_type const& crime_keys,
 			decltype(pop_type_distribution)::keys_type const& pop_type_keys,
+			decltype(culture_distribution)::keys_type const& culture_keys,
+			decltype(religion_distribution)::keys_type const& religion_keys,
 			decltype(goods_data)::keys_type const& good_instances_keys,
+			production_type_keys_t const& production_type_keys,
 			decltype(regiment_type_unlock_levels)::keys_type const& regiment_type_unlock_levels_keys,
 			decltype(ship_type_unlock_levels)::keys_type const& ship_type_unlock_levels_keys,
 			decltype(tax_rate_by_strata)::keys_type const& strata_keys,
@@ -509,7 +530,11 @@ namespace OpenVic {
 		void _update_current_tech(InstanceManager const& instance_manager);
 		void _update_technology(InstanceManager const& instance_manager);
 		void _update_politics();
+		// Run for every country in parallel by CountryInstanceManager::update_gamestate, before any update_gamestate.
 		void _update_population();
+		/* Relies on every country's population stats already being up to date, so it is private and only called by
+		 * CountryInstanceManager::update_gamestate after its _update_population pre-pass. */
+		void update_gamestate(InstanceManager& instance_manager);
 		void _update_trade();
 		void _update_diplomacy();
 		void _update_military(
@@ -519,7 +544,23 @@ namespace OpenVic {
 
 		bool update_rule_set();
 
+		void _add_persistent_modifier(Modifier const& modifier);
+		void _remove_persistent_modifier(Modifier const& modifier);
+		// Either modifier may be null, nothing is done if they're the same.
+		void _replace_persistent_modifier(Modifier const* old_modifier, Modifier const* new_modifier);
+		// Sums up the modifiers tracked by persistent_modifier_sum from scratch.
+		void _build_persistent_modifier_sum(ModifierSum& target) const;
+
 	public:
+		// Debug cross-check comparing persistent_modifier_sum with a full rebuild, logging an error if they differ.
+		bool check_persistent_modifier_sum() const;
+		/* Adds an event modifier lasting until expiry_date, or moves its expiry date if the country already has it,
+		 * keeping persistent_modifier_sum up to date. Event modifiers must only be added through this. */
+		void add_event_modifier(Modifier const& modifier, Date expiry_date);
+		// Re-evaluates triggered modifiers whose inputs have changed, adding or removing them from the persistent sum.
+		void update_triggered_modifiers(
+			InstanceManager const& instance_manager, TriggeredModifierCache const& triggered_modifier_cache
+		);
 		void update_modifier_sum(Date today, StaticModifierCache const& static_modifier_cache);
 		void contribute_province_modifier_sum(ModifierSum const& province_modifier_sum);
 		fixed_point_t get_modifier_effect_value(ModifierEffect const& effect) const;
@@ -530,7 +571,6 @@ namespace OpenVic {
 		}
 
 		void country_reset_before_tick();
-		void update_gamestate(InstanceManager& instance_manager);
 		void country_tick(InstanceManager& instance_manager);
 
 		good_data_t& get_good_data(GoodInstance const& good_instance);
@@ -539,11 +579,22 @@ namespace OpenVic {
 		good_data_t const& get_good_data(GoodDefinition const& good_definition) const;
 
 		//thread safe
+		/* Economy statistics reported during the map tick are accumulated in a dense per-thread buffer, without locking,
+		 * and only added to goods_data when the thread reports for a different country or flush_economy_reports is called.
+		 * Code ticking a province must call flush_economy_reports once it's done. */
 		void report_pop_need_consumption(PopType const& pop_type, GoodDefinition const& good, const fixed_point_t quantity);
 		void report_pop_need_demand(PopType const& pop_type, GoodDefinition const& good, const fixed_point_t quantity);
 		void report_input_consumption(ProductionType const& production_type, GoodDefinition const& good, const fixed_point_t quantity);
 		void report_input_demand(ProductionType const& production_type, GoodDefinition const& good, const fixed_point_t quantity);
 		void report_output(ProductionType const& production_type, const fixed_point_t quantity);
+		// Adds the calling thread's buffered reports to their country's goods_data.
+		static void flush_economy_reports();
+
+		/* For a market's after-trade callbacks, which for any one good all run on the thread executing that good's orders,
+		 * so this writes straight to the good's data without locking or buffering. */
+		void report_pop_need_consumption_after_trade(
+			PopType const& pop_type, GoodDefinition const& good, const fixed_point_t quantity
+		);
 	};
 
 	struct CountryDefinitionManager;
@@ -554,6 +605,7 @@ namespace OpenVic {
 		CountryDefinitionManager const& PROPERTY(country_definition_manager);
 
 		IdentifierRegistry<CountryInstance> IDENTIFIER_REGISTRY(country_instance);
+		TriggeredModifierCache PROPERTY_REF(triggered_modifier_cache);
 
 		IndexedMap<CountryDefinition, CountryInstance*> PROPERTY(country_definition_to_instance_map);
 
@@ -584,7 +636,10 @@ namespace OpenVic {
 			decltype(CountryInstance::government_flag_overrides)::keys_type const& government_type_keys,
 			decltype(CountryInstance::crime_unlock_levels)::keys_type const& crime_keys,
 			decltype(CountryInstance::pop_type_distribution)::keys_type const& pop_type_keys,
+			decltype(CountryInstance::culture_distribution)::keys_type const& culture_keys,
+			decltype(CountryInstance::religion_distribution)::keys_type const& religion_keys,
 			decltype(CountryInstance::goods_data)::keys_type const& good_instances_keys,
+			CountryInstance::production_type_keys_t const& production_type_keys,
 			decltype(CountryInstance::regiment_type_unlock_levels)::keys_type const& regiment_type_unlock_levels_keys,
 			decltype(CountryInstance::ship_type_unlock_levels)::keys_type const& ship_type_unlock_levels_keys,
 			decltype(CountryInstance::tax_rate_by_strata):: keys_type const& strata_keys,
@@ -594,6 +649,7 @@ namespace OpenVic {
 
 		bool apply_history_to_countries(CountryHistoryManager const& history_manager, InstanceManager& instance_manager);
 
+		void update_triggered_modifiers(InstanceManager const& instance_manager);
 		void update_modifier_sums(Date today, StaticModifierCache const& static_modifier_cache);
 		void update_gamestate(InstanceManager& instance_manager);
 		void country_manager_reset_before_tick();
@@ -1,5 +1,8 @@
 #include "Dataloader.hpp"
 
+#include <chrono>
+#include <iterator>
+#include <span>
 #include <system_error>
 
 #include <openvic-dataloader/csv/Parser.hpp>
@@ -15,6 +18,7 @@
 #include "openvic-simulation/misc/SoundEffect.hpp"
 #include "openvic-simulation/utility/Logger.hpp"
 #include "openvic-simulation/utility/StringUtils.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
 
 using namespace OpenVic;
 using namespace OpenVic::NodeTools;
@@ -35,6 +39,11 @@ static fs::path ensure_forward_slash_path(std::string_view path) {
 #endif
 }
 
+void Dataloader::set_definitions_cache_path(fs::path const& new_definitions_cache_path) {
+	definitions_cache.close();
+	definitions_cache_path = new_definitions_cache_path;
+}
+
 bool Dataloader::set_roots(path_vector_t const& new_roots) {
 	if (!roots.empty()) {
 		Logger::warning("Overriding existing dataloader roots!");
@@ -192,8 +201,7 @@ string_set_t Dataloader::lookup_dirs_in_dir(std::string_view path) const {
 }
 
 template<std::derived_from<detail::BasicParser> Parser, bool (*parse_func)(Parser&)>
-static Parser _run_ovdl_parser(fs::path const& path) {
-	Parser parser;
+static void _run_ovdl_parser(Parser& parser, fs::path const& path) {
 	std::string buffer;
 	auto error_log_stream = detail::make_callback_stream<char>(
 		[](void const* s, std::streamsize n, void* user_data) -> std::streamsize {
@@ -215,7 +223,7 @@ static Parser _run_ovdl_parser(fs::path const& path) {
 	}
 	if (parser.has_fatal_error() || parser.has_error()) {
 		Logger::error("Parser errors while loading ", path);
-		return parser;
+		return;
 	}
 	if (!parse_func(parser)) {
 		Logger::error("Parse function returned false for ", path, "!");
@@ -227,6 +235,12 @@ static Parser _run_ovdl_parser(fs::path const& path) {
 	if (parser.has_fatal_error() || parser.has_error()) {
 		Logger::error("Parser errors while parsing ", path);
 	}
+}
+
+template<std::derived_from<detail::BasicParser> Parser, bool (*parse_func)(Parser&)>
+static Parser _run_ovdl_parser(fs::path const& path) {
+	Parser parser;
+	_run_ovdl_parser<Parser, parse_func>(parser, path);
 	return parser;
 }
 
@@ -258,6 +272,70 @@ v2script::Parser& Dataloader::parse_defines_cached(fs::path const& path) {
 	return cached_parsers.emplace_back(parse_defines(path));
 }
 
+std::vector<v2script::Parser> Dataloader::parse_defines_parallel(path_vector_t const& files) {
+	std::vector<v2script::Parser> parsers(files.size());
+
+	/* File sizes vary a lot, so each file is its own chunk to let idle threads steal the rest. */
+	ThreadPool::get_instance().parallel_for(files.size(), 1, [&files, &parsers](size_t begin, size_t end) -> void {
+		for (size_t index = begin; index < end; ++index) {
+			_run_ovdl_parser<v2script::Parser, &_v2script_parse>(parsers[index], files[index]);
+		}
+	});
+
+	return parsers;
+}
+
+static size_t _milliseconds_since(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool _apply_to_parsed_files(
+	std::string_view name, Dataloader::path_vector_t const& files, std::span<const v2script::Parser> parsers,
+	Dataloader::parsed_file_callback_t callback, size_t parse_milliseconds
+) {
+	const std::chrono::steady_clock::time_point apply_start = std::chrono::steady_clock::now();
+
+	bool ret = true;
+	for (size_t index = 0; index < files.size(); ++index) {
+		if (!callback(files[index], parsers[index])) {
+			Logger::error("Callback failed for file: ", files[index]);
+			ret = false;
+		}
+	}
+
+	Logger::info(
+		"Loaded ", files.size(), " ", name, " files: parsed in ", parse_milliseconds, "ms, applied in ",
+		_milliseconds_since(apply_start), "ms"
+	);
+
+	return ret;
+}
+
+bool Dataloader::parse_and_apply_to_files(
+	std::string_view name, path_vector_t const& files, parsed_file_callback_t callback
+) const {
+	const std::chrono::steady_clock::time_point parse_start = std::chrono::steady_clock::now();
+	const std::vector<v2script::Parser> parsers = parse_defines_parallel(files);
+	return _apply_to_parsed_files(name, files, parsers, callback, _milliseconds_since(parse_start));
+}
+
+bool Dataloader::parse_cached_and_apply_to_files(
+	std::string_view name, path_vector_t const& files, parsed_file_callback_t callback
+) {
+	const std::chrono::steady_clock::time_point parse_start = std::chrono::steady_clock::now();
+	std::vector<v2script::Parser> parsers = parse_defines_parallel(files);
+	const size_t parse_milliseconds = _milliseconds_since(parse_start);
+
+	/* Moving a Parser doesn't move its Node tree, so Nodes referenced by the callbacks stay valid in the cache. */
+	const size_t cache_begin = cached_parsers.size();
+	cached_parsers.reserve(cache_begin + parsers.size());
+	std::move(parsers.begin(), parsers.end(), std::back_inserter(cached_parsers));
+
+	return _apply_to_parsed_files(
+		name, files, { cached_parsers.data() + cache_begin, files.size() }, callback, parse_milliseconds
+	);
+}
+
 void Dataloader::free_cache() {
 	cached_parsers.clear();
 }
@@ -321,11 +399,13 @@ bool Dataloader::_load_pop_types(DefinitionManager& definition_manager) {
 
 	pop_manager.reserve_pop_types_and_delayed_nodes(pop_type_files.size());
 
-	ret &= apply_to_files(
-		pop_type_files,
-		[this, &pop_manager, &good_definition_manager, &ideology_manager](fs::path const& file) -> bool {
+	ret &= parse_cached_and_apply_to_files(
+		"pop type", pop_type_files,
+		[&pop_manager, &good_definition_manager, &ideology_manager](
+			fs::path const& file, v2script::Parser const& parser
+		) -> bool {
 			return pop_manager.load_pop_type_file(
-				file.stem().string(), good_definition_manager, ideology_manager, parse_defines_cached(file).get_file_node()
+				file.stem().string(), good_definition_manager, ideology_manager, parser.get_file_node()
 			);
 		}
 	);
@@ -358,14 +438,14 @@ bool Dataloader::_load_units(DefinitionManager& definition_manager) const {
 
 	unit_type_manager.reserve_all_unit_types(unit_files.size());
 
-	bool ret = apply_to_files(
-		unit_files,
-		[&definition_manager, &unit_type_manager](fs::path const& file) -> bool {
+	bool ret = parse_and_apply_to_files(
+		"unit", unit_files,
+		[&definition_manager, &unit_type_manager](fs::path const& file, v2script::Parser const& parser) -> bool {
 			return unit_type_manager.load_unit_type_file(
 				definition_manager.get_economy_manager().get_good_definition_manager(),
 				definition_manager.get_map_definition().get_terrain_type_manager(),
 				definition_manager.get_modifier_manager(),
-				parse_defines(file)
+				parser
 			);
 		}
 	);
@@ -438,14 +518,16 @@ bool Dataloader::_load_technologies(DefinitionManager& definition_manager) {
 	}
 
 	static constexpr std::string_view technologies_directory = "technologies";
-	if (!apply_to_files(
-		lookup_files_in_dir(technologies_directory, ".txt"),
-		[this, &definition_manager, &technology_manager, &modifier_manager](fs::path const& file) -> bool {
+	if (!parse_cached_and_apply_to_files(
+		"technology", lookup_files_in_dir(technologies_directory, ".txt"),
+		[&definition_manager, &technology_manager, &modifier_manager](
+			fs::path const& file, v2script::Parser const& parser
+		) -> bool {
 			return technology_manager.load_technologies_file(
 				modifier_manager,
 				definition_manager.get_military_manager().get_unit_type_manager(),
 				definition_manager.get_economy_manager().get_building_type_manager(),
-				parse_defines_cached(file).get_file_node()
+				parser.get_file_node()
 			);
 		}
 	)) {
@@ -465,15 +547,15 @@ bool Dataloader::_load_inventions(DefinitionManager& definition_manager) {
 
 	InventionManager& invention_manager = definition_manager.get_research_manager().get_invention_manager();
 
-	bool ret = apply_to_files(
-		lookup_files_in_dir(inventions_directory, ".txt"),
-		[this, &definition_manager, &invention_manager](fs::path const& file) -> bool {
+	bool ret = parse_cached_and_apply_to_files(
+		"invention", lookup_files_in_dir(inventions_directory, ".txt"),
+		[&definition_manager, &invention_manager](fs::path const& file, v2script::Parser const& parser) -> bool {
 			return invention_manager.load_inventions_file(
 				definition_manager.get_modifier_manager(),
 				definition_manager.get_military_manager().get_unit_type_manager(),
 				definition_manager.get_economy_manager().get_building_type_manager(),
 				definition_manager.get_crime_manager(),
-				parse_defines_cached(file).get_file_node()
+				parser.get_file_node()
 			);
 		}
 	);
@@ -488,10 +570,10 @@ bool Dataloader::_load_decisions(DefinitionManager& definition_manager) {
 
 	DecisionManager& decision_manager = definition_manager.get_decision_manager();
 
-	bool ret = apply_to_files(
-		lookup_files_in_dir(decisions_directory, ".txt"),
-		[this, &decision_manager](fs::path const& file) -> bool {
-			return decision_manager.load_decision_file(parse_defines_cached(file).get_file_node());
+	bool ret = parse_cached_and_apply_to_files(
+		"decision", lookup_files_in_dir(decisions_directory, ".txt"),
+		[&decision_manager](fs::path const& file, v2script::Parser const& parser) -> bool {
+			return decision_manager.load_decision_file(parser.get_file_node());
 		}
 	);
 
@@ -516,9 +598,11 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 		country_history_manager.reserve_more_country_histories(country_history_files.size());
 		deployment_manager.reserve_more_deployments(country_history_files.size());
 
-		ret &= apply_to_files(
-			country_history_files,
-			[this, &definition_manager, &country_history_manager, unused_history_file_warnings](fs::path const& file) -> bool {
+		ret &= parse_and_apply_to_files(
+			"country history", country_history_files,
+			[this, &definition_manager, &country_history_manager, unused_history_file_warnings](
+				fs::path const& file, v2script::Parser const& parser
+			) -> bool {
 				const std::string filename = file.stem().string();
 				const std::string_view country_id = extract_basic_identifier_prefix(filename);
 
@@ -535,7 +619,7 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 					definition_manager, *this, *country,
 					definition_manager.get_politics_manager().get_ideology_manager().get_ideologies(),
 					definition_manager.get_politics_manager().get_government_type_manager().get_government_types(),
-					parse_defines(file).get_file_node()
+					parser.get_file_node()
 				);
 			}
 		);
@@ -559,10 +643,10 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 
 		province_history_manager.reserve_more_province_histories(province_history_files.size());
 
-		ret &= apply_to_files(
-			province_history_files,
-			[this, &definition_manager, &province_history_manager, &map_definition, unused_history_file_warnings](
-				fs::path const& file
+		ret &= parse_and_apply_to_files(
+			"province history", province_history_files,
+			[&definition_manager, &province_history_manager, &map_definition, unused_history_file_warnings](
+				fs::path const& file, v2script::Parser const& parser
 			) -> bool {
 				const std::string filename = file.stem().string();
 				const std::string_view province_id = extract_basic_identifier_prefix(filename);
@@ -576,7 +660,7 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 				}
 
 				return province_history_manager.load_province_history_file(
-					definition_manager, *province, parse_defines(file).get_file_node()
+					definition_manager, *province, parser.get_file_node()
 				);
 			}
 		);
@@ -595,13 +679,14 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 			if (result.ec == std::errc{} && date <= last_bookmark_date) {
 				bool non_integer_size = false;
 
-				ret &= apply_to_files(
+				ret &= parse_and_apply_to_files(
+					"pop history",
 					lookup_files_in_dir(StringUtils::append_string_views(pop_history_directory, dir), ".txt"),
-					[this, &definition_manager, &province_history_manager, date, &non_integer_size](
-						fs::path const& file
+					[&definition_manager, &province_history_manager, date, &non_integer_size](
+						fs::path const& file, v2script::Parser const& parser
 					) -> bool {
 						return province_history_manager.load_pop_history_file(
-							definition_manager, date, parse_defines(file).get_file_node(), &non_integer_size
+							definition_manager, date, parser.get_file_node(), &non_integer_size
 						);
 					}
 				);
@@ -622,11 +707,13 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 
 		static constexpr std::string_view diplomacy_history_directory = "history/diplomacy";
 
-		ret &= apply_to_files(
-			lookup_files_in_dir(diplomacy_history_directory, ".txt"),
-			[this, &definition_manager, &diplomatic_history_manager](fs::path const& file) -> bool {
+		ret &= parse_and_apply_to_files(
+			"diplomacy history", lookup_files_in_dir(diplomacy_history_directory, ".txt"),
+			[&definition_manager, &diplomatic_history_manager](
+				fs::path const& file, v2script::Parser const& parser
+			) -> bool {
 				return diplomatic_history_manager.load_diplomacy_history_file(
-					definition_manager.get_country_definition_manager(), parse_defines(file).get_file_node()
+					definition_manager.get_country_definition_manager(), parser.get_file_node()
 				);
 			}
 		);
@@ -637,12 +724,12 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 
 		diplomatic_history_manager.reserve_more_wars(war_history_files.size());
 
-		ret &= apply_to_files(
-			war_history_files,
-			[this, &definition_manager, &diplomatic_history_manager](fs::path const& file) -> bool {
-				return diplomatic_history_manager.load_war_history_file(
-					definition_manager, parse_defines(file).get_file_node()
-				);
+		ret &= parse_and_apply_to_files(
+			"war history", war_history_files,
+			[&definition_manager, &diplomatic_history_manager](
+				fs::path const& file, v2script::Parser const& parser
+			) -> bool {
+				return diplomatic_history_manager.load_war_history_file(definition_manager, parser.get_file_node());
 			}
 		);
 
@@ -655,11 +742,11 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 bool Dataloader::_load_events(DefinitionManager& definition_manager) {
 	static constexpr std::string_view events_directory = "events";
 
-	const bool ret = apply_to_files(
-		lookup_files_in_dir(events_directory, ".txt"),
-		[this, &definition_manager](fs::path const& file) -> bool {
+	const bool ret = parse_cached_and_apply_to_files(
+		"event", lookup_files_in_dir(events_directory, ".txt"),
+		[&definition_manager](fs::path const& file, v2script::Parser const& parser) -> bool {
 			return definition_manager.get_event_manager().load_event_file(
-				definition_manager.get_politics_manager().get_issue_manager(), parse_defines_cached(file).get_file_node()
+				definition_manager.get_politics_manager().get_issue_manager(), parser.get_file_node()
 			);
 		}
 	);
@@ -668,7 +755,9 @@ bool Dataloader::_load_events(DefinitionManager& definition_manager) {
 	return ret;
 }
 
-bool Dataloader::_load_map_dir(DefinitionManager& definition_manager) const {
+bool Dataloader::_load_map_dir(
+	DefinitionManager& definition_manager, DefinitionsCache::reader_t* cache_reader, DefinitionsCache::writer_t* cache_writer
+) const {
 	static constexpr std::string_view map_directory = "map/";
 	MapDefinition& map_definition = definition_manager.get_map_definition();
 
@@ -777,14 +866,23 @@ bool Dataloader::_load_map_dir(DefinitionManager& definition_manager) const {
 		ret = false;
 	}
 
-	if (!map_definition.load_map_images(
-		lookup_file(append_string_views(map_directory, provinces)),
-		lookup_file(append_string_views(map_directory, terrain)),
-		lookup_file(append_string_views(map_directory, rivers)), false
-	)) {
-		Logger::error("Failed to load map images!");
-		ret = false;
+	const std::chrono::steady_clock::time_point images_start = std::chrono::steady_clock::now();
+	if (cache_reader == nullptr || !map_definition.load_map_images_from_cache(*cache_reader)) {
+		if (map_definition.load_map_images(
+			lookup_file(append_string_views(map_directory, provinces)),
+			lookup_file(append_string_views(map_directory, terrain)),
+			lookup_file(append_string_views(map_directory, rivers)), false
+		)) {
+			/* Only written when the images had to be loaded from the files, as that is when the cache needs saving. */
+			if (cache_writer != nullptr) {
+				map_definition.write_map_images_cache(*cache_writer);
+			}
+		} else {
+			Logger::error("Failed to load map images!");
+			ret = false;
+		}
 	}
+	Logger::info("Loaded map images in ", _milliseconds_since(images_start), "ms");
 
 	if (map_definition.generate_and_load_province_adjacencies(
 		parse_csv(lookup_file(append_string_views(map_directory, adjacencies))).get_lines()
@@ -804,6 +902,11 @@ bool Dataloader::_load_map_dir(DefinitionManager& definition_manager) const {
 		ret = false;
 	}
 
+	if (!map_definition.build_distance_oracles()) {
+		Logger::error("Failed to build province distance oracles!");
+		ret = false;
+	}
+
 	if (!map_definition.load_climate_file(
 		definition_manager.get_modifier_manager(),
 		parse_defines(lookup_file(append_string_views(map_directory, climate_file))).get_file_node()
@@ -887,12 +990,30 @@ bool Dataloader::load_defines(
 	static constexpr std::string_view triggered_modifiers_file = "common/triggered_modifiers.txt";
 	static constexpr std::string_view on_actions_file = "common/on_actions.txt";
 
+	const std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
+
 	bool ret = true;
 
-	if (!definition_manager.get_mapmode_manager().setup_mapmodes()) {
-		Logger::error("Failed to set up mapmodes!");
-		ret = false;
+	/* Cached sections are read in the same order they are written. Sections are only written when they couldn't be
+	 * read from the cache, so the cache is saved if and only if the writer holds any data. The key's cost, logged below,
+	 * grows with the number of files under the roots (around 20ms for 12000 files) and should stay well under the time
+	 * the cache saves, which is logged as the map images' load time. */
+	DefinitionsCache::reader_t cache_reader;
+	DefinitionsCache::writer_t cache_writer;
+	DefinitionsCache::reader_t* cache_reader_ptr = nullptr;
+	DefinitionsCache::writer_t* cache_writer_ptr = nullptr;
+	if (!definitions_cache_path.empty()) {
+		const std::chrono::steady_clock::time_point key_start = std::chrono::steady_clock::now();
+		const DefinitionsCache::key_t cache_key = DefinitionsCache::compute_key(roots);
+		Logger::info("Computed definitions cache key in ", _milliseconds_since(key_start), "ms");
+
+		if (definitions_cache.open(definitions_cache_path, cache_key)) {
+			cache_reader = definitions_cache.get_reader();
+			cache_reader_ptr = &cache_reader;
+		}
+		cache_writer_ptr = &cache_writer;
 	}
+
 	if (!_load_sound_effect_defines(definition_manager)) {
 		Logger::error("Failed to load sound effect defines");
 		ret = false;
@@ -957,7 +1078,13 @@ bool Dataloader::load_defines(
 		Logger::error("Failed to load buildings!");
 		ret = false;
 	}
-	if (!_load_map_dir(definition_manager)) {
+	if (!definition_manager.get_mapmode_manager().setup_mapmodes(
+		definition_manager.get_economy_manager().get_building_type_manager()
+	)) {
+		Logger::error("Failed to set up mapmodes!");
+		ret = false;
+	}
+	if (!_load_map_dir(definition_manager, cache_reader_ptr, cache_writer_ptr)) {
 		Logger::error("Failed to load map!");
 		ret = false;
 	}
@@ -1118,7 +1245,20 @@ bool Dataloader::load_defines(
 		ret = false;
 	}
 
+	Logger::info("Loaded static defines in ", _milliseconds_since(load_start), "ms");
+
+	if (cache_writer_ptr != nullptr) {
+		/* Not saved if loading failed, as the cache would preserve the broken results. */
+		if (!cache_writer.get_data().empty() && ret) {
+			definitions_cache.save(cache_writer);
+		} else {
+			definitions_cache.close();
+		}
+	}
+
+	const std::chrono::steady_clock::time_point scripts_start = std::chrono::steady_clock::now();
 	ret &= parse_scripts(definition_manager);
+	Logger::info("Parsed condition and effect scripts in ", _milliseconds_since(scripts_start), "ms");
 
 	free_cache();
 
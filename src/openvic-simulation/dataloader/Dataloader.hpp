@@ -3,6 +3,7 @@
 #include <openvic-dataloader/csv/Parser.hpp>
 #include <openvic-dataloader/v2script/Parser.hpp>
 
+#include "openvic-simulation/dataloader/DefinitionsCache.hpp"
 #include "openvic-simulation/dataloader/NodeTools.hpp"
 
 namespace OpenVic {
@@ -24,6 +25,9 @@ namespace OpenVic {
 	private:
 		path_vector_t PROPERTY(roots);
 		std::vector<ovdl::v2script::Parser> cached_parsers;
+		/* Empty if the definitions cache is disabled. */
+		fs::path PROPERTY(definitions_cache_path);
+		DefinitionsCache definitions_cache;
 
 		bool _load_interface_files(UIManager& ui_manager) const;
 		bool _load_pop_types(DefinitionManager& definition_manager);
@@ -33,7 +37,10 @@ namespace OpenVic {
 		bool _load_technologies(DefinitionManager& definition_manager);
 		bool _load_inventions(DefinitionManager& definition_manager);
 		bool _load_events(DefinitionManager& definition_manager);
-		bool _load_map_dir(DefinitionManager& definition_manager) const;
+		bool _load_map_dir(
+			DefinitionManager& definition_manager, DefinitionsCache::reader_t* cache_reader,
+			DefinitionsCache::writer_t* cache_writer
+		) const;
 		bool _load_song_chances(DefinitionManager& definition_manager);
 		bool _load_sound_effect_defines(DefinitionManager& definition_manager) const;
 		bool _load_decisions(DefinitionManager& definition_manager);
@@ -57,6 +64,9 @@ namespace OpenVic {
 		 * is only guaranteed to be valid until the function is next called. */
 		ovdl::v2script::Parser& parse_defines_cached(fs::path const& path);
 
+		/* Parse every file with parse_defines on the ThreadPool, returning the Parsers in the same order as files. */
+		static std::vector<ovdl::v2script::Parser> parse_defines_parallel(path_vector_t const& files);
+
 	private:
 		/* Clear the cache vector, freeing all cached Parsers and their Node trees. Pointers to cached Parsers' Nodes should
 		 * be set to null before this is called to avoid segfaults. */
@@ -90,6 +100,11 @@ namespace OpenVic {
 		/* In reverse-load order, so base defines first and final loaded mod last */
 		bool set_roots(path_vector_t const& new_roots);
 
+		/* Enables the DefinitionsCache, stored at the given file path, for subsequent load_defines calls. This only lets
+		 * reading the map images be skipped, text files are parsed either way. An empty path disables it. The path
+		 * should not be under any of the roots. */
+		void set_definitions_cache_path(fs::path const& new_definitions_cache_path);
+
 		/* REQUIREMENTS:
 		 * DAT-24
 		 */
@@ -106,6 +121,18 @@ namespace OpenVic {
 		) const;
 		bool apply_to_files(path_vector_t const& files, NodeTools::callback_t<fs::path const&> callback) const;
 
+		/* Parse all of the files in parallel with parse_defines_parallel, then call callback on each file and its Parser
+		 * sequentially in the order of files, so anything the callback registers is registered in the same order as with
+		 * apply_to_files. The time taken by each phase is logged, with name describing the files. */
+		using parsed_file_callback_t = NodeTools::callback_t<fs::path const&, ovdl::v2script::Parser const&>;
+		bool parse_and_apply_to_files(
+			std::string_view name, path_vector_t const& files, parsed_file_callback_t callback
+		) const;
+		/* Same as parse_and_apply_to_files, but the Parsers are kept in the cache like with parse_defines_cached. */
+		bool parse_cached_and_apply_to_files(
+			std::string_view name, path_vector_t const& files, parsed_file_callback_t callback
+		);
+
 		string_set_t lookup_dirs_in_dir(std::string_view path) const;
 
 		/* Load and parse all of the text defines data, including parsing cached condition and effect scripts after all the
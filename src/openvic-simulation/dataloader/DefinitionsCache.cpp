@@ -0,0 +1,199 @@
+#include "DefinitionsCache.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <system_error>
+
+#include "openvic-simulation/utility/Logger.hpp"
+
+using namespace OpenVic;
+
+static constexpr uint32_t CACHE_MAGIC = 0x4344564f; // "OVDC"
+
+bool DefinitionsCache::reader_t::read_string(std::string& string) {
+	uint64_t size = 0;
+	if (!read(size) || !_can_read(size)) {
+		return false;
+	}
+	string.assign(reinterpret_cast<char const*>(data.data() + offset), size);
+	offset += size;
+	return true;
+}
+
+bool DefinitionsCache::reader_t::read_section(section_tag_t tag) {
+	section_tag_t found_tag = 0;
+	if (!read(found_tag)) {
+		return false;
+	}
+	if (found_tag != tag) {
+		Logger::error("Definitions cache section mismatch: found ", found_tag, ", expected ", tag);
+		failed = true;
+		return false;
+	}
+	return true;
+}
+
+namespace {
+	// 64-bit FNV-1a, stable across platforms and runs unlike std::hash.
+	struct key_hasher_t {
+		DefinitionsCache::key_t hash = 0xcbf29ce484222325;
+
+		void add_bytes(void const* bytes, size_t count) {
+			for (size_t index = 0; index < count; ++index) {
+				hash ^= static_cast<uint8_t const*>(bytes)[index];
+				hash *= 0x100000001b3;
+			}
+		}
+
+		template<typename T>
+		void add(T const& value) {
+			add_bytes(&value, sizeof(T));
+		}
+
+		void add_string(std::string_view string) {
+			add<uint64_t>(string.size());
+			add_bytes(string.data(), string.size());
+		}
+	};
+
+	struct file_entry_t {
+		std::string path;
+		uint64_t size;
+		int64_t modification_time;
+
+		bool operator<(file_entry_t const& other) const {
+			return path < other.path;
+		}
+	};
+}
+
+DefinitionsCache::key_t DefinitionsCache::compute_key(std::span<const fs::path> roots) {
+	key_hasher_t hasher;
+	hasher.add(FORMAT_VERSION);
+
+	std::vector<file_entry_t> entries;
+
+	for (fs::path const& root : roots) {
+		hasher.add_string(root.generic_string());
+
+		entries.clear();
+		std::error_code ec;
+		for (
+			fs::recursive_directory_iterator it { root, fs::directory_options::skip_permission_denied, ec }, end;
+			!ec && it != end; it.increment(ec)
+		) {
+			fs::directory_entry const& entry = *it;
+			if (!entry.is_regular_file(ec)) {
+				continue;
+			}
+			const uint64_t size = entry.file_size(ec);
+			const fs::file_time_type modification_time = entry.last_write_time(ec);
+			entries.push_back({
+				entry.path().lexically_relative(root).generic_string(), size,
+				static_cast<int64_t>(modification_time.time_since_epoch().count())
+			});
+		}
+		if (ec) {
+			Logger::warning("Error while listing files for definitions cache key in ", root, ": ", ec.message());
+		}
+
+		// Directory iteration order is unspecified.
+		std::sort(entries.begin(), entries.end());
+
+		hasher.add<uint64_t>(entries.size());
+		for (file_entry_t const& entry : entries) {
+			hasher.add_string(entry.path);
+			hasher.add(entry.size);
+			hasher.add(entry.modification_time);
+		}
+	}
+
+	return hasher.hash;
+}
+
+bool DefinitionsCache::open(fs::path const& new_cache_path, key_t new_key) {
+	close();
+	cache_path = new_cache_path;
+	key = new_key;
+
+	std::error_code ec;
+	if (!fs::is_regular_file(cache_path, ec)) {
+		Logger::info("No definitions cache found at ", cache_path);
+		return false;
+	}
+
+	if (!file.open(cache_path)) {
+		return false;
+	}
+
+	reader_t header_reader { file.get_data() };
+	uint32_t magic = 0;
+	key_t file_key = 0;
+	header_reader.read(magic);
+	header_reader.read(file_key);
+	if (header_reader.has_failed() || magic != CACHE_MAGIC) {
+		Logger::warning("Invalid definitions cache header in ", cache_path);
+		file.close();
+		return false;
+	}
+	if (file_key != key) {
+		Logger::info("Definitions cache ", cache_path, " is out of date");
+		file.close();
+		return false;
+	}
+
+	static constexpr size_t HEADER_SIZE = sizeof(magic) + sizeof(file_key);
+	contents = file.get_data().subspan(HEADER_SIZE);
+
+	Logger::info("Using definitions cache ", cache_path);
+	return true;
+}
+
+void DefinitionsCache::close() {
+	file.close();
+	contents = {};
+}
+
+bool DefinitionsCache::save(writer_t const& writer) {
+	if (cache_path.empty()) {
+		Logger::error("Cannot save definitions cache without a path!");
+		return false;
+	}
+
+	close();
+
+	writer_t header_writer;
+	header_writer.write(CACHE_MAGIC);
+	header_writer.write(key);
+
+	/* Written to a temporary file which then replaces the cache, so an interrupted save never leaves a truncated cache
+	 * with a valid header. */
+	fs::path temporary_path = cache_path;
+	temporary_path += ".tmp";
+
+	std::error_code ec;
+	if (cache_path.has_parent_path()) {
+		fs::create_directories(cache_path.parent_path(), ec);
+	}
+
+	{
+		std::ofstream stream { temporary_path, std::ios::binary | std::ios::trunc };
+		for (std::span<const uint8_t> data : { header_writer.get_data(), writer.get_data() }) {
+			stream.write(reinterpret_cast<char const*>(data.data()), data.size());
+		}
+		if (stream.fail()) {
+			Logger::error("Failed to write definitions cache to ", temporary_path);
+			return false;
+		}
+	}
+
+	fs::rename(temporary_path, cache_path, ec);
+	if (ec) {
+		Logger::error("Failed to replace definitions cache ", cache_path, ": ", ec.message());
+		fs::remove(temporary_path, ec);
+		return false;
+	}
+
+	Logger::info("Saved definitions cache to ", cache_path);
+	return true;
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "openvic-simulation/utility/MemoryMappedFile.hpp"
+
+namespace OpenVic {
+	namespace fs = std::filesystem;
+
+	/* Binary cache of definitions derived from the game and mod files, allowing expensive loading steps to be skipped
+	 * on later startups. Currently the only section is MapDefinition's map image output (see write_map_images_cache),
+	 * all text definitions are still parsed on every startup as the definitions they produce refer to each other by
+	 * pointer and so cannot be written out as they are. The cache is keyed by a hash of the roots and the relative path,
+	 * size and modification time of every file under them, so adding, removing or changing any file invalidates it.
+	 *
+	 * Sections are written sequentially by a writer_t and read back in the same order by a reader_t over a memory mapping
+	 * of the cache file. Each section starts with a tag, so a reader can detect sections which are missing or out of
+	 * order. Values are stored in the host's byte order, the key includes a format version which must be bumped whenever
+	 * the layout of any section changes. */
+	struct DefinitionsCache {
+		using key_t = uint64_t;
+		using section_tag_t = uint32_t;
+
+		static constexpr uint32_t FORMAT_VERSION = 1;
+
+		template<typename T>
+		static constexpr bool is_cacheable_v = std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>;
+
+		struct writer_t {
+		private:
+			std::vector<uint8_t> buffer;
+
+		public:
+			inline std::span<const uint8_t> get_data() const {
+				return buffer;
+			}
+
+			template<typename T>
+			requires is_cacheable_v<T>
+			void write(T const& value) {
+				const size_t offset = buffer.size();
+				buffer.resize(offset + sizeof(T));
+				std::memcpy(buffer.data() + offset, &value, sizeof(T));
+			}
+
+			// Writes the element count followed by the elements.
+			template<typename T>
+			requires is_cacheable_v<T>
+			void write_span(std::span<const T> values) {
+				write<uint64_t>(values.size());
+				const size_t offset = buffer.size();
+				buffer.resize(offset + values.size_bytes());
+				if (!values.empty()) {
+					std::memcpy(buffer.data() + offset, values.data(), values.size_bytes());
+				}
+			}
+
+			inline void write_string(std::string_view string) {
+				write_span(std::span<const char> { string.data(), string.size() });
+			}
+
+			inline void begin_section(section_tag_t tag) {
+				write(tag);
+			}
+		};
+
+		/* Every read returns false, leaving its output unchanged, once the data runs out or a section tag mismatches.
+		 * After a failure all further reads fail too, so a sequence of reads only needs its result checked at the end. */
+		struct reader_t {
+		private:
+			std::span<const uint8_t> data;
+			size_t offset = 0;
+			bool failed = false;
+
+			bool _can_read(size_t byte_count) {
+				if (failed || data.size() - offset < byte_count) {
+					failed = true;
+				}
+				return !failed;
+			}
+
+		public:
+			reader_t() = default;
+			reader_t(std::span<const uint8_t> new_data) : data { new_data } {}
+
+			inline bool has_failed() const {
+				return failed;
+			}
+
+			template<typename T>
+			requires is_cacheable_v<T>
+			bool read(T& value) {
+				if (!_can_read(sizeof(T))) {
+					return false;
+				}
+				std::memcpy(&value, data.data() + offset, sizeof(T));
+				offset += sizeof(T);
+				return true;
+			}
+
+			template<typename T>
+			requires is_cacheable_v<T>
+			bool read_vector(std::vector<T>& values) {
+				uint64_t count = 0;
+				if (!read(count) || count > (data.size() - offset) / sizeof(T)) {
+					failed = true;
+					return false;
+				}
+				values.resize(count);
+				if (count > 0) {
+					std::memcpy(values.data(), data.data() + offset, count * sizeof(T));
+				}
+				offset += count * sizeof(T);
+				return true;
+			}
+
+			bool read_string(std::string& string);
+
+			bool read_section(section_tag_t tag);
+		};
+
+	private:
+		fs::path cache_path;
+		key_t key = 0;
+		MemoryMappedFile file;
+		std::span<const uint8_t> contents;
+
+	public:
+		/* Hash of the format version, the roots and every file under them. The cache file itself should not be under any
+		 * of the roots, otherwise saving it changes the key. */
+		static key_t compute_key(std::span<const fs::path> roots);
+
+		/* Sets where the cache lives and which key it must match, then maps the file if it exists with a matching key.
+		 * Returns whether a valid cache was found. */
+		bool open(fs::path const& new_cache_path, key_t new_key);
+		void close();
+
+		inline bool is_valid() const {
+			return file.is_open();
+		}
+
+		// Reads the sections after the header. Only valid if is_valid() and until the cache is closed.
+		inline reader_t get_reader() const {
+			return { contents };
+		}
+
+		/* Writes the sections in writer to the cache file with the key given to open, replacing any existing cache.
+		 * The cache is closed first, so readers from get_reader must not be used afterwards. */
+		bool save(writer_t const& writer);
+	};
+}
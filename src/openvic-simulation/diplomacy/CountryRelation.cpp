@@ -1,54 +1,132 @@
 #include "CountryRelation.hpp"
 
-#include <cassert>
+#include <algorithm>
 
-#include "openvic-simulation/country/CountryDefinition.hpp"
 #include "openvic-simulation/country/CountryInstance.hpp"
 #include "openvic-simulation/utility/ErrorMacros.hpp"
 
 using namespace OpenVic;
 
-CountryRelationInstanceProxy::CountryRelationInstanceProxy(std::string_view id) : country_id { id } {}
+static constexpr country_relation_value_t clamp_relation(int32_t value) {
+	return static_cast<country_relation_value_t>(
+		std::clamp<int32_t>(value, CountryRelationManager::MIN_RELATION, CountryRelationManager::MAX_RELATION)
+	);
+}
 
-CountryRelationInstanceProxy::CountryRelationInstanceProxy(CountryInstance const* country)
-	: country_id { country->get_country_definition()->get_identifier() } {}
+bool CountryRelationManager::is_valid_pair(country_index_t country, country_index_t recipient) const {
+	return country != recipient && country < country_count && recipient < country_count;
+}
 
-CountryRelationInstanceProxy::operator std::string_view() const {
-	return country_id;
+void CountryRelationManager::setup(size_t new_country_count) {
+	country_count = new_country_count;
+	relations.assign(country_count > 1 ? country_count * (country_count - 1) / 2 : 0, 0);
 }
 
-CountryRelationManager::CountryRelationManager(/* TODO: Country Instance Manager Reference */) {}
+bool CountryRelationManager::reset_country(country_index_t country) {
+	OV_ERR_FAIL_COND_V(country >= country_count, false);
 
-bool CountryRelationManager::add_country(CountryRelationInstanceProxy country) {
-	// TODO: iterate through Country Instances adding country to every previously existing country_relations
+	// Relations with lower indexed countries are the country's own row, higher indexed ones are spread across later rows.
+	std::fill_n(relations.begin() + get_relation_offset(country, 0), country, 0);
+	for (country_index_t other = country + 1; other < country_count; ++other) {
+		relations[get_relation_offset(other, country)] = 0;
+	}
 	return true;
 }
 
-bool CountryRelationManager::remove_country(CountryRelationInstanceProxy country) {
-	// TODO: iterate through country_relations removing every pair that references the country's id
-	return true;
+bool CountryRelationManager::reset_country(CountryInstance const& country) {
+	return reset_country(country.get_index());
 }
 
 country_relation_value_t CountryRelationManager::get_country_relation(
-	CountryRelationInstanceProxy country, CountryRelationInstanceProxy recepient
+	country_index_t country, country_index_t recipient
 ) const {
-	auto it = country_relations.find({ country.country_id, recepient.country_id });
-	OV_ERR_FAIL_COND_V(it == country_relations.end(), 0);
-	return it->second;
+	OV_ERR_FAIL_COND_V(!is_valid_pair(country, recipient), 0);
+	return relations[get_relation_offset(country, recipient)];
 }
 
-country_relation_value_t*
-CountryRelationManager::get_country_relation_ptr(CountryRelationInstanceProxy country, CountryRelationInstanceProxy recepient) {
-	auto it = country_relations.find({ country.country_id, recepient.country_id });
-	OV_ERR_FAIL_COND_V(it == country_relations.end(), nullptr);
-	return &it.value();
+country_relation_value_t CountryRelationManager::get_country_relation(
+	CountryInstance const& country, CountryInstance const& recipient
+) const {
+	return get_country_relation(country.get_index(), recipient.get_index());
+}
+
+country_relation_value_t* CountryRelationManager::get_country_relation_ptr(
+	country_index_t country, country_index_t recipient
+) {
+	OV_ERR_FAIL_COND_V(!is_valid_pair(country, recipient), nullptr);
+	return &relations[get_relation_offset(country, recipient)];
+}
+
+country_relation_value_t* CountryRelationManager::get_country_relation_ptr(
+	CountryInstance const& country, CountryInstance const& recipient
+) {
+	return get_country_relation_ptr(country.get_index(), recipient.get_index());
+}
+
+bool CountryRelationManager::set_country_relation(
+	country_index_t country, country_index_t recipient, country_relation_value_t value
+) {
+	OV_ERR_FAIL_COND_V(!is_valid_pair(country, recipient), false);
+	relations[get_relation_offset(country, recipient)] = clamp_relation(value);
+	return true;
 }
 
 bool CountryRelationManager::set_country_relation(
-	CountryRelationInstanceProxy country, CountryRelationInstanceProxy recepient, country_relation_value_t value
+	CountryInstance const& country, CountryInstance const& recipient, country_relation_value_t value
+) {
+	return set_country_relation(country.get_index(), recipient.get_index(), value);
+}
+
+bool CountryRelationManager::change_country_relation(country_index_t country, country_index_t recipient, int32_t change) {
+	OV_ERR_FAIL_COND_V(!is_valid_pair(country, recipient), false);
+	country_relation_value_t& relation = relations[get_relation_offset(country, recipient)];
+	relation = clamp_relation(relation + change);
+	return true;
+}
+
+bool CountryRelationManager::change_country_relation(
+	CountryInstance const& country, CountryInstance const& recipient, int32_t change
 ) {
-	auto it = country_relations.find({ country.country_id, recepient.country_id });
-	OV_ERR_FAIL_COND_V(it == country_relations.end(), false);
-	it.value() = value;
+	return change_country_relation(country.get_index(), recipient.get_index(), change);
+}
+
+bool CountryRelationManager::drift_relations(country_relation_value_t target, country_relation_value_t step) {
+	// std::clamp requires -step <= step.
+	OV_ERR_FAIL_COND_V_MSG(step < 0, false, "Cannot drift relations by a negative step!");
+	target = clamp_relation(target);
+
+	// Branch-free so the loop vectorises, each value moves by the distance to target clamped to [-step, step].
+	for (country_relation_value_t& relation : relations) {
+		relation += static_cast<country_relation_value_t>(std::clamp<int32_t>(target - relation, -step, step));
+	}
 	return true;
 }
+
+bool CountryRelationManager::decay_relations(country_relation_value_t step) {
+	return drift_relations(0, step);
+}
+
+std::vector<CountryRelationManager::sparse_relation_t> CountryRelationManager::get_sparse_relations() const {
+	std::vector<sparse_relation_t> sparse_relations;
+
+	size_t offset = 0;
+	for (country_index_t country = 1; country < country_count; ++country) {
+		for (country_index_t recipient = 0; recipient < country; ++recipient, ++offset) {
+			if (relations[offset] != 0) {
+				sparse_relations.push_back({ country, recipient, relations[offset] });
+			}
+		}
+	}
+
+	return sparse_relations;
+}
+
+bool CountryRelationManager::set_sparse_relations(std::vector<sparse_relation_t> const& sparse_relations) {
+	std::fill(relations.begin(), relations.end(), 0);
+
+	bool ret = true;
+	for (sparse_relation_t const& sparse_relation : sparse_relations) {
+		ret &= set_country_relation(sparse_relation.country, sparse_relation.recipient, sparse_relation.value);
+	}
+	return ret;
+}
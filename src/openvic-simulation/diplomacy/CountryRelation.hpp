@@ -1,95 +1,77 @@
 #pragma once
 
-#include <compare>
-#include <tuple>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
-#include "openvic-simulation/types/OrderedContainers.hpp"
-#include "openvic-simulation/utility/Utility.hpp"
+#include "openvic-simulation/utility/Getters.hpp"
 
 namespace OpenVic {
 	struct CountryInstance;
 
-	struct CountryRelationInstanceProxy {
-		std::string_view country_id;
+	using country_relation_value_t = int16_t;
 
-		CountryRelationInstanceProxy(std::string_view id);
-		CountryRelationInstanceProxy(CountryInstance const* country);
+	/* Relations between every pair of countries, stored as a strictly lower triangular matrix of values indexed by
+	 * CountryInstance index. The relation between countries a and b with a > b lives at a * (a - 1) / 2 + b, so a lookup
+	 * is a couple of integer operations with no hashing, and relations are symmetric by construction. A country has no
+	 * relation with itself. Batched updates (decay, drift) are plain loops over the contiguous value array which the
+	 * compiler can vectorise. */
+	struct CountryRelationManager {
+		using country_index_t = size_t;
 
-		operator std::string_view() const;
-	};
+		static constexpr country_relation_value_t MIN_RELATION = -200;
+		static constexpr country_relation_value_t MAX_RELATION = 200;
 
-	struct CountryRelationPair : std::pair<std::string_view, std::string_view> {
-		using base_type = std::pair<std::string_view, std::string_view>;
-		using base_type::base_type;
+		// Compact form for saves, only non-zero relations are listed.
+		struct sparse_relation_t {
+			country_index_t country;
+			country_index_t recipient;
+			country_relation_value_t value;
+		};
 
-		inline constexpr auto operator<=>(CountryRelationPair const& rhs) const {
-			using ordering = decltype(OpenVic::utility::three_way(std::tie(first, second), std::tie(rhs.first, rhs.second)));
+	private:
+		size_t PROPERTY(country_count, 0);
+		std::vector<country_relation_value_t> relations;
 
-			auto tied = std::tie(first, second);
-			if (tied == std::tie(rhs.first, rhs.second)) {
-				return ordering::equivalent;
-			} else if (tied == std::tie(rhs.second, rhs.first)) {
-				return ordering::equivalent;
+		static constexpr size_t get_relation_offset(country_index_t country, country_index_t recipient) {
+			if (country < recipient) {
+				std::swap(country, recipient);
 			}
-
-			auto& [lhs_left, lhs_right] = *this;
-			auto& [rhs_left, rhs_right] = rhs;
-
-			auto& lhs_comp_first = lhs_left > lhs_right ? lhs_left : lhs_right;
-			auto& lhs_comp_second = lhs_left < lhs_right ? lhs_left : lhs_right;
-
-			auto& rhs_comp_first = rhs_left > rhs_right ? rhs_left : rhs_right;
-			auto& rhs_comp_second = rhs_left < rhs_right ? rhs_left : rhs_right;
-
-			return OpenVic::utility::three_way(
-				std::tie(lhs_comp_first, lhs_comp_second), std::tie(rhs_comp_first, rhs_comp_second)
-			);
-		}
-
-		inline constexpr bool operator==(CountryRelationPair const& rhs) const {
-			auto tied = std::tie(first, second);
-			return tied == std::tie(rhs.first, rhs.second) || tied == std::tie(rhs.second, rhs.first);
-		}
-	};
-}
-
-namespace std {
-	template<>
-	struct hash<OpenVic::CountryRelationPair> {
-		size_t operator()(OpenVic::CountryRelationPair const& pair) const {
-			std::size_t seed1(0);
-			OpenVic::utility::hash_combine(seed1, pair.first);
-			OpenVic::utility::hash_combine(seed1, pair.second);
-
-			std::size_t seed2(0);
-			OpenVic::utility::hash_combine(seed2, pair.second);
-			OpenVic::utility::hash_combine(seed2, pair.first);
-
-			return std::min(seed1, seed2);
+			return country * (country - 1) / 2 + recipient;
 		}
-	};
-}
 
-namespace OpenVic {
-	using country_relation_value_t = int16_t;
-
-	struct CountryRelationManager {
-	private:
-		// TODO: reference of manager responsible for storing CountryInstances
-		ordered_map<CountryRelationPair, country_relation_value_t> country_relations;
+		bool is_valid_pair(country_index_t country, country_index_t recipient) const;
 
 	public:
-		CountryRelationManager(/* TODO: Country Instance Manager Reference */);
+		CountryRelationManager() = default;
+
+		// Resizes the matrix for country_count countries and resets every relation to zero.
+		void setup(size_t new_country_count);
 
-		bool add_country(CountryRelationInstanceProxy country);
-		bool remove_country(CountryRelationInstanceProxy country);
+		// Resets all of the country's relations to zero, e.g. when it stops existing.
+		bool reset_country(country_index_t country);
+		bool reset_country(CountryInstance const& country);
 
-		country_relation_value_t
-		get_country_relation(CountryRelationInstanceProxy country, CountryRelationInstanceProxy recepient) const;
-		country_relation_value_t*
-		get_country_relation_ptr(CountryRelationInstanceProxy country, CountryRelationInstanceProxy recepient);
+		country_relation_value_t get_country_relation(country_index_t country, country_index_t recipient) const;
+		country_relation_value_t get_country_relation(CountryInstance const& country, CountryInstance const& recipient) const;
+		country_relation_value_t* get_country_relation_ptr(country_index_t country, country_index_t recipient);
+		country_relation_value_t* get_country_relation_ptr(CountryInstance const& country, CountryInstance const& recipient);
+		// Values are clamped to [MIN_RELATION, MAX_RELATION].
+		bool set_country_relation(country_index_t country, country_index_t recipient, country_relation_value_t value);
 		bool set_country_relation(
-			CountryRelationInstanceProxy country, CountryRelationInstanceProxy recepient, country_relation_value_t value
+			CountryInstance const& country, CountryInstance const& recipient, country_relation_value_t value
 		);
+		bool change_country_relation(country_index_t country, country_index_t recipient, int32_t change);
+		bool change_country_relation(CountryInstance const& country, CountryInstance const& recipient, int32_t change);
+
+		/* Moves every relation towards target, clamped to [MIN_RELATION, MAX_RELATION], by up to step without
+		 * overshooting it. Fails without changing anything if step is negative. */
+		bool drift_relations(country_relation_value_t target, country_relation_value_t step);
+		// Moves every relation towards zero by up to step.
+		bool decay_relations(country_relation_value_t step);
+
+		std::vector<sparse_relation_t> get_sparse_relations() const;
+		// Resets every relation to zero and then applies the listed relations.
+		bool set_sparse_relations(std::vector<sparse_relation_t> const& sparse_relations);
 	};
 }
@@ -92,13 +92,9 @@ bool DiplomaticActionManager::setup_diplomatic_actions() {
 		{
 			.commit =
 				[](Argument& arg) {
-					auto relation = arg.instance_manager.get_country_relation_manager().get_country_relation_ptr(
-						arg.sender, arg.reciever
+					arg.instance_manager.get_country_relation_manager().change_country_relation(
+						*arg.sender, *arg.reciever, 25
 					);
-					if (!relation) {
-						return;
-					}
-					*relation += 25;
 				},
 			.allowed =
 				[](Argument const& arg) {
@@ -111,13 +107,9 @@ bool DiplomaticActionManager::setup_diplomatic_actions() {
 		{
 			.commit =
 				[](Argument& arg) {
-					auto relation = arg.instance_manager.get_country_relation_manager().get_country_relation_ptr(
-						arg.sender, arg.reciever
+					arg.instance_manager.get_country_relation_manager().change_country_relation(
+						*arg.sender, *arg.reciever, -25
 					);
-					if (!relation) {
-						return;
-					}
-					*relation -= 25;
 				},
 			.allowed =
 				[](Argument const& arg) {
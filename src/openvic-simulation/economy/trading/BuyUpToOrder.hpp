@@ -1,22 +1,26 @@
 #pragma once
 
 #include "openvic-simulation/economy/trading/BuyResult.hpp"
+#include "openvic-simulation/types/InplaceFunction.hpp"
 #include "openvic-simulation/utility/Getters.hpp"
 
 namespace OpenVic {
 	struct GoodDefinition;
 
 	struct GoodBuyUpToOrder {
+		// Stored inline so placing an order never heap allocates.
+		using after_trade_func_t = InplaceFunction<void(const BuyResult)>;
+
 	private:
 		const fixed_point_t PROPERTY(max_quantity);
 		const fixed_point_t PROPERTY(money_to_spend);
-		std::function<void(const BuyResult)> PROPERTY(after_trade);
+		after_trade_func_t PROPERTY(after_trade);
 
 	public:
 		GoodBuyUpToOrder(
 			const fixed_point_t new_max_quantity,
 			const fixed_point_t new_money_to_spend,
-			std::function<void(const BuyResult)>&& new_after_trade
+			after_trade_func_t&& new_after_trade
 		);
 		GoodBuyUpToOrder(GoodBuyUpToOrder&&) = default;
 
@@ -35,7 +39,7 @@ namespace OpenVic {
 			GoodDefinition const& new_good,
 			const fixed_point_t new_max_quantity,
 			const fixed_point_t new_money_to_spend,
-			std::function<void(const BuyResult)>&& new_after_trade
+			after_trade_func_t&& new_after_trade
 		);
 		BuyUpToOrder(BuyUpToOrder&&) = default;
 	};
@@ -1,5 +1,7 @@
 #include "GoodMarket.hpp"
 
+#include <algorithm>
+
 #include "openvic-simulation/economy/GoodDefinition.hpp"
 #include "openvic-simulation/misc/GameRulesManager.hpp"
 #include "openvic-simulation/utility/CompilerFeatureTesting.hpp"
@@ -8,9 +10,7 @@ using namespace OpenVic;
 static constexpr size_t MONTHS_OF_PRICE_HISTORY = 36;
 
 GoodMarket::GoodMarket(GameRulesManager const& new_game_rules_manager, GoodDefinition const& new_good_definition)
-  : buy_lock { std::make_unique<std::mutex>() },
-	sell_lock { std::make_unique<std::mutex>() },
-	game_rules_manager { new_game_rules_manager },
+  : game_rules_manager { new_game_rules_manager },
 	good_definition { new_good_definition },
 	price { new_good_definition.get_base_price() },
 	is_available { new_good_definition.get_is_available_from_start() },
@@ -53,14 +53,50 @@ void GoodMarket::update_next_price_limits() {
 	price_inverse = fixed_point_t::_1() / price;
 }
 
-void GoodMarket::add_buy_up_to_order(GoodBuyUpToOrder&& buy_up_to_order) {
-	const std::lock_guard<std::mutex> lock_guard { *buy_lock };
-	buy_up_to_orders.push_back(std::move(buy_up_to_order));
+void GoodMarket::add_buy_up_to_orders(std::vector<GoodBuyUpToOrder>& new_buy_up_to_orders) {
+	for (GoodBuyUpToOrder& buy_up_to_order : new_buy_up_to_orders) {
+		buy_up_to_orders.push_back(std::move(buy_up_to_order));
+	}
+	new_buy_up_to_orders.clear();
 }
 
-void GoodMarket::add_market_sell_order(GoodMarketSellOrder&& market_sell_order) {
-	const std::lock_guard<std::mutex> lock_guard { *sell_lock };
-	market_sell_orders.push_back(std::move(market_sell_order));
+void GoodMarket::add_market_sell_orders(std::vector<GoodMarketSellOrder>& new_market_sell_orders) {
+	for (GoodMarketSellOrder& market_sell_order : new_market_sell_orders) {
+		market_sell_orders.push_back(std::move(market_sell_order));
+	}
+	new_market_sell_orders.clear();
+}
+
+fixed_point_t GoodMarket::get_saturation_price(const fixed_point_t money_to_spend, const fixed_point_t max_quantity) {
+	//(((money_to_spend + 1) << PRECISION) - 1) overflows int64 for large budgets,
+	//so divide first and then long divide the remainder one bit at a time.
+	if (money_to_spend < fixed_point_t::_0()) {
+		return -fixed_point_t::max();
+	}
+
+	const uint64_t numerator = static_cast<uint64_t>(money_to_spend.get_raw_value()) + 1;
+	const uint64_t divisor = static_cast<uint64_t>(max_quantity.get_raw_value());
+	uint64_t quotient = numerator / divisor;
+	uint64_t remainder = numerator % divisor;
+	if (quotient > static_cast<uint64_t>(fixed_point_t::max().get_raw_value() >> fixed_point_t::PRECISION)) {
+		return fixed_point_t::max();
+	}
+
+	//remainder < divisor < 2^63, so doubling it can't overflow
+	for (int32_t bit = 0; bit < fixed_point_t::PRECISION; ++bit) {
+		quotient <<= 1;
+		remainder <<= 1;
+		if (remainder >= divisor) {
+			remainder -= divisor;
+			quotient |= 1;
+		}
+	}
+
+	//subtracting 1 from the shifted numerator only lowers the quotient when it divided exactly
+	if (remainder == 0) {
+		--quotient;
+	}
+	return fixed_point_t::parse_raw(static_cast<int64_t>(quotient));
 }
 
 void GoodMarket::execute_orders() {
@@ -161,30 +197,105 @@ void GoodMarket::execute_orders() {
 				new_price = max_next_price;
 			}
 
-			bool someone_bought_max_quantity;
-			do {
-				someone_bought_max_quantity = false;
-				for (size_t i = 0; i < buy_up_to_orders.size(); i++) {
-					GoodBuyUpToOrder const& buy_up_to_order = buy_up_to_orders[i];
-					if (quantity_bought_per_order[i] == buy_up_to_order.get_max_quantity()) {
-						continue;
+			//Water-filling: an unsaturated order is saturated once remaining_supply / purchasing_power_sum reaches its
+			//max_quantity / purchasing_power. Saturating an order never lowers that ratio for the others.
+			//Usually a single pass over the orders saturates none of them, which ends the distribution.
+			//Otherwise sorting the rest by that ratio once and saturating from the smallest threshold
+			//replaces repeated passes over all orders.
+			unsaturated_orders.clear();
+			bool someone_bought_max_quantity = false;
+			for (size_t i = 0; i < buy_up_to_orders.size(); i++) {
+				const fixed_point_t max_quantity = buy_up_to_orders[i].get_max_quantity();
+				if (quantity_bought_per_order[i] == max_quantity) {
+					continue;
+				}
+
+				const fixed_point_t share = fixed_point_t::mul_div(
+					remaining_supply, purchasing_power_per_order[i], purchasing_power_sum
+				);
+				if (share >= max_quantity) {
+					someone_bought_max_quantity = true;
+					quantity_bought_per_order[i] = max_quantity;
+					remaining_supply -= max_quantity;
+					purchasing_power_sum -= purchasing_power_per_order[i];
+				} else {
+					//threshold is only needed if the orders have to be sorted
+					unsaturated_orders.push_back({ fixed_point_t::_0(), i });
+				}
+			}
+
+			if (someone_bought_max_quantity) {
+				for (unsaturated_order_t& unsaturated_order : unsaturated_orders) {
+					const fixed_point_t purchasing_power = purchasing_power_per_order[unsaturated_order.order_index];
+					unsaturated_order.saturation_threshold = purchasing_power > fixed_point_t::_0()
+						? buy_up_to_orders[unsaturated_order.order_index].get_max_quantity() / purchasing_power
+						: fixed_point_t::max();
+				}
+
+				std::sort(
+					unsaturated_orders.begin(), unsaturated_orders.end(),
+					[](unsaturated_order_t const& lhs, unsaturated_order_t const& rhs) -> bool {
+						return lhs.saturation_threshold < rhs.saturation_threshold;
 					}
+				);
+
+				size_t saturated_count = 0;
+				for (; saturated_count < unsaturated_orders.size(); saturated_count++) {
+					const size_t i = unsaturated_orders[saturated_count].order_index;
+					const fixed_point_t max_quantity = buy_up_to_orders[i].get_max_quantity();
+					const fixed_point_t share = fixed_point_t::mul_div(
+						remaining_supply, purchasing_power_per_order[i], purchasing_power_sum
+					);
+					if (share < max_quantity) {
+						break;
+					}
+
+					quantity_bought_per_order[i] = max_quantity;
+					remaining_supply -= max_quantity;
+					purchasing_power_sum -= purchasing_power_per_order[i];
+				}
 
-					const fixed_point_t distributed_supply
-						= quantity_bought_per_order[i]
-						= fixed_point_t::mul_div(
-							remaining_supply,
-							purchasing_power_per_order[i],
-							purchasing_power_sum
+				//Thresholds are rounded, so an order past the break can still round up to its max_quantity.
+				//Saturate those too, stopping on the same condition as the repeated passes: no unsaturated order is left
+				//that would get its max_quantity. This is a single extra pass unless rounding actually mattered.
+				//A saturation here can tip an order already passed over, needing another pass, so many orders tied
+				//to within rounding could take a pass each. The passes are capped to keep this linear; any order
+				//still over its max_quantity after them is limited to it below, leaving a rounding-sized amount unsold.
+				size_t rounding_pass_count = 0;
+				do {
+					someone_bought_max_quantity = false;
+					for (size_t j = saturated_count; j < unsaturated_orders.size(); j++) {
+						const size_t i = unsaturated_orders[j].order_index;
+						const fixed_point_t max_quantity = buy_up_to_orders[i].get_max_quantity();
+						const fixed_point_t share = fixed_point_t::mul_div(
+							remaining_supply, purchasing_power_per_order[i], purchasing_power_sum
 						);
-					if (distributed_supply >= buy_up_to_order.get_max_quantity()) {
+						if (share < max_quantity) {
+							continue;
+						}
+
 						someone_bought_max_quantity = true;
-						quantity_bought_per_order[i] = buy_up_to_order.get_max_quantity();
-						remaining_supply -= buy_up_to_order.get_max_quantity();
+						quantity_bought_per_order[i] = max_quantity;
+						remaining_supply -= max_quantity;
 						purchasing_power_sum -= purchasing_power_per_order[i];
+						std::swap(unsaturated_orders[j], unsaturated_orders[saturated_count++]);
 					}
-				}
-			} while (someone_bought_max_quantity);
+				} while (someone_bought_max_quantity && ++rounding_pass_count < max_rounding_passes);
+
+				unsaturated_orders.erase(unsaturated_orders.begin(), unsaturated_orders.begin() + saturated_count);
+			}
+
+			for (unsaturated_order_t const& unsaturated_order : unsaturated_orders) {
+				const size_t i = unsaturated_order.order_index;
+				quantity_bought_per_order[i] = std::min(
+					fixed_point_t::mul_div(
+						remaining_supply,
+						purchasing_power_per_order[i],
+						purchasing_power_sum
+					),
+					buy_up_to_orders[i].get_max_quantity()
+				);
+			}
 
 			quantity_traded_yesterday = fixed_point_t::_0();
 			for (size_t i = 0; i < buy_up_to_orders.size(); i++) {
@@ -199,7 +310,15 @@ void GoodMarket::execute_orders() {
 		} else {
 			//sell below max_next_price
 			if (game_rules_manager.get_use_optimal_pricing()) {
-				//drop price while remaining_supply > 0 && new_price > min_next_price
+				//An order saturates once money_to_spend >= new_price * max_quantity, i.e. once new_price drops to its
+				//saturation price. As new_price only decreases, sorting orders by saturation price (highest first)
+				//lets every price drop saturate the next orders in line instead of scanning all orders again.
+				//The price usually settles without dropping at all, so orders are only sorted once it first drops.
+				bool orders_sorted = false;
+				size_t saturated_count = 0;
+
+				//drop price from max_next_price while remaining_supply > 0 && new_price > min_next_price
+				new_price = max_next_price;
 				while (remaining_supply > fixed_point_t::_0()) {
 					const fixed_point_t possible_price = money_left_to_spend_sum / remaining_supply;
 
@@ -215,17 +334,39 @@ void GoodMarket::execute_orders() {
 
 					new_price = possible_price;
 
-					for (size_t i = 0; i < buy_up_to_orders.size(); i++) {
-						GoodBuyUpToOrder const& buy_up_to_order = buy_up_to_orders[i];
-						if (quantity_bought_per_order[i] == buy_up_to_order.get_max_quantity()) {
-							continue;
+					if (!orders_sorted) {
+						orders_sorted = true;
+						unsaturated_orders.clear();
+						for (size_t i = 0; i < buy_up_to_orders.size(); i++) {
+							GoodBuyUpToOrder const& buy_up_to_order = buy_up_to_orders[i];
+							if (quantity_bought_per_order[i] == buy_up_to_order.get_max_quantity()) {
+								continue;
+							}
+
+							unsaturated_orders.push_back({
+								get_saturation_price(buy_up_to_order.get_money_to_spend(), buy_up_to_order.get_max_quantity()),
+								i
+							});
 						}
 
-						if (buy_up_to_order.get_money_to_spend() >= new_price * buy_up_to_order.get_max_quantity()) {
-							quantity_bought_per_order[i] = buy_up_to_order.get_max_quantity();
-							remaining_supply -= buy_up_to_order.get_max_quantity();
-							money_left_to_spend_sum -= buy_up_to_order.get_money_to_spend();
+						std::sort(
+							unsaturated_orders.begin(), unsaturated_orders.end(),
+							[](unsaturated_order_t const& lhs, unsaturated_order_t const& rhs) -> bool {
+								return lhs.saturation_threshold > rhs.saturation_threshold;
+							}
+						);
+					}
+
+					for (; saturated_count < unsaturated_orders.size(); saturated_count++) {
+						unsaturated_order_t const& unsaturated_order = unsaturated_orders[saturated_count];
+						if (new_price > unsaturated_order.saturation_threshold) {
+							break;
 						}
+
+						GoodBuyUpToOrder const& buy_up_to_order = buy_up_to_orders[unsaturated_order.order_index];
+						quantity_bought_per_order[unsaturated_order.order_index] = buy_up_to_order.get_max_quantity();
+						remaining_supply -= buy_up_to_order.get_max_quantity();
+						money_left_to_spend_sum -= buy_up_to_order.get_money_to_spend();
 					}
 				}
 			} else {
@@ -271,6 +412,7 @@ void GoodMarket::execute_orders() {
 		market_sell_orders.clear();
 		quantity_bought_per_order.clear();
 		purchasing_power_per_order.clear();
+		unsaturated_orders.clear();
 	}
 
 	price_change_yesterday = new_price - price;
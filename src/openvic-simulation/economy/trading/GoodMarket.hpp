@@ -1,7 +1,6 @@
 #pragma once
 
-#include <memory>
-#include <mutex>
+#include <vector>
 
 #include "openvic-simulation/economy/trading/BuyUpToOrder.hpp"
 #include "openvic-simulation/economy/trading/MarketSellOrder.hpp"
@@ -16,8 +15,8 @@ namespace OpenVic {
 		GoodDefinition const& PROPERTY(good_definition);
 
 		static constexpr int32_t exponential_price_change_shift = 7;
-		std::unique_ptr<std::mutex> buy_lock;
-		std::unique_ptr<std::mutex> sell_lock;
+		//passes over the orders past the sorted saturation loop's break, which only saturate orders due to rounding
+		static constexpr size_t max_rounding_passes = 4;
 		GameRulesManager const& game_rules_manager;
 		fixed_point_t absolute_maximum_price;
 		fixed_point_t absolute_minimum_price;
@@ -27,7 +26,14 @@ namespace OpenVic {
 		std::vector<fixed_point_t> quantity_bought_per_order;
 		std::vector<fixed_point_t> purchasing_power_per_order;
 
-		//only used during day tick (from actors placing order until execute_orders())
+		struct unsaturated_order_t {
+			//price or supply share at which the order gets its max_quantity, orders are sorted by this
+			fixed_point_t saturation_threshold;
+			size_t order_index;
+		};
+		std::vector<unsaturated_order_t> unsaturated_orders;
+
+		//only used during day tick (from merging OrderBookShards until execute_orders())
 		std::vector<GoodBuyUpToOrder> buy_up_to_orders;
 		std::vector<GoodMarketSellOrder> market_sell_orders;
 
@@ -50,12 +56,14 @@ namespace OpenVic {
 		GoodMarket(GameRulesManager const& new_game_rules_manager, GoodDefinition const& new_good_definition);
 		GoodMarket(GoodMarket&&) = default;
 
-		//thread safe
-		void add_buy_up_to_order(GoodBuyUpToOrder&& buy_up_to_order);
-		void add_market_sell_order(GoodMarketSellOrder&& market_sell_order);
-
 		//not thread safe
+		//moves all orders out of the given vector, keeping its capacity for reuse
+		void add_buy_up_to_orders(std::vector<GoodBuyUpToOrder>& new_buy_up_to_orders);
+		void add_market_sell_orders(std::vector<GoodMarketSellOrder>& new_market_sell_orders);
 		void execute_orders();
+		//highest price for which (price * max_quantity) rounds down to at most money_to_spend,
+		//computed on raw values so it matches that comparison exactly
+		static fixed_point_t get_saturation_price(const fixed_point_t money_to_spend, const fixed_point_t max_quantity);
 		void on_use_exponential_price_changes_changed();
 		void record_price_history();
 	};
@@ -13,6 +13,29 @@ MarketInstance::MarketInstance(CountryDefines const& new_country_defines, GoodIn
 :	country_defines { new_country_defines },
 	good_instance_manager { new_good_instance_manager} {}
 
+bool MarketInstance::setup_order_book_shards(size_t shard_count) {
+	if (!order_book_shards.empty()) {
+		Logger::error("Cannot set up order book shards - already set up!");
+		return false;
+	}
+
+	if (!good_instance_manager.good_instances_are_locked()) {
+		Logger::error("Cannot set up order book shards - good instances are not locked!");
+		return false;
+	}
+
+	order_book_shards.reserve(shard_count);
+	for (size_t index = 0; index < shard_count; ++index) {
+		order_book_shards.emplace_back(good_instance_manager.get_good_instances());
+	}
+
+	return true;
+}
+
+OrderBookShard& MarketInstance::get_order_book_shard(size_t shard_index) {
+	return order_book_shards[shard_index];
+}
+
 bool MarketInstance::get_is_available(GoodDefinition const& good_definition) const {
 	return good_instance_manager.get_good_instance_from_definition(good_definition).get_is_available();
 }
@@ -25,7 +48,7 @@ fixed_point_t MarketInstance::get_price_inverse(GoodDefinition const& good_defin
 	return good_instance_manager.get_good_instance_from_definition(good_definition).get_price_inverse();
 }
 
-void MarketInstance::place_buy_up_to_order(BuyUpToOrder&& buy_up_to_order) {
+void MarketInstance::place_buy_up_to_order(OrderBookShard& order_book_shard, BuyUpToOrder&& buy_up_to_order) {
 	GoodDefinition const& good = buy_up_to_order.get_good();
 	if (OV_unlikely(buy_up_to_order.get_max_quantity() <= 0)) {
 		Logger::error("Received BuyUpToOrder for ",good," with max quantity ",buy_up_to_order.get_max_quantity());
@@ -33,11 +56,10 @@ void MarketInstance::place_buy_up_to_order(BuyUpToOrder&& buy_up_to_order) {
 		return;
 	}
 
-	GoodMarket& good_instance = good_instance_manager.get_good_instance_from_definition(good);
-	good_instance.add_buy_up_to_order(std::move(buy_up_to_order));
+	order_book_shard.add_buy_up_to_order(std::move(buy_up_to_order));
 }
 
-void MarketInstance::place_market_sell_order(MarketSellOrder&& market_sell_order) {
+void MarketInstance::place_market_sell_order(OrderBookShard& order_book_shard, MarketSellOrder&& market_sell_order) {
 	GoodDefinition const& good = market_sell_order.get_good();
 	if (OV_unlikely(market_sell_order.get_quantity() <= 0)) {
 		Logger::error("Received MarketSellOrder for ",good," with quantity ",market_sell_order.get_quantity());
@@ -53,15 +75,18 @@ void MarketInstance::place_market_sell_order(MarketSellOrder&& market_sell_order
 		return;
 	}
 
-	GoodMarket& good_instance = good_instance_manager.get_good_instance_from_definition(good);
-	good_instance.add_market_sell_order(std::move(market_sell_order));
+	order_book_shard.add_market_sell_order(std::move(market_sell_order));
 }
 
 void MarketInstance::execute_orders() {
 	auto& good_instances = good_instance_manager.get_good_instances();
 	parallel_for_each(
 		good_instances,
-		[](GoodMarket& good_instance) -> void {
+		[this](GoodMarket& good_instance) -> void {
+			// Shards are always merged in the same order, so clearing is deterministic however the tick was scheduled.
+			for (OrderBookShard& order_book_shard : order_book_shards) {
+				order_book_shard.move_orders_to(good_instance);
+			}
 			good_instance.execute_orders();
 		}
 	);
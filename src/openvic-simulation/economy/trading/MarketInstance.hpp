@@ -1,5 +1,8 @@
 #pragma once
 
+#include <vector>
+
+#include "openvic-simulation/economy/trading/OrderBookShard.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
 
 namespace OpenVic {
@@ -13,13 +16,18 @@ namespace OpenVic {
 	private:
 		CountryDefines const& country_defines;
 		GoodInstanceManager& good_instance_manager;
+		std::vector<OrderBookShard> order_book_shards;
 	public:
 		MarketInstance(CountryDefines const& new_country_defines, GoodInstanceManager& new_good_instance_manager);
+		// Must be called once, after goods are set up and before any shard references are taken.
+		bool setup_order_book_shards(size_t shard_count);
+		OrderBookShard& get_order_book_shard(size_t shard_index);
 		bool get_is_available(GoodDefinition const& good_definition) const;
 		fixed_point_t get_max_next_price(GoodDefinition const& good_definition) const;
 		fixed_point_t get_price_inverse(GoodDefinition const& good_definition) const;
-		void place_buy_up_to_order(BuyUpToOrder&& buy_up_to_order);
-		void place_market_sell_order(MarketSellOrder&& market_sell_order);
+		//thread safe as long as each shard is only used by one thread at a time
+		void place_buy_up_to_order(OrderBookShard& order_book_shard, BuyUpToOrder&& buy_up_to_order);
+		void place_market_sell_order(OrderBookShard& order_book_shard, MarketSellOrder&& market_sell_order);
 		void execute_orders();
 		void record_price_history();
 	};
@@ -4,7 +4,7 @@ using namespace OpenVic;
 
 GoodMarketSellOrder::GoodMarketSellOrder(
 	const fixed_point_t new_quantity,
-	std::function<void(const SellResult)>&& new_after_trade
+	after_trade_func_t&& new_after_trade
 ):
 	quantity { new_quantity },
 	after_trade { std::move(new_after_trade) }
@@ -13,7 +13,7 @@ GoodMarketSellOrder::GoodMarketSellOrder(
 MarketSellOrder::MarketSellOrder(
 	GoodDefinition const& new_good,
 	const fixed_point_t new_quantity,
-	std::function<void(const SellResult)>&& new_after_trade
+	after_trade_func_t&& new_after_trade
 ): GoodMarketSellOrder(new_quantity, std::move(new_after_trade)),
 	good { new_good }
 	{}
\ No newline at end of file
@@ -1,20 +1,24 @@
 #pragma once
 
 #include "openvic-simulation/economy/trading/SellResult.hpp"
+#include "openvic-simulation/types/InplaceFunction.hpp"
 #include "openvic-simulation/utility/Getters.hpp"
 
 namespace OpenVic {
 	struct GoodDefinition;
 
 	struct GoodMarketSellOrder {
+		// Stored inline so placing an order never heap allocates.
+		using after_trade_func_t = InplaceFunction<void(const SellResult)>;
+
 	private:
 		const fixed_point_t PROPERTY(quantity);
-		std::function<void(const SellResult)> PROPERTY(after_trade);
+		after_trade_func_t PROPERTY(after_trade);
 
 	public:
 		GoodMarketSellOrder(
 			const fixed_point_t new_quantity,
-			std::function<void(const SellResult)>&& new_after_trade
+			after_trade_func_t&& new_after_trade
 		);
 		GoodMarketSellOrder(GoodMarketSellOrder&&) = default;
 	};
@@ -27,7 +31,7 @@ namespace OpenVic {
 		MarketSellOrder(
 			GoodDefinition const& new_good,
 			const fixed_point_t new_quantity,
-			std::function<void(const SellResult)>&& new_after_trade
+			after_trade_func_t&& new_after_trade
 		);
 		MarketSellOrder(MarketSellOrder&&) = default;
 	};
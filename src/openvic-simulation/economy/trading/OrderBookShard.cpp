@@ -0,0 +1,24 @@
+#include "OrderBookShard.hpp"
+
+#include "openvic-simulation/economy/GoodDefinition.hpp"
+
+using namespace OpenVic;
+
+OrderBookShard::OrderBookShard(decltype(buy_up_to_orders)::keys_type const& good_keys)
+  : buy_up_to_orders { &good_keys },
+	market_sell_orders { &good_keys }
+	{}
+
+void OrderBookShard::add_buy_up_to_order(BuyUpToOrder&& buy_up_to_order) {
+	buy_up_to_orders.get_values()[buy_up_to_order.get_good().get_index()].push_back(std::move(buy_up_to_order));
+}
+
+void OrderBookShard::add_market_sell_order(MarketSellOrder&& market_sell_order) {
+	market_sell_orders.get_values()[market_sell_order.get_good().get_index()].push_back(std::move(market_sell_order));
+}
+
+void OrderBookShard::move_orders_to(GoodMarket& good_market) {
+	const size_t good_index = good_market.get_good_definition().get_index();
+	good_market.add_buy_up_to_orders(buy_up_to_orders.get_values()[good_index]);
+	good_market.add_market_sell_orders(market_sell_orders.get_values()[good_index]);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+#include "openvic-simulation/economy/GoodInstance.hpp"
+#include "openvic-simulation/economy/trading/BuyUpToOrder.hpp"
+#include "openvic-simulation/economy/trading/MarketSellOrder.hpp"
+#include "openvic-simulation/types/IndexedMap.hpp"
+
+namespace OpenVic {
+	/* Orders placed by a single actor group (e.g. everything ticked by one province), bucketed by good.
+	 * A shard must only be written to by one thread at a time, which lets orders be placed without any locking.
+	 * Shards are merged into their GoodMarkets in a fixed order before execution, so each market always sees
+	 * its orders in the same order regardless of how the tick was scheduled across threads. */
+	struct OrderBookShard {
+	private:
+		IndexedMap<GoodInstance, std::vector<GoodBuyUpToOrder>> buy_up_to_orders;
+		IndexedMap<GoodInstance, std::vector<GoodMarketSellOrder>> market_sell_orders;
+
+	public:
+		OrderBookShard(decltype(buy_up_to_orders)::keys_type const& good_keys);
+		OrderBookShard(OrderBookShard&&) = default;
+
+		//not thread safe
+		void add_buy_up_to_order(BuyUpToOrder&& buy_up_to_order);
+		void add_market_sell_order(MarketSellOrder&& market_sell_order);
+
+		// Moves this shard's orders for the market's good into the market, leaving their storage for reuse.
+		void move_orders_to(GoodMarket& good_market);
+	};
+}
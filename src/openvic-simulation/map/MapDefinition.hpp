@@ -7,9 +7,11 @@
 
 #include <openvic-dataloader/csv/LineObject.hpp>
 
+#include "openvic-simulation/dataloader/DefinitionsCache.hpp"
 #include "openvic-simulation/map/ProvinceDefinition.hpp"
 #include "openvic-simulation/map/Region.hpp"
 #include "openvic-simulation/map/TerrainType.hpp"
+#include "openvic-simulation/pathfinding/LandmarkDistanceOracle.hpp"
 #include "openvic-simulation/types/Colour.hpp"
 #include "openvic-simulation/types/IdentifierRegistry.hpp"
 #include "openvic-simulation/types/OrderedContainers.hpp"
@@ -65,6 +67,12 @@ namespace OpenVic {
 
 		ProvinceDefinition::index_t PROPERTY(max_provinces);
 
+		/* Movement graphs for armies (land and strait adjacencies between land provinces) and navies (water and canal
+		 * adjacencies between water provinces, tagged with their canal index). Impassable and coastal adjacencies are
+		 * excluded from both. Oracle nodes are province indices minus one, see get_distance_oracle_node. */
+		LandmarkDistanceOracle PROPERTY(land_distance_oracle);
+		LandmarkDistanceOracle PROPERTY(naval_distance_oracle);
+
 		ProvinceDefinition::index_t get_index_from_colour(colour_t colour) const;
 		bool _generate_standard_province_adjacencies();
 
@@ -124,8 +132,19 @@ namespace OpenVic {
 		static bool load_region_colours(ast::NodeCPtr root, std::vector<colour_t>& colours);
 		bool load_region_file(ast::NodeCPtr root, std::vector<colour_t> const& colours);
 		bool load_map_images(fs::path const& province_path, fs::path const& terrain_path, fs::path const& rivers_path, bool detailed_errors);
+		/* Everything load_map_images generates (shape image, province terrain types and centres, and rivers), so that
+		 * reading the map images can be skipped when the DefinitionsCache is valid. */
+		void write_map_images_cache(DefinitionsCache::writer_t& writer) const;
+		bool load_map_images_from_cache(DefinitionsCache::reader_t& reader);
 		bool generate_and_load_province_adjacencies(std::vector<ovdl::csv::LineObject> const& additional_adjacencies);
 		bool load_climate_file(ModifierManager const& modifier_manager, ast::NodeCPtr root);
 		bool load_continent_file(ModifierManager const& modifier_manager, ast::NodeCPtr root);
+		/* Must be called after adjacencies and positions are loaded, as edge distances use unit positions */
+		bool build_distance_oracles();
+
+		static constexpr LandmarkDistanceOracle::node_t get_distance_oracle_node(ProvinceDefinition const& province) {
+			return province.get_index() - 1;
+		}
+		ProvinceDefinition const* get_province_definition_from_distance_oracle_node(LandmarkDistanceOracle::node_t node) const;
 	};
 }
@@ -24,7 +24,9 @@ bool MapInstance::setup(
 	PopsDefines const& pop_defines,
 	decltype(ProvinceInstance::population_by_strata)::keys_type const& strata_keys,
 	decltype(ProvinceInstance::pop_type_distribution)::keys_type const& pop_type_keys,
-	decltype(ProvinceInstance::ideology_distribution)::keys_type const& ideology_keys
+	decltype(ProvinceInstance::ideology_distribution)::keys_type const& ideology_keys,
+	decltype(ProvinceInstance::culture_distribution)::keys_type const& culture_keys,
+	decltype(ProvinceInstance::religion_distribution)::keys_type const& religion_keys
 ) {
 	if (province_instances_are_locked()) {
 		Logger::error("Cannot setup map instance - province instances are already locked!");
@@ -36,18 +38,24 @@ bool MapInstance::setup(
 	if (!map_definition.province_definitions_are_locked()) {
 		Logger::error("Cannot setup map instance - province definitions are not locked!");
 		ret = false;
+	} else if (!market_instance.setup_order_book_shards(map_definition.get_province_definition_count())) {
+		Logger::error("Cannot setup map instance - failed to set up province order book shards!");
+		ret = false;
 	} else {
 		province_instances.reserve(map_definition.get_province_definition_count());
 
 		for (ProvinceDefinition const& province : map_definition.get_province_definitions()) {
 			if (province_instances.add_item({
 				market_instance,
+				pop_store,
 				modifier_effect_cache,
 				pop_defines,
 				province,
 				strata_keys,
 				pop_type_keys,
-				ideology_keys
+				ideology_keys,
+				culture_keys,
+				religion_keys
 			})) {
 				// We need to update the province's ModifierSum's source here as the province's address is finally stable
 				// after changing between its constructor call and now due to being std::move'd into the registry.
@@ -129,6 +137,9 @@ bool MapInstance::apply_history_to_provinces(
 		}
 	}
 
+	// Owners, controllers, cores and pops may all have changed, even if loading the bookmark goes on to fail.
+	gamestate_revision++;
+
 	return ret;
 }
 
@@ -142,10 +153,19 @@ void MapInstance::update_gamestate(const Date today, DefineManager const& define
 	highest_province_population = 0;
 	total_map_population = 0;
 
-	for (ProvinceInstance& province : province_instances.get_items()) {
-		province.update_gamestate(today, define_manager);
+	pop_store.clamp_values();
+
+	// Each province only reads and writes its own pops and PopStore slots, so the pop -> province rollups run in parallel
+	// and the map-wide totals are reduced from the results afterwards in a fixed order.
+	auto& provinces = province_instances.get_items();
+	parallel_for_each(
+		provinces,
+		[today, &define_manager](ProvinceInstance& province) -> void {
+			province.update_gamestate(today, define_manager);
+		}
+	);
 
-		// Update population stats
+	for (ProvinceInstance const& province : provinces) {
 		const pop_size_t province_population = province.get_total_population();
 		if (highest_province_population < province_population) {
 			highest_province_population = province_population;
@@ -154,6 +174,8 @@ void MapInstance::update_gamestate(const Date today, DefineManager const& define
 		total_map_population += province_population;
 	}
 	state_manager.update_gamestate();
+
+	gamestate_revision++;
 }
 
 void MapInstance::map_tick(const Date today) {
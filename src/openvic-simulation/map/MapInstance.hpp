@@ -4,6 +4,7 @@
 #include "openvic-simulation/map/ProvinceDefinition.hpp"
 #include "openvic-simulation/map/ProvinceInstance.hpp"
 #include "openvic-simulation/map/State.hpp"
+#include "openvic-simulation/pop/PopStore.hpp"
 #include "openvic-simulation/types/Date.hpp"
 #include "openvic-simulation/types/IdentifierRegistry.hpp"
 
@@ -21,9 +22,15 @@ namespace OpenVic {
 		MapDefinition const& PROPERTY(map_definition);
 
 		IdentifierRegistry<ProvinceInstance> IDENTIFIER_REGISTRY_CUSTOM_INDEX_OFFSET(province_instance, 1);
+		PopStore PROPERTY_REF(pop_store);
 
 		pop_size_t PROPERTY(highest_province_population, 0);
 		pop_size_t PROPERTY(total_map_population, 0);
+		/* Incremented by every gamestate update and whenever province history is applied, so that anything derived from
+		 * province state can tell when it is stale. Anything else which changes province state, e.g. ownership, outside
+		 * of a gamestate update must increment it too. Commands such as expanding buildings instead request a gamestate
+		 * update, so their effects are picked up once it has run. */
+		uint32_t PROPERTY(gamestate_revision, 0);
 
 		StateManager PROPERTY_REF(state_manager);
 
@@ -46,7 +53,9 @@ namespace OpenVic {
 			PopsDefines const& pop_defines,
 			decltype(ProvinceInstance::population_by_strata)::keys_type const& strata_keys,
 			decltype(ProvinceInstance::pop_type_distribution)::keys_type const& pop_type_keys,
-			decltype(ProvinceInstance::ideology_distribution)::keys_type const& ideology_keys
+			decltype(ProvinceInstance::ideology_distribution)::keys_type const& ideology_keys,
+			decltype(ProvinceInstance::culture_distribution)::keys_type const& culture_keys,
+			decltype(ProvinceInstance::religion_distribution)::keys_type const& religion_keys
 		);
 		bool apply_history_to_provinces(
 			ProvinceHistoryManager const& history_manager,
@@ -1,10 +1,14 @@
 #include "Mapmode.hpp"
 
+#include <algorithm>
+
 #include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/economy/BuildingType.hpp"
 #include "openvic-simulation/map/MapDefinition.hpp"
 #include "openvic-simulation/map/MapInstance.hpp"
 #include "openvic-simulation/map/ProvinceDefinition.hpp"
 #include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
 
 using namespace OpenVic;
 using namespace OpenVic::colour_literals;
@@ -14,12 +18,14 @@ Mapmode::Mapmode(
 	index_t new_index,
 	colour_func_t new_colour_func,
 	std::string_view new_localisation_key,
-	bool new_parchment_mapmode_allowed
+	bool new_parchment_mapmode_allowed,
+	inputs_t new_inputs
 ) : HasIdentifier { new_identifier },
 	HasIndex { new_index },
 	colour_func { std::move(new_colour_func) },
 	localisation_key { new_localisation_key.empty() ? new_identifier : new_localisation_key },
-	parchment_mapmode_allowed { new_parchment_mapmode_allowed } {}
+	parchment_mapmode_allowed { new_parchment_mapmode_allowed },
+	inputs { new_inputs } {}
 
 const Mapmode Mapmode::ERROR_MAPMODE {
 	"mapmode_error", -1, [](
@@ -27,7 +33,8 @@ const Mapmode Mapmode::ERROR_MAPMODE {
 		CountryInstance const* player_country, ProvinceInstance const* selected_province
 	) -> base_stripe_t {
 		return { 0xFFFF0000_argb, colour_argb_t::null() };
-	}
+	},
+	{}, true, inputs_t::DEFINITIONS_ONLY
 };
 
 Mapmode::base_stripe_t Mapmode::get_base_stripe_colours(
@@ -41,7 +48,8 @@ bool MapmodeManager::add_mapmode(
 	std::string_view identifier,
 	Mapmode::colour_func_t colour_func,
 	std::string_view localisation_key,
-	bool parchment_mapmode_allowed
+	bool parchment_mapmode_allowed,
+	Mapmode::inputs_t inputs
 ) {
 	if (identifier.empty()) {
 		Logger::error("Invalid mapmode identifier - empty!");
@@ -56,17 +64,22 @@ bool MapmodeManager::add_mapmode(
 		static_cast<Mapmode::index_t>(mapmodes.size()),
 		colour_func,
 		localisation_key,
-		parchment_mapmode_allowed
+		parchment_mapmode_allowed,
+		inputs
 	});
 }
 
-bool MapmodeManager::generate_mapmode_colours(
+bool MapmodeManager::fill_base_stripe_colours(
 	MapInstance const& map_instance, Mapmode const* mapmode,
 	CountryInstance const* player_country, ProvinceInstance const* selected_province,
-	uint8_t* target
+	std::span<Mapmode::base_stripe_t> target
 ) const {
-	if (target == nullptr) {
-		Logger::error("Mapmode colour target pointer is null!");
+	const size_t province_count = map_instance.get_map_definition().get_province_definition_count();
+	if (target.size() <= province_count) {
+		Logger::error(
+			"Mapmode colour target has ", target.size(), " entries, expected at least ", province_count + 1,
+			" (one per province plus the null province)!"
+		);
 		return false;
 	}
 
@@ -79,29 +92,94 @@ bool MapmodeManager::generate_mapmode_colours(
 		ret = false;
 	}
 
-	Mapmode::base_stripe_t* target_stripes = reinterpret_cast<Mapmode::base_stripe_t*>(target);
-
-	target_stripes[ProvinceDefinition::NULL_INDEX] = colour_argb_t::null();
+	target[ProvinceDefinition::NULL_INDEX] = colour_argb_t::null();
 
 	if (map_instance.province_instances_are_locked()) {
-		for (ProvinceInstance const& province : map_instance.get_province_instances()) {
-			target_stripes[province.get_index()] = mapmode->get_base_stripe_colours(
-				map_instance, province, player_country, selected_province
-			);
-		}
+		// Colour functions only read the map and provinces, so provinces can be coloured in parallel.
+		std::vector<ProvinceInstance> const& provinces = map_instance.get_province_instances();
+		ThreadPool::get_instance().parallel_for(
+			provinces.size(),
+			[&map_instance, mapmode, player_country, selected_province, &provinces, target](
+				size_t begin, size_t end
+			) -> void {
+				for (size_t index = begin; index < end; ++index) {
+					ProvinceInstance const& province = provinces[index];
+					target[province.get_index()] = mapmode->get_base_stripe_colours(
+						map_instance, province, player_country, selected_province
+					);
+				}
+			}
+		);
 	} else {
-		for (
-			size_t index = ProvinceDefinition::NULL_INDEX + 1;
-			index <= map_instance.get_map_definition().get_province_definition_count();
-			++index
-		) {
-			target_stripes[index] = colour_argb_t::null();
-		}
+		std::fill(
+			target.begin() + ProvinceDefinition::NULL_INDEX + 1, target.begin() + province_count + 1,
+			colour_argb_t::null()
+		);
 	}
 
 	return ret;
 }
 
+bool MapmodeManager::generate_mapmode_colours(
+	MapInstance const& map_instance, Mapmode const* mapmode,
+	CountryInstance const* player_country, ProvinceInstance const* selected_province,
+	uint8_t* target
+) const {
+	if (target == nullptr) {
+		Logger::error("Mapmode colour target pointer is null!");
+		return false;
+	}
+
+	return fill_base_stripe_colours(
+		map_instance, mapmode, player_country, selected_province,
+		{
+			reinterpret_cast<Mapmode::base_stripe_t*>(target),
+			map_instance.get_map_definition().get_province_definition_count() + 1
+		}
+	);
+}
+
+bool MapmodeColourBuffer::update(
+	MapmodeManager const& mapmode_manager, MapInstance const& map_instance, Mapmode const* new_mapmode,
+	CountryInstance const* new_player_country, ProvinceInstance const* new_selected_province
+) {
+	const size_t entry_count = map_instance.get_map_definition().get_province_definition_count() + 1;
+
+	bool stale = mapmode == nullptr || mapmode != new_mapmode || colours.size() != entry_count ||
+		provinces_coloured != map_instance.province_instances_are_locked();
+
+	if (!stale) {
+		const Mapmode::inputs_t inputs = mapmode->get_inputs();
+		if (inputs << Mapmode::inputs_t::SELECTION) {
+			stale |= player_country != new_player_country || selected_province != new_selected_province;
+		}
+		if (inputs << Mapmode::inputs_t::GAMESTATE) {
+			stale |= gamestate_revision != map_instance.get_gamestate_revision();
+		}
+	}
+
+	if (!stale) {
+		return false;
+	}
+
+	colours.resize(entry_count, colour_argb_t::null());
+	mapmode_manager.fill_base_stripe_colours(
+		map_instance, new_mapmode, new_player_country, new_selected_province, colours
+	);
+
+	mapmode = new_mapmode;
+	player_country = new_player_country;
+	selected_province = new_selected_province;
+	gamestate_revision = map_instance.get_gamestate_revision();
+	provinces_coloured = map_instance.province_instances_are_locked();
+
+	return true;
+}
+
+void MapmodeColourBuffer::invalidate() {
+	mapmode = nullptr;
+}
+
 static constexpr colour_argb_t::value_type ALPHA_VALUE = colour_argb_t::max_value;
 /* White default colour, used in mapmodes including political, revolt risk and party loyaly. */
 static constexpr colour_argb_t DEFAULT_COLOUR_WHITE = (0xFFFFFF_argb).with_alpha(ALPHA_VALUE);
@@ -137,15 +215,30 @@ static constexpr auto get_colour_mapmode(T const*(P::*get_item)() const) {
 }
 
 template<HasGetColour T>
-static constexpr Mapmode::base_stripe_t shaded_mapmode(fixed_point_map_t<T const*> const& map) {
-	const std::pair<fixed_point_map_const_iterator_t<T const*>, fixed_point_map_const_iterator_t<T const*>> largest =
-		get_largest_two_items(map);
-	if (largest.first != map.end()) {
-		const colour_argb_t base_colour = colour_argb_t { largest.first->first->get_colour(), ALPHA_VALUE };
-		if (largest.second != map.end()) {
+static constexpr Mapmode::base_stripe_t shaded_mapmode(IndexedMap<T, fixed_point_t> const& map) {
+	// Indices of the largest and second largest non-zero values, with zero values counting as absent.
+	size_t largest = map.size(), second_largest = map.size();
+	fixed_point_t total = fixed_point_t::_0();
+
+	for (size_t index = 0; index < map.size(); ++index) {
+		const fixed_point_t value = map[index];
+		if (value > fixed_point_t::_0()) {
+			total += value;
+			if (largest == map.size() || value > map[largest]) {
+				second_largest = largest;
+				largest = index;
+			} else if (second_largest == map.size() || value > map[second_largest]) {
+				second_largest = index;
+			}
+		}
+	}
+
+	if (largest != map.size()) {
+		const colour_argb_t base_colour = colour_argb_t { map(largest).get_colour(), ALPHA_VALUE };
+		if (second_largest != map.size()) {
 			/* If second largest is at least a third... */
-			if (largest.second->second * 3 >= get_total(map)) {
-				const colour_argb_t stripe_colour = colour_argb_t { largest.second->first->get_colour(), ALPHA_VALUE };
+			if (map[second_largest] * 3 >= total) {
+				const colour_argb_t stripe_colour = colour_argb_t { map(second_largest).get_colour(), ALPHA_VALUE };
 				return { base_colour, stripe_colour };
 			}
 		}
@@ -155,7 +248,7 @@ static constexpr Mapmode::base_stripe_t shaded_mapmode(fixed_point_map_t<T const
 }
 
 template<HasGetColour T>
-static constexpr auto shaded_mapmode(fixed_point_map_t<T const*> const&(ProvinceInstance::*get_map)() const) {
+static constexpr auto shaded_mapmode(IndexedMap<T, fixed_point_t> const&(ProvinceInstance::*get_map)() const) {
 	return [get_map](
 		MapInstance const& map_instance, ProvinceInstance const& province,
 		CountryInstance const* player_country, ProvinceInstance const* selected_province
@@ -164,14 +257,33 @@ static constexpr auto shaded_mapmode(fixed_point_map_t<T const*> const&(Province
 	};
 }
 
-bool MapmodeManager::setup_mapmodes() {
+bool MapmodeManager::setup_mapmodes(BuildingTypeManager const& building_type_manager) {
 	if (mapmodes_are_locked()) {
 		Logger::error("Cannot setup mapmodes - already locked!");
 		return false;
 	}
+	if (!building_type_manager.building_types_are_locked()) {
+		Logger::error("Cannot setup mapmodes - building types not locked!");
+		return false;
+	}
 
 	bool ret = true;
 
+	using enum Mapmode::inputs_t;
+
+	// Every land province has one building per province building type, in the same order, so the railroad's index among
+	// them is found once here rather than looking the building up by identifier in every province. Water provinces have
+	// no buildings, and neither does any province if there is no railroad, so get_building_by_index returns null.
+	std::vector<BuildingType const*> const& province_building_types =
+		building_type_manager.get_province_building_types();
+	const size_t railroad_index = std::find(
+		province_building_types.begin(), province_building_types.end(),
+		building_type_manager.get_building_type_by_identifier("railroad")
+	) - province_building_types.begin();
+	if (railroad_index == province_building_types.size()) {
+		Logger::warning("No railroad province building type found for mapmode_infrastructure!");
+	}
+
 	// Default number of mapmodes
 	reserve_mapmodes(22);
 
@@ -185,19 +297,24 @@ bool MapmodeManager::setup_mapmodes() {
 			return colour_argb_t::null();
 		},
 		"MAPMODE_1",
-		false // Parchment mapmode not allowed
+		false, // Parchment mapmode not allowed
+		DEFINITIONS_ONLY
+	);
+	ret &= add_mapmode(
+		"mapmode_political", get_colour_mapmode(&ProvinceInstance::get_owner), "MAPMODE_2", true, GAMESTATE
 	);
-	ret &= add_mapmode("mapmode_political", get_colour_mapmode(&ProvinceInstance::get_owner), "MAPMODE_2");
 	ret &= add_mapmode("mapmode_militancy", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_3");
 	ret &= add_mapmode("mapmode_diplomatic", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_4");
-	ret &= add_mapmode("mapmode_region", get_colour_mapmode(&ProvinceDefinition::get_region), "MAPMODE_5");
+	ret &= add_mapmode(
+		"mapmode_region", get_colour_mapmode(&ProvinceDefinition::get_region), "MAPMODE_5", true, DEFINITIONS_ONLY
+	);
 	ret &= add_mapmode(
 		"mapmode_infrastructure",
-		[](
+		[railroad_index](
 			MapInstance const& map_instance, ProvinceInstance const& province,
 			CountryInstance const* player_country, ProvinceInstance const* selected_province
 		) -> Mapmode::base_stripe_t {
-			BuildingInstance const* railroad = province.get_building_by_identifier("railroad");
+			BuildingInstance const* railroad = province.get_building_by_index(railroad_index);
 			if (railroad != nullptr) {
 				const colour_argb_t::value_type val = colour_argb_t::colour_traits::component_from_fraction(
 					railroad->get_level(), railroad->get_building_type().get_max_level() + 1, 0.5f, 1.0f
@@ -213,13 +330,17 @@ bool MapmodeManager::setup_mapmodes() {
 			}
 			return colour_argb_t::null();
 		},
-		"MAPMODE_6"
+		"MAPMODE_6",
+		true,
+		GAMESTATE
 	);
 	ret &= add_mapmode("mapmode_colonial", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_7");
 	ret &= add_mapmode("mapmode_administrative", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_8");
 	ret &= add_mapmode("mapmode_recruitment", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_9");
 	ret &= add_mapmode("mapmode_national_focus", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_10");
-	ret &= add_mapmode("mapmode_rgo", get_colour_mapmode(&ProvinceInstance::get_rgo_good), "MAPMODE_11");
+	ret &= add_mapmode(
+		"mapmode_rgo", get_colour_mapmode(&ProvinceInstance::get_rgo_good), "MAPMODE_11", true, GAMESTATE
+	);
 	ret &= add_mapmode(
 		"mapmode_population",
 		[](
@@ -238,9 +359,13 @@ bool MapmodeManager::setup_mapmodes() {
 				return colour_argb_t::null();
 			}
 		},
-		"MAPMODE_12"
+		"MAPMODE_12",
+		true,
+		GAMESTATE
+	);
+	ret &= add_mapmode(
+		"mapmode_culture", shaded_mapmode(&ProvinceInstance::get_culture_distribution), "MAPMODE_13", true, GAMESTATE
 	);
-	ret &= add_mapmode("mapmode_culture", shaded_mapmode(&ProvinceInstance::get_culture_distribution), "MAPMODE_13");
 	ret &= add_mapmode("mapmode_sphere", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_14");
 	ret &= add_mapmode("mapmode_supply", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_15");
 	ret &= add_mapmode("mapmode_party_loyalty", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_16");
@@ -265,7 +390,9 @@ bool MapmodeManager::setup_mapmodes() {
 				return colour_argb_t::null();
 			}
 		},
-		"MAPMODE_22"
+		"MAPMODE_22",
+		true,
+		DEFINITIONS_ONLY
 	);
 
 	/*
@@ -281,7 +408,10 @@ bool MapmodeManager::setup_mapmodes() {
 				CountryInstance const* player_country, ProvinceInstance const* selected_province
 			) -> Mapmode::base_stripe_t {
 				return colour_argb_t { province.get_province_definition().get_colour(), ALPHA_VALUE };
-			}
+			},
+			{},
+			true,
+			DEFINITIONS_ONLY
 		);
 		ret &= add_mapmode(
 			"mapmode_index",
@@ -293,10 +423,17 @@ bool MapmodeManager::setup_mapmodes() {
 					province.get_index(), map_instance.get_map_definition().get_province_definition_count() + 1
 				);
 				return colour_argb_t::fill_as(f).with_alpha(ALPHA_VALUE);
-			}
+			},
+			{},
+			true,
+			DEFINITIONS_ONLY
+		);
+		ret &= add_mapmode(
+			"mapmode_religion", shaded_mapmode(&ProvinceInstance::get_religion_distribution), {}, true, GAMESTATE
+		);
+		ret &= add_mapmode(
+			"mapmode_terrain_type", get_colour_mapmode(&ProvinceInstance::get_terrain_type), {}, true, GAMESTATE
 		);
-		ret &= add_mapmode("mapmode_religion", shaded_mapmode(&ProvinceInstance::get_religion_distribution));
-		ret &= add_mapmode("mapmode_terrain_type", get_colour_mapmode(&ProvinceInstance::get_terrain_type));
 		ret &= add_mapmode(
 			"mapmode_adjacencies",
 			[](
@@ -340,7 +477,10 @@ bool MapmodeManager::setup_mapmodes() {
 				}
 
 				return colour_argb_t::null();
-			}
+			},
+			{},
+			true,
+			SELECTION
 		);
 	}
 
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <span>
+#include <vector>
 
 #include "openvic-simulation/types/Colour.hpp"
+#include "openvic-simulation/types/EnumBitfield.hpp"
 #include "openvic-simulation/types/HasIdentifier.hpp"
 #include "openvic-simulation/types/IdentifierRegistry.hpp"
 
@@ -11,6 +15,7 @@ namespace OpenVic {
 	struct MapInstance;
 	struct ProvinceInstance;
 	struct CountryInstance;
+	struct BuildingTypeManager;
 
 	struct Mapmode : HasIdentifier, HasIndex<int32_t> {
 		friend struct MapmodeManager;
@@ -28,18 +33,29 @@ namespace OpenVic {
 			base_stripe_t(MapInstance const&, ProvinceInstance const&, CountryInstance const*, ProvinceInstance const*)
 		>;
 
+		/* What a mapmode's colours are computed from besides province and map definitions, so that colour buffers
+		 * know when they must be regenerated. This is a bitfield. */
+		enum struct inputs_t : uint8_t {
+			DEFINITIONS_ONLY = 0,
+			SELECTION        = 1 << 0, // The player country and selected province
+			GAMESTATE        = 1 << 1, // Anything updated by a gamestate update
+			ALL_INPUTS       = SELECTION | GAMESTATE
+		};
+
 	private:
 		// Not const so they don't have to be copied when the Mapmode is moved
 		colour_func_t PROPERTY(colour_func);
 		std::string PROPERTY(localisation_key);
 		const bool PROPERTY_CUSTOM_PREFIX(parchment_mapmode_allowed, is);
+		const inputs_t PROPERTY(inputs);
 
 		Mapmode(
 			std::string_view new_identifier,
 			index_t new_index,
 			colour_func_t new_colour_func,
 			std::string_view new_localisation_key = {},
-			bool new_parchment_mapmode_allowed = true
+			bool new_parchment_mapmode_allowed = true,
+			inputs_t new_inputs = inputs_t::ALL_INPUTS
 		);
 
 	public:
@@ -53,6 +69,8 @@ namespace OpenVic {
 		) const;
 	};
 
+	template<> struct enable_bitfield<Mapmode::inputs_t> : std::true_type {};
+
 	struct MapmodeManager {
 	private:
 		IdentifierRegistry<Mapmode> IDENTIFIER_REGISTRY(mapmode);
@@ -64,9 +82,19 @@ namespace OpenVic {
 			std::string_view identifier,
 			Mapmode::colour_func_t colour_func,
 			std::string_view localisation_key = {},
-			bool parchment_mapmode_allowed = true
+			bool parchment_mapmode_allowed = true,
+			Mapmode::inputs_t inputs = Mapmode::inputs_t::ALL_INPUTS
 		);
 
+		/* Fills target, which must have get_province_definition_count() + 1 entries, with the base and stripe colours
+		 * of every province in parallel. The null province's entry is always null, as are all others if province
+		 * instances are not set up yet. Returns false if mapmode is null, in which case ERROR_MAPMODE is used. */
+		bool fill_base_stripe_colours(
+			MapInstance const& map_instance, Mapmode const* mapmode,
+			CountryInstance const* player_country, ProvinceInstance const* selected_province,
+			std::span<Mapmode::base_stripe_t> target
+		) const;
+
 		/* The mapmode colour image contains of a list of base colours and stripe colours. Each colour is four bytes
 		 * in RGBA format, with the alpha value being used to interpolate with the terrain colour, so A = 0 is fully terrain
 		 * and A = 255 is fully the RGB colour packaged with A. The base and stripe colours for each province are packed
@@ -78,6 +106,32 @@ namespace OpenVic {
 			uint8_t* target
 		) const;
 
-		bool setup_mapmodes();
+		// Building types must be locked, as mapmodes look up the buildings they show once here.
+		bool setup_mapmodes(BuildingTypeManager const& building_type_manager);
+	};
+
+	/* Holds the colours of a mapmode for every province, as would be uploaded by a frontend, and only regenerates them
+	 * when the mapmode or one of its inputs has changed since the last update, e.g. a definitions-only mapmode is never
+	 * recoloured after being generated and a gamestate-only mapmode ignores the selected province. Gamestate changes
+	 * are detected through MapInstance's gamestate_revision, so they are only seen once it has been incremented. */
+	struct MapmodeColourBuffer {
+	private:
+		std::vector<Mapmode::base_stripe_t> PROPERTY(colours);
+		Mapmode const* mapmode = nullptr;
+		CountryInstance const* player_country = nullptr;
+		ProvinceInstance const* selected_province = nullptr;
+		uint32_t gamestate_revision = 0;
+		bool provinces_coloured = false;
+
+	public:
+		/* Returns true if the colours were regenerated. The buffer is sized to the map's province definition count
+		 * plus one for the null province, matching generate_mapmode_colours. */
+		bool update(
+			MapmodeManager const& mapmode_manager, MapInstance const& map_instance, Mapmode const* new_mapmode,
+			CountryInstance const* new_player_country, ProvinceInstance const* new_selected_province
+		);
+
+		// Forces the next update to regenerate the colours.
+		void invalidate();
 	};
 }
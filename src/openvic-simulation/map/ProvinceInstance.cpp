@@ -12,27 +12,31 @@
 #include "openvic-simulation/military/UnitInstanceGroup.hpp"
 #include "openvic-simulation/modifier/StaticModifierCache.hpp"
 #include "openvic-simulation/politics/Ideology.hpp"
-#include "openvic-simulation/utility/CompilerFeatureTesting.hpp"
 #include "openvic-simulation/utility/Logger.hpp"
 
 using namespace OpenVic;
 
 ProvinceInstance::ProvinceInstance(
 	MarketInstance& new_market_instance,
+	PopStore& new_pop_store,
 	ModifierEffectCache const& new_modifier_effect_cache,
 	PopsDefines const& new_pop_defines,
 	ProvinceDefinition const& new_province_definition,
 	decltype(population_by_strata)::keys_type const& strata_keys,
 	decltype(pop_type_distribution)::keys_type const& pop_type_keys,
-	decltype(ideology_distribution)::keys_type const& ideology_keys
+	decltype(ideology_distribution)::keys_type const& ideology_keys,
+	decltype(culture_distribution)::keys_type const& culture_keys,
+	decltype(religion_distribution)::keys_type const& religion_keys
 ) : HasIdentifierAndColour { new_province_definition },
 	HasIndex { new_province_definition.get_index() },
 	FlagStrings { "province" },
 	province_definition { new_province_definition },
 	modifier_effect_cache { new_modifier_effect_cache },
+	order_book_shard { new_market_instance.get_order_book_shard(new_province_definition.get_index() - 1) },
 	terrain_type { new_province_definition.get_default_terrain_type() },
 	rgo { new_market_instance, pop_type_keys },
 	buildings { "buildings", false },
+	pop_store { new_pop_store },
 	shared_pop_values { new_pop_defines, strata_keys },
 	population_by_strata { &strata_keys },
 	militancy_by_strata { &strata_keys },
@@ -42,7 +46,9 @@ ProvinceInstance::ProvinceInstance(
 	pop_type_distribution { &pop_type_keys },
 	pops_cache_by_type { &pop_type_keys },
 	ideology_distribution { &ideology_keys },
-	vote_distribution { nullptr } {}
+	vote_distribution { nullptr },
+	culture_distribution { &culture_keys },
+	religion_distribution { &religion_keys } {}
 
 void ProvinceInstance::set_state(State* new_state) {
 	// TODO - ensure this is removed from old state and added to new state (either here or wherever this is called from)
@@ -151,23 +157,11 @@ fixed_point_t ProvinceInstance::get_party_support(CountryParty const& party) con
 }
 
 fixed_point_t ProvinceInstance::get_culture_proportion(Culture const& culture) const {
-	const decltype(culture_distribution)::const_iterator it = culture_distribution.find(&culture);
-
-	if (it != culture_distribution.end()) {
-		return it->second;
-	} else {
-		return fixed_point_t::_0();
-	}
+	return culture_distribution[culture];
 }
 
 fixed_point_t ProvinceInstance::get_religion_proportion(Religion const& religion) const {
-	const decltype(religion_distribution)::const_iterator it = religion_distribution.find(&religion);
-
-	if (it != religion_distribution.end()) {
-		return it->second;
-	} else {
-		return fixed_point_t::_0();
-	}
+	return religion_distribution[religion];
 }
 
 bool ProvinceInstance::expand_building(size_t building_index) {
@@ -179,41 +173,44 @@ bool ProvinceInstance::expand_building(size_t building_index) {
 	return building->expand();
 }
 
-void ProvinceInstance::_add_pop(Pop&& pop) {
-	pop.set_location(*this);
-	pops.insert(std::move(pop));
-}
-
-bool ProvinceInstance::add_pop(Pop&& pop) {
-	if (!province_definition.is_water()) {
-		_add_pop(std::move(pop));
-		return true;
-	} else {
-		Logger::error("Trying to add pop to water province ", get_identifier());
-		return false;
-	}
-}
-
 bool ProvinceInstance::add_pop_vec(
 	std::vector<PopBase> const& pop_vec,
 	MarketInstance& market_instance,
 	ArtisanalProducerFactoryPattern& artisanal_producer_factory_pattern
 ) {
-	if (!province_definition.is_water()) {
-		reserve_more(pops, pop_vec.size());
-		for (PopBase const& pop : pop_vec) {
-			_add_pop(Pop {
-				pop,
-				*ideology_distribution.get_keys(),
-				market_instance,
-				artisanal_producer_factory_pattern
-			});
-		}
-		return true;
-	} else {
+	if (province_definition.is_water()) {
 		Logger::error("Trying to add pop vector to water province ", get_identifier());
 		return false;
 	}
+
+	/* Checked before any pops are created, as each one takes a PopStore slot which can never be freed. */
+	const PopStore::slot_t first_slot = pop_store.get_pop_count();
+	if (pops.empty()) {
+		pop_store_slots_begin = pop_store_slots_end = first_slot;
+	} else if (first_slot != pop_store_slots_end) {
+		Logger::error(
+			"Trying to add pops to province ", get_identifier(), " whose pops occupy PopStore slots ", pop_store_slots_begin,
+			" to ", pop_store_slots_end, " after other provinces' pops were added in slots up to ", first_slot,
+			" - a province's pops must occupy a contiguous range of slots!"
+		);
+		return false;
+	}
+
+	reserve_more(pops, pop_vec.size());
+	for (PopBase const& pop_base : pop_vec) {
+		Pop pop {
+			pop_base,
+			*ideology_distribution.get_keys(),
+			market_instance,
+			pop_store,
+			artisanal_producer_factory_pattern
+		};
+		pop.set_location(*this);
+		pops.insert(std::move(pop));
+	}
+	pop_store_slots_end = pop_store.get_pop_count();
+
+	return true;
 }
 
 size_t ProvinceInstance::get_pop_count() const {
@@ -237,7 +234,7 @@ void ProvinceInstance::_update_pops(DefineManager const& define_manager) {
 
 	pop_type_distribution.clear();
 	ideology_distribution.clear();
-	issue_distribution.clear();
+	zero_fixed_point_map(issue_distribution);
 	vote_distribution.clear();
 	culture_distribution.clear();
 	religion_distribution.clear();
@@ -264,19 +261,7 @@ void ProvinceInstance::_update_pops(DefineManager const& define_manager) {
 		// TODO - change casting if pop_size_t changes type
 		const fixed_point_t pop_size_f = fixed_point_t::parse(pop_size_s);
 
-		total_population += pop_size_s;
-		average_literacy += pop.get_literacy() * pop_size_f;
-		average_consciousness += pop.get_consciousness() * pop_size_f;
-		average_militancy += pop.get_militancy() * pop_size_f;
-
 		PopType const& pop_type = *pop.get_type();
-		Strata const& strata = pop_type.get_strata();
-
-		population_by_strata[strata] += pop_size_s;
-		militancy_by_strata[strata] += pop.get_militancy() * pop_size_f;
-		life_needs_fulfilled_by_strata[strata] += pop.get_life_needs_fulfilled() * pop_size_f;
-		everyday_needs_fulfilled_by_strata[strata] += pop.get_everyday_needs_fulfilled() * pop_size_f;
-		luxury_needs_fulfilled_by_strata[strata] += pop.get_luxury_needs_fulfilled() * pop_size_f;
 
 		pop_type_distribution[pop_type] += pop_size_s;
 		pops_cache_by_type[pop_type].push_back(&pop);
@@ -284,11 +269,44 @@ void ProvinceInstance::_update_pops(DefineManager const& define_manager) {
 		ideology_distribution += pop.get_ideology_distribution();
 		issue_distribution += pop.get_issue_distribution();
 		vote_distribution += pop.get_vote_distribution();
-		culture_distribution[&pop.get_culture()] += pop_size_f;
-		religion_distribution[&pop.get_religion()] += pop_size_f;
+		culture_distribution[pop.get_culture()] += pop_size_f;
+		religion_distribution[pop.get_religion()] += pop_size_f;
 
 		max_supported_regiments += pop.get_max_supported_regiments();
 	}
+	erase_zero_values(issue_distribution);
+
+	// Scalar totals are summed straight from the PopStore columns, which hold this province's pops contiguously.
+	std::vector<pop_size_t> const& sizes = pop_store.get_sizes();
+	std::vector<fixed_point_t> const& literacies = pop_store.get_literacies();
+	std::vector<fixed_point_t> const& consciousnesses = pop_store.get_consciousnesses();
+	std::vector<fixed_point_t> const& militancies = pop_store.get_militancies();
+	std::vector<size_t> const& strata_indices = pop_store.get_strata_indices();
+	std::vector<fixed_point_t> const& life_needs_fulfilled = pop_store.get_life_needs_fulfilled();
+	std::vector<fixed_point_t> const& everyday_needs_fulfilled = pop_store.get_everyday_needs_fulfilled();
+	std::vector<fixed_point_t> const& luxury_needs_fulfilled = pop_store.get_luxury_needs_fulfilled();
+
+	for (PopStore::slot_t slot = pop_store_slots_begin; slot < pop_store_slots_end; ++slot) {
+		const pop_size_t pop_size_s = sizes[slot];
+		// TODO - change casting if pop_size_t changes type
+		const fixed_point_t pop_size_f = fixed_point_t::parse(pop_size_s);
+
+		total_population += pop_size_s;
+		average_literacy += literacies[slot] * pop_size_f;
+		average_consciousness += consciousnesses[slot] * pop_size_f;
+		average_militancy += militancies[slot] * pop_size_f;
+	}
+
+	for (PopStore::slot_t slot = pop_store_slots_begin; slot < pop_store_slots_end; ++slot) {
+		const size_t strata_index = strata_indices[slot];
+		const fixed_point_t pop_size_f = fixed_point_t::parse(sizes[slot]);
+
+		population_by_strata[strata_index] += sizes[slot];
+		militancy_by_strata[strata_index] += militancies[slot] * pop_size_f;
+		life_needs_fulfilled_by_strata[strata_index] += life_needs_fulfilled[slot] * pop_size_f;
+		everyday_needs_fulfilled_by_strata[strata_index] += everyday_needs_fulfilled[slot] * pop_size_f;
+		luxury_needs_fulfilled_by_strata[strata_index] += luxury_needs_fulfilled[slot] * pop_size_f;
+	}
 
 	if (total_population > 0) {
 		average_literacy /= total_population;
@@ -411,16 +429,17 @@ void ProvinceInstance::update_gamestate(const Date today, DefineManager const& d
 
 void ProvinceInstance::province_tick(const Date today) {
 	shared_pop_values.update_pop_values_from_province();
-	parallel_for_each(
-		pops,
-		[](Pop& pop) -> void {
-			pop.pop_tick();
-		}
-	);
+	pop_store.update_needs_scalars(pop_store_slots_begin, pop_store_slots_end, shared_pop_values);
+	// Pops tick sequentially as they share this province's order book shard. Parallelism comes from provinces instead,
+	// and the fixed pop order keeps the shard's order sequence deterministic.
+	for (Pop& pop : pops) {
+		pop.pop_tick();
+	}
 	for (BuildingInstance& building : buildings.get_items()) {
 		building.tick(today);
 	}
 	rgo.rgo_tick();
+	CountryInstance::flush_economy_reports();
 }
 
 bool ProvinceInstance::add_unit_instance_group(UnitInstanceGroup& group) {
@@ -428,9 +447,11 @@ bool ProvinceInstance::add_unit_instance_group(UnitInstanceGroup& group) {
 
 	switch (group.get_branch()) {
 	case LAND:
+		group.position_list_index = armies.size();
 		armies.push_back(static_cast<ArmyInstance*>(&group));
 		return true;
 	case NAVAL:
+		group.position_list_index = navies.size();
 		navies.push_back(static_cast<NavyInstance*>(&group));
 		return true;
 	default:
@@ -446,11 +467,13 @@ bool ProvinceInstance::remove_unit_instance_group(UnitInstanceGroup const& group
 	const auto remove_from_vector = [this, &group]<UnitType::branch_t Branch>(
 		std::vector<UnitInstanceGroupBranched<Branch>*>& unit_instance_groups
 	) -> bool {
-		const typename std::vector<UnitInstanceGroupBranched<Branch>*>::const_iterator it =
-			std::find(unit_instance_groups.begin(), unit_instance_groups.end(), &group);
+		const size_t index = group.position_list_index;
 
-		if (it != unit_instance_groups.end()) {
-			unit_instance_groups.erase(it);
+		// The last group is moved into the removed group's place, so removal is O(1) but does not preserve order.
+		if (index < unit_instance_groups.size() && unit_instance_groups[index] == &group) {
+			unit_instance_groups[index] = unit_instance_groups.back();
+			unit_instance_groups[index]->position_list_index = index;
+			unit_instance_groups.pop_back();
 			return true;
 		} else {
 			Logger::error(
@@ -66,6 +66,8 @@ namespace OpenVic {
 	private:
 		ProvinceDefinition const& PROPERTY(province_definition);
 		ModifierEffectCache const& PROPERTY(modifier_effect_cache);
+		// Orders placed by this province's pops and RGO, only written to while this province ticks.
+		OrderBookShard& PROPERTY_MOD(order_book_shard);
 
 		TerrainType const* PROPERTY(terrain_type);
 		life_rating_t PROPERTY(life_rating, 0);
@@ -94,7 +96,12 @@ namespace OpenVic {
 		UNIT_BRANCHED_GETTER_CONST(get_unit_instance_groups, armies, navies);
 
 	private:
-		plf::colony<Pop> PROPERTY(pops); // TODO - replace with a more easily vectorisable container?
+		// The per-pop scalars of this province's pops are stored in pop_store, in slots [begin, end). Pops are never
+		// removed, so their slots stay contiguous once add_pop_vec has created them.
+		PopStore& pop_store;
+		PopStore::slot_t PROPERTY(pop_store_slots_begin, 0);
+		PopStore::slot_t PROPERTY(pop_store_slots_end, 0);
+		plf::colony<Pop> PROPERTY(pops);
 		PopValuesFromProvince PROPERTY(shared_pop_values);
 		pop_size_t PROPERTY(total_population, 0);
 		// TODO - population change (growth + migration), monthly totals + breakdown by source/destination
@@ -113,21 +120,23 @@ namespace OpenVic {
 		IndexedMap<Ideology, fixed_point_t> PROPERTY(ideology_distribution);
 		fixed_point_map_t<Issue const*> PROPERTY(issue_distribution);
 		IndexedMap<CountryParty, fixed_point_t> PROPERTY(vote_distribution);
-		fixed_point_map_t<Culture const*> PROPERTY(culture_distribution);
-		fixed_point_map_t<Religion const*> PROPERTY(religion_distribution);
+		IndexedMap<Culture, fixed_point_t> PROPERTY(culture_distribution);
+		IndexedMap<Religion, fixed_point_t> PROPERTY(religion_distribution);
 		size_t PROPERTY(max_supported_regiments, 0);
 
 		ProvinceInstance(
 			MarketInstance& new_market_instance,
+			PopStore& new_pop_store,
 			ModifierEffectCache const& new_modifier_effect_cache,
 			PopsDefines const& new_pop_defines,
 			ProvinceDefinition const& new_province_definition,
 			decltype(population_by_strata)::keys_type const& strata_keys,
 			decltype(pop_type_distribution)::keys_type const& pop_type_keys,
-			decltype(ideology_distribution)::keys_type const& ideology_keys
+			decltype(ideology_distribution)::keys_type const& ideology_keys,
+			decltype(culture_distribution)::keys_type const& culture_keys,
+			decltype(religion_distribution)::keys_type const& religion_keys
 		);
 
-		void _add_pop(Pop&& pop);
 		void _update_pops(DefineManager const& define_manager);
 		bool convert_rgo_worker_pops_to_equivalent(ProductionType const& production_type);
 
@@ -200,7 +209,8 @@ namespace OpenVic {
 
 		bool expand_building(size_t building_index);
 
-		bool add_pop(Pop&& pop);
+		/* Creates pops from pop_vec. The new pops' PopStore slots must directly follow this province's existing ones,
+		 * so pops can only be added to the province whose pops were added most recently. */
 		bool add_pop_vec(
 			std::vector<PopBase> const& pop_vec,
 			MarketInstance& market_instance,
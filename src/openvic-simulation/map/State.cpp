@@ -6,6 +6,7 @@
 #include "openvic-simulation/map/ProvinceInstance.hpp"
 #include "openvic-simulation/map/Region.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/utility/CompilerFeatureTesting.hpp"
 #include "openvic-simulation/utility/StringUtils.hpp"
 
 using namespace OpenVic;
@@ -18,7 +19,9 @@ State::State(
 	ProvinceInstance::colony_status_t new_colony_status,
 	decltype(population_by_strata)::keys_type const& strata_keys,
 	decltype(pop_type_distribution)::keys_type const& pop_type_keys,
-	decltype(ideology_distribution)::keys_type const& ideology_keys
+	decltype(ideology_distribution)::keys_type const& ideology_keys,
+	decltype(culture_distribution)::keys_type const& culture_keys,
+	decltype(religion_distribution)::keys_type const& religion_keys
 ) : state_set { new_state_set },
 	owner { new_owner },
 	capital { new_capital },
@@ -32,7 +35,9 @@ State::State(
 	pop_type_distribution { &pop_type_keys },
 	pops_cache_by_type { &pop_type_keys },
 	ideology_distribution { &ideology_keys },
-	vote_distribution { new_owner != nullptr ? &new_owner->get_country_definition()->get_parties() : nullptr } {}
+	vote_distribution { new_owner != nullptr ? &new_owner->get_country_definition()->get_parties() : nullptr },
+	culture_distribution { &culture_keys },
+	religion_distribution { &religion_keys } {}
 
 std::string State::get_identifier() const {
 	return StringUtils::append_string_views(
@@ -60,23 +65,11 @@ fixed_point_t State::get_party_support(CountryParty const& party) const {
 }
 
 fixed_point_t State::get_culture_proportion(Culture const& culture) const {
-	const decltype(culture_distribution)::const_iterator it = culture_distribution.find(&culture);
-
-	if (it != culture_distribution.end()) {
-		return it->second;
-	} else {
-		return fixed_point_t::_0();
-	}
+	return culture_distribution[culture];
 }
 
 fixed_point_t State::get_religion_proportion(Religion const& religion) const {
-	const decltype(religion_distribution)::const_iterator it = religion_distribution.find(&religion);
-
-	if (it != religion_distribution.end()) {
-		return it->second;
-	} else {
-		return fixed_point_t::_0();
-	}
+	return religion_distribution[religion];
 }
 
 void State::update_gamestate() {
@@ -93,7 +86,7 @@ void State::update_gamestate() {
 
 	pop_type_distribution.clear();
 	ideology_distribution.clear();
-	issue_distribution.clear();
+	zero_fixed_point_map(issue_distribution);
 	vote_distribution.clear();
 	culture_distribution.clear();
 	religion_distribution.clear();
@@ -143,6 +136,7 @@ void State::update_gamestate() {
 
 		max_supported_regiments += province->get_max_supported_regiments();
 	}
+	erase_zero_values(issue_distribution);
 
 	if (total_population > 0) {
 		average_literacy /= total_population;
@@ -197,7 +191,9 @@ bool StateManager::add_state_set(
 	MapInstance& map_instance, Region const& region,
 	decltype(State::population_by_strata)::keys_type const& strata_keys,
 	decltype(State::pop_type_distribution)::keys_type const& pop_type_keys,
-	decltype(State::ideology_distribution)::keys_type const& ideology_keys
+	decltype(State::ideology_distribution)::keys_type const& ideology_keys,
+	decltype(State::culture_distribution)::keys_type const& culture_keys,
+	decltype(State::religion_distribution)::keys_type const& religion_keys
 ) {
 	if (region.get_meta()) {
 		Logger::error("Cannot use meta region \"", region.get_identifier(), "\" as state template!");
@@ -247,7 +243,7 @@ bool StateManager::add_state_set(
 		State& state = *state_set.states.insert({
 			/* TODO: capital province logic */
 			state_set, owner, capital, std::move(provinces), capital->get_colony_status(), strata_keys, pop_type_keys,
-			ideology_keys
+			ideology_keys, culture_keys, religion_keys
 		});
 
 		for (ProvinceInstance* province : state.get_provinces()) {
@@ -266,7 +262,9 @@ bool StateManager::generate_states(
 	MapInstance& map_instance,
 	decltype(State::population_by_strata)::keys_type const& strata_keys,
 	decltype(State::pop_type_distribution)::keys_type const& pop_type_keys,
-	decltype(State::ideology_distribution)::keys_type const& ideology_keys
+	decltype(State::ideology_distribution)::keys_type const& ideology_keys,
+	decltype(State::culture_distribution)::keys_type const& culture_keys,
+	decltype(State::religion_distribution)::keys_type const& religion_keys
 ) {
 	MapDefinition const& map_definition = map_instance.get_map_definition();
 
@@ -278,7 +276,9 @@ bool StateManager::generate_states(
 
 	for (Region const& region : map_definition.get_regions()) {
 		if (!region.get_meta()) {
-			if (add_state_set(map_instance, region, strata_keys, pop_type_keys, ideology_keys)) {
+			if (add_state_set(
+				map_instance, region, strata_keys, pop_type_keys, ideology_keys, culture_keys, religion_keys
+			)) {
 				state_count += state_sets.back().get_state_count();
 			} else {
 				ret = false;
@@ -296,7 +296,11 @@ void StateManager::reset() {
 }
 
 void StateManager::update_gamestate() {
-	for (StateSet& state_set : state_sets) {
-		state_set.update_gamestate();
-	}
+	// States only read their own provinces, which have all finished updating by this point.
+	parallel_for_each(
+		state_sets,
+		[](StateSet& state_set) -> void {
+			state_set.update_gamestate();
+		}
+	);
 }
\ No newline at end of file
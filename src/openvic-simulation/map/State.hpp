@@ -41,8 +41,8 @@ namespace OpenVic {
 		IndexedMap<Ideology, fixed_point_t> PROPERTY(ideology_distribution);
 		fixed_point_map_t<Issue const*> PROPERTY(issue_distribution);
 		IndexedMap<CountryParty, fixed_point_t> PROPERTY(vote_distribution);
-		fixed_point_map_t<Culture const*> PROPERTY(culture_distribution);
-		fixed_point_map_t<Religion const*> PROPERTY(religion_distribution);
+		IndexedMap<Culture, fixed_point_t> PROPERTY(culture_distribution);
+		IndexedMap<Religion, fixed_point_t> PROPERTY(religion_distribution);
 
 		fixed_point_t PROPERTY(industrial_power);
 
@@ -56,7 +56,9 @@ namespace OpenVic {
 			ProvinceInstance::colony_status_t new_colony_status,
 			decltype(population_by_strata)::keys_type const& strata_keys,
 			decltype(pop_type_distribution)::keys_type const& pop_type_keys,
-			decltype(ideology_distribution)::keys_type const& ideology_keys
+			decltype(ideology_distribution)::keys_type const& ideology_keys,
+			decltype(culture_distribution)::keys_type const& culture_keys,
+			decltype(religion_distribution)::keys_type const& religion_keys
 		);
 
 	public:
@@ -123,7 +125,9 @@ namespace OpenVic {
 			MapInstance& map_instance, Region const& region,
 			decltype(State::population_by_strata)::keys_type const& strata_keys,
 			decltype(State::pop_type_distribution)::keys_type const& pop_type_keys,
-			decltype(State::ideology_distribution)::keys_type const& ideology_keys
+			decltype(State::ideology_distribution)::keys_type const& ideology_keys,
+			decltype(State::culture_distribution)::keys_type const& culture_keys,
+			decltype(State::religion_distribution)::keys_type const& religion_keys
 		);
 
 	public:
@@ -134,7 +138,9 @@ namespace OpenVic {
 			MapInstance& map_instance,
 			decltype(State::population_by_strata)::keys_type const& strata_keys,
 			decltype(State::pop_type_distribution)::keys_type const& pop_type_keys,
-			decltype(State::ideology_distribution)::keys_type const& ideology_keys
+			decltype(State::ideology_distribution)::keys_type const& ideology_keys,
+			decltype(State::culture_distribution)::keys_type const& culture_keys,
+			decltype(State::religion_distribution)::keys_type const& religion_keys
 		);
 
 		void reset();
@@ -269,11 +269,11 @@ fixed_point_t UnitInstanceGroupBranched<NAVAL>::get_total_consumed_supply() cons
 
 template<UnitType::branch_t Branch>
 UnitInstanceBranched<Branch>& UnitInstanceManager::generate_unit_instance(UnitDeployment<Branch> const& unit_deployment) {
-	UnitInstanceBranched<Branch>& unit_instance = *get_unit_instances<Branch>().insert(
-		[this, &unit_deployment]() -> UnitInstanceBranched<Branch> {
+	return get_unit_instances<Branch>().insert(
+		[&unit_deployment](unique_id_t unique_id) -> UnitInstanceBranched<Branch> {
 			if constexpr (Branch == LAND) {
 				return {
-					unique_id_counter++,
+					unique_id,
 					unit_deployment.get_name(),
 					unit_deployment.get_type(),
 					nullptr, // TODO - get pop from Province unit_deployment.get_home()
@@ -281,17 +281,13 @@ UnitInstanceBranched<Branch>& UnitInstanceManager::generate_unit_instance(UnitDe
 				};
 			} else if constexpr (Branch == NAVAL) {
 				return {
-					unique_id_counter++,
+					unique_id,
 					unit_deployment.get_name(),
 					unit_deployment.get_type()
 				};
 			}
-		}()
+		}
 	);
-
-	unit_instance_map.emplace(unit_instance.get_unique_id(), &unit_instance);
-
-	return unit_instance;
 }
 
 template<UnitType::branch_t Branch>
@@ -314,10 +310,11 @@ bool UnitInstanceManager::generate_unit_instance_group(
 		return false;
 	}
 
-	UnitInstanceGroupBranched<Branch>& unit_instance_group = *get_unit_instance_groups<Branch>().insert({
-		unique_id_counter++, unit_deployment_group.get_name()
-	});
-	unit_instance_group_map.emplace(unit_instance_group.get_unique_id(), &unit_instance_group);
+	UnitInstanceGroupBranched<Branch>& unit_instance_group = get_unit_instance_groups<Branch>().insert(
+		[&unit_deployment_group](unique_id_t unique_id) -> UnitInstanceGroupBranched<Branch> {
+			return { unique_id, unit_deployment_group.get_name() };
+		}
+	);
 
 	bool ret = true;
 
@@ -351,10 +348,11 @@ bool UnitInstanceManager::generate_unit_instance_group(
 }
 
 void UnitInstanceManager::generate_leader(CountryInstance& country, LeaderBase const& leader) {
-	LeaderInstance& leader_instance = *leaders.insert({
-		unique_id_counter++, leader, country
-	});
-	leader_instance_map.emplace(leader_instance.get_unique_id(), &leader_instance);
+	LeaderInstance& leader_instance = leaders.insert(
+		[&country, &leader](unique_id_t unique_id) -> LeaderInstance {
+			return { unique_id, leader, country };
+		}
+	);
 	country.add_leader(leader_instance);
 
 	if (leader_instance.get_picture().empty() && country.get_primary_culture() != nullptr) {
@@ -370,7 +368,12 @@ UnitInstanceManager::UnitInstanceManager(
 	MilitaryDefines const& new_military_defines
 ) : culture_manager { new_culture_manager },
 	leader_trait_manager { new_leader_trait_manager },
-	military_defines { new_military_defines } {}
+	military_defines { new_military_defines },
+	leaders { static_cast<uint8_t>(unique_id_tag_t::LEADER) },
+	regiments { static_cast<uint8_t>(unique_id_tag_t::REGIMENT) },
+	ships { static_cast<uint8_t>(unique_id_tag_t::SHIP) },
+	armies { static_cast<uint8_t>(unique_id_tag_t::ARMY) },
+	navies { static_cast<uint8_t>(unique_id_tag_t::NAVY) } {}
 
 bool UnitInstanceManager::generate_deployment(
 	MapInstance& map_instance, CountryInstance& country, Deployment const* deployment
@@ -417,31 +420,27 @@ void UnitInstanceManager::tick() {
 }
 
 LeaderInstance* UnitInstanceManager::get_leader_instance_by_unique_id(unique_id_t unique_id) {
-	const decltype(leader_instance_map)::const_iterator it = leader_instance_map.find(unique_id);
-
-	if (it != leader_instance_map.end()) {
-		return it->second;
-	} else {
-		return nullptr;
-	}
+	return leaders.get(unique_id);
 }
 
 UnitInstance* UnitInstanceManager::get_unit_instance_by_unique_id(unique_id_t unique_id) {
-	const decltype(unit_instance_map)::const_iterator it = unit_instance_map.find(unique_id);
-
-	if (it != unit_instance_map.end()) {
-		return it->second;
-	} else {
+	switch (static_cast<unique_id_tag_t>(SlotMap<RegimentInstance>::get_tag(unique_id))) {
+	case unique_id_tag_t::REGIMENT:
+		return regiments.get(unique_id);
+	case unique_id_tag_t::SHIP:
+		return ships.get(unique_id);
+	default:
 		return nullptr;
 	}
 }
 
 UnitInstanceGroup* UnitInstanceManager::get_unit_instance_group_by_unique_id(unique_id_t unique_id) {
-	const decltype(unit_instance_group_map)::const_iterator it = unit_instance_group_map.find(unique_id);
-
-	if (it != unit_instance_group_map.end()) {
-		return it->second;
-	} else {
+	switch (static_cast<unique_id_tag_t>(SlotMap<ArmyInstance>::get_tag(unique_id))) {
+	case unique_id_tag_t::ARMY:
+		return armies.get(unique_id);
+	case unique_id_tag_t::NAVY:
+		return navies.get(unique_id);
+	default:
 		return nullptr;
 	}
 }
@@ -5,12 +5,11 @@
 #include <string_view>
 #include <vector>
 
-#include <plf_colony.h>
-
 #include "openvic-simulation/military/Leader.hpp"
 #include "openvic-simulation/military/UnitInstance.hpp"
 #include "openvic-simulation/military/UnitType.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/SlotMap.hpp"
 #include "openvic-simulation/utility/Getters.hpp"
 
 namespace OpenVic {
@@ -20,6 +19,9 @@ namespace OpenVic {
 	struct MapInstance;
 
 	struct UnitInstanceGroup {
+		friend struct ProvinceInstance;
+		friend struct CountryInstance;
+
 	private:
 		const unique_id_t PROPERTY(unique_id);
 		const UnitType::branch_t PROPERTY(branch);
@@ -28,6 +30,10 @@ namespace OpenVic {
 		LeaderInstance* PROPERTY_PTR(leader, nullptr);
 		ProvinceInstance* PROPERTY_PTR(position, nullptr);
 		CountryInstance* PROPERTY_PTR(country, nullptr);
+		/* This group's indices in its position's and country's lists of unit groups of its branch, kept up to date by
+		 * them so that they can remove it in O(1) by moving their last group into its place. */
+		size_t position_list_index = 0;
+		size_t country_list_index = 0;
 
 		fixed_point_t PROPERTY(total_organisation);
 		fixed_point_t PROPERTY(total_max_organisation);
@@ -166,24 +172,20 @@ namespace OpenVic {
 		LeaderTraitManager const& leader_trait_manager;
 		MilitaryDefines const& military_defines;
 
-		// TODO - use single counter or separate for leaders vs units vs unit groups? (even separate for branches?)
-		// Starts at 1, so ID 0 represents an invalid value
-		unique_id_t unique_id_counter = 1;
-
-		// TODO - maps from unique_ids to leader/unit/unit group pointers (one big map or multiple maps?)
+		/* Unique IDs are the handles of each item in its slot map, which are looked up in O(1). Each slot map has a
+		 * different tag, so no two items share an ID and an ID's tag tells which slot map it belongs to. ID 0 is never
+		 * used, so it represents an invalid value. */
+		enum struct unique_id_tag_t : uint8_t { LEADER, REGIMENT, SHIP, ARMY, NAVY };
 
-		plf::colony<LeaderInstance> PROPERTY(leaders);
-		ordered_map<unique_id_t, LeaderInstance*> PROPERTY(leader_instance_map);
+		SlotMap<LeaderInstance> PROPERTY(leaders);
 
-		plf::colony<RegimentInstance> PROPERTY(regiments);
-		plf::colony<ShipInstance> PROPERTY(ships);
-		ordered_map<unique_id_t, UnitInstance*> PROPERTY(unit_instance_map);
+		SlotMap<RegimentInstance> PROPERTY(regiments);
+		SlotMap<ShipInstance> PROPERTY(ships);
 
 		UNIT_BRANCHED_GETTER(get_unit_instances, regiments, ships);
 
-		plf::colony<ArmyInstance> PROPERTY(armies);
-		plf::colony<NavyInstance> PROPERTY(navies);
-		ordered_map<unique_id_t, UnitInstanceGroup*> PROPERTY(unit_instance_group_map);
+		SlotMap<ArmyInstance> PROPERTY(armies);
+		SlotMap<NavyInstance> PROPERTY(navies);
 
 		UNIT_BRANCHED_GETTER(get_unit_instance_groups, armies, navies);
 
@@ -0,0 +1,353 @@
+#include "EventScheduler.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "openvic-simulation/country/CountryDefinition.hpp"
+#include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/InstanceManager.hpp"
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/misc/Event.hpp"
+#include "openvic-simulation/modifier/Modifier.hpp"
+#include "openvic-simulation/utility/Logger.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
+
+using namespace OpenVic;
+
+void EventScheduler::event_index_t::add_event(prerequisites_t const& prerequisites, size_t event_index) {
+	if (prerequisites.tag != nullptr) {
+		by_tag[prerequisites.tag].push_back(event_index);
+	} else if (prerequisites.modifier != nullptr) {
+		by_modifier[prerequisites.modifier].push_back(event_index);
+	} else if (!prerequisites.flag.empty()) {
+		by_flag[prerequisites.flag].push_back(event_index);
+	} else {
+		unindexed.push_back(event_index);
+	}
+}
+
+void EventScheduler::event_index_t::clear() {
+	by_tag.clear();
+	by_modifier.clear();
+	by_flag.clear();
+	unindexed.clear();
+}
+
+void EventScheduler::event_index_t::get_candidates(
+	CountryDefinition const* tag, FlagStrings const& flags, std::vector<ModifierInstance> const& event_modifiers,
+	std::vector<size_t>& candidates
+) const {
+	const auto add_candidates = [&candidates](auto const& index_map, auto const& key) -> void {
+		const auto it = index_map.find(key);
+		if (it != index_map.end()) {
+			candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+		}
+	};
+
+	candidates = unindexed;
+	if (tag != nullptr) {
+		add_candidates(by_tag, tag);
+	}
+	for (std::string const& flag : flags.get_flags()) {
+		add_candidates(by_flag, flag);
+	}
+	for (ModifierInstance const& modifier : event_modifiers) {
+		add_candidates(by_modifier, modifier.get_modifier());
+	}
+	// Candidates are checked in event order, and only once if a modifier is applied more than once.
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+void EventScheduler::_extract_prerequisites(
+	ConditionNode const& node, bool country_event, prerequisites_t& prerequisites
+) {
+	if (!node.is_valid() || node.get_condition() == nullptr) {
+		return;
+	}
+
+	const std::string_view identifier = node.get_condition()->get_identifier();
+	ConditionNode::value_t const& value = node.get_value();
+
+	// Only conditions which must hold for the whole trigger to hold are prerequisites, so ORs and NOTs are skipped.
+	if (identifier == "AND") {
+		if (ConditionNode::condition_list_t const* list = std::get_if<ConditionNode::condition_list_t>(&value)) {
+			for (ConditionNode const& child : *list) {
+				_extract_prerequisites(child, country_event, prerequisites);
+			}
+		}
+		return;
+	}
+
+	ConditionNode::string_t const* string = std::get_if<ConditionNode::string_t>(&value);
+
+	if (identifier == "has_global_flag" && string != nullptr) {
+		prerequisites.global_flags.push_back(*string);
+	} else if (identifier == "year" && std::holds_alternative<ConditionNode::integer_t>(value)) {
+		prerequisites.min_year = std::clamp<ConditionNode::integer_t>(
+			std::get<ConditionNode::integer_t>(value), prerequisites.min_year, std::numeric_limits<Date::year_t>::max()
+		);
+	} else if (identifier == (country_event ? "has_country_flag" : "has_province_flag") && string != nullptr) {
+		prerequisites.flag = *string;
+	} else if (
+		identifier == (country_event ? "has_country_modifier" : "has_province_modifier") &&
+		node.get_condition_value_item() != nullptr
+	) {
+		prerequisites.modifier = static_cast<Modifier const*>(node.get_condition_value_item());
+	} else if (country_event && identifier == "tag" && node.get_condition_value_item() != nullptr) {
+		prerequisites.tag = static_cast<CountryDefinition const*>(node.get_condition_value_item());
+	}
+}
+
+EventScheduler::prerequisites_t EventScheduler::get_prerequisites(ConditionNode const& trigger, bool country_event) {
+	prerequisites_t prerequisites;
+	_extract_prerequisites(trigger, country_event, prerequisites);
+	return prerequisites;
+}
+
+void EventScheduler::setup(EventManager const& event_manager) {
+	country_events.clear();
+	province_events.clear();
+	country_event_index.clear();
+	province_event_index.clear();
+	fired_once_events.clear();
+	fired_events.clear();
+
+	size_t unindexed_count = 0;
+	std::string unsupported_events;
+
+	for (Event const& event : event_manager.get_events()) {
+		// Triggered only events are fired by effects and on actions rather than by their mean time to happen.
+		if (event.is_triggered_only() || event.get_mean_time_to_happen().get_base() <= 0) {
+			continue;
+		}
+
+		/* Left out until their conditions are implemented, as their triggers can't be evaluated. Unscheduled events are
+		 * never fired, which is safer than firing them when they shouldn't be. */
+		if (event.get_trigger().get_bytecode().get_unsupported_count() > 0) {
+			if (!unsupported_events.empty()) {
+				unsupported_events += ", ";
+			}
+			unsupported_events += event.get_identifier();
+			continue;
+		}
+
+		const bool country_event = event.get_type() == Event::event_type_t::COUNTRY;
+		scheduled_event_t scheduled_event {
+			&event, get_prerequisites(event.get_trigger().get_condition_root(), country_event)
+		};
+		prerequisites_t const& prerequisites = scheduled_event.prerequisites;
+
+		std::vector<scheduled_event_t>& events = country_event ? country_events : province_events;
+		event_index_t& event_index = country_event ? country_event_index : province_event_index;
+
+		event_index.add_event(prerequisites, events.size());
+		if (prerequisites.tag == nullptr && prerequisites.modifier == nullptr && prerequisites.flag.empty()) {
+			unindexed_count++;
+		}
+		events.push_back(std::move(scheduled_event));
+	}
+
+	Logger::info(
+		"Scheduled ", country_events.size(), " country and ", province_events.size(), " province events, ",
+		unindexed_count, " of which have no tag, modifier or flag prerequisite"
+	);
+	if (!unsupported_events.empty()) {
+		Logger::warning("Not scheduling events whose triggers use unsupported conditions: ", unsupported_events);
+	}
+}
+
+bool EventScheduler::_is_event_active(
+	scheduled_event_t const& scheduled_event, InstanceManager const& instance_manager
+) const {
+	prerequisites_t const& prerequisites = scheduled_event.prerequisites;
+	if (instance_manager.get_today().get_year() < prerequisites.min_year) {
+		return false;
+	}
+	if (scheduled_event.event->get_fire_only_once() && fired_once_events.contains(scheduled_event.event)) {
+		return false;
+	}
+	for (std::string const& global_flag : prerequisites.global_flags) {
+		if (!instance_manager.get_global_flags().has_flag(global_flag)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+fixed_point_t EventScheduler::get_interval_probability(fixed_point_t mean_time_to_happen) {
+	if (mean_time_to_happen <= fixed_point_t::_1()) {
+		return fixed_point_t::_1();
+	}
+
+	/* 1 - (1 - 1 / mean_time_to_happen) ^ CHECK_INTERVAL, using exponentiation by squaring. With fixed_point_t's 16
+	 * fractional bits 1 / mean_time_to_happen is only a few units for typical mean times to happen, or 0 beyond 65536
+	 * days, and truncating it and every product noticeably biases the result, so this uses 31 fractional bits, with
+	 * which the product of two values no greater than 1 still fits in 64 bits, and only rounds once at the end. */
+	static constexpr int32_t WIDE_PRECISION = 31;
+	static constexpr uint64_t WIDE_ONE = uint64_t { 1 } << WIDE_PRECISION;
+	static constexpr int32_t NARROWING_SHIFT = WIDE_PRECISION - fixed_point_t::PRECISION;
+
+	uint64_t daily_miss = WIDE_ONE -
+		(WIDE_ONE << fixed_point_t::PRECISION) / static_cast<uint64_t>(mean_time_to_happen.get_raw_value());
+	uint64_t interval_miss = WIDE_ONE;
+	for (Timespan::day_t exponent = CHECK_INTERVAL; exponent > 0; exponent >>= 1) {
+		if (exponent & 1) {
+			interval_miss = (interval_miss * daily_miss) >> WIDE_PRECISION;
+		}
+		daily_miss = (daily_miss * daily_miss) >> WIDE_PRECISION;
+	}
+
+	// Rounded to the nearest value, but never to 0, so that any event with a finite mean time to happen can fire.
+	const uint64_t interval_chance = WIDE_ONE - interval_miss;
+	const int64_t rounded_chance = static_cast<int64_t>(
+		(interval_chance + (uint64_t { 1 } << (NARROWING_SHIFT - 1))) >> NARROWING_SHIFT
+	);
+	return fixed_point_t::parse_raw(std::max<int64_t>(rounded_chance, 1));
+}
+
+size_t EventScheduler::get_first_checked_scope(Date today) {
+	return (today - Date {}).to_int() % CHECK_INTERVAL;
+}
+
+// Uses the splitmix64 finaliser to mix the inputs.
+fixed_point_t EventScheduler::get_event_roll(size_t event_index, size_t scope_index, Timespan::day_t day) {
+	uint64_t hash = (static_cast<uint64_t>(day) << 40) ^ (static_cast<uint64_t>(event_index) << 20) ^ scope_index;
+	hash += 0x9E3779B97F4A7C15;
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EB;
+	hash ^= hash >> 31;
+	return fixed_point_t::parse_raw(hash & fixed_point_t::FRAC_MASK);
+}
+
+template<typename T>
+void EventScheduler::_tick_scopes(
+	InstanceManager const& instance_manager, std::vector<T> const& scopes,
+	std::vector<scheduled_event_t> const& events, event_index_t const& event_index
+) {
+	static constexpr bool country_scopes = std::is_same_v<T, CountryInstance>;
+
+	if (events.empty()) {
+		return;
+	}
+
+	const Timespan::day_t day = (instance_manager.get_today() - Date {}).to_int();
+	const size_t first_scope = get_first_checked_scope(instance_manager.get_today());
+
+	// Prerequisites not depending on the scope are checked once per event.
+	std::vector<uint8_t> events_active(events.size());
+	for (size_t index = 0; index < events.size(); ++index) {
+		events_active[index] = _is_event_active(events[index], instance_manager);
+	}
+
+	struct worker_t {
+		std::vector<size_t> candidates;
+		std::vector<fired_index_t> fired;
+		size_t trigger_evaluation_count = 0;
+	};
+
+	ThreadPool& thread_pool = ThreadPool::get_instance();
+	std::vector<worker_t> workers(thread_pool.get_worker_count());
+
+	// Only every CHECK_INTERVAL-th scope is checked today, starting from first_scope.
+	const size_t scope_count = scopes.size() > first_scope ? (scopes.size() - first_scope - 1) / CHECK_INTERVAL + 1 : 0;
+
+	thread_pool.parallel_for(
+		scope_count,
+		[&instance_manager, &scopes, &events, &event_index, &events_active, &workers, first_scope, day](
+			size_t begin, size_t end
+		) -> void {
+			worker_t& worker = workers[ThreadPool::get_current_worker_index()];
+
+			for (size_t step = begin; step < end; ++step) {
+				const size_t scope_index = first_scope + step * CHECK_INTERVAL;
+				T const& scope = scopes[scope_index];
+
+				if constexpr (country_scopes) {
+					if (!scope.exists()) {
+						continue;
+					}
+				} else {
+					if (scope.get_owner() == nullptr) {
+						continue;
+					}
+				}
+
+				CountryDefinition const* tag = nullptr;
+				if constexpr (country_scopes) {
+					tag = scope.get_country_definition();
+				}
+				event_index.get_candidates(tag, scope, scope.get_event_modifiers(), worker.candidates);
+
+				const ConditionBytecode::context_t context { instance_manager, &scope, {} };
+
+				for (const size_t candidate : worker.candidates) {
+					if (!events_active[candidate]) {
+						continue;
+					}
+					prerequisites_t const& prerequisites = events[candidate].prerequisites;
+					if (prerequisites.tag != nullptr && tag != prerequisites.tag) {
+						continue;
+					}
+					if (!prerequisites.flag.empty() && !scope.has_flag(prerequisites.flag)) {
+						continue;
+					}
+					if (prerequisites.modifier != nullptr && std::none_of(
+						scope.get_event_modifiers().begin(), scope.get_event_modifiers().end(),
+						[&prerequisites](ModifierInstance const& modifier) -> bool {
+							return modifier.get_modifier() == prerequisites.modifier;
+						}
+					)) {
+						continue;
+					}
+
+					Event const& event = *events[candidate].event;
+					worker.trigger_evaluation_count++;
+					if (!event.get_trigger().get_bytecode().evaluate(context, &scope)) {
+						continue;
+					}
+
+					const fixed_point_t probability =
+						get_interval_probability(event.get_mean_time_to_happen().evaluate(context, &scope));
+					if (get_event_roll(candidate, scope_index, day) < probability) {
+						worker.fired.push_back({ scope_index, candidate });
+					}
+				}
+			}
+		}
+	);
+
+	std::vector<fired_index_t> fired;
+	for (worker_t& worker : workers) {
+		trigger_evaluation_count += worker.trigger_evaluation_count;
+		fired.insert(fired.end(), worker.fired.begin(), worker.fired.end());
+	}
+	std::sort(fired.begin(), fired.end());
+
+	for (fired_index_t const& fired_index : fired) {
+		Event const* event = events[fired_index.event_index].event;
+		if (event->get_fire_only_once() && !fired_once_events.emplace(event).second) {
+			continue;
+		}
+		T const& scope = scopes[fired_index.scope_index];
+		if constexpr (country_scopes) {
+			fired_events.push_back({ event, &scope, nullptr });
+		} else {
+			fired_events.push_back({ event, nullptr, &scope });
+		}
+	}
+}
+
+void EventScheduler::tick(InstanceManager const& instance_manager) {
+	fired_events.clear();
+	trigger_evaluation_count = 0;
+
+	_tick_scopes(
+		instance_manager, instance_manager.get_country_instance_manager().get_country_instances(), country_events,
+		country_event_index
+	);
+	_tick_scopes(
+		instance_manager, instance_manager.get_map_instance().get_province_instances(), province_events,
+		province_event_index
+	);
+}
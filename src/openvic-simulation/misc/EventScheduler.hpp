@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "openvic-simulation/types/Date.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/OrderedContainers.hpp"
+#include "openvic-simulation/utility/Getters.hpp"
+
+namespace OpenVic {
+	struct Event;
+	struct EventManager;
+	struct CountryDefinition;
+	struct CountryInstance;
+	struct ProvinceInstance;
+	struct FlagStrings;
+	struct Modifier;
+	struct ModifierInstance;
+	struct InstanceManager;
+	struct ConditionNode;
+
+	/* Decides which mean time to happen events fire each day. Rather than testing every event's trigger for every scope
+	 * daily, each event is indexed by a cheap prerequisite taken from its trigger (a tag, modifier or flag) so that only
+	 * scopes meeting it are considered, and each scope is only checked every CHECK_INTERVAL days, on a day staggered by
+	 * its index, with the chance of the event happening at some point in that interval. */
+	struct EventScheduler {
+		static constexpr Timespan::day_t CHECK_INTERVAL = 20;
+
+		struct fired_event_t {
+			Event const* event;
+			// Only the one matching the event's type is set.
+			CountryInstance const* country;
+			ProvinceInstance const* province;
+		};
+
+		/* Requirements taken from the conditions ANDed together at the top of an event's trigger, any of which may be
+		 * unset. A scope failing any of them cannot satisfy the trigger. */
+		struct prerequisites_t {
+			CountryDefinition const* tag = nullptr;
+			Modifier const* modifier = nullptr;
+			std::string flag;
+			std::vector<std::string> global_flags;
+			Date::year_t min_year = 0;
+		};
+
+		// Each event is listed under its most selective prerequisite only, tag then modifier then flag.
+		struct event_index_t {
+		private:
+			ordered_map<CountryDefinition const*, std::vector<size_t>> by_tag;
+			ordered_map<Modifier const*, std::vector<size_t>> by_modifier;
+			string_map_t<std::vector<size_t>> by_flag;
+			std::vector<size_t> unindexed;
+
+		public:
+			void add_event(prerequisites_t const& prerequisites, size_t event_index);
+			void clear();
+
+			/* Replaces candidates with the indices, in ascending order and without duplicates, of the events whose
+			 * indexed prerequisite the scope meets. tag is nullptr for province scopes. */
+			void get_candidates(
+				CountryDefinition const* tag, FlagStrings const& flags,
+				std::vector<ModifierInstance> const& event_modifiers, std::vector<size_t>& candidates
+			) const;
+		};
+
+	private:
+		struct scheduled_event_t {
+			Event const* event;
+			prerequisites_t prerequisites;
+		};
+
+		// An event, given by its index, which fired for a scope, given by its index.
+		struct fired_index_t {
+			size_t scope_index;
+			size_t event_index;
+
+			friend constexpr auto operator<=>(fired_index_t const&, fired_index_t const&) = default;
+		};
+
+		std::vector<scheduled_event_t> country_events, province_events;
+		event_index_t country_event_index, province_event_index;
+		ordered_set<Event const*> fired_once_events;
+
+		std::vector<fired_event_t> PROPERTY(fired_events);
+		// The number of triggers evaluated on the last tick, after candidates were filtered by their prerequisites.
+		size_t PROPERTY(trigger_evaluation_count, 0);
+
+		static void _extract_prerequisites(
+			ConditionNode const& node, bool country_event, prerequisites_t& prerequisites
+		);
+		bool _is_event_active(scheduled_event_t const& scheduled_event, InstanceManager const& instance_manager) const;
+
+		template<typename T>
+		void _tick_scopes(
+			InstanceManager const& instance_manager, std::vector<T> const& scopes,
+			std::vector<scheduled_event_t> const& events, event_index_t const& event_index
+		);
+
+	public:
+		// Events whose triggers use unsupported conditions are left out, and listed in a warning.
+		void setup(EventManager const& event_manager);
+
+		// Replaces fired_events with the events which fire today.
+		void tick(InstanceManager const& instance_manager);
+
+		/* The chance of an event with the given mean time to happen in days firing at some point over CHECK_INTERVAL
+		 * days, treating it as having a 1 / mean_time_to_happen chance of firing each day. */
+		static fixed_point_t get_interval_probability(fixed_point_t mean_time_to_happen);
+
+		static prerequisites_t get_prerequisites(ConditionNode const& trigger, bool country_event);
+
+		/* Scopes are checked on the day their index is congruent to modulo CHECK_INTERVAL, so this is the index of the
+		 * first scope checked on the given day, followed by every CHECK_INTERVAL-th scope after it. */
+		static size_t get_first_checked_scope(Date today);
+
+		/* A deterministic roll in [0, 1) for an event and scope on a given day, so that results do not depend on
+		 * thread scheduling. */
+		static fixed_point_t get_event_roll(size_t event_index, size_t scope_index, Timespan::day_t day);
+	};
+}
@@ -0,0 +1,104 @@
+#include "DenseModifierValue.hpp"
+
+#include <algorithm>
+
+#include "openvic-simulation/modifier/ModifierValue.hpp"
+
+using namespace OpenVic;
+
+fixed_point_t& DenseModifierValue::get_effect_ref(ModifierEffect const& effect) {
+	std::vector<fixed_point_t>& values = values_by_target[effect.get_target_slot()];
+	if (effect.get_index() >= values.size()) {
+		values.resize(effect.get_index() + 1);
+	}
+	return values[effect.get_index()];
+}
+
+void DenseModifierValue::clear() {
+	for (std::vector<fixed_point_t>& values : values_by_target) {
+		std::fill(values.begin(), values.end(), fixed_point_t::_0());
+	}
+}
+
+fixed_point_t DenseModifierValue::get_effect(ModifierEffect const& effect) const {
+	std::vector<fixed_point_t> const& values = values_by_target[effect.get_target_slot()];
+	return effect.get_index() < values.size() ? values[effect.get_index()] : fixed_point_t::_0();
+}
+
+void DenseModifierValue::multiply_add_exclude_targets(
+	ModifierValue const& other, fixed_point_t multiplier, ModifierEffect::target_t excluded_targets
+) {
+	// Multiplying by 1 is exact, so skipping it doesn't change the result
+	if (multiplier == fixed_point_t::_1()) {
+		for (ModifierValue::effect_map_t::value_type const& value : other.get_values()) {
+			if (ModifierEffect::excludes_targets(value.first->get_targets(), excluded_targets)) {
+				get_effect_ref(*value.first) += value.second;
+			}
+		}
+	} else if (multiplier != fixed_point_t::_0()) {
+		for (ModifierValue::effect_map_t::value_type const& value : other.get_values()) {
+			if (ModifierEffect::excludes_targets(value.first->get_targets(), excluded_targets)) {
+				get_effect_ref(*value.first) += value.second * multiplier;
+			}
+		}
+	}
+}
+
+void DenseModifierValue::multiply_subtract_exclude_targets(
+	ModifierValue const& other, fixed_point_t multiplier, ModifierEffect::target_t excluded_targets
+) {
+	if (multiplier == fixed_point_t::_1()) {
+		for (ModifierValue::effect_map_t::value_type const& value : other.get_values()) {
+			if (ModifierEffect::excludes_targets(value.first->get_targets(), excluded_targets)) {
+				get_effect_ref(*value.first) -= value.second;
+			}
+		}
+	} else if (multiplier != fixed_point_t::_0()) {
+		for (ModifierValue::effect_map_t::value_type const& value : other.get_values()) {
+			if (ModifierEffect::excludes_targets(value.first->get_targets(), excluded_targets)) {
+				get_effect_ref(*value.first) -= value.second * multiplier;
+			}
+		}
+	}
+}
+
+void DenseModifierValue::add_exclude_targets(DenseModifierValue const& other, ModifierEffect::target_t excluded_targets) {
+	for (size_t slot = 0; slot < ModifierEffect::TARGET_COUNT; ++slot) {
+		if (ModifierEffect::excludes_targets(static_cast<ModifierEffect::target_t>(1 << slot), excluded_targets)) {
+			std::vector<fixed_point_t> const& other_values = other.values_by_target[slot];
+			std::vector<fixed_point_t>& values = values_by_target[slot];
+
+			if (values.size() < other_values.size()) {
+				values.resize(other_values.size());
+			}
+
+			// Plain element-wise loop over contiguous arrays, left for the compiler to vectorise
+			fixed_point_t* const values_data = values.data();
+			fixed_point_t const* const other_values_data = other_values.data();
+			for (size_t index = 0; index < other_values.size(); ++index) {
+				values_data[index] += other_values_data[index];
+			}
+		}
+	}
+}
+
+bool DenseModifierValue::operator==(DenseModifierValue const& other) const {
+	const auto is_zero = [](fixed_point_t value) -> bool {
+		return value == fixed_point_t::_0();
+	};
+
+	for (size_t slot = 0; slot < ModifierEffect::TARGET_COUNT; ++slot) {
+		std::vector<fixed_point_t> const& values = values_by_target[slot];
+		std::vector<fixed_point_t> const& other_values = other.values_by_target[slot];
+		const size_t common_size = std::min(values.size(), other_values.size());
+
+		if (
+			!std::equal(values.begin(), values.begin() + common_size, other_values.begin()) ||
+			!std::all_of(values.begin() + common_size, values.end(), is_zero) ||
+			!std::all_of(other_values.begin() + common_size, other_values.end(), is_zero)
+		) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "openvic-simulation/modifier/ModifierEffect.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+namespace OpenVic {
+	struct ModifierValue;
+
+	/* Summed effect values stored as one fixed_point_t array per target, indexed by each effect's index within its target.
+	 * Modifier definitions stay as sparse ModifierValues, but sums are read for every entity every day, so here a lookup
+	 * is a single array access and adding one dense value to another is a plain loop over arrays. Every effect has exactly
+	 * one target, so excluding a target means skipping its whole array. Effects which were never added read as zero, and
+	 * arrays grow on demand, so no effect count is needed up front. */
+	struct DenseModifierValue {
+	private:
+		std::array<std::vector<fixed_point_t>, ModifierEffect::TARGET_COUNT> values_by_target;
+
+		fixed_point_t& get_effect_ref(ModifierEffect const& effect);
+
+	public:
+		// Zeroes every value while keeping the arrays' sizes, so rebuilding a sum doesn't reallocate.
+		void clear();
+
+		fixed_point_t get_effect(ModifierEffect const& effect) const;
+
+		void multiply_add_exclude_targets(
+			ModifierValue const& other, fixed_point_t multiplier, ModifierEffect::target_t excluded_targets
+		);
+		// Exact inverse of multiply_add_exclude_targets with the same arguments, as each effect's scaled value is calculated
+		// the same way before being subtracted.
+		void multiply_subtract_exclude_targets(
+			ModifierValue const& other, fixed_point_t multiplier, ModifierEffect::target_t excluded_targets
+		);
+		void add_exclude_targets(DenseModifierValue const& other, ModifierEffect::target_t excluded_targets);
+
+		// Values are compared as if both had the same array sizes, with missing values being zero.
+		bool operator==(DenseModifierValue const& other) const;
+	};
+}
@@ -54,7 +54,7 @@ namespace OpenVic {
 		friend struct ModifierManager;
 
 	private:
-		ConditionScript trigger;
+		ConditionScript PROPERTY(trigger);
 
 	protected:
 		TriggeredModifier(
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <bit>
 #include <string>
 #include <string_view>
 
@@ -9,7 +10,9 @@
 namespace OpenVic {
 	struct ModifierManager;
 
-	struct ModifierEffect : HasIdentifier {
+	/* Each effect has exactly one target, and its index is its position among the effects sharing that target, in
+	 * registration order. This lets dense sums of effects be stored as one array per target, see DenseModifierValue. */
+	struct ModifierEffect : HasIdentifier, HasIndex<> {
 		friend struct ModifierManager;
 
 		enum class format_t : uint8_t {
@@ -27,7 +30,13 @@ namespace OpenVic {
 			ALL_TARGETS = (1 << 3) - 1
 		};
 
+		static constexpr size_t TARGET_COUNT = std::bit_width(static_cast<uint8_t>(target_t::ALL_TARGETS));
+
 		static constexpr bool excludes_targets(target_t targets, target_t excluded_target);
+		// Position of a single target in [0, TARGET_COUNT), e.g. for indexing arrays with one element per target.
+		static constexpr size_t get_target_slot(target_t single_target) {
+			return std::countr_zero(static_cast<uint8_t>(single_target));
+		}
 
 		static std::string target_to_string(target_t target);
 
@@ -46,8 +55,8 @@ namespace OpenVic {
 		// TODO - format/precision, e.g. 80% vs 0.8 vs 0.800, 2 vs 2.0 vs 200%
 
 		ModifierEffect(
-			std::string_view new_identifier, bool new_is_positive_good, format_t new_format, target_t new_targets,
-			std::string_view new_localisation_key, bool new_has_no_effect
+			std::string_view new_identifier, index_t new_index, bool new_is_positive_good, format_t new_format,
+			target_t new_targets, std::string_view new_localisation_key, bool new_has_no_effect
 		);
 
 	public:
@@ -60,6 +69,9 @@ namespace OpenVic {
 		inline constexpr bool is_local() const {
 			return !is_global();
 		}
+		inline constexpr size_t get_target_slot() const {
+			return get_target_slot(targets);
+		}
 	};
 
 	template<> struct enable_bitfield<ModifierEffect::target_t> : std::true_type {};
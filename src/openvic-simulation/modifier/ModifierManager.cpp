@@ -59,12 +59,15 @@ bool ModifierManager::_register_modifier_effect(
 		return false;
 	}
 
+	size_t& target_effect_count = modifier_effect_counts[ModifierEffect::get_target_slot(targets)];
+
 	const bool ret = registry.add_item({
-		std::move(identifier), is_positive_good, format, targets, localisation_key, has_no_effect
+		std::move(identifier), target_effect_count, is_positive_good, format, targets, localisation_key, has_no_effect
 	});
 
 	if (ret) {
 		effect_cache = &registry.back();
+		++target_effect_count;
 	}
 
 	return ret;
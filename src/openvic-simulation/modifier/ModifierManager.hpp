@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string_view>
 
 #include "openvic-simulation/modifier/Modifier.hpp"
@@ -33,6 +34,8 @@ namespace OpenVic {
 		modifier_effect_registry_t IDENTIFIER_REGISTRY(base_province_modifier_effect);
 		modifier_effect_registry_t IDENTIFIER_REGISTRY(terrain_modifier_effect);
 		case_insensitive_string_set_t complex_modifiers;
+		// Number of effects registered with each target, used to give each effect its index within its target.
+		std::array<size_t, ModifierEffect::TARGET_COUNT> modifier_effect_counts {};
 
 		IdentifierRegistry<IconModifier> IDENTIFIER_REGISTRY(event_modifier);
 		IdentifierRegistry<TriggeredModifier> IDENTIFIER_REGISTRY(triggered_modifier);
@@ -1,5 +1,7 @@
 #include "ModifierSum.hpp"
 
+#include <algorithm>
+
 #include "openvic-simulation/modifier/Modifier.hpp"
 
 #include "openvic-simulation/country/CountryInstance.hpp"
@@ -33,11 +35,15 @@ bool ModifierSum::empty() {
 }
 
 fixed_point_t ModifierSum::get_modifier_effect_value(ModifierEffect const& effect, bool* effect_found) const {
-	return value_sum.get_effect(effect, effect_found);
+	const fixed_point_t value = value_sum.get_effect(effect);
+	if (effect_found != nullptr) {
+		*effect_found = value != fixed_point_t::_0();
+	}
+	return value;
 }
 
 bool ModifierSum::has_modifier_effect(ModifierEffect const& effect) const {
-	return value_sum.has_effect(effect);
+	return value_sum.get_effect(effect) != fixed_point_t::_0();
 }
 
 void ModifierSum::add_modifier(
@@ -60,14 +66,46 @@ void ModifierSum::add_modifier(
 void ModifierSum::add_modifier_sum(ModifierSum const& modifier_sum) {
 	reserve_more(modifiers, modifier_sum.modifiers.size());
 
-	// We could test that excluded_targets != ALL_TARGETS, but in practice it's always
-	// called with an explcit/hardcoded value and so won't ever exclude everything.
+	// Entries in a sum never have a multiplier of zero, as add_modifier skips them
 	for (modifier_entry_t const& modifier_entry : modifier_sum.modifiers) {
-		add_modifier(
+		modifiers.emplace_back(
 			modifier_entry.modifier,
 			modifier_entry.multiplier,
-			modifier_entry.source,
-			modifier_entry.excluded_targets
+			modifier_entry_t::source_or_null_fallback(modifier_entry.source, this_source),
+			modifier_entry.excluded_targets | this_excluded_targets
 		);
 	}
+
+	value_sum.add_exclude_targets(modifier_sum.value_sum, this_excluded_targets);
+}
+
+bool ModifierSum::remove_modifier(
+	Modifier const& modifier, fixed_point_t multiplier, modifier_entry_t::modifier_source_t const& source,
+	ModifierEffect::target_t excluded_targets
+) {
+	// add_modifier never adds entries with a multiplier of zero
+	if (multiplier == fixed_point_t::_0()) {
+		return true;
+	}
+
+	const modifier_entry_t entry {
+		modifier,
+		multiplier,
+		modifier_entry_t::source_or_null_fallback(source, this_source),
+		excluded_targets | this_excluded_targets
+	};
+
+	const std::vector<modifier_entry_t>::const_iterator it = std::find(modifiers.begin(), modifiers.end(), entry);
+	if (it == modifiers.end()) {
+		return false;
+	}
+
+	value_sum.multiply_subtract_exclude_targets(entry.modifier, entry.multiplier, entry.excluded_targets);
+	modifiers.erase(it);
+	return true;
+}
+
+bool ModifierSum::is_equivalent_to(ModifierSum const& other) const {
+	return value_sum == other.value_sum &&
+		std::is_permutation(modifiers.begin(), modifiers.end(), other.modifiers.begin(), other.modifiers.end());
 }
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <concepts>
+#include <memory>
 #include <variant>
 
 #include "openvic-simulation/dataloader/NodeTools.hpp"
+#include "openvic-simulation/modifier/DenseModifierValue.hpp"
 #include "openvic-simulation/modifier/ModifierValue.hpp"
 #include "openvic-simulation/modifier/Modifier.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
@@ -46,6 +48,16 @@ namespace OpenVic {
 			source { new_source },
 			excluded_targets { new_excluded_targets } {}
 
+		constexpr modifier_entry_t(modifier_entry_t const&) = default;
+		// Rebinds the modifier reference rather than being implicitly deleted, so entries can be erased from a vector.
+		constexpr modifier_entry_t& operator=(modifier_entry_t const& other) {
+			if (this != &other) {
+				std::destroy_at(this);
+				std::construct_at(this, other);
+			}
+			return *this;
+		}
+
 		constexpr bool operator==(modifier_entry_t const& other) const {
 			return &modifier == &other.modifier
 				&& multiplier == other.multiplier
@@ -95,7 +107,7 @@ namespace OpenVic {
 		ModifierEffect::target_t PROPERTY_RW(this_excluded_targets, ModifierEffect::target_t::NO_TARGETS);
 
 		std::vector<modifier_entry_t> PROPERTY(modifiers);
-		ModifierValue PROPERTY(value_sum);
+		DenseModifierValue PROPERTY(value_sum);
 
 	public:
 		ModifierSum() = default;
@@ -107,6 +119,7 @@ namespace OpenVic {
 		void clear();
 		bool empty();
 
+		// As value_sum is dense, an effect is only considered found/present if its summed value is non-zero.
 		fixed_point_t get_modifier_effect_value(ModifierEffect const& effect, bool* effect_found = nullptr) const;
 		bool has_modifier_effect(ModifierEffect const& effect) const;
 
@@ -116,11 +129,24 @@ namespace OpenVic {
 			modifier_entry_t::modifier_source_t const& source = {},
 			ModifierEffect::target_t excluded_targets = ModifierEffect::target_t::NO_TARGETS
 		);
-		// Reserves space for the number of modifier entries in the given sum and adds each of them using add_modifier
+		// Reserves space for the number of modifier entries in the given sum and appends each of them as add_modifier would
 		// with the modifier entries' attributes as arguments. This means non-null sources are preserved (null ones are
 		// replaced with this_source, but in practice the other sum should've set them itself already) and exclusion targets
-		// are combined with this_excluded_targets.
+		// are combined with this_excluded_targets. The other sum's values already account for its entries' exclusions, so
+		// its value_sum is added as a whole, skipping only the arrays of this sum's excluded targets.
 		void add_modifier_sum(ModifierSum const& modifier_sum);
+		// Removes the entry added by an add_modifier call with the same arguments and subtracts exactly the value it added,
+		// so a sum maintained by adding and removing modifiers as they change matches one rebuilt from scratch (apart from
+		// entry order). Returns false if there is no matching entry.
+		bool remove_modifier(
+			Modifier const& modifier,
+			fixed_point_t multiplier = fixed_point_t::_1(),
+			modifier_entry_t::modifier_source_t const& source = {},
+			ModifierEffect::target_t excluded_targets = ModifierEffect::target_t::NO_TARGETS
+		);
+
+		// Checks whether both sums have the same entries, in any order, and the same effect values.
+		bool is_equivalent_to(ModifierSum const& other) const;
 
 		// TODO - help calculate value_sum[effect]? Early return if lookup in value_sum fails?
 		constexpr void for_each_contributing_modifier(
@@ -0,0 +1,182 @@
+#include "TriggeredModifierCache.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/InstanceManager.hpp"
+#include "openvic-simulation/modifier/Modifier.hpp"
+#include "openvic-simulation/utility/Logger.hpp"
+
+using namespace OpenVic;
+
+using dependency_t = TriggeredModifierCache::dependency_t;
+
+bool TriggeredModifierCache::country_state_t::is_active(size_t trigger_index) const {
+	return trigger_index < active.size() && active[trigger_index];
+}
+
+static constexpr dependency_t get_opcode_dependencies(ConditionBytecode::opcode_t opcode) {
+	using enum ConditionBytecode::opcode_t;
+
+	switch (opcode) {
+	// Control flow and leaves whose result can never change for a given country.
+	case ALWAYS_TRUE:
+	case ALWAYS_FALSE:
+	case UNSUPPORTED:
+	case NOT:
+	case JUMP_IF_FALSE:
+	case JUMP_IF_TRUE:
+	case SCOPE_THIS:
+	case TAG:
+		return dependency_t::NO_DEPENDENCIES;
+	case TECHNOLOGY:
+	case INVENTION:
+		return dependency_t::TECHNOLOGY;
+	case REFORM:
+	case GOVERNMENT:
+	case NATIONAL_VALUE:
+	case TECH_SCHOOL:
+		return dependency_t::POLITICS;
+	case HAS_COUNTRY_FLAG:
+		return dependency_t::COUNTRY_FLAGS;
+	case HAS_GLOBAL_FLAG:
+		return dependency_t::GLOBAL_FLAGS;
+	case AT_WAR:
+		return dependency_t::WAR;
+	case LITERACY:
+		return dependency_t::LITERACY;
+	default:
+		return dependency_t::VOLATILE;
+	}
+}
+
+void TriggeredModifierCache::setup(std::vector<TriggeredModifier> const& triggered_modifiers) {
+	triggers.clear();
+	triggers.reserve(triggered_modifiers.size());
+
+	std::string unsupported_modifiers;
+
+	for (TriggeredModifier const& modifier : triggered_modifiers) {
+		ConditionBytecode const& bytecode = modifier.get_trigger().get_bytecode();
+		trigger_t& trigger = triggers.emplace_back(trigger_t {
+			&modifier, dependency_t::NO_DEPENDENCIES, {}, bytecode.get_unsupported_count() == 0
+		});
+
+		if (!trigger.supported) {
+			if (!unsupported_modifiers.empty()) {
+				unsupported_modifiers += ", ";
+			}
+			unsupported_modifiers += modifier.get_identifier();
+			continue;
+		}
+
+		for (ConditionBytecode::instruction_t const& instruction : bytecode.get_instructions()) {
+			trigger.dependencies |= get_opcode_dependencies(instruction.opcode);
+			if (instruction.opcode == ConditionBytecode::opcode_t::LITERACY) {
+				trigger.literacy_thresholds.push_back(instruction.value);
+			}
+		}
+
+		std::sort(trigger.literacy_thresholds.begin(), trigger.literacy_thresholds.end());
+		trigger.literacy_thresholds.erase(
+			std::unique(trigger.literacy_thresholds.begin(), trigger.literacy_thresholds.end()),
+			trigger.literacy_thresholds.end()
+		);
+	}
+
+	if (!unsupported_modifiers.empty()) {
+		Logger::warning(
+			"Triggered modifiers whose triggers use unsupported conditions will never apply: ", unsupported_modifiers
+		);
+	}
+}
+
+size_t TriggeredModifierCache::get_trigger_count() const {
+	return triggers.size();
+}
+
+TriggeredModifier const& TriggeredModifierCache::get_triggered_modifier(size_t trigger_index) const {
+	return *triggers[trigger_index].modifier;
+}
+
+dependency_t TriggeredModifierCache::get_dependencies(size_t trigger_index) const {
+	return triggers[trigger_index].dependencies;
+}
+
+bool TriggeredModifierCache::is_supported(size_t trigger_index) const {
+	return triggers[trigger_index].supported;
+}
+
+std::span<const fixed_point_t> TriggeredModifierCache::get_literacy_thresholds(size_t trigger_index) const {
+	return triggers[trigger_index].literacy_thresholds;
+}
+
+bool TriggeredModifierCache::is_literacy_threshold_crossed(
+	std::span<const fixed_point_t> thresholds, fixed_point_t old_literacy, fixed_point_t new_literacy
+) {
+	const fixed_point_t min_literacy = std::min(old_literacy, new_literacy);
+	const fixed_point_t max_literacy = std::max(old_literacy, new_literacy);
+
+	const auto threshold = std::upper_bound(thresholds.begin(), thresholds.end(), min_literacy);
+	return threshold != thresholds.end() && *threshold <= max_literacy;
+}
+
+void TriggeredModifierCache::update_country(
+	InstanceManager const& instance_manager, CountryInstance const& country, country_state_t& state,
+	std::vector<size_t>& changed, ConditionBytecode::profile_t* profile
+) const {
+	const bool first_update = state.active.size() != triggers.size();
+	if (first_update) {
+		state.active.assign(triggers.size(), false);
+	}
+
+	dependency_t changed_inputs = dependency_t::VOLATILE;
+	if (first_update || state.technology_revision != country.get_technology_revision()) {
+		changed_inputs |= dependency_t::TECHNOLOGY;
+	}
+	if (first_update || state.politics_revision != country.get_politics_revision()) {
+		changed_inputs |= dependency_t::POLITICS;
+	}
+	if (first_update || state.flag_revision != country.get_flag_revision()) {
+		changed_inputs |= dependency_t::COUNTRY_FLAGS;
+	}
+	if (first_update || state.global_flag_revision != instance_manager.get_global_flags().get_flag_revision()) {
+		changed_inputs |= dependency_t::GLOBAL_FLAGS;
+	}
+	if (first_update || state.at_war != country.is_at_war()) {
+		changed_inputs |= dependency_t::WAR;
+	}
+
+	const fixed_point_t new_literacy = country.get_national_literacy();
+
+	const ConditionBytecode::context_t context { instance_manager, &country, {} };
+
+	for (size_t index = 0; index < triggers.size(); ++index) {
+		trigger_t const& trigger = triggers[index];
+		if (!trigger.supported) {
+			continue;
+		}
+
+		bool needs_update = first_update || (trigger.dependencies & changed_inputs) != dependency_t::NO_DEPENDENCIES;
+
+		if (!needs_update && state.literacy != new_literacy) {
+			needs_update = is_literacy_threshold_crossed(trigger.literacy_thresholds, state.literacy, new_literacy);
+		}
+
+		if (needs_update) {
+			const bool active = trigger.modifier->get_trigger().get_bytecode().evaluate(context, &country, profile);
+			if (active != static_cast<bool>(state.active[index])) {
+				state.active[index] = active;
+				changed.push_back(index);
+			}
+		}
+	}
+
+	state.technology_revision = country.get_technology_revision();
+	state.politics_revision = country.get_politics_revision();
+	state.flag_revision = country.get_flag_revision();
+	state.global_flag_revision = instance_manager.get_global_flags().get_flag_revision();
+	state.at_war = country.is_at_war();
+	state.literacy = new_literacy;
+}
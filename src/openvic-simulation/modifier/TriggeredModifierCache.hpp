@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "openvic-simulation/scripts/ConditionBytecode.hpp"
+#include "openvic-simulation/types/EnumBitfield.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+namespace OpenVic {
+	struct TriggeredModifier;
+	struct CountryInstance;
+	struct InstanceManager;
+
+	/* Tracks which triggered modifiers apply to each country without re-evaluating every trigger daily. Each trigger's
+	 * compiled bytecode is scanned for the country state it reads, and it is only re-evaluated for a country once one of
+	 * those inputs has changed. Triggers reading anything untracked, including any other scope, are volatile and are
+	 * re-evaluated on every update. Triggers using unsupported conditions can't be evaluated, so are never active. */
+	struct TriggeredModifierCache {
+		enum struct dependency_t : uint8_t {
+			NO_DEPENDENCIES = 0,
+			TECHNOLOGY      = 1 << 0, // Technologies and inventions
+			POLITICS        = 1 << 1, // Reforms, government type, national value and tech school
+			COUNTRY_FLAGS   = 1 << 2,
+			GLOBAL_FLAGS    = 1 << 3,
+			WAR             = 1 << 4,
+			LITERACY        = 1 << 5, // National literacy crossing one of the trigger's thresholds
+			VOLATILE        = 1 << 6
+		};
+
+		// The inputs a country's triggers were last evaluated with, along with their results.
+		struct country_state_t {
+			friend struct TriggeredModifierCache;
+
+		private:
+			std::vector<uint8_t> active;
+			uint32_t technology_revision = 0;
+			uint32_t politics_revision = 0;
+			uint32_t flag_revision = 0;
+			uint32_t global_flag_revision = 0;
+			bool at_war = false;
+			fixed_point_t literacy;
+
+		public:
+			bool is_active(size_t trigger_index) const;
+		};
+
+	private:
+		struct trigger_t {
+			TriggeredModifier const* modifier;
+			dependency_t dependencies;
+			std::vector<fixed_point_t> literacy_thresholds;
+			bool supported;
+		};
+
+		std::vector<trigger_t> triggers;
+
+	public:
+		// Triggers using unsupported conditions are listed in a warning.
+		void setup(std::vector<TriggeredModifier> const& triggered_modifiers);
+
+		size_t get_trigger_count() const;
+		TriggeredModifier const& get_triggered_modifier(size_t trigger_index) const;
+		dependency_t get_dependencies(size_t trigger_index) const;
+		// False if the trigger uses unsupported conditions, in which case it is never evaluated or active.
+		bool is_supported(size_t trigger_index) const;
+		// The distinct thresholds of the trigger's literacy leaves, in ascending order.
+		std::span<const fixed_point_t> get_literacy_thresholds(size_t trigger_index) const;
+
+		/* Whether a literacy >= threshold leaf can change result when literacy goes from old_literacy to new_literacy
+		 * (in either direction), i.e. whether any of the sorted thresholds lies in (min, max] of the two. */
+		static bool is_literacy_threshold_crossed(
+			std::span<const fixed_point_t> thresholds, fixed_point_t old_literacy, fixed_point_t new_literacy
+		);
+
+		/* Re-evaluates the triggers of country whose inputs differ from those recorded in state, appending the indices
+		 * of those whose result changed to changed. Every trigger is evaluated on a state's first update. Profiling
+		 * counts for the evaluated triggers are added to profile if it isn't null. */
+		void update_country(
+			InstanceManager const& instance_manager, CountryInstance const& country, country_state_t& state,
+			std::vector<size_t>& changed, ConditionBytecode::profile_t* profile = nullptr
+		) const;
+	};
+
+	template<> struct enable_bitfield<TriggeredModifierCache::dependency_t> : std::true_type {};
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "openvic-simulation/pathfinding/FlatAStarPathing.hpp"
+#include "openvic-simulation/pathfinding/FlatPointGraph.hpp"
+#include "openvic-simulation/pathfinding/PointMap.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/utility/ErrorMacros.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
+
+namespace OpenVic {
+	/** Batched A* and reachability queries over a PointMap
+
+		Answers many queries in one call, spread over the ThreadPool. Every pool thread runs its share of the queries with
+		its own FlatAStarSearch over a single shared FlatPointGraph, appending results to its own buffers, which are then
+		gathered into flat result arrays in query order. Results are identical for any worker count.
+
+		Only one batch may run on a given BatchPathing at a time, as the per-thread scratch belongs to the object.
+		Requires that any change to the PointMap must call reset_search()
+	 */
+	template<PathingCostPolicy CostPolicy = EuclideanPathingCostPolicy>
+	struct BatchPathing {
+		using point_index_t = FlatPointGraph::point_index_t;
+		using point_id_t = PointMap::points_key_type;
+
+		static constexpr fixed_point_t NO_PATH_COST = fixed_point_t::max();
+
+		struct path_query_t {
+			point_id_t from;
+			point_id_t to;
+		};
+
+		struct reachable_query_t {
+			point_id_t from;
+			fixed_point_t max_cost;
+		};
+
+		// The path of query i is point_ids[offsets[i], offsets[i + 1]), empty if no path was found.
+		struct path_batch_t {
+			std::vector<size_t> offsets;
+			std::vector<point_id_t> point_ids;
+			// Total cost of each query's path, NO_PATH_COST if no path was found.
+			std::vector<fixed_point_t> costs;
+
+			size_t get_query_count() const {
+				return costs.size();
+			}
+
+			std::span<const point_id_t> get_path(size_t query) const {
+				return { point_ids.data() + offsets[query], point_ids.data() + offsets[query + 1] };
+			}
+		};
+
+		/* The points reached by query i, and the cost of reaching each of them, are point_ids and costs in
+		 * [offsets[i], offsets[i + 1]), ordered by increasing cost. */
+		struct reachable_batch_t {
+			std::vector<size_t> offsets;
+			std::vector<point_id_t> point_ids;
+			std::vector<fixed_point_t> costs;
+
+			size_t get_query_count() const {
+				return offsets.empty() ? 0 : offsets.size() - 1;
+			}
+
+			std::span<const point_id_t> get_point_ids(size_t query) const {
+				return { point_ids.data() + offsets[query], point_ids.data() + offsets[query + 1] };
+			}
+
+			std::span<const fixed_point_t> get_costs(size_t query) const {
+				return { costs.data() + offsets[query], costs.data() + offsets[query + 1] };
+			}
+		};
+
+	private:
+		// Where a query's results were written in its worker's buffers.
+		struct result_location_t {
+			size_t worker;
+			size_t begin;
+			size_t size;
+		};
+
+		struct worker_scratch_t {
+			FlatAStarSearch<CostPolicy> search;
+			std::vector<point_id_t> point_ids;
+			std::vector<fixed_point_t> costs;
+		};
+
+		PointMap const* point_map;
+		FlatPointGraph graph;
+		std::vector<worker_scratch_t> worker_scratch;
+		std::vector<result_location_t> result_locations;
+
+		void _prepare_workers() {
+			const size_t worker_count = ThreadPool::get_instance().get_worker_count();
+			if (worker_scratch.size() != worker_count) {
+				worker_scratch.resize(worker_count);
+				for (worker_scratch_t& scratch : worker_scratch) {
+					scratch.search.resize(graph.get_point_count());
+				}
+			}
+			for (worker_scratch_t& scratch : worker_scratch) {
+				scratch.point_ids.clear();
+				scratch.costs.clear();
+			}
+		}
+
+		/* Turns result_locations into offsets into the flat arrays, then copies every query's results from its worker's
+		 * buffers. Costs are only gathered when per_point_costs is set, otherwise they are one per query. */
+		void _gather_results(
+			std::vector<size_t>& offsets, std::vector<point_id_t>& point_ids, std::vector<fixed_point_t>* per_point_costs
+		) const {
+			const size_t query_count = result_locations.size();
+
+			offsets.resize(query_count + 1);
+			size_t total_size = 0;
+			for (size_t query = 0; query < query_count; ++query) {
+				offsets[query] = total_size;
+				total_size += result_locations[query].size;
+			}
+			offsets[query_count] = total_size;
+
+			point_ids.resize(total_size);
+			if (per_point_costs != nullptr) {
+				per_point_costs->resize(total_size);
+			}
+
+			ThreadPool::get_instance().parallel_for(
+				query_count,
+				[this, &offsets, &point_ids, per_point_costs](size_t begin, size_t end) -> void {
+					for (size_t query = begin; query < end; ++query) {
+						result_location_t const& location = result_locations[query];
+						worker_scratch_t const& scratch = worker_scratch[location.worker];
+						std::copy_n(
+							scratch.point_ids.begin() + location.begin, location.size, point_ids.begin() + offsets[query]
+						);
+						if (per_point_costs != nullptr) {
+							std::copy_n(
+								scratch.costs.begin() + location.begin, location.size,
+								per_point_costs->begin() + offsets[query]
+							);
+						}
+					}
+				}
+			);
+		}
+
+	public:
+		BatchPathing(PointMap const* map) : point_map(map) {
+			reset_search();
+		}
+
+		BatchPathing(PointMap const& map) : BatchPathing(&map) {}
+
+		PointMap const& get_point_map() const {
+			return *point_map;
+		}
+
+		FlatPointGraph const& get_graph() const {
+			return graph;
+		}
+
+		void reset_search() {
+			graph.build(*point_map);
+			worker_scratch.clear();
+		}
+
+		// Fills result with the path of each query, as FlatAStarPathing::get_id_path would find it.
+		void find_paths(std::span<const path_query_t> queries, path_batch_t& result, bool allow_partial_path = false) {
+			_prepare_workers();
+			result_locations.resize(queries.size());
+			result.costs.resize(queries.size());
+
+			ThreadPool::get_instance().parallel_for(
+				queries.size(),
+				[this, queries, &result, allow_partial_path](size_t begin, size_t end) -> void {
+					const size_t worker = ThreadPool::get_current_worker_index();
+					worker_scratch_t& scratch = worker_scratch[worker];
+
+					for (size_t query = begin; query < end; ++query) {
+						path_query_t const& path_query = queries[query];
+						result_location_t& location = result_locations[query];
+						location = { worker, scratch.point_ids.size(), 0 };
+						result.costs[query] = NO_PATH_COST;
+
+						const point_index_t from_index = graph.get_index(path_query.from);
+						const point_index_t to_index = graph.get_index(path_query.to);
+						OV_ERR_CONTINUE_MSG(
+							from_index == FlatPointGraph::INVALID_INDEX || to_index == FlatPointGraph::INVALID_INDEX,
+							fmt::format(
+								"Can't get id path. Point with id: {} or {} doesn't exist.", path_query.from, path_query.to
+							)
+						);
+
+						if (from_index == to_index) {
+							scratch.point_ids.push_back(path_query.from);
+							location.size = 1;
+							result.costs[query] = 0;
+							continue;
+						}
+
+						const point_index_t path_end =
+							scratch.search.find_path_end(graph, from_index, to_index, allow_partial_path);
+						if (path_end == FlatPointGraph::INVALID_INDEX) {
+							continue;
+						}
+
+						scratch.search.append_path(
+							from_index, path_end, scratch.point_ids, [this](point_index_t p) -> point_id_t {
+								return graph.get_id(p);
+							}
+						);
+						location.size = scratch.point_ids.size() - location.begin;
+						result.costs[query] = scratch.search.get_path_cost(path_end);
+					}
+				}
+			);
+
+			_gather_results(result.offsets, result.point_ids, nullptr);
+		}
+
+		/* Fills result with every enabled point reachable from each query's start point at a cost of at most the query's
+		 * max_cost, e.g. the provinces a unit can reach within a number of days when costs are scaled to travel time.
+		 * The start point itself is always included, at cost 0. */
+		void find_reachable(std::span<const reachable_query_t> queries, reachable_batch_t& result) {
+			_prepare_workers();
+			result_locations.resize(queries.size());
+
+			ThreadPool::get_instance().parallel_for(
+				queries.size(),
+				[this, queries](size_t begin, size_t end) -> void {
+					const size_t worker = ThreadPool::get_current_worker_index();
+					worker_scratch_t& scratch = worker_scratch[worker];
+
+					for (size_t query = begin; query < end; ++query) {
+						reachable_query_t const& reachable_query = queries[query];
+						result_location_t& location = result_locations[query];
+						location = { worker, scratch.point_ids.size(), 0 };
+
+						const point_index_t from_index = graph.get_index(reachable_query.from);
+						OV_ERR_CONTINUE_MSG(
+							from_index == FlatPointGraph::INVALID_INDEX,
+							fmt::format("Can't get reachable points. Point with id: {} doesn't exist.", reachable_query.from)
+						);
+
+						scratch.search.find_reachable(
+							graph, from_index, reachable_query.max_cost,
+							[this, &scratch](point_index_t p, fixed_point_t cost) -> void {
+								scratch.point_ids.push_back(graph.get_id(p));
+								scratch.costs.push_back(cost);
+							}
+						);
+						location.size = scratch.point_ids.size() - location.begin;
+					}
+				}
+			);
+
+			_gather_results(result.offsets, result.point_ids, &result.costs);
+		}
+	};
+}
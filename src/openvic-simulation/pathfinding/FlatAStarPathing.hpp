@@ -0,0 +1,393 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "openvic-simulation/pathfinding/FlatPointGraph.hpp"
+#include "openvic-simulation/pathfinding/PointMap.hpp"
+#include "openvic-simulation/types/Vector.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/utility/ErrorMacros.hpp"
+
+namespace OpenVic {
+	template<typename T>
+	concept PathingCostPolicy = requires(ivec2_t const& from, ivec2_t const& to) {
+		{ T::estimate_cost(from, to) } -> std::same_as<fixed_point_t>;
+		{ T::compute_cost(from, to) } -> std::same_as<fixed_point_t>;
+	};
+
+	// Same costs as PathingBase's default _estimate_cost and _compute_cost.
+	struct EuclideanPathingCostPolicy {
+		static fixed_point_t estimate_cost(ivec2_t const& from, ivec2_t const& to) {
+			return fixed_point_t { from.distance_squared(to) }.sqrt();
+		}
+
+		static fixed_point_t compute_cost(ivec2_t const& from, ivec2_t const& to) {
+			return fixed_point_t { from.distance_squared(to) }.sqrt();
+		}
+	};
+
+	/** Per-search state for A* over a FlatPointGraph
+
+		The search state of each point lives in flat arrays indexed by the point's dense graph index rather than in a hash
+		map keyed by point id. Entries are only valid when their pass matches the current query's, so nothing is cleared
+		between queries. The open list is a binary heap which tracks each point's position in it, so decreasing a point's
+		key is a sift up from its known position rather than a linear search, and costs come from a CostPolicy chosen at
+		compile time instead of virtual calls.
+
+		The graph is passed to every call rather than owned, so several searches (e.g. one per thread) can share one graph.
+		resize must be called whenever the graph's point count changes.
+	 */
+	template<PathingCostPolicy CostPolicy = EuclideanPathingCostPolicy>
+	struct FlatAStarSearch {
+		using point_index_t = FlatPointGraph::point_index_t;
+
+		static constexpr point_index_t INVALID_INDEX = FlatPointGraph::INVALID_INDEX;
+
+	private:
+		uint64_t current_pass = 1;
+
+		// Search state, one entry per graph point.
+		std::vector<uint64_t> open_passes;
+		std::vector<uint64_t> closed_passes;
+		std::vector<fixed_point_t> g_scores;
+		std::vector<fixed_point_t> f_scores;
+		// Used for getting closest_point_of_last_pathing_call.
+		std::vector<fixed_point_t> abs_f_scores;
+		std::vector<point_index_t> prev_points;
+		std::vector<point_index_t> heap_positions;
+
+		std::vector<point_index_t> open_heap;
+		point_index_t last_closest_point = INVALID_INDEX;
+
+		// Returns true when point a should be expanded before point b.
+		bool _is_better(point_index_t a, point_index_t b) const {
+			if (f_scores[a] != f_scores[b]) {
+				return f_scores[a] < f_scores[b];
+			}
+			// If the f_costs are the same then prioritize the points that are further away from the start.
+			return g_scores[a] > g_scores[b];
+		}
+
+		void _heap_place(point_index_t point, point_index_t position) {
+			open_heap[position] = point;
+			heap_positions[point] = position;
+		}
+
+		void _heap_sift_up(point_index_t position) {
+			const point_index_t point = open_heap[position];
+			while (position > 0) {
+				const point_index_t parent = (position - 1) / 2;
+				if (!_is_better(point, open_heap[parent])) {
+					break;
+				}
+				_heap_place(open_heap[parent], position);
+				position = parent;
+			}
+			_heap_place(point, position);
+		}
+
+		void _heap_sift_down(point_index_t position) {
+			const point_index_t point = open_heap[position];
+			const point_index_t size = open_heap.size();
+			while (true) {
+				point_index_t child = 2 * position + 1;
+				if (child >= size) {
+					break;
+				}
+				if (child + 1 < size && _is_better(open_heap[child + 1], open_heap[child])) {
+					++child;
+				}
+				if (!_is_better(open_heap[child], point)) {
+					break;
+				}
+				_heap_place(open_heap[child], position);
+				position = child;
+			}
+			_heap_place(point, position);
+		}
+
+		void _heap_push(point_index_t point) {
+			open_heap.push_back(point);
+			_heap_sift_up(open_heap.size() - 1);
+		}
+
+		point_index_t _heap_pop() {
+			const point_index_t top = open_heap.front();
+			const point_index_t last = open_heap.back();
+			open_heap.pop_back();
+			if (!open_heap.empty()) {
+				_heap_place(last, 0);
+				_heap_sift_down(0);
+			}
+			return top;
+		}
+
+		// Pushes begin_point as the only open point of a new pass and returns the pass.
+		uint64_t _start(point_index_t begin_point, fixed_point_t estimate) {
+			const uint64_t pass = current_pass++;
+			last_closest_point = INVALID_INDEX;
+			open_heap.clear();
+
+			g_scores[begin_point] = 0;
+			f_scores[begin_point] = estimate;
+			abs_f_scores[begin_point] = estimate;
+			open_passes[begin_point] = pass;
+			_heap_push(begin_point);
+
+			return pass;
+		}
+
+		// Relaxes the edge from p to e, with e's heuristic given by estimate(e_position).
+		template<typename EstimateFunc>
+		void _relax(
+			FlatPointGraph const& graph, point_index_t p, point_index_t e, uint64_t pass, EstimateFunc&& estimate
+		) {
+			ivec2_t const& e_position = graph.get_position(e);
+			const fixed_point_t tentative_g_score =
+				g_scores[p] + CostPolicy::compute_cost(graph.get_position(p), e_position) * graph.get_weight_scale(e);
+
+			const bool new_point = open_passes[e] != pass;
+			if (new_point) { // The point wasn't inside the open list.
+				open_passes[e] = pass;
+			} else if (tentative_g_score >= g_scores[e]) { // The new path is worse than the previous.
+				return;
+			}
+
+			prev_points[e] = p;
+			g_scores[e] = tentative_g_score;
+			abs_f_scores[e] = estimate(e_position);
+			f_scores[e] = g_scores[e] + abs_f_scores[e];
+
+			if (new_point) {
+				_heap_push(e);
+			} else {
+				// A lower g_score only ever improves the point's position in the heap.
+				_heap_sift_up(heap_positions[e]);
+			}
+		}
+
+		bool _solve(FlatPointGraph const& graph, point_index_t begin_point, point_index_t end_point, bool allow_partial_path) {
+			if (!graph.is_enabled(end_point) && !allow_partial_path) {
+				last_closest_point = INVALID_INDEX;
+				return false;
+			}
+
+			ivec2_t const& end_position = graph.get_position(end_point);
+			const auto estimate = [&end_position](ivec2_t const& position) -> fixed_point_t {
+				return CostPolicy::estimate_cost(position, end_position);
+			};
+
+			const uint64_t pass = _start(begin_point, estimate(graph.get_position(begin_point)));
+
+			while (!open_heap.empty()) {
+				const point_index_t p = open_heap.front(); // The currently processed point.
+
+				// Find point closer to end_point, or same distance to end_point but closer to begin_point.
+				if (
+					last_closest_point == INVALID_INDEX || abs_f_scores[last_closest_point] > abs_f_scores[p] ||
+					(abs_f_scores[last_closest_point] >= abs_f_scores[p] && g_scores[last_closest_point] > g_scores[p])
+				) {
+					last_closest_point = p;
+				}
+
+				if (p == end_point) {
+					return true;
+				}
+
+				_heap_pop(); // Remove the current point from the open list.
+				closed_passes[p] = pass; // Mark the point as closed.
+
+				for (const point_index_t e : graph.get_neighbors(p)) {
+					if (graph.is_enabled(e) && closed_passes[e] != pass) {
+						_relax(graph, p, e, pass, estimate);
+					}
+				}
+			}
+
+			return false;
+		}
+
+	public:
+		void resize(size_t point_count) {
+			open_passes.assign(point_count, 0);
+			closed_passes.assign(point_count, 0);
+			g_scores.assign(point_count, 0);
+			f_scores.assign(point_count, 0);
+			abs_f_scores.assign(point_count, 0);
+			prev_points.assign(point_count, INVALID_INDEX);
+			heap_positions.assign(point_count, 0);
+			open_heap.clear();
+			open_heap.reserve(point_count);
+			last_closest_point = INVALID_INDEX;
+		}
+
+		// Returns the end point of the found path, or INVALID_INDEX if no path (or partial path if allowed) exists.
+		point_index_t find_path_end(
+			FlatPointGraph const& graph, point_index_t from_index, point_index_t to_index, bool allow_partial_path
+		) {
+			if (!_solve(graph, from_index, to_index, allow_partial_path)) {
+				if (!allow_partial_path || last_closest_point == INVALID_INDEX) {
+					return INVALID_INDEX;
+				}
+
+				// Use closest point instead.
+				return last_closest_point;
+			}
+			return to_index;
+		}
+
+		// Cost of the path from the last search's begin point to a point it reached, e.g. the result of find_path_end.
+		fixed_point_t get_path_cost(point_index_t point_index) const {
+			return g_scores[point_index];
+		}
+
+		// Appends the values of the points on the last search's path from from_index to to_index, both included, to path.
+		template<typename T, typename Func>
+		void append_path(point_index_t from_index, point_index_t to_index, std::vector<T>& path, Func&& get_value) const {
+			size_t pc = 1; // Begin point
+			for (point_index_t p = to_index; p != from_index; p = prev_points[p]) {
+				pc++;
+			}
+
+			const size_t path_begin = path.size();
+			path.resize(path_begin + pc);
+
+			size_t idx = path_begin + pc - 1;
+			for (point_index_t p = to_index; p != from_index; p = prev_points[p]) {
+				path[idx--] = get_value(p);
+			}
+			path[path_begin] = get_value(from_index); // Assign first
+		}
+
+		/* Calls on_reached(point_index, cost) for from_index and every enabled point whose cheapest path from it costs at
+		 * most max_cost, in order of increasing cost. This is a Dijkstra search, so CostPolicy::estimate_cost is unused. */
+		template<typename Func>
+		void find_reachable(FlatPointGraph const& graph, point_index_t from_index, fixed_point_t max_cost, Func&& on_reached) {
+			const auto no_estimate = [](ivec2_t const& position) -> fixed_point_t {
+				return 0;
+			};
+
+			const uint64_t pass = _start(from_index, 0);
+
+			while (!open_heap.empty()) {
+				const point_index_t p = _heap_pop();
+				if (g_scores[p] > max_cost) {
+					break;
+				}
+				closed_passes[p] = pass;
+				on_reached(p, g_scores[p]);
+
+				for (const point_index_t e : graph.get_neighbors(p)) {
+					if (graph.is_enabled(e) && closed_passes[e] != pass) {
+						_relax(graph, p, e, pass, no_estimate);
+					}
+				}
+			}
+		}
+	};
+
+	/** A* Pathfinding implementation over a FlatPointGraph
+
+		Gives the same results as AStarPathing, using a FlatAStarSearch over a snapshot of the PointMap.
+
+		Requires that any change to the PointMap must call reset_search()
+	 */
+	template<PathingCostPolicy CostPolicy = EuclideanPathingCostPolicy>
+	struct FlatAStarPathing {
+		using point_index_t = FlatPointGraph::point_index_t;
+
+	private:
+		static constexpr point_index_t INVALID_INDEX = FlatPointGraph::INVALID_INDEX;
+
+		PointMap const* point_map;
+		FlatPointGraph graph;
+		FlatAStarSearch<CostPolicy> search;
+
+	public:
+		FlatAStarPathing(PointMap const* map) : point_map(map) {
+			reset_search();
+		}
+
+		FlatAStarPathing(PointMap const& map) : FlatAStarPathing(&map) {}
+
+		PointMap const& get_point_map() const {
+			return *point_map;
+		}
+
+		FlatPointGraph const& get_graph() const {
+			return graph;
+		}
+
+		void reset_search() {
+			graph.build(*point_map);
+			search.resize(graph.get_point_count());
+		}
+
+		std::vector<ivec2_t> get_point_path(
+			PointMap::points_key_type from_id, PointMap::points_key_type to_id, bool allow_partial_path = false
+		) {
+			const point_index_t from_index = graph.get_index(from_id);
+			OV_ERR_FAIL_COND_V_MSG(
+				from_index == INVALID_INDEX, std::vector<ivec2_t>(),
+				fmt::format("Can't get point path. Point with id: {} doesn't exist.", from_id)
+			);
+
+			const point_index_t to_index = graph.get_index(to_id);
+			OV_ERR_FAIL_COND_V_MSG(
+				to_index == INVALID_INDEX, std::vector<ivec2_t>(),
+				fmt::format("Can't get point path. Point with id: {} doesn't exist.", to_id)
+			);
+
+			if (from_index == to_index) {
+				return std::vector<ivec2_t> { graph.get_position(from_index) };
+			}
+
+			const point_index_t path_end = search.find_path_end(graph, from_index, to_index, allow_partial_path);
+			if (path_end == INVALID_INDEX) {
+				return std::vector<ivec2_t>();
+			}
+
+			std::vector<ivec2_t> path;
+			search.append_path(from_index, path_end, path, [this](point_index_t p) -> ivec2_t {
+				return graph.get_position(p);
+			});
+			return path;
+		}
+
+		std::vector<PointMap::points_key_type> get_id_path(
+			PointMap::points_key_type from_id, PointMap::points_key_type to_id, bool allow_partial_path = false
+		) {
+			const point_index_t from_index = graph.get_index(from_id);
+			OV_ERR_FAIL_COND_V_MSG(
+				from_index == INVALID_INDEX, std::vector<PointMap::points_key_type>(),
+				fmt::format("Can't get id path. Point with id: {} doesn't exist.", from_id)
+			);
+
+			const point_index_t to_index = graph.get_index(to_id);
+			OV_ERR_FAIL_COND_V_MSG(
+				to_index == INVALID_INDEX, std::vector<PointMap::points_key_type>(),
+				fmt::format("Can't get id path. Point with id: {} doesn't exist.", to_id)
+			);
+
+			if (from_index == to_index) {
+				return std::vector<PointMap::points_key_type> { from_id };
+			}
+
+			const point_index_t path_end = search.find_path_end(graph, from_index, to_index, allow_partial_path);
+			if (path_end == INVALID_INDEX) {
+				return std::vector<PointMap::points_key_type>();
+			}
+
+			std::vector<PointMap::points_key_type> path;
+			search.append_path(from_index, path_end, path, [this](point_index_t p) -> PointMap::points_key_type {
+				return graph.get_id(p);
+			});
+			return path;
+		}
+	};
+}
@@ -0,0 +1,64 @@
+#include "openvic-simulation/pathfinding/FlatPointGraph.hpp"
+
+#include <vector>
+
+#include <tsl/ordered_map.h>
+
+#include "openvic-simulation/pathfinding/PointMap.hpp"
+
+using namespace OpenVic;
+
+void FlatPointGraph::build(PointMap const& point_map) {
+	const std::vector<PointMap::points_key_type> point_ids = point_map.get_point_ids();
+
+	index_by_id.clear();
+	index_by_id.reserve(point_ids.size());
+	ids = point_ids;
+	positions.clear();
+	positions.reserve(point_ids.size());
+	weight_scales.clear();
+	weight_scales.reserve(point_ids.size());
+	enabled.clear();
+	enabled.reserve(point_ids.size());
+
+	for (point_index_t index = 0; index < point_ids.size(); ++index) {
+		index_by_id.emplace(point_ids[index], index);
+	}
+
+	std::vector<PointMap::Point const*> points;
+	points.reserve(point_ids.size());
+	size_t neighbor_count = 0;
+
+	for (PointMap::points_key_type const& id : point_ids) {
+		PointMap::Point const* point = point_map.try_get_point(id);
+		points.push_back(point);
+		positions.push_back(point->position);
+		weight_scales.push_back(point->weight_scale);
+		enabled.push_back(point->enabled);
+		neighbor_count += point->neighbors.size();
+	}
+
+	neighbor_offsets.clear();
+	neighbor_offsets.reserve(point_ids.size() + 1);
+	neighbor_indices.clear();
+	neighbor_indices.reserve(neighbor_count);
+
+	for (PointMap::Point const* point : points) {
+		neighbor_offsets.push_back(neighbor_indices.size());
+		for (PointMap::points_key_type const& neighbor_id : point->neighbors) {
+			const point_index_t neighbor_index = get_index(neighbor_id);
+			if (neighbor_index != INVALID_INDEX) {
+				neighbor_indices.push_back(neighbor_index);
+			}
+		}
+	}
+	neighbor_offsets.push_back(neighbor_indices.size());
+}
+
+FlatPointGraph::point_index_t FlatPointGraph::get_index(PointMap::points_key_type id) const {
+	const decltype(index_by_id)::const_iterator it = index_by_id.find(id);
+	if (it == index_by_id.end()) {
+		return INVALID_INDEX;
+	}
+	return it.value();
+}
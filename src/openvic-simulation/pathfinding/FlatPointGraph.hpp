@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include <tsl/ordered_map.h>
+
+#include "openvic-simulation/pathfinding/PointMap.hpp"
+#include "openvic-simulation/types/Vector.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+namespace OpenVic {
+	/** Read-only snapshot of a PointMap in flat arrays
+
+		Points are renumbered with dense indices in the PointMap's iteration order, and each point's data lives in its own
+		array so searches can keep their per-point state in parallel arrays of the same size. Neighbours are stored in
+		compressed sparse row form: the neighbours of point i are neighbor_indices[neighbor_offsets[i], neighbor_offsets[i + 1]).
+
+		The snapshot does not track changes to its PointMap, build must be called again after any change.
+	 */
+	struct FlatPointGraph {
+		using point_index_t = uint32_t;
+
+		static constexpr point_index_t INVALID_INDEX = std::numeric_limits<point_index_t>::max();
+
+	private:
+		tsl::ordered_map<PointMap::points_key_type, point_index_t> index_by_id;
+		std::vector<PointMap::points_key_type> ids;
+		std::vector<ivec2_t> positions;
+		std::vector<fixed_point_t> weight_scales;
+		std::vector<uint8_t> enabled;
+		std::vector<point_index_t> neighbor_offsets;
+		std::vector<point_index_t> neighbor_indices;
+
+	public:
+		void build(PointMap const& point_map);
+
+		inline size_t get_point_count() const {
+			return ids.size();
+		}
+
+		point_index_t get_index(PointMap::points_key_type id) const;
+
+		inline PointMap::points_key_type get_id(point_index_t index) const {
+			return ids[index];
+		}
+		inline ivec2_t const& get_position(point_index_t index) const {
+			return positions[index];
+		}
+		inline fixed_point_t get_weight_scale(point_index_t index) const {
+			return weight_scales[index];
+		}
+		inline bool is_enabled(point_index_t index) const {
+			return enabled[index] != 0;
+		}
+		inline std::span<const point_index_t> get_neighbors(point_index_t index) const {
+			return { neighbor_indices.data() + neighbor_offsets[index], neighbor_indices.data() + neighbor_offsets[index + 1] };
+		}
+	};
+}
@@ -0,0 +1,327 @@
+#include "openvic-simulation/pathfinding/LandmarkDistanceOracle.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/utility/Logger.hpp"
+
+using namespace OpenVic;
+
+using heap_entry_t = std::pair<LandmarkDistanceOracle::distance_t, LandmarkDistanceOracle::node_t>;
+static constexpr std::greater<heap_entry_t> heap_compare {};
+
+void LandmarkDistanceOracle::_compute_distances_from(node_t source, std::vector<distance_t>& distances) const {
+	distances.assign(get_node_count(), NO_PATH);
+
+	std::vector<heap_entry_t> open_heap;
+	distances[source] = 0;
+	open_heap.emplace_back(distances[source], source);
+
+	while (!open_heap.empty()) {
+		std::pop_heap(open_heap.begin(), open_heap.end(), heap_compare);
+		const auto [distance, node] = open_heap.back();
+		open_heap.pop_back();
+
+		if (distance > distances[node]) {
+			continue;
+		}
+
+		for (edge_t const& edge : get_edges(node)) {
+			const distance_t new_distance = distance + edge.distance;
+			if (new_distance < distances[edge.to]) {
+				distances[edge.to] = new_distance;
+				open_heap.emplace_back(new_distance, edge.to);
+				std::push_heap(open_heap.begin(), open_heap.end(), heap_compare);
+			}
+		}
+	}
+}
+
+void LandmarkDistanceOracle::_find_components() {
+	component_ids.assign(get_node_count(), INVALID_NODE);
+
+	node_t component_count = 0;
+	std::vector<node_t> stack;
+
+	for (node_t root = 0; root < get_node_count(); ++root) {
+		if (component_ids[root] != INVALID_NODE) {
+			continue;
+		}
+
+		component_ids[root] = component_count;
+		stack.push_back(root);
+		while (!stack.empty()) {
+			const node_t node = stack.back();
+			stack.pop_back();
+			for (edge_t const& edge : get_edges(node)) {
+				if (component_ids[edge.to] == INVALID_NODE) {
+					component_ids[edge.to] = component_count;
+					stack.push_back(edge.to);
+				}
+			}
+		}
+
+		++component_count;
+	}
+}
+
+void LandmarkDistanceOracle::_select_landmarks(size_t landmark_count) {
+	landmarks.clear();
+
+	if (landmark_count == 0) {
+		landmark_distances.clear();
+		return;
+	}
+
+	const size_t node_count = get_node_count();
+
+	// Nodes of each component, with components too small to need landmarks left out.
+	std::vector<std::vector<node_t>> components;
+	for (node_t node = 0; node < node_count; ++node) {
+		if (component_ids[node] >= components.size()) {
+			components.resize(component_ids[node] + 1);
+		}
+		components[component_ids[node]].push_back(node);
+	}
+	std::erase_if(components, [](std::vector<node_t> const& component) -> bool {
+		return component.size() < MIN_LANDMARK_COMPONENT_SIZE;
+	});
+	std::stable_sort(
+		components.begin(), components.end(),
+		[](std::vector<node_t> const& lhs, std::vector<node_t> const& rhs) -> bool {
+			return lhs.size() > rhs.size();
+		}
+	);
+
+	const size_t eligible_node_count = std::transform_reduce(
+		components.begin(), components.end(), size_t { 0 }, std::plus {},
+		[](std::vector<node_t> const& component) -> size_t {
+			return component.size();
+		}
+	);
+
+	std::vector<std::vector<distance_t>> distances_by_landmark;
+	std::vector<distance_t> distances;
+
+	for (std::vector<node_t> const& component : components) {
+		if (landmarks.size() >= landmark_count) {
+			break;
+		}
+
+		// Landmarks are shared out between components in proportion to their size, with at least one each.
+		const size_t component_landmark_count = std::min(
+			std::max<size_t>(landmark_count * component.size() / eligible_node_count, 1), landmark_count - landmarks.size()
+		);
+
+		// Farthest point selection: the first landmark is the node farthest from an arbitrary start node, and each
+		// following one is the node farthest from all of the component's landmarks so far.
+		std::vector<distance_t> min_landmark_distances;
+		_compute_distances_from(component.front(), min_landmark_distances);
+
+		for (size_t index = 0; index < component_landmark_count; ++index) {
+			node_t farthest = component.front();
+			for (node_t node : component) {
+				if (min_landmark_distances[node] > min_landmark_distances[farthest]) {
+					farthest = node;
+				}
+			}
+			if (index > 0 && min_landmark_distances[farthest] == 0) {
+				// Every node is already a landmark.
+				break;
+			}
+
+			_compute_distances_from(farthest, distances);
+			landmarks.push_back(farthest);
+
+			if (index == 0) {
+				min_landmark_distances = distances;
+			} else {
+				for (node_t node : component) {
+					min_landmark_distances[node] = std::min(min_landmark_distances[node], distances[node]);
+				}
+			}
+
+			distances_by_landmark.push_back(std::move(distances));
+		}
+	}
+
+	// Stored node-major, so computing a node's bound reads one contiguous row.
+	landmark_distances.resize(node_count * landmarks.size());
+	for (node_t node = 0; node < node_count; ++node) {
+		for (size_t landmark = 0; landmark < landmarks.size(); ++landmark) {
+			landmark_distances[node * landmarks.size() + landmark] = distances_by_landmark[landmark][node];
+		}
+	}
+}
+
+bool LandmarkDistanceOracle::build(
+	std::vector<node_t>&& new_edge_offsets, std::vector<edge_t>&& new_edges, size_t landmark_count
+) {
+	if (new_edge_offsets.empty() || new_edge_offsets.back() != new_edges.size()) {
+		Logger::error(
+			"Invalid landmark distance oracle graph: ", new_edge_offsets.size(), " edge offsets for ", new_edges.size(),
+			" edges!"
+		);
+		return false;
+	}
+
+	edge_offsets = std::move(new_edge_offsets);
+	edges = std::move(new_edges);
+
+	bool ret = true;
+	for (edge_t const& edge : edges) {
+		if (edge.to >= get_node_count() || edge.distance < 0) {
+			Logger::error("Invalid landmark distance oracle edge to node ", edge.to, " with distance ", edge.distance);
+			ret = false;
+		}
+	}
+	if (!ret) {
+		edge_offsets.clear();
+		edges.clear();
+		return false;
+	}
+
+	_find_components();
+	_select_landmarks(landmark_count);
+
+	return true;
+}
+
+bool LandmarkDistanceOracle::is_reachable(node_t from, node_t to) const {
+	return from < get_node_count() && to < get_node_count() && component_ids[from] == component_ids[to];
+}
+
+LandmarkDistanceOracle::distance_t LandmarkDistanceOracle::get_lower_bound(node_t from, node_t to) const {
+	if (!is_reachable(from, to)) {
+		return NO_PATH;
+	}
+
+	distance_t bound = 0;
+	const size_t landmark_count = landmarks.size();
+	distance_t const* from_distances = landmark_distances.data() + from * landmark_count;
+	distance_t const* to_distances = landmark_distances.data() + to * landmark_count;
+	for (size_t landmark = 0; landmark < landmark_count; ++landmark) {
+		// Landmarks in other components are unreachable from both nodes.
+		if (from_distances[landmark] != NO_PATH) {
+			bound = std::max(bound, (to_distances[landmark] - from_distances[landmark]).abs());
+		}
+	}
+	return bound;
+}
+
+LandmarkDistanceOracle::node_t LandmarkDistanceOracle::_search(
+	node_t from, node_t to, search_state_t& state, blocked_tags_t const* blocked_tags
+) const {
+	state.settled_node_count = 0;
+
+	if (!is_reachable(from, to)) {
+		return INVALID_NODE;
+	}
+
+	const size_t node_count = get_node_count();
+	if (state.open_passes.size() != node_count) {
+		state.pass = 0;
+		state.open_passes.assign(node_count, 0);
+		state.closed_passes.assign(node_count, 0);
+		state.g_scores.assign(node_count, 0);
+		state.h_scores.assign(node_count, 0);
+		state.prev_nodes.assign(node_count, INVALID_NODE);
+	}
+	const uint64_t pass = ++state.pass;
+
+	const size_t landmark_count = landmarks.size();
+	distance_t const* to_distances = landmark_distances.data() + to * landmark_count;
+	state.target_landmark_distances.assign(to_distances, to_distances + landmark_count);
+
+	const auto estimate = [this, &state, landmark_count](node_t node) -> distance_t {
+		distance_t bound = 0;
+		distance_t const* node_distances = landmark_distances.data() + node * landmark_count;
+		for (size_t landmark = 0; landmark < landmark_count; ++landmark) {
+			if (node_distances[landmark] != NO_PATH) {
+				bound = std::max(bound, (state.target_landmark_distances[landmark] - node_distances[landmark]).abs());
+			}
+		}
+		return bound;
+	};
+
+	std::vector<heap_entry_t>& open_heap = state.open_heap;
+	open_heap.clear();
+
+	state.open_passes[from] = pass;
+	state.g_scores[from] = 0;
+	state.h_scores[from] = estimate(from);
+	state.prev_nodes[from] = INVALID_NODE;
+	open_heap.emplace_back(state.h_scores[from], from);
+
+	while (!open_heap.empty()) {
+		std::pop_heap(open_heap.begin(), open_heap.end(), heap_compare);
+		const node_t node = open_heap.back().second;
+		open_heap.pop_back();
+
+		// Nodes are pushed again whenever their g_score improves, so older entries are skipped here. The landmark
+		// heuristic is consistent, so a node's g_score is final once it has been settled.
+		if (state.closed_passes[node] == pass) {
+			continue;
+		}
+		state.closed_passes[node] = pass;
+		++state.settled_node_count;
+
+		if (node == to) {
+			return to;
+		}
+
+		const distance_t node_g_score = state.g_scores[node];
+
+		for (edge_t const& edge : get_edges(node)) {
+			if (state.closed_passes[edge.to] == pass || (blocked_tags != nullptr && (*blocked_tags)[edge.tag])) {
+				continue;
+			}
+
+			const distance_t tentative_g_score = node_g_score + edge.distance;
+
+			if (state.open_passes[edge.to] != pass) {
+				state.open_passes[edge.to] = pass;
+				state.h_scores[edge.to] = estimate(edge.to);
+			} else if (tentative_g_score >= state.g_scores[edge.to]) {
+				continue;
+			}
+
+			state.g_scores[edge.to] = tentative_g_score;
+			state.prev_nodes[edge.to] = node;
+			open_heap.emplace_back(tentative_g_score + state.h_scores[edge.to], edge.to);
+			std::push_heap(open_heap.begin(), open_heap.end(), heap_compare);
+		}
+	}
+
+	return INVALID_NODE;
+}
+
+LandmarkDistanceOracle::distance_t LandmarkDistanceOracle::get_distance(
+	node_t from, node_t to, search_state_t& state, blocked_tags_t const* blocked_tags
+) const {
+	if (_search(from, to, state, blocked_tags) == INVALID_NODE) {
+		return NO_PATH;
+	}
+	return state.g_scores[to];
+}
+
+LandmarkDistanceOracle::distance_t LandmarkDistanceOracle::get_path(
+	node_t from, node_t to, search_state_t& state, std::vector<node_t>& path, blocked_tags_t const* blocked_tags
+) const {
+	path.clear();
+
+	if (_search(from, to, state, blocked_tags) == INVALID_NODE) {
+		return NO_PATH;
+	}
+
+	for (node_t node = to; node != INVALID_NODE; node = state.prev_nodes[node]) {
+		path.push_back(node);
+	}
+	std::reverse(path.begin(), path.end());
+
+	return state.g_scores[to];
+}
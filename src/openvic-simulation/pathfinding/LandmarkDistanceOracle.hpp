@@ -0,0 +1,111 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/utility/Getters.hpp"
+
+namespace OpenVic {
+	/** Shortest path oracle for a static graph using ALT (A*, Landmarks and Triangle inequality)
+
+		Preprocessing picks a set of landmark nodes and stores every node's exact distance to each of them. Queries then
+		run A* with the heuristic max over landmarks L of |d(L, to) - d(L, node)|, a lower bound which is much tighter than
+		a geometric one on irregular graphs like the province map, so searches settle far fewer nodes. Connected components
+		are also precomputed, so queries between unconnected nodes return immediately.
+
+		The graph must be undirected, i.e. every edge must have a reverse edge with the same distance. Edges may carry a
+		tag (e.g. a canal index) which individual queries can block. Blocking edges only makes paths longer, so the
+		landmark bounds stay valid.
+
+		The oracle itself is read-only after build, all per-query scratch data lives in a search_state_t, so queries on
+		different threads only need their own search_state_t.
+	 */
+	struct LandmarkDistanceOracle {
+		using node_t = uint32_t;
+		using distance_t = fixed_point_t;
+		using tag_t = uint8_t;
+		using blocked_tags_t = std::bitset<std::numeric_limits<tag_t>::max() + 1>;
+
+		static constexpr node_t INVALID_NODE = std::numeric_limits<node_t>::max();
+		static constexpr distance_t NO_PATH = fixed_point_t::max();
+		// Tag 0 marks edges which can never be blocked.
+		static constexpr tag_t NO_TAG = 0;
+		static constexpr size_t DEFAULT_LANDMARK_COUNT = 16;
+		// Components smaller than this are cheap enough to search without landmarks.
+		static constexpr size_t MIN_LANDMARK_COMPONENT_SIZE = 32;
+
+		struct edge_t {
+			node_t to;
+			distance_t distance;
+			tag_t tag = NO_TAG;
+		};
+
+		struct search_state_t {
+			friend struct LandmarkDistanceOracle;
+
+		private:
+			uint64_t pass = 0;
+			std::vector<uint64_t> open_passes;
+			std::vector<uint64_t> closed_passes;
+			std::vector<distance_t> g_scores;
+			std::vector<distance_t> h_scores;
+			std::vector<node_t> prev_nodes;
+			std::vector<std::pair<distance_t, node_t>> open_heap;
+			std::vector<distance_t> target_landmark_distances;
+			size_t PROPERTY(settled_node_count, 0);
+		};
+
+	private:
+		// Neighbours of node n are edges[edge_offsets[n], edge_offsets[n + 1]).
+		std::vector<node_t> edge_offsets;
+		std::vector<edge_t> edges;
+		std::vector<node_t> component_ids;
+		std::vector<node_t> PROPERTY(landmarks);
+		// Distance from landmark l to node n is landmark_distances[n * landmark count + l], NO_PATH if unreachable.
+		std::vector<distance_t> landmark_distances;
+
+		void _compute_distances_from(node_t source, std::vector<distance_t>& distances) const;
+		void _find_components();
+		void _select_landmarks(size_t landmark_count);
+
+		// Returns the node the search ended at, to if a path was found or INVALID_NODE otherwise.
+		node_t _search(node_t from, node_t to, search_state_t& state, blocked_tags_t const* blocked_tags) const;
+
+	public:
+		/* Builds the oracle for a graph with edge_offsets.size() - 1 nodes, taking ownership of its edges.
+		 * landmark_count is an upper bound, 0 landmarks gives plain Dijkstra searches. */
+		bool build(
+			std::vector<node_t>&& new_edge_offsets, std::vector<edge_t>&& new_edges,
+			size_t landmark_count = DEFAULT_LANDMARK_COUNT
+		);
+
+		inline size_t get_node_count() const {
+			return edge_offsets.empty() ? 0 : edge_offsets.size() - 1;
+		}
+
+		inline std::span<const edge_t> get_edges(node_t node) const {
+			return { edges.data() + edge_offsets[node], edges.data() + edge_offsets[node + 1] };
+		}
+
+		// Whether a path exists when no edges are blocked.
+		bool is_reachable(node_t from, node_t to) const;
+		// Admissible estimate of the distance between two nodes, NO_PATH if they are unconnected.
+		distance_t get_lower_bound(node_t from, node_t to) const;
+
+		// Returns NO_PATH if there is no path.
+		distance_t get_distance(
+			node_t from, node_t to, search_state_t& state, blocked_tags_t const* blocked_tags = nullptr
+		) const;
+		// Fills path with the nodes from from to to inclusive and returns the path's distance, or returns NO_PATH and
+		// leaves path empty if there is no path.
+		distance_t get_path(
+			node_t from, node_t to, search_state_t& state, std::vector<node_t>& path,
+			blocked_tags_t const* blocked_tags = nullptr
+		) const;
+	};
+}
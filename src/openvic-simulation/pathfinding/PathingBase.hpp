@@ -128,7 +128,7 @@ namespace OpenVic {
 			);
 
 			if (from_it == to_it) {
-				return std::vector<ivec2_t> { 1, from_it.value().point->position };
+				return std::vector<ivec2_t> { from_it.value().point->position };
 			}
 
 			bool found_route = _solve(from_it, to_it, current_pass++, allow_partial_path);
@@ -195,7 +195,7 @@ namespace OpenVic {
 			);
 
 			if (from_it == to_it) {
-				return std::vector<PointMap::points_key_type> { 1, from_id };
+				return std::vector<PointMap::points_key_type> { from_id };
 			}
 
 			bool found_route = _solve(from_it, to_it, current_pass++, allow_partial_path);
@@ -148,7 +148,7 @@ std::span<const PointMap::points_key_type> PointMap::get_point_connections(point
 	return std::span<const points_key_type> { it.value().neighbors.values_container() };
 }
 
-std::vector<PointMap::points_key_type> PointMap::get_point_ids() {
+std::vector<PointMap::points_key_type> PointMap::get_point_ids() const {
 	std::vector<points_key_type> point_list;
 	point_list.reserve(points.size());
 
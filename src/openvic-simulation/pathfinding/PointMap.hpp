@@ -151,7 +151,7 @@ namespace OpenVic {
 		bool has_point(points_key_type id) const;
 
 		std::span<const points_key_type> get_point_connections(points_key_type id) const;
-		std::vector<points_key_type> get_point_ids();
+		std::vector<points_key_type> get_point_ids() const;
 
 		void set_point_disabled(points_key_type id, bool disabled = true);
 		bool is_point_disabled(points_key_type id) const;
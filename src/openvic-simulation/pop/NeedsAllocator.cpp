@@ -0,0 +1,123 @@
+#include "NeedsAllocator.hpp"
+
+#include <algorithm>
+
+using namespace OpenVic;
+
+void NeedsAllocator::clear() {
+	needs.clear();
+}
+
+void NeedsAllocator::add_need(
+	const size_t need_index, const fixed_point_t max_money_to_spend, const fixed_point_t price_inverse
+) {
+	if (max_money_to_spend <= fixed_point_t::_0()) {
+		//already has all the money it can spend
+		return;
+	}
+
+	// The saturation threshold is only needed for sorting, so it's left to _allocate_sorted.
+	needs.push_back({ fixed_point_t::_0(), need_index, max_money_to_spend, price_inverse });
+}
+
+static bool can_saturate(
+	const fixed_point_t cash_left_to_spend, const fixed_point_t price_inverse_sum, const fixed_point_t price_inverse,
+	const fixed_point_t max_money_to_spend
+) {
+	return fixed_point_t::mul_div(cash_left_to_spend, price_inverse, price_inverse_sum) >= max_money_to_spend;
+}
+
+void NeedsAllocator::allocate(
+	fixed_point_t cash_left_to_spend, fixed_point_t& price_inverse_sum, std::span<fixed_point_t> money_to_spend_per_need
+) {
+	if (needs.size() <= MAX_RESTARTING_NEED_COUNT) {
+		_allocate_restarting(cash_left_to_spend, price_inverse_sum, money_to_spend_per_need);
+	} else {
+		_allocate_sorted(cash_left_to_spend, price_inverse_sum, money_to_spend_per_need);
+	}
+}
+
+void NeedsAllocator::_allocate_restarting(
+	fixed_point_t cash_left_to_spend, fixed_point_t& price_inverse_sum, std::span<fixed_point_t> money_to_spend_per_need
+) {
+	/* Saturates the first need in list order that can be, then starts over, as Pop::allocate_for_needs originally did.
+	 * Erasing saturated needs keeps the rest in list order. */
+	size_t i = 0;
+	while (i < needs.size()) {
+		need_t const& need = needs[i];
+		if (can_saturate(cash_left_to_spend, price_inverse_sum, need.price_inverse, need.max_money_to_spend)) {
+			cash_left_to_spend -= need.max_money_to_spend;
+			money_to_spend_per_need[need.need_index] = need.max_money_to_spend;
+			price_inverse_sum -= need.price_inverse;
+			needs.erase(needs.begin() + i);
+			i = 0;
+		} else {
+			i++;
+		}
+	}
+
+	for (need_t const& need : needs) {
+		money_to_spend_per_need[need.need_index] = fixed_point_t::mul_div(
+			cash_left_to_spend,
+			need.price_inverse,
+			price_inverse_sum
+		);
+	}
+}
+
+void NeedsAllocator::_allocate_sorted(
+	fixed_point_t cash_left_to_spend, fixed_point_t& price_inverse_sum, std::span<fixed_point_t> money_to_spend_per_need
+) {
+	for (need_t& need : needs) {
+		need.saturation_threshold = need.price_inverse > fixed_point_t::_0()
+			? need.max_money_to_spend / need.price_inverse
+			: fixed_point_t::max();
+	}
+
+	std::sort(
+		needs.begin(), needs.end(),
+		[](need_t const& lhs, need_t const& rhs) -> bool {
+			return lhs.saturation_threshold < rhs.saturation_threshold;
+		}
+	);
+
+	/* Cash is spread over needs in proportion to their price inverse, and a need is saturated once its share covers its
+	 * max_money_to_spend, i.e. once cash_left_to_spend / price_inverse_sum reaches its saturation threshold.
+	 * Saturating a need never lowers that ratio, so needs saturate in ascending threshold order and a single pass
+	 * over the sorted needs gives the same result as repeatedly restarting over all of them. */
+	size_t saturated_count = 0;
+	while (saturated_count < needs.size()) {
+		//thresholds are truncated, so any need sharing the next threshold may be the one that saturates
+		const fixed_point_t next_threshold = needs[saturated_count].saturation_threshold;
+		size_t next_index = saturated_count;
+		while (
+			next_index < needs.size()
+			&& needs[next_index].saturation_threshold == next_threshold
+			&& !can_saturate(
+				cash_left_to_spend, price_inverse_sum, needs[next_index].price_inverse, needs[next_index].max_money_to_spend
+			)
+		) {
+			next_index++;
+		}
+
+		if (next_index == needs.size() || needs[next_index].saturation_threshold != next_threshold) {
+			break;
+		}
+
+		std::swap(needs[saturated_count], needs[next_index]);
+		need_t const& saturated_need = needs[saturated_count];
+		cash_left_to_spend -= saturated_need.max_money_to_spend;
+		money_to_spend_per_need[saturated_need.need_index] = saturated_need.max_money_to_spend;
+		price_inverse_sum -= saturated_need.price_inverse;
+		saturated_count++;
+	}
+
+	for (size_t i = saturated_count; i < needs.size(); i++) {
+		need_t const& need = needs[i];
+		money_to_spend_per_need[need.need_index] = fixed_point_t::mul_div(
+			cash_left_to_spend,
+			need.price_inverse,
+			price_inverse_sum
+		);
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+namespace OpenVic {
+	/* Spreads a pop's cash over the goods of one of its need lists in proportion to each good's price inverse, giving
+	 * a need at most its max_money_to_spend and spreading what it doesn't take over the other needs again.
+	 * Needs are sorted once by the point at which they saturate, rather than restarting over all needs every time one
+	 * saturates. Short need lists skip the sort, as restarting over them is cheaper (see the NeedsAllocator benchmark
+	 * test, with the crossover at around 10 needs). Holds its sort buffer so it can be reused between pops without
+	 * allocating. */
+	struct NeedsAllocator {
+		// Up to this many needs are allocated by restarting, more are sorted first.
+		static constexpr size_t MAX_RESTARTING_NEED_COUNT = 8;
+
+	private:
+		struct need_t {
+			// max_money_to_spend / price_inverse, the cash left to price inverse sum ratio at which the need saturates
+			fixed_point_t saturation_threshold;
+			size_t need_index;
+			fixed_point_t max_money_to_spend;
+			fixed_point_t price_inverse;
+		};
+
+		// The needs allocate hasn't given their max_money_to_spend yet.
+		std::vector<need_t> needs;
+
+		void _allocate_restarting(
+			fixed_point_t cash_left_to_spend, fixed_point_t& price_inverse_sum,
+			std::span<fixed_point_t> money_to_spend_per_need
+		);
+		void _allocate_sorted(
+			fixed_point_t cash_left_to_spend, fixed_point_t& price_inverse_sum,
+			std::span<fixed_point_t> money_to_spend_per_need
+		);
+
+	public:
+		void clear();
+
+		// Needs with a max_money_to_spend of 0 or less are ignored.
+		void add_need(size_t need_index, fixed_point_t max_money_to_spend, fixed_point_t price_inverse);
+
+		/* Sets money_to_spend_per_need[need_index] for each added need and leaves the rest untouched. Each need's share
+		 * of the cash is its price inverse over price_inverse_sum, which has the saturated needs' price inverses
+		 * subtracted from it. */
+		void allocate(
+			fixed_point_t cash_left_to_spend, fixed_point_t& price_inverse_sum,
+			std::span<fixed_point_t> money_to_spend_per_need
+		);
+	};
+}
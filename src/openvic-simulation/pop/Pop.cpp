@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <utility>
+#include <vector>
 
 #define KEEP_DO_FOR_ALL_TYPES_OF_INCOME
 #define KEEP_DO_FOR_ALL_TYPES_OF_EXPENSES
@@ -17,11 +21,80 @@
 #include "openvic-simulation/economy/trading/MarketInstance.hpp"
 #include "openvic-simulation/map/ProvinceInstance.hpp"
 #include "openvic-simulation/modifier/ModifierEffectCache.hpp"
+#include "openvic-simulation/pop/NeedsAllocator.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
 #include "openvic-simulation/utility/Utility.hpp"
 
 using namespace OpenVic;
 
+static constexpr uint32_t NO_NEED_INDEX = std::numeric_limits<uint32_t>::max();
+
+// Position of a good in each of a pop type's need lists, or NO_NEED_INDEX if the pop doesn't need to buy it this tick.
+struct need_indices_t {
+	#define NEED_INDEX(need_category) \
+		uint32_t need_category = NO_NEED_INDEX;
+
+	DO_FOR_ALL_NEED_CATEGORIES(NEED_INDEX)
+	#undef NEED_INDEX
+};
+
+/* Per-thread scratch space used while a pop builds its buy orders in pop_tick, indexed by good index so that, once grown
+ * to the number of goods, filling it needs neither hashing nor allocation. Only the entries that were touched are reset. */
+struct pop_tick_buffers_t {
+	struct good_entry_t {
+		fixed_point_t max_quantity_to_buy;
+		fixed_point_t money_to_spend;
+		need_indices_t need_indices;
+		bool has_money_to_spend = false;
+		bool is_touched = false;
+	};
+
+private:
+	std::vector<good_entry_t> entries;
+	std::vector<size_t> touched_indices;
+
+public:
+	// Goods in the order they were first given money to spend, which is the order their buy orders are placed in.
+	std::vector<GoodDefinition const*> goods_to_buy;
+	// Money allocated to each entry of the need list being processed by allocate_for_needs.
+	std::vector<fixed_point_t> money_to_spend_per_need_draft;
+
+	NeedsAllocator needs_allocator;
+
+	good_entry_t& operator[](GoodDefinition const& good) {
+		const size_t index = good.get_index();
+		if (OV_unlikely(index >= entries.size())) {
+			entries.resize(index + 1);
+		}
+
+		good_entry_t& entry = entries[index];
+		if (!entry.is_touched) {
+			entry.is_touched = true;
+			touched_indices.push_back(index);
+		}
+		return entry;
+	}
+
+	void add_money_to_spend(GoodDefinition const& good, const fixed_point_t money_to_spend) {
+		good_entry_t& entry = (*this)[good];
+		if (!entry.has_money_to_spend) {
+			entry.has_money_to_spend = true;
+			goods_to_buy.push_back(&good);
+		}
+		entry.money_to_spend += money_to_spend;
+	}
+
+	void clear() {
+		for (const size_t index : touched_indices) {
+			entries[index] = {};
+		}
+		touched_indices.clear();
+		goods_to_buy.clear();
+	}
+};
+
+static thread_local pop_tick_buffers_t pop_tick_buffers;
+
 PopBase::PopBase(
 	PopType const& new_type, Culture const& new_culture, Religion const& new_religion, pop_size_t new_size,
 	fixed_point_t new_militancy, fixed_point_t new_consciousness, RebelType const* new_rebel_type
@@ -32,10 +105,16 @@ Pop::Pop(
 	PopBase const& pop_base,
 	decltype(ideology_distribution)::keys_type const& ideology_keys,
 	MarketInstance& new_market_instance,
+	PopStore& new_pop_store,
 	ArtisanalProducerFactoryPattern& artisanal_producer_factory_pattern
 )
-  : PopBase { pop_base },
+  : type { pop_base.get_type() },
+	culture { pop_base.get_culture() },
+	religion { pop_base.get_religion() },
+	rebel_type { pop_base.get_rebel_type() },
 	market_instance { new_market_instance },
+	pop_store { new_pop_store },
+	pop_store_slot { new_pop_store.add_pop(pop_base, DEFAULT_POP_LITERACY) },
 	artisanal_producer_nullable {
 		type->get_is_artisan()
 			? artisanal_producer_factory_pattern.CreateNewArtisanalProducer()
@@ -43,24 +122,29 @@ Pop::Pop(
 	},
 	ideology_distribution { &ideology_keys },
 	vote_distribution { nullptr } {
-		reserve_needs_fulfilled_goods();
+		setup_needs_for_type();
 	}
 
 #define CATEGORY_HANDLER(need_category)\
 	need_category##_needs_acquired_quantity(other.need_category##_needs_acquired_quantity.load()),\
-	need_category##_needs_desired_quantity(other.need_category##_needs_desired_quantity.load()),
+	need_category##_needs_desired_quantity(other.need_category##_needs_desired_quantity.load()),\
+	need_category##_needs(std::move(other.need_category##_needs)),\
+	need_category##_needs_fulfilled_goods(std::move(other.need_category##_needs_fulfilled_goods)),
 
-#define INCOME_EXPENSE_HANDLER(money_type) money_type(std::move(other.money_type)),
+#define INCOME_EXPENSE_HANDLER(money_type) money_type(other.money_type.load()),
 
 Pop::Pop(Pop&& other)
-	: PopBase(static_cast<PopBase&&>(other)),
+	: type { other.type },
+	  culture { other.culture },
+	  religion { other.religion },
+	  rebel_type { other.rebel_type },
 	  artisanal_producer_nullable{std::move(other.artisanal_producer_nullable)},
 	  cash_allocated_for_artisanal_spending(std::move(other.cash_allocated_for_artisanal_spending)),
 	  artisanal_produce_left_to_sell(std::move(other.artisanal_produce_left_to_sell)),
-	  max_quantity_to_buy_per_good(std::move(other.max_quantity_to_buy_per_good)),
-	  money_to_spend_per_good(std::move(other.money_to_spend_per_good)),
 	  location(std::exchange(other.location, nullptr)),
 	  market_instance { other.market_instance },
+	  pop_store { other.pop_store },
+	  pop_store_slot { other.pop_store_slot },
 	  total_change(other.total_change),
 	  num_grown(other.num_grown),
 	  num_promoted(other.num_promoted),
@@ -68,12 +152,11 @@ Pop::Pop(Pop&& other)
 	  num_migrated_internal(other.num_migrated_internal),
 	  num_migrated_external(other.num_migrated_external),
 	  num_migrated_colonial(other.num_migrated_colonial),
-	  literacy(std::move(other.literacy)),
 	  ideology_distribution { std::move(other.ideology_distribution) },
 	  issue_distribution(std::move(other.issue_distribution)),
 	  vote_distribution { std::move(other.vote_distribution) },
 	  unemployment(std::move(other.unemployment)),
-	  income(std::move(other.income)),
+	  income(other.income.load()),
 	  savings(std::move(other.savings)),
 	  cash(other.cash.load()),
 	  expenses(other.expenses.load()),
@@ -88,7 +171,7 @@ Pop::Pop(Pop&& other)
 void Pop::setup_pop_test_values(IssueManager const& issue_manager) {
 	/* Returns +/- range% of size. */
 	const auto test_size = [this](int32_t range) -> pop_size_t {
-		return size * ((rand() % (2 * range + 1)) - range) / 100;
+		return get_size() * ((rand() % (2 * range + 1)) - range) / 100;
 	};
 
 	num_grown = test_size(5);
@@ -119,7 +202,7 @@ void Pop::setup_pop_test_values(IssueManager const& issue_manager) {
 	for (Ideology const& ideology : *ideology_distribution.get_keys()) {
 		test_weight(ideology_distribution, ideology, 1, 5);
 	}
-	ideology_distribution.rescale(size);
+	ideology_distribution.rescale(get_size());
 
 	issue_distribution.clear();
 	for (Issue const& issue : issue_manager.get_issues()) {
@@ -130,14 +213,14 @@ void Pop::setup_pop_test_values(IssueManager const& issue_manager) {
 			test_weight(issue_distribution, reform, 3, 6);
 		}
 	}
-	rescale_fixed_point_map(issue_distribution, size);
+	rescale_fixed_point_map(issue_distribution, get_size());
 
 	if (vote_distribution.has_keys()) {
 		vote_distribution.clear();
 		for (CountryParty const& party : *vote_distribution.get_keys()) {
 			test_weight(vote_distribution, party, 4, 10);
 		}
-		vote_distribution.rescale(size);
+		vote_distribution.rescale(get_size());
 	}
 
 	/* Returns a fixed point between 0 and max. */
@@ -164,7 +247,8 @@ bool Pop::convert_to_equivalent() {
 	}
 
 	type = equivalent;
-	reserve_needs_fulfilled_goods();
+	pop_store.strata_indices[pop_store_slot] = type->get_strata().get_index();
+	setup_needs_for_type();
 	return true;
 }
 
@@ -217,27 +301,24 @@ fixed_point_t Pop::get_party_support(CountryParty const& party) const {
 void Pop::update_gamestate(
 	DefineManager const& define_manager, CountryInstance const* owner, const fixed_point_t pop_size_per_regiment_multiplier
 ) {
-	static constexpr fixed_point_t MIN_MILITANCY = fixed_point_t::_0();
-	static constexpr fixed_point_t MAX_MILITANCY = fixed_point_t::_10();
-	static constexpr fixed_point_t MIN_CONSCIOUSNESS = fixed_point_t::_0();
-	static constexpr fixed_point_t MAX_CONSCIOUSNESS = fixed_point_t::_10();
-	static constexpr fixed_point_t MIN_LITERACY = fixed_point_t::_0_01();
-	static constexpr fixed_point_t MAX_LITERACY = fixed_point_t::_1();
+	// Militancy, consciousness and literacy have already been clamped for all pops by PopStore::clamp_values.
+
+	#define SET_NEEDS_FULFILLED(need_category) \
+		pop_store.need_category##_needs_fulfilled[pop_store_slot] = get_##need_category##_needs_fulfilled();
 
-	militancy = std::clamp(militancy, MIN_MILITANCY, MAX_MILITANCY);
-	consciousness = std::clamp(consciousness, MIN_CONSCIOUSNESS, MAX_CONSCIOUSNESS);
-	literacy = std::clamp(literacy, MIN_LITERACY, MAX_LITERACY);
+	DO_FOR_ALL_NEED_CATEGORIES(SET_NEEDS_FULFILLED)
+	#undef SET_NEEDS_FULFILLED
 
 	if (type->get_can_be_recruited()) {
 		MilitaryDefines const& military_defines = define_manager.get_military_defines();
 
 		if (
-			size < military_defines.get_min_pop_size_for_regiment() || owner == nullptr ||
+			get_size() < military_defines.get_min_pop_size_for_regiment() || owner == nullptr ||
 			!RegimentType::allowed_cultures_check_culture_in_country(owner->get_allowed_regiment_cultures(), culture, *owner)
 		) {
 			max_supported_regiments = 0;
 		} else {
-			max_supported_regiments = (fixed_point_t::parse(size) / (
+			max_supported_regiments = (fixed_point_t::parse(get_size()) / (
 				fixed_point_t::parse(military_defines.get_pop_size_per_regiment()) * pop_size_per_regiment_multiplier
 			)).to_int64_t() + 1;
 		}
@@ -252,25 +333,29 @@ std::stringstream Pop::get_pop_context_text() const {
 	} else {
 		pop_context << location->get_identifier();
 	}
-	pop_context << " type: " << type << " culture: " << culture << " religion: " << religion << " size: " << size;
+	pop_context << " type: " << type << " culture: " << culture << " religion: " << religion << " size: " << get_size();
 	return pop_context;
 }
 
-void Pop::reserve_needs_fulfilled_goods() {
+void Pop::setup_needs_for_type() {
 	PopType const& type_never_null = *type;
-	#define RESERVE_NEEDS(need_category) \
-		need_category##_needs_fulfilled_goods.reserve(type_never_null.get_##need_category##_needs().size());
+	#define SETUP_NEEDS(need_category) \
+		need_category##_needs.assign(type_never_null.get_##need_category##_needs().size(), fixed_point_t::_0()); \
+		need_category##_needs_fulfilled_goods.clear(); \
+		need_category##_needs_fulfilled_goods.reserve(type_never_null.get_##need_category##_needs().size()); \
+		for (auto const& [good, base_demand] : type_never_null.get_##need_category##_needs()) { \
+			need_category##_needs_fulfilled_goods.emplace(good, false); \
+		}
 
-	DO_FOR_ALL_NEED_CATEGORIES(RESERVE_NEEDS)
-	#undef RESERVE_NEEDS
+	DO_FOR_ALL_NEED_CATEGORIES(SETUP_NEEDS)
+	#undef SETUP_NEEDS
 }
 
 void Pop::fill_needs_fulfilled_goods_with_false() {
-	PopType const& type_never_null = *type;
+	// The keys only change with the pop's type, so only the values need resetting.
 	#define FILL_WITH_FALSE(need_category) \
-		need_category##_needs_fulfilled_goods.clear(); \
-		for (auto [good, base_demand] : type_never_null.get_##need_category##_needs()) { \
-			need_category##_needs_fulfilled_goods.emplace(good, false); \
+		for (auto it = need_category##_needs_fulfilled_goods.begin(); it != need_category##_needs_fulfilled_goods.end(); ++it) { \
+			it.value() = false; \
 		}
 
 	DO_FOR_ALL_NEED_CATEGORIES(FILL_WITH_FALSE)
@@ -298,7 +383,7 @@ DO_FOR_ALL_TYPES_OF_POP_INCOME(DEFINE_ADD_INCOME_FUNCTIONS)
 #define DEFINE_ADD_EXPENSE_FUNCTIONS(name) \
 	void Pop::add_##name(const fixed_point_t amount){ \
 		if (OV_unlikely(amount == fixed_point_t::_0())) { \
-			if (size > 1024) { \
+			if (get_size() > 1024) { \
 				Logger::warning("Adding ", #name, " of 0 to pop. Context:", get_pop_context_text().str()); \
 			} \
 			return; \
@@ -332,38 +417,39 @@ DO_FOR_ALL_NEED_CATEGORIES(DEFINE_NEEDS_FULFILLED)
 	name = fixed_point_t::_0();
 
 void Pop::allocate_for_needs(
-	GoodDefinition::good_definition_map_t const& scaled_needs,
+	GoodDefinition::good_definition_map_t const& type_needs,
+	std::vector<fixed_point_t> const& scaled_needs,
 	fixed_point_t& price_inverse_sum,
 	fixed_point_t& cash_left_to_spend
 ) {
-	GoodDefinition::good_definition_map_t money_to_spend_per_good_draft {}; //TODO pool
-	fixed_point_t cash_left_to_spend_draft = cash_left_to_spend;
+	std::vector<fixed_point_t>& money_to_spend_per_need_draft = pop_tick_buffers.money_to_spend_per_need_draft;
+	money_to_spend_per_need_draft.assign(scaled_needs.size(), fixed_point_t::_0());
+
+	NeedsAllocator& needs_allocator = pop_tick_buffers.needs_allocator;
+	needs_allocator.clear();
 	for (size_t i = 0; i < scaled_needs.size(); i++) {
-		auto [good_definition, max_quantity_to_buy] = *scaled_needs.nth(i);
-		const fixed_point_t max_money_to_spend = max_quantity_to_buy * market_instance.get_max_next_price(*good_definition);
-		if (money_to_spend_per_good_draft[good_definition] >= max_money_to_spend) {
+		const fixed_point_t max_quantity_to_buy = scaled_needs[i];
+		if (max_quantity_to_buy == fixed_point_t::_0()) {
 			continue;
 		}
 
-		fixed_point_t price_inverse = market_instance.get_price_inverse(*good_definition);
-		fixed_point_t cash_available_for_good = fixed_point_t::mul_div(
-			cash_left_to_spend_draft,
-			price_inverse,
-			price_inverse_sum
+		GoodDefinition const& good_definition = *type_needs.nth(i)->first;
+		needs_allocator.add_need(
+			i,
+			max_quantity_to_buy * market_instance.get_max_next_price(good_definition),
+			market_instance.get_price_inverse(good_definition)
 		);
+	}
 
-		if (cash_available_for_good >= max_money_to_spend) {
-			cash_left_to_spend_draft -= max_money_to_spend;
-			money_to_spend_per_good_draft[good_definition] = max_money_to_spend;
-			price_inverse_sum -= price_inverse;
-			i = -1; //Restart loop and skip maxed out needs. This is required to spread the remaining cash again.
-		} else {
-			money_to_spend_per_good_draft[good_definition] = cash_available_for_good;
+	needs_allocator.allocate(cash_left_to_spend, price_inverse_sum, money_to_spend_per_need_draft);
+
+	for (size_t i = 0; i < scaled_needs.size(); i++) {
+		if (scaled_needs[i] == fixed_point_t::_0()) {
+			continue;
 		}
-	}
 
-	for (auto const& [good, money_to_spend] : money_to_spend_per_good_draft) {
-		money_to_spend_per_good[good] += money_to_spend;
+		const fixed_point_t money_to_spend = money_to_spend_per_need_draft[i];
+		pop_tick_buffers.add_money_to_spend(*type_needs.nth(i)->first, money_to_spend);
 		cash_left_to_spend -= money_to_spend;
 	}
 }
@@ -374,8 +460,7 @@ void Pop::pop_tick() {
 	#undef SET_ALL_INCOME_TO_ZERO
 
 	cash_allocated_for_artisanal_spending = fixed_point_t::_0();
-	max_quantity_to_buy_per_good.clear();
-	money_to_spend_per_good.clear();
+	pop_tick_buffers.clear();
 	fill_needs_fulfilled_goods_with_false();
 	if (artisanal_producer_nullable != nullptr) {
 		//execute artisan_tick before needs
@@ -384,22 +469,18 @@ void Pop::pop_tick() {
 
 	PopType const& type_never_null = *type;
 	ProvinceInstance& location_never_null = *location;
-	PopValuesFromProvince const& shared_values = location_never_null.get_shared_pop_values();
-	PopStrataValuesFromProvince const& shared_strata_values = shared_values.get_effects_per_strata()[type_never_null.get_strata()];
-	PopsDefines const& defines = shared_values.get_defines();
-	const fixed_point_t base_needs_scalar = (
-		fixed_point_t::_1() + 2 * consciousness / defines.get_pdef_base_con()
-	) * size;
 	constexpr int32_t size_denominator = 200000;
 
 	CountryInstance* country_to_report_economy_nullable = location_never_null.get_country_to_report_economy();
 	#define FILL_NEEDS(need_category) \
-		need_category##_needs.clear(); \
-		const fixed_point_t need_category##_needs_scalar = base_needs_scalar * shared_strata_values.get_shared_##need_category##_needs_scalar(); \
+		std::fill(need_category##_needs.begin(), need_category##_needs.end(), fixed_point_t::_0()); \
+		/* Calculated for all of the province's pops by PopStore::update_needs_scalars before they tick */ \
+		const fixed_point_t need_category##_needs_scalar = pop_store.need_category##_needs_scalars[pop_store_slot]; \
 		fixed_point_t need_category##_needs_price_inverse_sum = fixed_point_t::_0(); \
 		if (OV_likely(need_category##_needs_scalar > fixed_point_t::_0())) { \
 			need_category##_needs_acquired_quantity = need_category##_needs_desired_quantity = fixed_point_t::_0(); \
-			for (auto [good_definition, quantity] : type_never_null.get_##need_category##_needs()) { \
+			for (size_t need_index = 0; need_index < need_category##_needs.size(); ++need_index) { \
+				auto [good_definition, quantity] = *type_never_null.get_##need_category##_needs().nth(need_index); \
 				if (!market_instance.get_is_available(*good_definition)) { \
 					continue; \
 				} \
@@ -424,8 +505,10 @@ void Pop::pop_tick() {
 				} \
 				if (OV_likely(max_quantity_to_buy > 0)) { \
 					need_category##_needs_price_inverse_sum += market_instance.get_price_inverse(*good_definition); \
-					need_category##_needs[good_definition] += max_quantity_to_buy; \
-					max_quantity_to_buy_per_good[good_definition] += max_quantity_to_buy; \
+					need_category##_needs[need_index] = max_quantity_to_buy; \
+					pop_tick_buffers_t::good_entry_t& good_entry = pop_tick_buffers[*good_definition]; \
+					good_entry.max_quantity_to_buy += max_quantity_to_buy; \
+					good_entry.need_indices.need_category = static_cast<uint32_t>(need_index); \
 				} \
 			} \
 		}
@@ -438,25 +521,31 @@ void Pop::pop_tick() {
 
 	#define ALLOCATE_FOR_NEEDS(need_category) \
 		if (cash_left_to_spend > fixed_point_t::_0()) { \
-			allocate_for_needs(need_category##_needs, need_category##_needs_price_inverse_sum, cash_left_to_spend); \
+			allocate_for_needs( \
+				type_never_null.get_##need_category##_needs(), need_category##_needs, \
+				need_category##_needs_price_inverse_sum, cash_left_to_spend \
+			); \
 		}
 
 	DO_FOR_ALL_NEED_CATEGORIES(ALLOCATE_FOR_NEEDS)
 	#undef ALLOCATE_FOR_NEEDS
 
-	for (auto [good_definition, money_to_spend] : money_to_spend_per_good) {
-		const fixed_point_t max_quantity_to_buy = max_quantity_to_buy_per_good[good_definition];
+	for (GoodDefinition const* good_definition : pop_tick_buffers.goods_to_buy) {
+		pop_tick_buffers_t::good_entry_t const& good_entry = pop_tick_buffers[*good_definition];
+		const fixed_point_t max_quantity_to_buy = good_entry.max_quantity_to_buy;
+		const fixed_point_t money_to_spend = good_entry.money_to_spend;
+		const need_indices_t need_indices = good_entry.need_indices;
 
 		if (OV_unlikely(max_quantity_to_buy <= fixed_point_t::_0())) {
 			Logger::error("Aborted placing buy order for ",*good_definition," of max_quantity_to_buy 0.");
 			continue;
 		}
 
-		market_instance.place_buy_up_to_order(BuyUpToOrder {
+		market_instance.place_buy_up_to_order(location_never_null.get_order_book_shard(), BuyUpToOrder {
 			*good_definition,
 			max_quantity_to_buy,
 			money_to_spend,
-			[this, good_definition](const BuyResult buy_result) -> void {
+			[this, good_definition, need_indices](const BuyResult buy_result) -> void {
 				fixed_point_t quantity_left_to_consume = buy_result.get_quantity_bought();
 				if (artisanal_producer_nullable != nullptr) {
 					if (quantity_left_to_consume <= fixed_point_t::_0()) {
@@ -483,20 +572,19 @@ void Pop::pop_tick() {
 					if (quantity_left_to_consume <= fixed_point_t::_0()) { \
 						return; \
 					} \
-					const GoodDefinition::good_definition_map_t::const_iterator need_category##it = need_category##_needs.find(good_definition); \
-					if (need_category##it != need_category##_needs.end()) { \
-						const fixed_point_t desired_quantity = need_category##it->second; \
+					if (need_indices.need_category != NO_NEED_INDEX) { \
+						const fixed_point_t desired_quantity = need_category##_needs[need_indices.need_category]; \
 						fixed_point_t consumed_quantity; \
 						if (quantity_left_to_consume >= desired_quantity) { \
 							consumed_quantity = desired_quantity; \
-							need_category##_needs_fulfilled_goods.at(good_definition) = true; \
+							need_category##_needs_fulfilled_goods.nth(need_indices.need_category).value() = true; \
 						} else { \
 							consumed_quantity = quantity_left_to_consume; \
 						} \
 						need_category##_needs_acquired_quantity += consumed_quantity; \
 						quantity_left_to_consume -= consumed_quantity; \
 						if (get_country_to_report_economy_nullable != nullptr) { \
-							get_country_to_report_economy_nullable->report_pop_need_consumption(*type, *good_definition, consumed_quantity); \
+							get_country_to_report_economy_nullable->report_pop_need_consumption_after_trade(*type, *good_definition, consumed_quantity); \
 						} \
 						const fixed_point_t expense = fixed_point_t::mul_div( \
 							buy_result.get_money_spent(), \
@@ -513,7 +601,7 @@ void Pop::pop_tick() {
 	}
 
 	if (artisanal_produce_left_to_sell > fixed_point_t::_0()) {
-		market_instance.place_market_sell_order(MarketSellOrder {
+		market_instance.place_market_sell_order(location_never_null.get_order_book_shard(), MarketSellOrder {
 			artisanal_producer_nullable->get_production_type().get_output_good(),
 			artisanal_produce_left_to_sell,
 			[this](const SellResult sell_result) -> void {
@@ -528,8 +616,8 @@ void Pop::pop_tick() {
 
 void Pop::artisanal_buy(GoodDefinition const& good, const fixed_point_t max_quantity_to_buy, const fixed_point_t money_to_spend) {
 	cash_allocated_for_artisanal_spending += money_to_spend;
-	max_quantity_to_buy_per_good[&good] += max_quantity_to_buy;
-	money_to_spend_per_good[&good] += money_to_spend;
+	pop_tick_buffers[good].max_quantity_to_buy += max_quantity_to_buy;
+	pop_tick_buffers.add_money_to_spend(good, money_to_spend);
 }
 
 void Pop::artisanal_sell(const fixed_point_t quantity) {
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "openvic-simulation/country/CountryDefinition.hpp"
 #include "openvic-simulation/economy/production/ArtisanalProducerFactoryPattern.hpp"
+#include "openvic-simulation/pop/PopStore.hpp"
 #include "openvic-simulation/pop/PopType.hpp"
 #include "openvic-simulation/types/fixed_point/Atomic.hpp"
 
@@ -13,6 +15,7 @@ namespace OpenVic {
 	struct MarketInstance;
 	struct ProvinceInstance;
 
+	/* A pop as read from history, used to create its Pop. */
 	struct PopBase {
 		friend PopManager;
 
@@ -56,8 +59,9 @@ namespace OpenVic {
 		F(everyday) \
 		F(luxury)
 
+	// Goods' markets clear in parallel, so a pop's buy and sell callbacks can add to these from several threads at once.
 	#define DECLARE_POP_MONEY_STORES(money_type) \
-		fixed_point_t PROPERTY(money_type);
+		atomic_fixed_point_t PROPERTY(money_type);
 
 	#define DECLARE_POP_MONEY_STORE_FUNCTIONS(name) \
 		void add_##name(const fixed_point_t amount);
@@ -65,19 +69,27 @@ namespace OpenVic {
 	/* REQUIREMENTS:
 	 * POP-18, POP-19, POP-20, POP-21, POP-34, POP-35, POP-36, POP-37
 	 */
-	struct Pop : PopBase {
+	struct Pop {
 		friend struct ProvinceInstance;
 
 		static constexpr pop_size_t MAX_SIZE = std::numeric_limits<pop_size_t>::max();
 
 	private:
+		/* Only the values that don't live in the PopStore are copied from the PopBase, so there are no stale copies
+		 * of the current size, militancy and consciousness. */
+		PopType const* PROPERTY(type);
+		Culture const& PROPERTY(culture);
+		Religion const& PROPERTY(religion);
+		RebelType const* PROPERTY(rebel_type);
+
 		std::unique_ptr<ArtisanalProducer> artisanal_producer_nullable;
 		fixed_point_t cash_allocated_for_artisanal_spending;
 		fixed_point_t artisanal_produce_left_to_sell;
-		GoodDefinition::good_definition_map_t max_quantity_to_buy_per_good; //TODO pool?
-		GoodDefinition::good_definition_map_t money_to_spend_per_good; //TODO pool?
 		ProvinceInstance* PROPERTY_PTR(location, nullptr);
 		MarketInstance& PROPERTY(market_instance);
+		// The size, literacy, militancy and consciousness live in this slot.
+		PopStore& pop_store;
+		const PopStore::slot_t PROPERTY(pop_store_slot);
 
 		/* Last day's size change by source. */
 		pop_size_t PROPERTY(total_change, 0);
@@ -89,7 +101,6 @@ namespace OpenVic {
 		pop_size_t PROPERTY(num_migrated_colonial, 0);
 
 		static constexpr fixed_point_t DEFAULT_POP_LITERACY = fixed_point_t::_0_10();
-		fixed_point_t PROPERTY_RW(literacy, DEFAULT_POP_LITERACY);
 
 		// All of these should have a total size equal to the pop size, allowing the distributions from different pops to be
 		// added together with automatic weighting based on their relative sizes. Similarly, the province, state and country
@@ -99,7 +110,7 @@ namespace OpenVic {
 		IndexedMap<CountryParty, fixed_point_t> PROPERTY(vote_distribution);
 
 		fixed_point_t PROPERTY(unemployment);
-		fixed_point_t PROPERTY(income);
+		atomic_fixed_point_t PROPERTY(income);
 		fixed_point_t PROPERTY(savings);
 		atomic_fixed_point_t PROPERTY(cash);
 		atomic_fixed_point_t PROPERTY(expenses); //positive value means POP paid for goods. This is displayed * -1 in UI.
@@ -109,7 +120,8 @@ namespace OpenVic {
 			public: \
 			fixed_point_t get_##need_category##_needs_fulfilled() const; \
 			private: \
-			GoodDefinition::good_definition_map_t need_category##_needs; \
+			/* Quantity of each good in type's need_category needs the pop wants to buy this tick, in the same order */ \
+			std::vector<fixed_point_t> need_category##_needs; \
 			ordered_map<GoodDefinition const*, bool> PROPERTY(need_category##_needs_fulfilled_goods);
 
 		DO_FOR_ALL_NEED_CATEGORIES(NEED_MEMBERS)
@@ -125,14 +137,16 @@ namespace OpenVic {
 			PopBase const& pop_base,
 			decltype(ideology_distribution)::keys_type const& ideology_keys,
 			MarketInstance& new_market_instance,
+			PopStore& new_pop_store,
 			ArtisanalProducerFactoryPattern& artisanal_producer_factory_pattern
 		);
 
 		std::stringstream get_pop_context_text() const;
-		void reserve_needs_fulfilled_goods();
+		void setup_needs_for_type();
 		void fill_needs_fulfilled_goods_with_false();
 		void allocate_for_needs(
-			GoodDefinition::good_definition_map_t const& scaled_needs,
+			GoodDefinition::good_definition_map_t const& type_needs,
+			std::vector<fixed_point_t> const& scaled_needs,
 			fixed_point_t& price_inverse_sum,
 			fixed_point_t& cash_left_to_spend
 		);
@@ -143,6 +157,28 @@ namespace OpenVic {
 		Pop& operator=(Pop const&) = delete;
 		Pop& operator=(Pop&&) = delete;
 
+		pop_size_t get_size() const {
+			return pop_store.sizes[pop_store_slot];
+		}
+		fixed_point_t get_literacy() const {
+			return pop_store.literacies[pop_store_slot];
+		}
+		void set_literacy(const fixed_point_t new_literacy) {
+			pop_store.literacies[pop_store_slot] = new_literacy;
+		}
+		fixed_point_t get_militancy() const {
+			return pop_store.militancies[pop_store_slot];
+		}
+		void set_militancy(const fixed_point_t new_militancy) {
+			pop_store.militancies[pop_store_slot] = new_militancy;
+		}
+		fixed_point_t get_consciousness() const {
+			return pop_store.consciousnesses[pop_store_slot];
+		}
+		void set_consciousness(const fixed_point_t new_consciousness) {
+			pop_store.consciousnesses[pop_store_slot] = new_consciousness;
+		}
+
 		void setup_pop_test_values(IssueManager const& issue_manager);
 		bool convert_to_equivalent();
 
@@ -0,0 +1,66 @@
+#include "PopStore.hpp"
+
+#include <algorithm>
+
+#include "openvic-simulation/defines/PopsDefines.hpp"
+#include "openvic-simulation/pop/Pop.hpp"
+#include "openvic-simulation/pop/PopValuesFromProvince.hpp"
+
+using namespace OpenVic;
+
+PopStore::slot_t PopStore::add_pop(PopBase const& pop_base, const fixed_point_t literacy) {
+	const slot_t slot = sizes.size();
+
+	sizes.push_back(pop_base.get_size());
+	literacies.push_back(literacy);
+	militancies.push_back(pop_base.get_militancy());
+	consciousnesses.push_back(pop_base.get_consciousness());
+	strata_indices.push_back(pop_base.get_type()->get_strata().get_index());
+
+	life_needs_scalars.push_back(fixed_point_t::_0());
+	everyday_needs_scalars.push_back(fixed_point_t::_0());
+	luxury_needs_scalars.push_back(fixed_point_t::_0());
+
+	life_needs_fulfilled.push_back(fixed_point_t::_0());
+	everyday_needs_fulfilled.push_back(fixed_point_t::_0());
+	luxury_needs_fulfilled.push_back(fixed_point_t::_0());
+
+	return slot;
+}
+
+size_t PopStore::get_pop_count() const {
+	return sizes.size();
+}
+
+void PopStore::clamp_values() {
+	static constexpr fixed_point_t MIN_MILITANCY = fixed_point_t::_0();
+	static constexpr fixed_point_t MAX_MILITANCY = fixed_point_t::_10();
+	static constexpr fixed_point_t MIN_CONSCIOUSNESS = fixed_point_t::_0();
+	static constexpr fixed_point_t MAX_CONSCIOUSNESS = fixed_point_t::_10();
+	static constexpr fixed_point_t MIN_LITERACY = fixed_point_t::_0_01();
+	static constexpr fixed_point_t MAX_LITERACY = fixed_point_t::_1();
+
+	for (fixed_point_t& militancy : militancies) {
+		militancy = std::clamp(militancy, MIN_MILITANCY, MAX_MILITANCY);
+	}
+	for (fixed_point_t& consciousness : consciousnesses) {
+		consciousness = std::clamp(consciousness, MIN_CONSCIOUSNESS, MAX_CONSCIOUSNESS);
+	}
+	for (fixed_point_t& literacy : literacies) {
+		literacy = std::clamp(literacy, MIN_LITERACY, MAX_LITERACY);
+	}
+}
+
+void PopStore::update_needs_scalars(const slot_t begin, const slot_t end, PopValuesFromProvince const& shared_values) {
+	const fixed_point_t base_con = shared_values.get_defines().get_pdef_base_con();
+	IndexedMap<Strata, PopStrataValuesFromProvince> const& strata_values = shared_values.get_effects_per_strata();
+
+	for (slot_t slot = begin; slot < end; ++slot) {
+		const fixed_point_t base_needs_scalar = (fixed_point_t::_1() + 2 * consciousnesses[slot] / base_con) * sizes[slot];
+		PopStrataValuesFromProvince const& shared_strata_values = strata_values[strata_indices[slot]];
+
+		life_needs_scalars[slot] = base_needs_scalar * shared_strata_values.get_shared_life_needs_scalar();
+		everyday_needs_scalars[slot] = base_needs_scalar * shared_strata_values.get_shared_everyday_needs_scalar();
+		luxury_needs_scalars[slot] = base_needs_scalar * shared_strata_values.get_shared_luxury_needs_scalar();
+	}
+}
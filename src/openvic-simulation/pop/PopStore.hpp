@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/PopSize.hpp"
+#include "openvic-simulation/utility/Getters.hpp"
+
+namespace OpenVic {
+	struct Pop;
+	struct PopBase;
+	struct PopValuesFromProvince;
+
+	/* Structure-of-arrays storage for the per-pop scalars used by the daily pop tick and the gamestate update.
+	 * There is a single store for the whole map, with every pop owning one slot in each column. Pops are added
+	 * province by province, so each province's pops occupy a contiguous range of slots and both map-wide and
+	 * per-province passes over these values are branch-free loops over plain arrays. Slots are never freed or moved, as
+	 * pops are only created during setup and never removed; ProvinceInstance::add_pop_vec checks contiguity before any
+	 * slots are taken. */
+	struct PopStore {
+		friend struct Pop;
+
+		using slot_t = size_t;
+
+	private:
+		std::vector<pop_size_t> PROPERTY(sizes);
+		std::vector<fixed_point_t> PROPERTY(literacies);
+		std::vector<fixed_point_t> PROPERTY(militancies);
+		std::vector<fixed_point_t> PROPERTY(consciousnesses);
+		// Index of the strata of each pop's type, kept in sync by Pop whenever its type changes.
+		std::vector<size_t> PROPERTY(strata_indices);
+
+		// Filled at the start of each province's tick by update_needs_scalars, read by Pop::pop_tick.
+		std::vector<fixed_point_t> PROPERTY(life_needs_scalars);
+		std::vector<fixed_point_t> PROPERTY(everyday_needs_scalars);
+		std::vector<fixed_point_t> PROPERTY(luxury_needs_scalars);
+
+		// Filled by Pop::update_gamestate from the pop's needs accumulators, read by province population rollups.
+		std::vector<fixed_point_t> PROPERTY(life_needs_fulfilled);
+		std::vector<fixed_point_t> PROPERTY(everyday_needs_fulfilled);
+		std::vector<fixed_point_t> PROPERTY(luxury_needs_fulfilled);
+
+	public:
+		// Not thread safe, pops must only be added during setup.
+		slot_t add_pop(PopBase const& pop_base, const fixed_point_t literacy);
+		size_t get_pop_count() const;
+
+		// Clamps militancy, consciousness and literacy to their valid ranges for every pop on the map.
+		void clamp_values();
+		// Calculates the scaled needs of the pops in slots [begin, end), which must all belong to the province
+		// shared_values was last updated for.
+		void update_needs_scalars(const slot_t begin, const slot_t end, PopValuesFromProvince const& shared_values);
+	};
+}
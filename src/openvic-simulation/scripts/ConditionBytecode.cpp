@@ -0,0 +1,760 @@
+#include "ConditionBytecode.hpp"
+
+#include <limits>
+#include <utility>
+
+#include "openvic-simulation/country/CountryDefinition.hpp"
+#include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/economy/GoodDefinition.hpp"
+#include "openvic-simulation/InstanceManager.hpp"
+#include "openvic-simulation/map/MapInstance.hpp"
+#include "openvic-simulation/map/ProvinceDefinition.hpp"
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/map/Region.hpp"
+#include "openvic-simulation/map/State.hpp"
+#include "openvic-simulation/map/TerrainType.hpp"
+#include "openvic-simulation/modifier/Modifier.hpp"
+#include "openvic-simulation/politics/Government.hpp"
+#include "openvic-simulation/politics/Issue.hpp"
+#include "openvic-simulation/politics/NationalValue.hpp"
+#include "openvic-simulation/pop/Culture.hpp"
+#include "openvic-simulation/pop/Pop.hpp"
+#include "openvic-simulation/pop/PopType.hpp"
+#include "openvic-simulation/pop/Religion.hpp"
+#include "openvic-simulation/research/Invention.hpp"
+#include "openvic-simulation/research/Technology.hpp"
+#include "openvic-simulation/types/OrderedContainers.hpp"
+#include "openvic-simulation/utility/Logger.hpp"
+#include "openvic-simulation/utility/StringUtils.hpp"
+
+using namespace OpenVic;
+
+using enum ConditionBytecode::opcode_t;
+
+std::string_view ConditionBytecode::get_opcode_name(opcode_t opcode) {
+	static constexpr std::array<std::string_view, OPCODE_COUNT> opcode_names {
+#define CONDITION_OPCODE_NAME(name) #name,
+		CONDITION_OPCODES(CONDITION_OPCODE_NAME)
+#undef CONDITION_OPCODE_NAME
+	};
+
+	const size_t index = static_cast<size_t>(opcode);
+	return index < OPCODE_COUNT ? opcode_names[index] : "INVALID_OPCODE";
+}
+
+CountryInstance const* ConditionBytecode::scope_t::get_country() const {
+	switch (type) {
+	case scope_type_t::COUNTRY:
+		return static_cast<CountryInstance const*>(item);
+	case scope_type_t::STATE:
+		return static_cast<State const*>(item)->get_owner();
+	default: {
+		ProvinceInstance const* province = get_province();
+		return province != nullptr ? province->get_owner() : nullptr;
+	}
+	}
+}
+
+ProvinceInstance const* ConditionBytecode::scope_t::get_province() const {
+	switch (type) {
+	case scope_type_t::PROVINCE:
+		return static_cast<ProvinceInstance const*>(item);
+	case scope_type_t::POP:
+		return static_cast<Pop const*>(item)->get_location();
+	default:
+		return nullptr;
+	}
+}
+
+State const* ConditionBytecode::scope_t::get_state() const {
+	if (type == scope_type_t::STATE) {
+		return static_cast<State const*>(item);
+	}
+	ProvinceInstance const* province = get_province();
+	return province != nullptr ? province->get_state() : nullptr;
+}
+
+Pop const* ConditionBytecode::scope_t::get_pop() const {
+	return type == scope_type_t::POP ? static_cast<Pop const*>(item) : nullptr;
+}
+
+/* Items are stored as pointers to their own type, rather than to their HasIdentifier base, so that the interpreter
+ * can compare them with the pointers it gets from the game state. */
+static void const* resolve_item(ConditionBytecode::opcode_t opcode, HasIdentifier const* item) {
+	switch (opcode) {
+	case PRIMARY_CULTURE:
+	case ACCEPTED_CULTURE:
+	case CULTURE:
+		return static_cast<Culture const*>(item);
+	case RELIGION:
+		return static_cast<Religion const*>(item);
+	case GOVERNMENT:
+		return static_cast<GovernmentType const*>(item);
+	case TECH_SCHOOL:
+		return static_cast<TechnologySchool const*>(item);
+	case NATIONAL_VALUE:
+		return static_cast<NationalValue const*>(item);
+	case INVENTION:
+		return static_cast<Invention const*>(item);
+	case OWNS:
+	case CONTROLS:
+	case CAPITAL:
+	case PROVINCE_ID:
+		return static_cast<ProvinceDefinition const*>(item);
+	case TERRAIN:
+		return static_cast<TerrainType const*>(item);
+	case REGION:
+		return static_cast<Region const*>(item);
+	case CONTINENT:
+		return static_cast<Continent const*>(item);
+	case TRADE_GOODS:
+		return static_cast<GoodDefinition const*>(item);
+	case HAS_COUNTRY_MODIFIER:
+	case HAS_PROVINCE_MODIFIER:
+		return static_cast<Modifier const*>(item);
+	case POP_TYPE:
+		return static_cast<PopType const*>(item);
+	case STRATA:
+		return static_cast<Strata const*>(item);
+	default:
+		return nullptr;
+	}
+}
+
+static bool has_event_modifier(std::vector<ModifierInstance> const& event_modifiers, void const* modifier) {
+	for (ModifierInstance const& event_modifier : event_modifiers) {
+		if (event_modifier.get_modifier() == modifier) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template<typename T>
+static T const& get_item(ConditionBytecode::instruction_t const& instruction) {
+	return *static_cast<T const*>(instruction.item);
+}
+
+size_t ConditionBytecode::_emit(opcode_t opcode) {
+	instructions.push_back({ opcode });
+	return instructions.size() - 1;
+}
+
+void ConditionBytecode::_compile_list(ConditionNode::condition_list_t const& list, opcode_t jump_opcode) {
+	if (list.empty()) {
+		// An empty AND holds, an empty OR does not.
+		_emit(jump_opcode == JUMP_IF_FALSE ? ALWAYS_TRUE : ALWAYS_FALSE);
+		return;
+	}
+
+	std::vector<size_t> jumps;
+	for (size_t index = 0; index < list.size(); ++index) {
+		_compile_node(list[index]);
+		if (index + 1 < list.size()) {
+			jumps.push_back(_emit(jump_opcode));
+		}
+	}
+	for (const size_t jump : jumps) {
+		instructions[jump].argument = instructions.size();
+	}
+}
+
+void ConditionBytecode::_compile_node(ConditionNode const& node) {
+	static const string_map_t<opcode_t> scope_opcodes {
+		{ "THIS", SCOPE_THIS }, { "FROM", SCOPE_FROM }, { "owner", SCOPE_OWNER }, { "controller", SCOPE_CONTROLLER },
+		{ "capital_scope", SCOPE_CAPITAL }, { "location", SCOPE_LOCATION }, { "state_scope", SCOPE_STATE },
+		{ "any_owned_province", ANY_OWNED_PROVINCE }, { "any_core", ANY_CORE }, { "all_core", ALL_CORE },
+		{ "any_neighbor_country", ANY_NEIGHBOUR_COUNTRY }, { "any_greater_power", ANY_GREATER_POWER },
+		{ "any_state", ANY_STATE }, { "any_pop", ANY_POP }
+	};
+
+	Condition const* condition = node.get_condition();
+	ConditionNode::condition_list_t const* list = std::get_if<ConditionNode::condition_list_t>(&node.get_value());
+
+	if (condition == nullptr || !node.is_valid()) {
+		unsupported_count++;
+		_emit(UNSUPPORTED);
+		return;
+	}
+
+	const std::string_view identifier = condition->get_identifier();
+
+	if (list != nullptr && condition->get_scope_change() == scope_type_t::NO_SCOPE) {
+		if (identifier == "AND") {
+			_compile_list(*list, JUMP_IF_FALSE);
+			return;
+		}
+		if (identifier == "OR") {
+			_compile_list(*list, JUMP_IF_TRUE);
+			return;
+		}
+		if (identifier == "NOT") {
+			// NOT holds if none of its children do.
+			_compile_list(*list, JUMP_IF_TRUE);
+			_emit(NOT);
+			return;
+		}
+	}
+
+	if (list != nullptr && condition->get_scope_change() != scope_type_t::NO_SCOPE) {
+		opcode_t opcode = UNSUPPORTED;
+		void const* item = nullptr;
+
+		const decltype(scope_opcodes)::const_iterator it = scope_opcodes.find(identifier);
+		if (it != scope_opcodes.end()) {
+			opcode = it->second;
+		} else if (node.get_condition_key_item() != nullptr) {
+			if (condition->get_key_identifier_type() == identifier_type_t::COUNTRY_TAG) {
+				opcode = SCOPE_COUNTRY;
+				item = static_cast<CountryDefinition const*>(node.get_condition_key_item());
+			} else if (condition->get_key_identifier_type() == identifier_type_t::PROVINCE_ID) {
+				opcode = SCOPE_PROVINCE;
+				item = static_cast<ProvinceDefinition const*>(node.get_condition_key_item());
+			}
+		}
+
+		if (opcode == UNSUPPORTED) {
+			unsupported_count++;
+			_emit(UNSUPPORTED);
+			return;
+		}
+
+		const size_t scope_index = _emit(opcode);
+		instructions[scope_index].item = item;
+		_compile_list(*list, JUMP_IF_FALSE);
+		instructions[scope_index].argument = instructions.size();
+		return;
+	}
+
+	instruction_t instruction { UNSUPPORTED };
+	if (!_compile_leaf(node, instruction)) {
+		unsupported_count++;
+		instruction = { UNSUPPORTED };
+	}
+	instructions.push_back(instruction);
+}
+
+bool ConditionBytecode::_compile_leaf(ConditionNode const& node, instruction_t& instruction) {
+	enum struct operand_t : uint8_t { BOOLEAN, INTEGER, REAL, ITEM, COUNTRY, STRING };
+
+	struct leaf_t {
+		opcode_t opcode;
+		operand_t operand;
+	};
+
+	using enum operand_t;
+
+	static const string_map_t<leaf_t> leaves {
+		{ "always", { ALWAYS_TRUE, BOOLEAN } },
+		{ "year", { YEAR, INTEGER } },
+		{ "month", { MONTH, INTEGER } },
+		{ "has_global_flag", { HAS_GLOBAL_FLAG, STRING } },
+
+		{ "tag", { TAG, COUNTRY } },
+		{ "neighbour", { NEIGHBOUR, COUNTRY } },
+		{ "civilized", { CIVILISED, BOOLEAN } },
+		{ "is_greater_power", { GREAT_POWER, BOOLEAN } },
+		{ "is_secondary_power", { SECONDARY_POWER, BOOLEAN } },
+		{ "war", { AT_WAR, BOOLEAN } },
+		{ "is_disarmed", { DISARMED, BOOLEAN } },
+		{ "is_mobilised", { MOBILISED, BOOLEAN } },
+		{ "rank", { RANK, INTEGER } },
+		{ "total_pops", { TOTAL_POPS, INTEGER } },
+		{ "prestige", { PRESTIGE, REAL } },
+		{ "money", { MONEY, REAL } },
+		{ "treasury", { MONEY, REAL } },
+		{ "badboy", { INFAMY, REAL } },
+		{ "plurality", { PLURALITY, REAL } },
+		{ "revanchism", { REVANCHISM, REAL } },
+		{ "war_exhaustion", { WAR_EXHAUSTION, REAL } },
+		{ "civilization_progress", { CIVILISATION_PROGRESS, REAL } },
+		{ "has_country_flag", { HAS_COUNTRY_FLAG, STRING } },
+		{ "has_country_modifier", { HAS_COUNTRY_MODIFIER, ITEM } },
+		{ "primary_culture", { PRIMARY_CULTURE, ITEM } },
+		{ "accepted_culture", { ACCEPTED_CULTURE, ITEM } },
+		{ "government", { GOVERNMENT, ITEM } },
+		{ "tech_school", { TECH_SCHOOL, ITEM } },
+		{ "nationalvalue", { NATIONAL_VALUE, ITEM } },
+		{ "invention", { INVENTION, ITEM } },
+		{ "owns", { OWNS, ITEM } },
+		{ "controls", { CONTROLS, ITEM } },
+		{ "capital", { CAPITAL, ITEM } },
+
+		{ "literacy", { LITERACY, REAL } },
+		{ "militancy", { MILITANCY, REAL } },
+		{ "average_militancy", { MILITANCY, REAL } },
+		{ "consciousness", { CONSCIOUSNESS, REAL } },
+		{ "average_consciousness", { CONSCIOUSNESS, REAL } },
+		{ "culture", { CULTURE, ITEM } },
+		{ "religion", { RELIGION, ITEM } },
+
+		{ "has_province_flag", { HAS_PROVINCE_FLAG, STRING } },
+		{ "has_province_modifier", { HAS_PROVINCE_MODIFIER, ITEM } },
+		{ "province_id", { PROVINCE_ID, ITEM } },
+		{ "is_capital", { IS_CAPITAL, BOOLEAN } },
+		{ "is_coastal", { IS_COASTAL, BOOLEAN } },
+		{ "port", { PORT, BOOLEAN } },
+		{ "life_rating", { LIFE_RATING, REAL } },
+		{ "terrain", { TERRAIN, ITEM } },
+		{ "region", { REGION, ITEM } },
+		{ "continent", { CONTINENT, ITEM } },
+		{ "trade_goods", { TRADE_GOODS, ITEM } },
+
+		{ "pop_type", { POP_TYPE, ITEM } },
+		{ "type", { POP_TYPE, ITEM } },
+		{ "strata", { STRATA, ITEM } },
+		{ "unemployment", { UNEMPLOYMENT, REAL } }
+	};
+
+	Condition const& condition = *node.get_condition();
+	ConditionNode::value_t const& value = node.get_value();
+
+	// Conditions imported from other registries are keyed by the item they test.
+	switch (condition.get_key_identifier_type()) {
+	case identifier_type_t::NO_IDENTIFIER:
+		break;
+	case identifier_type_t::TECHNOLOGY:
+		if (!std::holds_alternative<bool>(value) || node.get_condition_key_item() == nullptr) {
+			return false;
+		}
+		instruction.opcode = TECHNOLOGY;
+		instruction.expected = std::get<bool>(value);
+		instruction.item = static_cast<Technology const*>(node.get_condition_key_item());
+		return true;
+	case identifier_type_t::REFORM_GROUP:
+		if (node.get_condition_value_item() == nullptr) {
+			return false;
+		}
+		instruction.opcode = REFORM;
+		instruction.item = static_cast<Reform const*>(node.get_condition_value_item());
+		return true;
+	default:
+		return false;
+	}
+
+	const std::string_view identifier = condition.get_identifier();
+
+	// exists takes either a boolean, testing the current scope, or a tag.
+	if (identifier == "exists") {
+		if (std::holds_alternative<bool>(value)) {
+			instruction.opcode = EXISTS;
+			instruction.expected = std::get<bool>(value);
+			return true;
+		}
+		instruction.opcode = EXISTS_COUNTRY;
+	} else {
+		const decltype(leaves)::const_iterator it = leaves.find(identifier);
+		if (it == leaves.end()) {
+			return false;
+		}
+		instruction.opcode = it->second.opcode;
+
+		switch (it->second.operand) {
+		case BOOLEAN:
+			if (!std::holds_alternative<bool>(value)) {
+				return false;
+			}
+			instruction.expected = std::get<bool>(value);
+			return true;
+		case INTEGER: {
+			if (!std::holds_alternative<ConditionNode::integer_t>(value)) {
+				return false;
+			}
+			// Operands too large for the argument are rejected rather than clamped, negative ones fail to parse.
+			const ConditionNode::integer_t integer = std::get<ConditionNode::integer_t>(value);
+			if (!std::in_range<uint32_t>(integer)) {
+				Logger::error(
+					"Condition ", identifier, " has integer operand ", integer, " outside the supported range [0, ",
+					std::numeric_limits<uint32_t>::max(), "]"
+				);
+				return false;
+			}
+			instruction.argument = integer;
+			return true;
+		}
+		case REAL:
+			if (!std::holds_alternative<ConditionNode::real_t>(value)) {
+				return false;
+			}
+			instruction.value = std::get<ConditionNode::real_t>(value);
+			return true;
+		case ITEM:
+			instruction.item = resolve_item(instruction.opcode, node.get_condition_value_item());
+			return instruction.item != nullptr;
+		case STRING:
+			if (!std::holds_alternative<ConditionNode::string_t>(value)) {
+				return false;
+			}
+			instruction.argument = strings.size();
+			strings.push_back(std::get<ConditionNode::string_t>(value));
+			return true;
+		case COUNTRY:
+			break;
+		}
+	}
+
+	// Country operands are either a tag, resolved at compile time, or THIS or FROM, resolved when evaluating.
+	if (node.get_condition_value_item() != nullptr) {
+		instruction.item = static_cast<CountryDefinition const*>(node.get_condition_value_item());
+		return true;
+	}
+	if (!std::holds_alternative<ConditionNode::string_t>(value)) {
+		return false;
+	}
+	const std::string_view country = std::get<ConditionNode::string_t>(value);
+	if (StringUtils::strings_equal_case_insensitive(country, "THIS")) {
+		instruction.argument = THIS_COUNTRY;
+		return true;
+	}
+	if (StringUtils::strings_equal_case_insensitive(country, "FROM")) {
+		instruction.argument = FROM_COUNTRY;
+		return true;
+	}
+	return false;
+}
+
+void ConditionBytecode::compile(ConditionNode const& root) {
+	instructions.clear();
+	strings.clear();
+	unsupported_count = 0;
+
+	_compile_node(root);
+}
+
+bool ConditionBytecode::empty() const {
+	return instructions.empty();
+}
+
+template<bool Profile>
+bool ConditionBytecode::_run(
+	context_t const& context, scope_t scope, uint32_t begin, uint32_t end, profile_t* profile, bool& indeterminate
+) const {
+	CountryInstanceManager const& country_instance_manager = context.instance_manager.get_country_instance_manager();
+
+	bool result = true;
+	uint32_t index = begin;
+
+	while (index < end) {
+		// Set by an UNSUPPORTED instruction in this range or a body run from it, after which no result is meaningful.
+		if (indeterminate) {
+			return false;
+		}
+
+		instruction_t const& instruction = instructions[index];
+		if constexpr (Profile) {
+			(*profile)[static_cast<size_t>(instruction.opcode)]++;
+		}
+
+		const auto run_body = [this, &context, &instruction, index, profile, &indeterminate](scope_t body_scope) -> bool {
+			return body_scope.type != scope_type_t::NO_SCOPE &&
+				_run<Profile>(context, body_scope, index + 1, instruction.argument, profile, indeterminate);
+		};
+
+		const auto get_country_operand = [&context, &country_instance_manager, &instruction]() -> CountryInstance const* {
+			if (instruction.item != nullptr) {
+				return &country_instance_manager.get_country_instance_from_definition(
+					*static_cast<CountryDefinition const*>(instruction.item)
+				);
+			}
+			return (instruction.argument == THIS_COUNTRY ? context.this_scope : context.from_scope).get_country();
+		};
+
+#define SCOPE_CASE(opcode, body_scope) \
+	case opcode: \
+		result = run_body(body_scope); \
+		index = instruction.argument; \
+		continue;
+
+#define LEAF_CASE(opcode, type, getter, expression) \
+	case opcode: { \
+		type const* leaf_scope = scope.getter(); \
+		result = leaf_scope != nullptr && (expression); \
+		break; \
+	}
+
+#define COUNTRY_CASE(opcode, expression) LEAF_CASE(opcode, CountryInstance, get_country, expression)
+#define PROVINCE_CASE(opcode, expression) LEAF_CASE(opcode, ProvinceInstance, get_province, expression)
+#define POP_CASE(opcode, expression) LEAF_CASE(opcode, Pop, get_pop, expression)
+
+		switch (instruction.opcode) {
+		case ALWAYS_TRUE:
+			result = instruction.expected;
+			break;
+		case ALWAYS_FALSE:
+			result = false;
+			break;
+		case UNSUPPORTED:
+			// Not false, as then a NOT or OR above it could make the whole condition hold when it shouldn't.
+			indeterminate = true;
+			return false;
+		case NOT:
+			result = !result;
+			break;
+		case JUMP_IF_FALSE:
+			if (!result) {
+				index = instruction.argument;
+				continue;
+			}
+			break;
+		case JUMP_IF_TRUE:
+			if (result) {
+				index = instruction.argument;
+				continue;
+			}
+			break;
+
+		SCOPE_CASE(SCOPE_THIS, context.this_scope)
+		SCOPE_CASE(SCOPE_FROM, context.from_scope)
+		SCOPE_CASE(SCOPE_OWNER, scope.get_country())
+		SCOPE_CASE(
+			SCOPE_CONTROLLER, scope.get_province() != nullptr ? scope.get_province()->get_controller() : nullptr
+		)
+		SCOPE_CASE(SCOPE_CAPITAL, scope.get_country() != nullptr ? scope.get_country()->get_capital() : nullptr)
+		SCOPE_CASE(SCOPE_LOCATION, scope.get_province())
+		SCOPE_CASE(SCOPE_STATE, scope.get_state())
+		SCOPE_CASE(
+			SCOPE_COUNTRY, &country_instance_manager.get_country_instance_from_definition(
+				get_item<CountryDefinition>(instruction)
+			)
+		)
+		SCOPE_CASE(
+			SCOPE_PROVINCE, &context.instance_manager.get_map_instance().get_province_instance_from_definition(
+				get_item<ProvinceDefinition>(instruction)
+			)
+		)
+
+		case ANY_OWNED_PROVINCE:
+		case ANY_CORE:
+		case ALL_CORE:
+		case ANY_NEIGHBOUR_COUNTRY:
+		case ANY_STATE: {
+			// all_ scopes hold unless their body fails for an element, any_ scopes hold once it succeeds for one.
+			const bool all = instruction.opcode == ALL_CORE;
+			result = all;
+			CountryInstance const* country = scope.get_country();
+			if (country != nullptr) {
+				const auto iterate = [&run_body, &result, all](auto const& elements) -> void {
+					for (auto const* element : elements) {
+						if (run_body(element) != all) {
+							result = !all;
+							return;
+						}
+					}
+				};
+				switch (instruction.opcode) {
+				case ANY_OWNED_PROVINCE:
+					iterate(country->get_owned_provinces());
+					break;
+				case ANY_NEIGHBOUR_COUNTRY:
+					iterate(country->get_neighbouring_countries());
+					break;
+				case ANY_STATE:
+					iterate(country->get_states());
+					break;
+				default:
+					iterate(country->get_core_provinces());
+					break;
+				}
+			}
+			index = instruction.argument;
+			continue;
+		}
+		case ANY_GREATER_POWER: {
+			result = false;
+			for (CountryInstance const* great_power : country_instance_manager.get_great_powers()) {
+				if (run_body(great_power)) {
+					result = true;
+					break;
+				}
+			}
+			index = instruction.argument;
+			continue;
+		}
+		case ANY_POP: {
+			const auto any_pop_in = [&run_body](ProvinceInstance const* province) -> bool {
+				for (Pop const& pop : province->get_pops()) {
+					if (run_body(&pop)) {
+						return true;
+					}
+				}
+				return false;
+			};
+			result = false;
+			if (scope.type == scope_type_t::STATE) {
+				for (ProvinceInstance const* province : static_cast<State const*>(scope.item)->get_provinces()) {
+					if (any_pop_in(province)) {
+						result = true;
+						break;
+					}
+				}
+			} else if (scope.type == scope_type_t::PROVINCE) {
+				result = any_pop_in(static_cast<ProvinceInstance const*>(scope.item));
+			} else if (CountryInstance const* country = scope.get_country(); country != nullptr) {
+				for (ProvinceInstance const* province : country->get_owned_provinces()) {
+					if (any_pop_in(province)) {
+						result = true;
+						break;
+					}
+				}
+			}
+			index = instruction.argument;
+			continue;
+		}
+
+		case YEAR:
+			result = context.instance_manager.get_today().get_year() >= instruction.argument;
+			break;
+		case MONTH:
+			// Script months count from 0.
+			result = context.instance_manager.get_today().get_month() - 1 >= static_cast<int64_t>(instruction.argument);
+			break;
+		case HAS_GLOBAL_FLAG:
+			result = context.instance_manager.get_global_flags().has_flag(strings[instruction.argument]);
+			break;
+
+		COUNTRY_CASE(
+			TAG, instruction.item != nullptr
+				? leaf_scope->get_country_definition() == instruction.item
+				: leaf_scope == get_country_operand()
+		)
+		COUNTRY_CASE(EXISTS, leaf_scope->exists() == instruction.expected)
+		case EXISTS_COUNTRY: {
+			CountryInstance const* country = get_country_operand();
+			result = country != nullptr && country->exists();
+			break;
+		}
+		COUNTRY_CASE(NEIGHBOUR, get_country_operand() != nullptr && leaf_scope->is_neighbour(*get_country_operand()))
+		COUNTRY_CASE(CIVILISED, leaf_scope->is_civilised() == instruction.expected)
+		COUNTRY_CASE(GREAT_POWER, leaf_scope->is_great_power() == instruction.expected)
+		COUNTRY_CASE(SECONDARY_POWER, leaf_scope->is_secondary_power() == instruction.expected)
+		COUNTRY_CASE(AT_WAR, leaf_scope->is_at_war() == instruction.expected)
+		COUNTRY_CASE(DISARMED, leaf_scope->is_disarmed() == instruction.expected)
+		COUNTRY_CASE(MOBILISED, leaf_scope->is_mobilised() == instruction.expected)
+		// A rank of 0 means the country is not ranked.
+		COUNTRY_CASE(RANK, leaf_scope->get_total_rank() > 0 && leaf_scope->get_total_rank() <= instruction.argument)
+		COUNTRY_CASE(TOTAL_POPS, leaf_scope->get_total_population() >= static_cast<pop_size_t>(instruction.argument))
+		COUNTRY_CASE(PRESTIGE, leaf_scope->get_prestige() >= instruction.value)
+		COUNTRY_CASE(MONEY, leaf_scope->get_cash_stockpile() >= instruction.value)
+		COUNTRY_CASE(INFAMY, leaf_scope->get_infamy() >= instruction.value)
+		COUNTRY_CASE(PLURALITY, leaf_scope->get_plurality() >= instruction.value)
+		COUNTRY_CASE(REVANCHISM, leaf_scope->get_revanchism() >= instruction.value)
+		COUNTRY_CASE(WAR_EXHAUSTION, leaf_scope->get_war_exhaustion() >= instruction.value)
+		COUNTRY_CASE(CIVILISATION_PROGRESS, leaf_scope->get_civilisation_progress() >= instruction.value)
+		COUNTRY_CASE(HAS_COUNTRY_FLAG, leaf_scope->has_flag(strings[instruction.argument]))
+		COUNTRY_CASE(HAS_COUNTRY_MODIFIER, has_event_modifier(leaf_scope->get_event_modifiers(), instruction.item))
+		COUNTRY_CASE(PRIMARY_CULTURE, leaf_scope->is_primary_culture(get_item<Culture>(instruction)))
+		COUNTRY_CASE(ACCEPTED_CULTURE, leaf_scope->is_accepted_culture(get_item<Culture>(instruction)))
+		COUNTRY_CASE(GOVERNMENT, leaf_scope->get_government_type() == instruction.item)
+		COUNTRY_CASE(TECH_SCHOOL, leaf_scope->get_tech_school() == instruction.item)
+		COUNTRY_CASE(NATIONAL_VALUE, leaf_scope->get_national_value() == instruction.item)
+		COUNTRY_CASE(
+			TECHNOLOGY, leaf_scope->is_technology_unlocked(get_item<Technology>(instruction)) == instruction.expected
+		)
+		COUNTRY_CASE(INVENTION, leaf_scope->is_invention_unlocked(get_item<Invention>(instruction)))
+		COUNTRY_CASE(
+			REFORM, leaf_scope->get_reforms()[get_item<Reform>(instruction).get_reform_group()] == instruction.item
+		)
+		COUNTRY_CASE(
+			OWNS, context.instance_manager.get_map_instance().get_province_instance_from_definition(
+				get_item<ProvinceDefinition>(instruction)
+			).get_owner() == leaf_scope
+		)
+		COUNTRY_CASE(
+			CONTROLS, context.instance_manager.get_map_instance().get_province_instance_from_definition(
+				get_item<ProvinceDefinition>(instruction)
+			).get_controller() == leaf_scope
+		)
+		COUNTRY_CASE(
+			CAPITAL, leaf_scope->get_capital() != nullptr &&
+				&leaf_scope->get_capital()->get_province_definition() == instruction.item
+		)
+
+		case LITERACY:
+		case MILITANCY:
+		case CONSCIOUSNESS: {
+			fixed_point_t scope_value;
+			if (Pop const* pop = scope.get_pop(); pop != nullptr) {
+				scope_value = instruction.opcode == LITERACY ? pop->get_literacy()
+					: instruction.opcode == MILITANCY ? pop->get_militancy() : pop->get_consciousness();
+			} else if (scope.type == scope_type_t::PROVINCE) {
+				ProvinceInstance const* province = static_cast<ProvinceInstance const*>(scope.item);
+				scope_value = instruction.opcode == LITERACY ? province->get_average_literacy()
+					: instruction.opcode == MILITANCY ? province->get_average_militancy()
+					: province->get_average_consciousness();
+			} else if (scope.type == scope_type_t::STATE) {
+				State const* state = static_cast<State const*>(scope.item);
+				scope_value = instruction.opcode == LITERACY ? state->get_average_literacy()
+					: instruction.opcode == MILITANCY ? state->get_average_militancy()
+					: state->get_average_consciousness();
+			} else if (scope.type == scope_type_t::COUNTRY) {
+				CountryInstance const* country = static_cast<CountryInstance const*>(scope.item);
+				scope_value = instruction.opcode == LITERACY ? country->get_national_literacy()
+					: instruction.opcode == MILITANCY ? country->get_national_militancy()
+					: country->get_national_consciousness();
+			} else {
+				result = false;
+				break;
+			}
+			result = scope_value >= instruction.value;
+			break;
+		}
+		case CULTURE:
+			if (Pop const* pop = scope.get_pop(); pop != nullptr) {
+				result = &pop->get_culture() == instruction.item;
+			} else {
+				CountryInstance const* country = scope.get_country();
+				result = country != nullptr && country->is_primary_or_accepted_culture(get_item<Culture>(instruction));
+			}
+			break;
+		case RELIGION:
+			if (Pop const* pop = scope.get_pop(); pop != nullptr) {
+				result = &pop->get_religion() == instruction.item;
+			} else {
+				CountryInstance const* country = scope.get_country();
+				result = country != nullptr && country->get_religion() == instruction.item;
+			}
+			break;
+
+		PROVINCE_CASE(HAS_PROVINCE_FLAG, leaf_scope->has_flag(strings[instruction.argument]))
+		PROVINCE_CASE(HAS_PROVINCE_MODIFIER, has_event_modifier(leaf_scope->get_event_modifiers(), instruction.item))
+		PROVINCE_CASE(PROVINCE_ID, &leaf_scope->get_province_definition() == instruction.item)
+		PROVINCE_CASE(
+			IS_CAPITAL, (leaf_scope->get_owner() != nullptr && leaf_scope->get_owner()->get_capital() == leaf_scope) ==
+				instruction.expected
+		)
+		PROVINCE_CASE(IS_COASTAL, leaf_scope->get_province_definition().is_coastal() == instruction.expected)
+		PROVINCE_CASE(PORT, leaf_scope->get_province_definition().has_port() == instruction.expected)
+		PROVINCE_CASE(LIFE_RATING, fixed_point_t::parse(leaf_scope->get_life_rating()) >= instruction.value)
+		PROVINCE_CASE(TERRAIN, leaf_scope->get_terrain_type() == instruction.item)
+		PROVINCE_CASE(REGION, get_item<Region>(instruction).contains_province(&leaf_scope->get_province_definition()))
+		PROVINCE_CASE(CONTINENT, leaf_scope->get_province_definition().get_continent() == instruction.item)
+		PROVINCE_CASE(TRADE_GOODS, leaf_scope->get_rgo_good() == instruction.item)
+
+		POP_CASE(POP_TYPE, leaf_scope->get_type() == instruction.item)
+		POP_CASE(STRATA, leaf_scope->get_type() != nullptr && &leaf_scope->get_type()->get_strata() == instruction.item)
+		POP_CASE(UNEMPLOYMENT, leaf_scope->get_unemployment() >= instruction.value)
+
+		case opcode_t::OPCODE_COUNT:
+			result = false;
+			break;
+		}
+
+#undef POP_CASE
+#undef PROVINCE_CASE
+#undef COUNTRY_CASE
+#undef LEAF_CASE
+#undef SCOPE_CASE
+
+		++index;
+	}
+
+	return result && !indeterminate;
+}
+
+bool ConditionBytecode::evaluate(context_t const& context, scope_t scope, profile_t* profile) const {
+	bool indeterminate = false;
+	const bool result = profile != nullptr
+		? _run<true>(context, scope, 0, instructions.size(), profile, indeterminate)
+		: _run<false>(context, scope, 0, instructions.size(), nullptr, indeterminate);
+	return result && !indeterminate;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "openvic-simulation/scripts/Condition.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/utility/Getters.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
+
+namespace OpenVic {
+	struct InstanceManager;
+	struct CountryInstance;
+	struct ProvinceInstance;
+	struct State;
+	struct Pop;
+
+	/* Opcodes are listed with the X macro so that their names can be printed alongside profiling counts.
+	 * Leaves set the result to whether their condition holds in the current scope. Country leaves fall back to the owner
+	 * of a province, state or pop scope, and province leaves to the location of a pop scope, as the parser allows them
+	 * in smaller scopes. */
+#define CONDITION_OPCODES(X) \
+	/* Control flow */ \
+	X(ALWAYS_TRUE) X(ALWAYS_FALSE) X(UNSUPPORTED) X(NOT) X(JUMP_IF_FALSE) X(JUMP_IF_TRUE) \
+	/* Scope changes, evaluating the instructions up to argument in the new scope */ \
+	X(SCOPE_THIS) X(SCOPE_FROM) X(SCOPE_OWNER) X(SCOPE_CONTROLLER) X(SCOPE_CAPITAL) X(SCOPE_LOCATION) X(SCOPE_STATE) \
+	X(SCOPE_COUNTRY) X(SCOPE_PROVINCE) \
+	X(ANY_OWNED_PROVINCE) X(ANY_CORE) X(ALL_CORE) X(ANY_NEIGHBOUR_COUNTRY) X(ANY_GREATER_POWER) X(ANY_STATE) X(ANY_POP) \
+	/* Global leaves */ \
+	X(YEAR) X(MONTH) X(HAS_GLOBAL_FLAG) \
+	/* Country leaves */ \
+	X(TAG) X(EXISTS) X(EXISTS_COUNTRY) X(NEIGHBOUR) X(CIVILISED) X(GREAT_POWER) X(SECONDARY_POWER) X(AT_WAR) X(DISARMED) \
+	X(MOBILISED) X(RANK) X(TOTAL_POPS) X(PRESTIGE) X(MONEY) X(INFAMY) X(PLURALITY) X(REVANCHISM) X(WAR_EXHAUSTION) \
+	X(CIVILISATION_PROGRESS) X(HAS_COUNTRY_FLAG) X(HAS_COUNTRY_MODIFIER) X(PRIMARY_CULTURE) X(ACCEPTED_CULTURE) \
+	X(GOVERNMENT) X(TECH_SCHOOL) X(NATIONAL_VALUE) X(TECHNOLOGY) X(INVENTION) X(REFORM) X(OWNS) X(CONTROLS) X(CAPITAL) \
+	/* Leaves using a pop scope's own value, and otherwise the province or state average or the national value, except \
+	 * for culture and religion which use the owner's */ \
+	X(LITERACY) X(MILITANCY) X(CONSCIOUSNESS) X(CULTURE) X(RELIGION) \
+	/* Province leaves */ \
+	X(HAS_PROVINCE_FLAG) X(HAS_PROVINCE_MODIFIER) X(PROVINCE_ID) X(IS_CAPITAL) X(IS_COASTAL) X(PORT) X(LIFE_RATING) \
+	X(TERRAIN) X(REGION) X(CONTINENT) X(TRADE_GOODS) \
+	/* Pop leaves */ \
+	X(POP_TYPE) X(STRATA) X(UNEMPLOYMENT)
+
+	/* A ConditionNode tree lowered to a flat array of instructions whose operands are resolved to definition pointers,
+	 * so that evaluating it involves no string lookups or variant visits. AND and OR lists short-circuit by jumping to
+	 * their end once their result is known, and a scope change's body is the range of instructions following it.
+	 * Conditions without an implementation compile to UNSUPPORTED and are counted so that missing coverage can be
+	 * reported. Reaching one makes the whole evaluation false, whatever NOTs or ORs enclose it, as otherwise e.g.
+	 * NOT = { <unsupported> } would always hold. */
+	struct ConditionBytecode {
+		enum struct opcode_t : uint8_t {
+#define CONDITION_OPCODE_ENUM(name) name,
+			CONDITION_OPCODES(CONDITION_OPCODE_ENUM)
+#undef CONDITION_OPCODE_ENUM
+			OPCODE_COUNT
+		};
+
+		static constexpr size_t OPCODE_COUNT = static_cast<size_t>(opcode_t::OPCODE_COUNT);
+
+		// Executions of each opcode, indexed by opcode.
+		using profile_t = std::array<uint64_t, OPCODE_COUNT>;
+
+		// The object a condition is evaluated against, one of the types in scope_type_t.
+		struct scope_t {
+			scope_type_t type = scope_type_t::NO_SCOPE;
+			void const* item = nullptr;
+
+			constexpr scope_t() = default;
+			constexpr scope_t(CountryInstance const* country)
+				: type { country != nullptr ? scope_type_t::COUNTRY : scope_type_t::NO_SCOPE }, item { country } {}
+			constexpr scope_t(ProvinceInstance const* province)
+				: type { province != nullptr ? scope_type_t::PROVINCE : scope_type_t::NO_SCOPE }, item { province } {}
+			constexpr scope_t(State const* state)
+				: type { state != nullptr ? scope_type_t::STATE : scope_type_t::NO_SCOPE }, item { state } {}
+			constexpr scope_t(Pop const* pop)
+				: type { pop != nullptr ? scope_type_t::POP : scope_type_t::NO_SCOPE }, item { pop } {}
+
+			// These return the item itself or the item it falls back to, or nullptr if there is none.
+			CountryInstance const* get_country() const;
+			ProvinceInstance const* get_province() const;
+			State const* get_state() const;
+			Pop const* get_pop() const;
+		};
+
+		struct context_t {
+			InstanceManager const& instance_manager;
+			scope_t this_scope;
+			scope_t from_scope;
+		};
+
+		struct instruction_t {
+			opcode_t opcode;
+			// The value a boolean leaf must have for the condition to hold.
+			bool expected = true;
+			/* Jump target or end of a scope change's body as an instruction index, an integer operand, an index into
+			 * strings, or for leaves taking a country whose item is nullptr, THIS_COUNTRY or FROM_COUNTRY. */
+			uint32_t argument = 0;
+			fixed_point_t value;
+			void const* item = nullptr;
+		};
+
+		static constexpr uint32_t THIS_COUNTRY = 1, FROM_COUNTRY = 2;
+
+		static std::string_view get_opcode_name(opcode_t opcode);
+
+	private:
+		std::vector<instruction_t> PROPERTY(instructions);
+		std::vector<std::string> strings;
+		size_t PROPERTY(unsupported_count, 0);
+
+		size_t _emit(opcode_t opcode);
+		void _compile_node(ConditionNode const& node);
+		void _compile_list(ConditionNode::condition_list_t const& list, opcode_t jump_opcode);
+		bool _compile_leaf(ConditionNode const& node, instruction_t& instruction);
+
+		template<bool Profile>
+		bool _run(
+			context_t const& context, scope_t scope, uint32_t begin, uint32_t end, profile_t* profile,
+			bool& indeterminate
+		) const;
+
+	public:
+		// Replaces any previously compiled bytecode.
+		void compile(ConditionNode const& root);
+
+		bool empty() const;
+
+		/* Must not run concurrently with changes to the state being read. Profiling counts are added to profile if it
+		 * is not null, it is left out of the interpreter entirely otherwise. */
+		bool evaluate(context_t const& context, scope_t scope, profile_t* profile = nullptr) const;
+
+		/* Evaluates the condition for every item, e.g. all provinces or all countries, in parallel, setting results[i] to
+		 * 1 if it holds for items[i] and 0 otherwise. results must be at least as long as items. */
+		template<typename T>
+		void evaluate_batch(
+			context_t const& context, std::span<T const> items, std::span<uint8_t> results, profile_t* profile = nullptr
+		) const {
+			ThreadPool& thread_pool = ThreadPool::get_instance();
+			std::vector<profile_t> worker_profiles(profile != nullptr ? thread_pool.get_worker_count() : 0);
+
+			thread_pool.parallel_for(
+				items.size(),
+				[this, &context, items, results, &worker_profiles](size_t begin, size_t end) -> void {
+					profile_t* worker_profile = worker_profiles.empty()
+						? nullptr : &worker_profiles[ThreadPool::get_current_worker_index()];
+					for (size_t index = begin; index < end; ++index) {
+						results[index] = evaluate(context, &items[index], worker_profile);
+					}
+				}
+			);
+
+			for (profile_t const& worker_profile : worker_profiles) {
+				for (size_t opcode = 0; opcode < OPCODE_COUNT; ++opcode) {
+					(*profile)[opcode] += worker_profile[opcode];
+				}
+			}
+		}
+	};
+}
@@ -10,11 +10,15 @@ ConditionScript::ConditionScript(
 ) : initial_scope { new_initial_scope }, this_scope { new_this_scope }, from_scope { new_from_scope } {}
 
 bool ConditionScript::_parse_script(ast::NodeCPtr root, DefinitionManager const& definition_manager) {
-	return definition_manager.get_script_manager().get_condition_manager().expect_condition_script(
+	const bool ret = definition_manager.get_script_manager().get_condition_manager().expect_condition_script(
 		definition_manager,
 		initial_scope,
 		this_scope,
 		from_scope,
 		move_variable_callback(condition_root)
 	)(root);
+
+	bytecode.compile(condition_root);
+
+	return ret;
 }
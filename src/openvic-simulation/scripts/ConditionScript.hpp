@@ -1,6 +1,7 @@
 #pragma once
 
 #include "openvic-simulation/scripts/Condition.hpp"
+#include "openvic-simulation/scripts/ConditionBytecode.hpp"
 #include "openvic-simulation/scripts/Script.hpp"
 
 namespace OpenVic {
@@ -13,6 +14,8 @@ namespace OpenVic {
 		scope_type_t PROPERTY(initial_scope);
 		scope_type_t PROPERTY(this_scope);
 		scope_type_t PROPERTY(from_scope);
+		// Compiled from condition_root once it has been parsed.
+		ConditionBytecode PROPERTY(bytecode);
 
 	protected:
 		bool _parse_script(ast::NodeCPtr root, DefinitionManager const& definition_manager) override;
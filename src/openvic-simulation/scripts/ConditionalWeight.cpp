@@ -128,6 +128,36 @@ bool ConditionalWeight<TYPE>::parse_scripts(DefinitionManager const& definition_
 	return parse_scripts_visitor_t { definition_manager }(condition_weight_items);
 }
 
+template<conditional_weight_type_t TYPE>
+fixed_point_t ConditionalWeight<TYPE>::evaluate(
+	ConditionBytecode::context_t const& context, ConditionBytecode::scope_t scope
+) const {
+	fixed_point_t result = base;
+
+	const auto apply = [&context, scope, &result](condition_weight_t const& condition_weight) -> void {
+		if (condition_weight.second.get_bytecode().evaluate(context, scope)) {
+			if constexpr (conditional_weight_type_is_additive(TYPE)) {
+				result += condition_weight.first;
+			} else {
+				result *= condition_weight.first;
+			}
+		}
+	};
+
+	// A group's modifiers are applied the same way as ungrouped ones.
+	for (condition_weight_item_t const& item : condition_weight_items) {
+		if (condition_weight_t const* condition_weight = std::get_if<condition_weight_t>(&item)) {
+			apply(*condition_weight);
+		} else {
+			for (condition_weight_t const& grouped_condition_weight : std::get<condition_weight_group_t>(item)) {
+				apply(grouped_condition_weight);
+			}
+		}
+	}
+
+	return result;
+}
+
 template<conditional_weight_type_t TYPE>
 bool ConditionalWeight<TYPE>::operator==(ConditionalWeight const& other) const {
 	return initial_scope == other.initial_scope &&
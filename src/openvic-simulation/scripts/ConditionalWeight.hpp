@@ -47,6 +47,10 @@ namespace OpenVic {
 
 		bool parse_scripts(DefinitionManager const& definition_manager);
 
+		/* Applies the factors of the modifiers whose conditions hold to base, adding them for additive types and
+		 * multiplying by them for multiplicative types. */
+		fixed_point_t evaluate(ConditionBytecode::context_t const& context, ConditionBytecode::scope_t scope) const;
+
 		// Used mainly to check if a ConditionalWeight has been properly initialised by comparing against {}
 		bool operator==(ConditionalWeight const& other) const;
 	};
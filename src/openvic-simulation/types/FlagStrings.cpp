@@ -12,7 +12,9 @@ bool FlagStrings::set_flag(std::string_view flag, bool warn) {
 		return false;
 	}
 
-	if (!flags.emplace(flag).second && warn) {
+	if (flags.emplace(flag).second) {
+		flag_revision++;
+	} else if (warn) {
 		Logger::warning("Attempted to set ", name, " flag \"", flag, "\": already set!");
 	}
 
@@ -25,7 +27,9 @@ bool FlagStrings::clear_flag(std::string_view flag, bool warn) {
 		return false;
 	}
 
-	if (flags.erase(flag) == 0 && warn) {
+	if (flags.erase(flag) != 0) {
+		flag_revision++;
+	} else if (warn) {
 		Logger::warning("Attempted to clear ", name, " flag \"", flag, "\": not set!");
 	}
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -11,6 +12,8 @@ namespace OpenVic {
 	struct FlagStrings {
 	private:
 		string_set_t PROPERTY(flags);
+		// Incremented whenever a flag is set or cleared, so that users can cheaply detect changes.
+		uint32_t PROPERTY(flag_revision, 0);
 		std::string name;
 
 	public:
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace OpenVic {
+	/* Type-erased owning callable whose target is stored inline, so constructing, copying and calling it never allocates,
+	 * unlike std::function. Only callables which fit in Capacity bytes and are trivially copyable and destructible are
+	 * accepted, e.g. lambdas capturing pointers and numbers by value. This is checked at compile time, so a capture list
+	 * that grows too large is a build error rather than a silent heap allocation. */
+	template<typename Sig, size_t Capacity = 4 * sizeof(void*)>
+	struct InplaceFunction;
+
+	template<typename Ret, typename... Args, size_t Capacity>
+	struct InplaceFunction<Ret(Args...), Capacity> {
+	private:
+		using invoke_func_t = Ret (*)(void const*, Args...);
+
+		alignas(void*) std::byte storage[Capacity];
+		invoke_func_t invoke_func = nullptr;
+
+	public:
+		static constexpr size_t CAPACITY = Capacity;
+
+		template<typename Func>
+		static constexpr bool can_store = sizeof(Func) <= Capacity && alignof(Func) <= alignof(void*) &&
+			std::is_trivially_copyable_v<Func> && std::is_trivially_destructible_v<Func>;
+
+		InplaceFunction() = default;
+
+		template<typename Func>
+		requires(!std::same_as<std::decay_t<Func>, InplaceFunction>) && std::invocable<std::decay_t<Func> const&, Args...>
+		InplaceFunction(Func&& func) {
+			using func_t = std::decay_t<Func>;
+
+			static_assert(sizeof(func_t) <= Capacity, "Callable is too large for InplaceFunction's inline storage!");
+			static_assert(alignof(func_t) <= alignof(void*), "Callable is over-aligned for InplaceFunction's inline storage!");
+			static_assert(
+				std::is_trivially_copyable_v<func_t> && std::is_trivially_destructible_v<func_t>,
+				"InplaceFunction can only store trivially copyable and destructible callables!"
+			);
+
+			::new (static_cast<void*>(storage)) func_t(std::forward<Func>(func));
+			invoke_func = [](void const* callable, Args... args) -> Ret {
+				return std::invoke(*static_cast<func_t const*>(callable), std::forward<Args>(args)...);
+			};
+		}
+
+		InplaceFunction(InplaceFunction const&) = default;
+		InplaceFunction(InplaceFunction&&) = default;
+		InplaceFunction& operator=(InplaceFunction const&) = default;
+		InplaceFunction& operator=(InplaceFunction&&) = default;
+
+		Ret operator()(Args... args) const {
+			return invoke_func(storage, std::forward<Args>(args)...);
+		}
+
+		explicit operator bool() const {
+			return invoke_func != nullptr;
+		}
+	};
+}
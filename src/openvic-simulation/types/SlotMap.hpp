@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <plf_colony.h>
+
+namespace OpenVic {
+	/* Owns items of type T, giving each one a generational handle which is resolved in O(1) by indexing an array of
+	 * slots and checking that the slot's generation matches the handle's. Erasing an item bumps its slot's generation
+	 * before the slot is reused, so stale handles resolve to nullptr rather than to whichever item replaced it.
+	 * Items live in a plf::colony, so pointers to them stay valid until they are erased, erasing is O(1), and iterating
+	 * walks contiguous blocks in a stable order, skipping erased items.
+	 * Handles pack a 24 bit generation, the map's 8 bit tag and a 32 bit slot index, from most to least significant.
+	 * Maps given different tags never produce equal handles, so handles from several maps can share one ID space, and
+	 * since generations start at 1, NULL_HANDLE (0) is never a valid handle. */
+	template<typename T>
+	struct SlotMap {
+		using handle_t = uint64_t;
+		using container_t = plf::colony<T>;
+		using iterator = typename container_t::iterator;
+		using const_iterator = typename container_t::const_iterator;
+
+		static constexpr handle_t NULL_HANDLE = 0;
+
+		static constexpr uint32_t get_index(handle_t handle) {
+			return static_cast<uint32_t>(handle);
+		}
+		static constexpr uint8_t get_tag(handle_t handle) {
+			return static_cast<uint8_t>(handle >> 32);
+		}
+		static constexpr uint32_t get_generation(handle_t handle) {
+			return static_cast<uint32_t>(handle >> 40);
+		}
+
+	private:
+		static constexpr uint32_t GENERATION_MASK = (1 << 24) - 1;
+
+		struct slot_t {
+			T* item;
+			uint32_t generation;
+		};
+
+		const uint8_t tag;
+		container_t items;
+		std::vector<slot_t> slots;
+		std::vector<uint32_t> free_slots;
+
+		constexpr handle_t _make_handle(uint32_t index, uint32_t generation) const {
+			return (static_cast<handle_t>(generation) << 40) | (static_cast<handle_t>(tag) << 32) | index;
+		}
+
+		slot_t const* _get_slot(handle_t handle) const {
+			const uint32_t index = get_index(handle);
+			if (get_tag(handle) == tag && index < slots.size()) {
+				slot_t const& slot = slots[index];
+				if (slot.item != nullptr && slot.generation == get_generation(handle)) {
+					return &slot;
+				}
+			}
+			return nullptr;
+		}
+
+		static void _advance_generation(slot_t& slot) {
+			// Generation 0 is skipped on wraparound so that NULL_HANDLE can never become valid.
+			slot.generation = (slot.generation + 1) & GENERATION_MASK;
+			if (slot.generation == 0) {
+				slot.generation = 1;
+			}
+		}
+
+	public:
+		SlotMap(uint8_t new_tag = 0) : tag { new_tag } {}
+		SlotMap(SlotMap&&) = default;
+
+		constexpr uint8_t get_tag() const {
+			return tag;
+		}
+
+		/* Reserves a handle, calls make_item(handle) to create the item, which may store the handle in itself, and
+		 * moves the result into the map. */
+		template<typename MakeItem>
+		requires std::is_same_v<std::invoke_result_t<MakeItem, handle_t>, T>
+		T& insert(MakeItem&& make_item) {
+			uint32_t index;
+			if (!free_slots.empty()) {
+				index = free_slots.back();
+				free_slots.pop_back();
+			} else {
+				index = static_cast<uint32_t>(slots.size());
+				slots.push_back({ nullptr, 1 });
+			}
+
+			slot_t& slot = slots[index];
+			slot.item = &*items.insert(std::forward<MakeItem>(make_item)(_make_handle(index, slot.generation)));
+			return *slot.item;
+		}
+
+		// Returns false if handle does not refer to an item in the map.
+		bool erase(handle_t handle) {
+			if (_get_slot(handle) == nullptr) {
+				return false;
+			}
+
+			const uint32_t index = get_index(handle);
+			slot_t& slot = slots[index];
+			items.erase(items.get_iterator(slot.item));
+			slot.item = nullptr;
+			_advance_generation(slot);
+			free_slots.push_back(index);
+			return true;
+		}
+
+		T* get(handle_t handle) {
+			slot_t const* slot = _get_slot(handle);
+			return slot != nullptr ? slot->item : nullptr;
+		}
+		T const* get(handle_t handle) const {
+			slot_t const* slot = _get_slot(handle);
+			return slot != nullptr ? slot->item : nullptr;
+		}
+
+		bool contains(handle_t handle) const {
+			return _get_slot(handle) != nullptr;
+		}
+
+		size_t size() const {
+			return items.size();
+		}
+		bool empty() const {
+			return items.empty();
+		}
+
+		void reserve(size_t count) {
+			items.reserve(count);
+			slots.reserve(count);
+		}
+
+		void clear() {
+			for (uint32_t index = 0; index < slots.size(); ++index) {
+				slot_t& slot = slots[index];
+				if (slot.item != nullptr) {
+					slot.item = nullptr;
+					_advance_generation(slot);
+					free_slots.push_back(index);
+				}
+			}
+			items.clear();
+		}
+
+		container_t& get_items() {
+			return items;
+		}
+		container_t const& get_items() const {
+			return items;
+		}
+
+		iterator begin() {
+			return items.begin();
+		}
+		iterator end() {
+			return items.end();
+		}
+		const_iterator begin() const {
+			return items.begin();
+		}
+		const_iterator end() const {
+			return items.end();
+		}
+	};
+}
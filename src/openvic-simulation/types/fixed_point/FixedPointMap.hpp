@@ -133,6 +133,29 @@ namespace OpenVic {
 		return total;
 	}
 
+	/* Sets every value to zero while keeping the keys, so a map which is rebuilt regularly from a similar set of keys
+	 * doesn't have to reinsert and rehash them each time. Follow the rebuild with erase_zero_values so keys which are
+	 * no longer used don't linger with zero values. */
+	template<typename T>
+	constexpr void zero_fixed_point_map(fixed_point_map_t<T>& map) {
+		for (auto [key, value] : mutable_iterator(map)) {
+			value = fixed_point_t::_0();
+		}
+	}
+
+	/* Erases the keys whose value is zero, keeping the others in order. Each erasure is linear in the map's size, but
+	 * after zero_fixed_point_map and a rebuild from a stable set of keys there is usually nothing to erase. */
+	template<typename T>
+	constexpr void erase_zero_values(fixed_point_map_t<T>& map) {
+		for (typename fixed_point_map_t<T>::const_iterator it = map.begin(); it != map.end();) {
+			if (it->second == fixed_point_t::_0()) {
+				it = map.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
 	template<typename T>
 	constexpr void normalise_fixed_point_map(fixed_point_map_t<T>& map) {
 		const fixed_point_t total = get_total(map);
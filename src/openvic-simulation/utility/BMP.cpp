@@ -13,8 +13,7 @@ BMP::~BMP() {
 
 bool BMP::open(fs::path const& filepath) {
 	reset();
-	file.open(filepath, std::ios::binary);
-	if (file.fail()) {
+	if (!file.open(filepath)) {
 		Logger::error("Failed to open BMP file \"", filepath, "\"");
 		close();
 		return false;
@@ -31,16 +30,11 @@ bool BMP::read_header() {
 		Logger::error("Cannot read BMP header before opening a file");
 		return false;
 	}
-	file.seekg(0, std::ios::beg);
-	if (file.fail()) {
-		Logger::error("Failed to move to the beginning of the BMP file!");
-		return false;
-	}
-	file.read(reinterpret_cast<char*>(&header), sizeof(header));
-	if (file.fail()) {
+	if (file.get_data().size() < sizeof(header)) {
 		Logger::error("Failed to read BMP header!");
 		return false;
 	}
+	memcpy(&header, file.get_data().data(), sizeof(header));
 
 	header_validated = true;
 
@@ -138,26 +132,20 @@ bool BMP::read_palette() {
 		Logger::error("Cannot read BMP palette - header indicates this file doesn't have one");
 		return false;
 	}
-	file.seekg(sizeof(header), std::ios::beg);
-	if (file.fail()) {
-		Logger::error("Failed to move to the palette in the BMP file!");
+	if (file.get_data().size() < sizeof(header) + palette_size * PALETTE_COLOUR_SIZE) {
+		Logger::error("Failed to read BMP palette!");
 		return false;
 	}
 	palette.resize(palette_size);
-	file.read(reinterpret_cast<char*>(palette.data()), palette_size * PALETTE_COLOUR_SIZE);
-	if (file.fail()) {
-		Logger::error("Failed to read BMP header!");
-		palette.clear();
-		return false;
-	}
+	memcpy(palette.data(), file.get_data().data() + sizeof(header), palette_size * PALETTE_COLOUR_SIZE);
 	palette_read = true;
 	return palette_read;
 }
 
 void BMP::close() {
-	if (file.is_open()) {
-		file.close();
-	}
+	file.close();
+	pixel_data = {};
+	pixel_data_read = false;
 }
 
 void BMP::reset() {
@@ -166,7 +154,7 @@ void BMP::reset() {
 	header_validated = false;
 	palette_size = 0;
 	palette.clear();
-	pixel_data.clear();
+	palette_read = false;
 }
 
 int32_t BMP::get_width() const {
@@ -201,24 +189,18 @@ bool BMP::read_pixel_data() {
 		Logger::error("Cannot read pixel data before BMP header is validated!");
 		return false;
 	}
-	file.seekg(header.offset, std::ios::beg);
-	if (file.fail()) {
-		Logger::error("Failed to move to the pixel data in the BMP file!");
-		return false;
-	}
-	const size_t pixel_data_size = get_width() * get_height() * header.bits_per_pixel / CHAR_BIT;
-	pixel_data.resize(pixel_data_size);
-	file.read(reinterpret_cast<char*>(pixel_data.data()), pixel_data_size);
-	if (file.fail()) {
+	const size_t pixel_data_size =
+		static_cast<size_t>(get_width()) * static_cast<size_t>(get_height()) * header.bits_per_pixel / CHAR_BIT;
+	if (header.offset > file.get_data().size() || file.get_data().size() - header.offset < pixel_data_size) {
 		Logger::error("Failed to read BMP pixel data!");
-		pixel_data.clear();
 		return false;
 	}
+	pixel_data = file.get_data().subspan(header.offset, pixel_data_size);
 	pixel_data_read = true;
 	return pixel_data_read;
 }
 
-std::vector<uint8_t> const& BMP::get_pixel_data() const {
+std::span<const uint8_t> BMP::get_pixel_data() const {
 	if (!pixel_data_read) {
 		Logger::warning("Trying to get BMP pixel data before loading");
 	}
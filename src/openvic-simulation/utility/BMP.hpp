@@ -1,14 +1,17 @@
 #pragma once
 
 #include <filesystem>
-#include <fstream>
+#include <span>
 #include <vector>
 
 #include "openvic-simulation/types/Colour.hpp"
+#include "openvic-simulation/utility/MemoryMappedFile.hpp"
 
 namespace OpenVic {
 	namespace fs = std::filesystem;
 
+	/* The file is memory mapped rather than read into memory, so pixel data is only paged in as it is accessed and is
+	 * never copied. The pixel data span is only valid until the BMP is closed or reset. */
 	class BMP {
 #pragma pack(push)
 #pragma pack(1)
@@ -36,11 +39,11 @@ namespace OpenVic {
 		using palette_colour_t = uint32_t;
 
 	private:
-		std::ifstream file;
+		MemoryMappedFile file;
 		bool header_validated = false, palette_read = false, pixel_data_read = false;
 		uint32_t palette_size = 0;
 		std::vector<palette_colour_t> palette;
-		std::vector<uint8_t> pixel_data;
+		std::span<const uint8_t> pixel_data;
 
 	public:
 		static constexpr uint32_t PALETTE_COLOUR_SIZE = sizeof(palette_colour_t);
@@ -51,6 +54,7 @@ namespace OpenVic {
 		bool open(fs::path const& filepath);
 		bool read_header();
 		bool read_palette();
+		// Validates that the file contains all of the pixel data, which can then be accessed without copying.
 		bool read_pixel_data();
 		void close();
 		void reset();
@@ -59,6 +63,6 @@ namespace OpenVic {
 		int32_t get_height() const;
 		uint16_t get_bits_per_pixel() const;
 		std::vector<palette_colour_t> const& get_palette() const;
-		std::vector<uint8_t> const& get_pixel_data() const;
+		std::span<const uint8_t> get_pixel_data() const;
 	};
 }
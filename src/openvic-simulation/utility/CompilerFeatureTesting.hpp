@@ -1,28 +1,27 @@
 #pragma once
 
-#include <execution>
+#include <iterator>
 
 #include <range/v3/algorithm/for_each.hpp>
 #include <range/v3/iterator/concepts.hpp>
 #include <range/v3/range/concepts.hpp>
 
+#include "openvic-simulation/utility/ThreadPool.hpp"
+
 namespace OpenVic {
+	/* We cannot use std::execution::par as its implementation uses exceptions, which we have disabled, and its
+	 * scheduling is implementation defined. Instead every platform runs on our own work-stealing ThreadPool. */
 	template<ranges::forward_iterator InputIt, ranges::indirectly_unary_invocable<InputIt> UnaryFunc>
 	inline constexpr void try_parallel_for_each(InputIt first, InputIt last, UnaryFunc f) {
-#ifndef __cpp_lib_execution
-		std::for_each(first, last, f);
-#else
-#if defined(__linux__) || defined(__MINGW32__)
-			// We cannot use std::execution::par here as its implementation uses exceptions, which we have disabled
-		std::for_each(first, last, f);
-#else
-		if constexpr (__cpp_lib_execution >= 201603L) {
-			std::for_each(std::execution::par, first, last, f);
-		} else {
-			std::for_each(first, last, f);
-		}
-#endif
-#endif
+		const size_t count = static_cast<size_t>(std::distance(first, last));
+
+		ThreadPool::get_instance().parallel_for(count, [&first, &f](size_t begin, size_t end) -> void {
+			// Non-random access containers like plf::colony provide their own faster std::advance overloads.
+			InputIt it = std::next(first, begin);
+			for (size_t index = begin; index < end; ++index, ++it) {
+				f(*it);
+			}
+		});
 	}
 
 	struct _for_each_fn {
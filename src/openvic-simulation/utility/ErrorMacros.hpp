@@ -66,3 +66,14 @@
 		return m_retval; \
 	} else \
 		((void)0)
+
+/**
+ * Ensures `m_cond` is false.
+ * If `m_cond` is true, prints `m_msg` and the current loop continues.
+ */
+#define OV_ERR_CONTINUE_MSG(m_cond, m_msg) \
+	if (OV_unlikely(m_cond)) { \
+		::OpenVic::Logger::error("Condition \"" _OV_STR(m_cond) "\" is true. Continuing.", m_msg); \
+		continue; \
+	} else \
+		((void)0)
@@ -0,0 +1,290 @@
+#include "Logger.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <streambuf>
+#include <thread>
+
+using namespace OpenVic;
+
+namespace {
+	// Appends everything written to it to a string which keeps its capacity between messages.
+	class message_buffer_t final : public std::streambuf {
+		std::string message;
+
+	protected:
+		int_type overflow(int_type ch) override {
+			if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+				message.push_back(traits_type::to_char_type(ch));
+			}
+			return traits_type::not_eof(ch);
+		}
+
+		std::streamsize xsputn(char_type const* str, std::streamsize count) override {
+			message.append(str, count);
+			return count;
+		}
+
+	public:
+		std::string& get_message() {
+			return message;
+		}
+	};
+
+	struct message_stream_t {
+		message_buffer_t buffer;
+		std::ostream stream { &buffer };
+	};
+}
+
+static thread_local message_stream_t message_stream;
+
+/* Bounded multi-producer queue, based on Dmitry Vyukov's bounded MPMC queue. Each slot's sequence number says whether
+ * it is free for the producer claiming enqueue position p (sequence == p) or holds the message for dequeue position p
+ * (sequence == p + 1). Messages are swapped in and out of the slots, so their strings' capacity is recycled. Only one
+ * thread dequeues at a time, the one holding drain_mutex. */
+struct Logger::log_ring_t {
+	static constexpr size_t CAPACITY = 1 << 12;
+	static constexpr size_t WAKE_DRAIN_THRESHOLD = CAPACITY / 4;
+	static constexpr std::chrono::milliseconds DRAIN_INTERVAL { 10 };
+
+	struct slot_t {
+		std::atomic<size_t> sequence;
+		log_channel_t* channel = nullptr;
+		std::string message;
+	};
+
+	std::unique_ptr<slot_t[]> slots;
+	std::atomic<size_t> enqueue_position = 0;
+	std::atomic<size_t> dequeue_position = 0;
+	std::string dequeued_message;
+	std::mutex drain_mutex;
+
+	std::mutex async_mutex;
+	std::atomic<bool> async = false;
+	std::thread drain_thread;
+	std::mutex wake_mutex;
+	std::condition_variable wake_condition;
+	bool stop_requested = false;
+	std::atomic<bool> drain_sleeping = false;
+
+	log_ring_t() : slots { std::make_unique<slot_t[]>(CAPACITY) } {
+		for (size_t index = 0; index < CAPACITY; ++index) {
+			slots[index].sequence.store(index, std::memory_order_relaxed);
+		}
+	}
+
+	~log_ring_t() {
+		set_async(false);
+		flush();
+	}
+
+	// Swaps message into a free slot, returning false if the ring is full.
+	bool try_push(log_channel_t& channel, std::string& message) {
+		size_t position = enqueue_position.load(std::memory_order_relaxed);
+		slot_t* slot;
+		while (true) {
+			slot = &slots[position % CAPACITY];
+			const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			if (sequence == position) {
+				if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (sequence < position) {
+				return false;
+			} else {
+				position = enqueue_position.load(std::memory_order_relaxed);
+			}
+		}
+		slot->channel = &channel;
+		slot->message.swap(message);
+		// Sequentially consistent to pair with has_message, see drain.
+		slot->sequence.store(position + 1);
+		return true;
+	}
+
+	bool has_message(size_t position) const {
+		return slots[position % CAPACITY].sequence.load() == position + 1;
+	}
+
+	// Must be called with drain_mutex held.
+	void drain_locked() {
+		size_t position = dequeue_position.load(std::memory_order_relaxed);
+		while (has_message(position)) {
+			slot_t& slot = slots[position % CAPACITY];
+			log_channel_t& channel = *slot.channel;
+			dequeued_message.swap(slot.message);
+			slot.sequence.store(position + CAPACITY, std::memory_order_release);
+			dequeue_position.store(++position, std::memory_order_relaxed);
+
+			_print_message(channel, std::move(dequeued_message));
+			dequeued_message.clear();
+		}
+	}
+
+	/* If wait is false and another thread is already draining, this returns immediately. Every drainer checks for new
+	 * messages after releasing drain_mutex, and every pusher tries to drain after publishing its message, so one of the
+	 * two always sees a message which is pushed while the other is draining. */
+	void drain(bool wait) {
+		while (true) {
+			size_t position;
+			{
+				std::unique_lock<std::mutex> lock { drain_mutex, std::defer_lock };
+				if (wait) {
+					lock.lock();
+				} else if (!lock.try_lock()) {
+					return;
+				}
+				drain_locked();
+				position = dequeue_position.load(std::memory_order_relaxed);
+			}
+			if (!has_message(position)) {
+				return;
+			}
+		}
+	}
+
+	void push(log_channel_t& channel, std::string& message) {
+		while (!try_push(channel, message)) {
+			/* The ring is full, so the message has to wait for space rather than be dropped. If the oldest message is
+			 * still being written by another thread, nothing can be drained until it is done. */
+			drain(true);
+			std::this_thread::yield();
+		}
+
+		if (!async.load(std::memory_order_relaxed)) {
+			drain(false);
+		} else if (
+			enqueue_position.load(std::memory_order_relaxed) - dequeue_position.load(std::memory_order_relaxed) >=
+				WAKE_DRAIN_THRESHOLD && drain_sleeping.exchange(false)
+		) {
+			const std::lock_guard<std::mutex> lock { wake_mutex };
+			wake_condition.notify_one();
+		}
+	}
+
+	void drain_thread_loop() {
+		while (true) {
+			drain(true);
+
+			std::unique_lock<std::mutex> lock { wake_mutex };
+			if (stop_requested) {
+				break;
+			}
+			drain_sleeping = true;
+			wake_condition.wait_for(lock, DRAIN_INTERVAL, [this]() -> bool {
+				return stop_requested || !drain_sleeping;
+			});
+			drain_sleeping = false;
+		}
+	}
+
+	void set_async(bool new_async) {
+		const std::lock_guard<std::mutex> async_lock { async_mutex };
+		if (async == new_async) {
+			return;
+		}
+
+		if (new_async) {
+			stop_requested = false;
+			drain_thread = std::thread { &log_ring_t::drain_thread_loop, this };
+			async = true;
+		} else {
+			async = false;
+			{
+				const std::lock_guard<std::mutex> lock { wake_mutex };
+				stop_requested = true;
+			}
+			wake_condition.notify_one();
+			drain_thread.join();
+			drain(true);
+		}
+	}
+
+	void flush() {
+		drain(true);
+
+		const std::lock_guard<std::mutex> lock { drain_mutex };
+		for (log_channel_t* channel : { &info_channel, &warning_channel, &error_channel }) {
+			_print_repeat_count(*channel);
+		}
+	}
+};
+
+Logger::log_ring_t& Logger::_get_ring() {
+	static log_ring_t ring;
+	return ring;
+}
+
+void Logger::set_async(bool async) {
+	_get_ring().set_async(async);
+}
+
+bool Logger::is_async() {
+	return _get_ring().async;
+}
+
+void Logger::flush() {
+	_get_ring().flush();
+}
+
+std::ostream& Logger::_begin_message() {
+	std::ostream& stream = message_stream.stream;
+	stream.clear();
+	stream.flags(std::ios_base::dec | std::ios_base::skipws);
+	stream.precision(6);
+	stream.width(0);
+	stream.fill(' ');
+	message_stream.buffer.get_message().clear();
+	return stream;
+}
+
+void Logger::_end_message(log_channel_t& log_channel) {
+	std::string& message = message_stream.buffer.get_message();
+	_get_ring().push(log_channel, message);
+	// message now holds a previously printed message's string, which is reused for the next message.
+	message.clear();
+}
+
+void Logger::_print_message(log_channel_t& log_channel, std::string&& message) {
+	if (!log_channel.func) {
+		log_channel.queue.push(std::move(message));
+		return;
+	}
+
+	if (message == log_channel.last_message) {
+		log_channel.repeat_count++;
+		log_channel.message_count++;
+		return;
+	}
+
+	_print_repeat_count(log_channel);
+	log_channel.last_message = message;
+	log_channel.func(std::move(message));
+	/* Only count printed messages, so that message_count matches what is seen in the console. */
+	log_channel.message_count++;
+}
+
+void Logger::_print_repeat_count(log_channel_t& log_channel) {
+	if (log_channel.repeat_count > 0 && log_channel.func) {
+		log_channel.func(
+			"Previous message repeated " + std::to_string(log_channel.repeat_count) +
+			(log_channel.repeat_count == 1 ? " time\n" : " times\n")
+		);
+		log_channel.repeat_count = 0;
+	}
+}
+
+void Logger::_set_func(log_channel_t& log_channel, log_func_t&& log_func) {
+	log_ring_t& ring = _get_ring();
+	ring.drain(true);
+
+	const std::lock_guard<std::mutex> lock { ring.drain_mutex };
+	_print_repeat_count(log_channel);
+	log_channel.func = std::move(log_func);
+	while (!log_channel.queue.empty()) {
+		_print_message(log_channel, std::move(log_channel.queue.front()));
+		log_channel.queue.pop();
+	}
+}
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <iostream>
 #include <mutex>
 #include <queue>
 #include <sstream>
+#include <string>
 
 #ifdef __cpp_lib_source_location
 #include <source_location>
@@ -46,6 +48,11 @@ namespace OpenVic {
 	};
 #endif
 
+	/* Messages are formatted into a reusable per-thread buffer and pushed onto a fixed size lock-free ring shared by
+	 * all channels, from which they are passed to the channels' functions in the order they were pushed. Without async
+	 * mode this is done by the logging threads themselves, one at a time, otherwise by a background drain thread. A
+	 * message identical to the previous one on the same channel is counted but not printed, with the number of such
+	 * repeats printed before the channel's next different message or on flush. */
 	class Logger final {
 		using log_func_t = std::function<void(std::string&&)>;
 		using log_queue_t = std::queue<std::string>;
@@ -69,37 +76,49 @@ namespace OpenVic {
 			});
 		}
 
+		/* Starts or stops the background drain thread. Logging threads then only push their messages, leaving them to be
+		 * printed shortly afterwards unless the ring is full. Stopping waits for every queued message to be printed. */
+		static void set_async(bool async);
+		static bool is_async();
+
+		// Prints every message logged so far, along with any pending repeat counts.
+		static void flush();
+
 	private:
 		struct log_channel_t {
 			log_func_t func;
+			// Messages logged before func was set.
 			log_queue_t queue;
-			size_t message_count;
+			std::string last_message;
+			size_t repeat_count;
+			std::atomic<size_t> message_count;
 		};
 
-		static inline std::mutex log_mutex;
+		struct log_ring_t;
+
+		static log_ring_t& _get_ring();
+
+		// Returns the calling thread's message stream, emptied and with default formatting.
+		static std::ostream& _begin_message();
+		// Pushes the calling thread's message onto the ring for log_channel.
+		static void _end_message(log_channel_t& log_channel);
+		// Must be called with the ring's drain mutex held.
+		static void _print_message(log_channel_t& log_channel, std::string&& message);
+		static void _print_repeat_count(log_channel_t& log_channel);
+		static void _set_func(log_channel_t& log_channel, log_func_t&& log_func);
 
 		template<typename... Args>
 		struct log {
 			log(log_channel_t& log_channel, Args&&... args, source_location const& location) {
-				const std::lock_guard<std::mutex> lock { log_mutex };
-
-				std::stringstream stream;
+				std::ostream& stream = _begin_message();
 				stream << StringUtils::get_filename(location.file_name()) << "("
 					/* Function name removed to reduce clutter. It is already included
 					* in Godot's print functions, so this was repeating it. */
 					//<< location.line() << ") `" << location.function_name() << "`: ";
 					<< location.line() << "): ";
 				((stream << std::forward<Args>(args)), ...);
-				stream << std::endl;
-				log_channel.queue.push(stream.str());
-				if (log_channel.func) {
-					do {
-						log_channel.func(std::move(log_channel.queue.front()));
-						log_channel.queue.pop();
-						/* Only count printed messages, so that message_count matches what is seen in the console. */
-						log_channel.message_count++;
-					} while (!log_channel.queue.empty());
-				}
+				stream << '\n';
+				_end_message(log_channel);
 			}
 		};
 
@@ -109,8 +128,9 @@ private: \
 \
 public: \
 	static inline void set_##name##_func(log_func_t log_func) { \
-		name##_channel.func = log_func; \
+		_set_func(name##_channel, std::move(log_func)); \
 	} \
+	/* Only printed messages and their repeats are counted, so in async mode this may lag behind until flush is called. */ \
 	static inline size_t get_##name##_count() { \
 		return name##_channel.message_count; \
 	} \
@@ -0,0 +1,127 @@
+#include "MemoryMappedFile.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "openvic-simulation/utility/Logger.hpp"
+
+using namespace OpenVic;
+
+MemoryMappedFile::~MemoryMappedFile() {
+	close();
+}
+
+#ifdef _WIN32
+
+bool MemoryMappedFile::open(fs::path const& filepath) {
+	close();
+
+	const HANDLE file = CreateFileW(
+		filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+	);
+	if (file == INVALID_HANDLE_VALUE) {
+		Logger::error("Failed to open file for memory mapping: ", filepath);
+		return false;
+	}
+	file_handle = file;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size)) {
+		Logger::error("Failed to get size of file for memory mapping: ", filepath);
+		close();
+		return false;
+	}
+	size = static_cast<size_t>(file_size.QuadPart);
+
+	// Empty files cannot be mapped, but are still valid.
+	if (size > 0) {
+		mapping_handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping_handle == nullptr) {
+			Logger::error("Failed to create file mapping: ", filepath);
+			close();
+			return false;
+		}
+
+		data = static_cast<uint8_t const*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+		if (data == nullptr) {
+			Logger::error("Failed to map view of file: ", filepath);
+			close();
+			return false;
+		}
+	}
+
+	opened = true;
+	return true;
+}
+
+void MemoryMappedFile::close() {
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+		data = nullptr;
+	}
+	if (mapping_handle != nullptr) {
+		CloseHandle(mapping_handle);
+		mapping_handle = nullptr;
+	}
+	if (file_handle != nullptr) {
+		CloseHandle(file_handle);
+		file_handle = nullptr;
+	}
+	size = 0;
+	opened = false;
+}
+
+#else
+
+bool MemoryMappedFile::open(fs::path const& filepath) {
+	close();
+
+	const int file = ::open(filepath.c_str(), O_RDONLY);
+	if (file < 0) {
+		Logger::error("Failed to open file for memory mapping: ", filepath);
+		return false;
+	}
+
+	struct stat file_stat;
+	if (fstat(file, &file_stat) != 0) {
+		Logger::error("Failed to get size of file for memory mapping: ", filepath);
+		::close(file);
+		return false;
+	}
+	size = static_cast<size_t>(file_stat.st_size);
+
+	// Empty files cannot be mapped, but are still valid.
+	if (size > 0) {
+		void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapping == MAP_FAILED) {
+			Logger::error("Failed to memory map file: ", filepath);
+			::close(file);
+			size = 0;
+			return false;
+		}
+		data = static_cast<uint8_t const*>(mapping);
+	}
+
+	// The mapping stays valid after its file descriptor is closed.
+	::close(file);
+
+	opened = true;
+	return true;
+}
+
+void MemoryMappedFile::close() {
+	if (data != nullptr) {
+		munmap(const_cast<uint8_t*>(data), size);
+		data = nullptr;
+	}
+	size = 0;
+	opened = false;
+}
+
+#endif
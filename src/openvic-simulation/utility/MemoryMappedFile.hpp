@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace OpenVic {
+	namespace fs = std::filesystem;
+
+	/* Read-only memory mapping of a whole file. The operating system pages the file in as it is accessed, so nothing is
+	 * copied into process memory up front and untouched parts of the file are never read. */
+	class MemoryMappedFile {
+#ifdef _WIN32
+		void* file_handle = nullptr;
+		void* mapping_handle = nullptr;
+#endif
+		uint8_t const* data = nullptr;
+		size_t size = 0;
+		bool opened = false;
+
+	public:
+		MemoryMappedFile() = default;
+		MemoryMappedFile(MemoryMappedFile const&) = delete;
+		MemoryMappedFile& operator=(MemoryMappedFile const&) = delete;
+		~MemoryMappedFile();
+
+		bool open(fs::path const& filepath);
+		void close();
+
+		inline bool is_open() const {
+			return opened;
+		}
+
+		// Empty for empty files. Only valid until the file is closed.
+		inline std::span<const uint8_t> get_data() const {
+			return { data, size };
+		}
+	};
+}
@@ -0,0 +1,92 @@
+#include "PhaseProfiler.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace OpenVic;
+
+PhaseProfiler::scope_t::scope_t(PhaseProfiler* new_profiler, std::string_view phase_name) : profiler { new_profiler } {
+	if (profiler != nullptr) {
+		phase_index = profiler->_get_phase_index(phase_name);
+		start_allocation_count = profiler->_get_allocation_count();
+		start_time = clock_t::now();
+	}
+}
+
+PhaseProfiler::scope_t::~scope_t() {
+	if (profiler != nullptr) {
+		const clock_t::time_point end_time = clock_t::now();
+		const size_t end_allocation_count = profiler->_get_allocation_count();
+
+		phase_t& phase = profiler->phases[phase_index];
+		phase.durations_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+		if (profiler->has_allocation_counts()) {
+			phase.allocation_counts.push_back(end_allocation_count - start_allocation_count);
+		}
+	}
+}
+
+PhaseProfiler::PhaseProfiler(allocation_count_func_t new_allocation_count_func)
+	: allocation_count_func { new_allocation_count_func } {}
+
+size_t PhaseProfiler::_get_phase_index(std::string_view phase_name) {
+	const std::vector<phase_t>::const_iterator it = std::find_if(
+		phases.begin(), phases.end(), [phase_name](phase_t const& phase) -> bool {
+			return phase.name == phase_name;
+		}
+	);
+	if (it != phases.end()) {
+		return it - phases.begin();
+	}
+	phases.push_back({ phase_name, {}, {} });
+	return phases.size() - 1;
+}
+
+size_t PhaseProfiler::_get_allocation_count() const {
+	return allocation_count_func != nullptr ? allocation_count_func() : 0;
+}
+
+std::vector<PhaseProfiler::phase_t> const& PhaseProfiler::get_phases() const {
+	return phases;
+}
+
+bool PhaseProfiler::has_allocation_counts() const {
+	return allocation_count_func != nullptr;
+}
+
+PhaseProfiler::statistics_t PhaseProfiler::get_statistics(phase_t const& phase) {
+	statistics_t statistics;
+	statistics.run_count = phase.durations_ns.size();
+	if (statistics.run_count == 0) {
+		return statistics;
+	}
+
+	std::vector<uint64_t> sorted_durations = phase.durations_ns;
+	std::sort(sorted_durations.begin(), sorted_durations.end());
+
+	const auto percentile = [&sorted_durations](size_t percent) -> uint64_t {
+		const size_t rank = (percent * sorted_durations.size() + 99) / 100;
+		return sorted_durations[rank > 0 ? rank - 1 : 0];
+	};
+
+	statistics.total_ns = std::accumulate(sorted_durations.begin(), sorted_durations.end(), uint64_t { 0 });
+	statistics.min_ns = sorted_durations.front();
+	statistics.max_ns = sorted_durations.back();
+	statistics.mean_ns = statistics.total_ns / statistics.run_count;
+	statistics.p50_ns = percentile(50);
+	statistics.p90_ns = percentile(90);
+	statistics.p99_ns = percentile(99);
+
+	if (!phase.allocation_counts.empty()) {
+		statistics.total_allocations =
+			std::accumulate(phase.allocation_counts.begin(), phase.allocation_counts.end(), uint64_t { 0 });
+		statistics.mean_allocations = statistics.total_allocations / phase.allocation_counts.size();
+		statistics.max_allocations = *std::max_element(phase.allocation_counts.begin(), phase.allocation_counts.end());
+	}
+
+	return statistics;
+}
+
+void PhaseProfiler::clear() {
+	phases.clear();
+}
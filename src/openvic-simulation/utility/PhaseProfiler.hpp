@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace OpenVic {
+	/* Records the wall time, and optionally the number of heap allocations, of every run of a set of named phases,
+	 * such as the steps of a simulation tick, so that statistics can be reported over many runs. Phases are listed in
+	 * the order they first ran and may be nested, in which case an outer phase's time includes its inner phases.
+	 * Phase names must outlive the profiler, e.g. string literals. Not thread safe, phases should be timed from the
+	 * thread driving the work being timed. */
+	struct PhaseProfiler {
+		using clock_t = std::chrono::steady_clock;
+		/* Returns the number of allocations made by the process so far. Only a program which replaces the global
+		 * operator new can count these, so it is left to such a program to provide. */
+		using allocation_count_func_t = size_t (*)();
+
+		struct phase_t {
+			std::string_view name;
+			std::vector<uint64_t> durations_ns;
+			std::vector<uint64_t> allocation_counts;
+		};
+
+		struct statistics_t {
+			size_t run_count = 0;
+			uint64_t total_ns = 0, min_ns = 0, max_ns = 0, mean_ns = 0, p50_ns = 0, p90_ns = 0, p99_ns = 0;
+			uint64_t total_allocations = 0, mean_allocations = 0, max_allocations = 0;
+		};
+
+		/* Adds the time between its construction and destruction to a run of a phase. A null profiler makes this a no-op,
+		 * so code can always be instrumented and only pays for a branch when no profiler is set. */
+		struct scope_t {
+		private:
+			PhaseProfiler* profiler;
+			size_t phase_index = 0;
+			size_t start_allocation_count = 0;
+			clock_t::time_point start_time;
+
+		public:
+			scope_t(PhaseProfiler* new_profiler, std::string_view phase_name);
+			scope_t(scope_t const&) = delete;
+			scope_t& operator=(scope_t const&) = delete;
+			~scope_t();
+		};
+
+	private:
+		std::vector<phase_t> phases;
+		allocation_count_func_t allocation_count_func = nullptr;
+
+		size_t _get_phase_index(std::string_view phase_name);
+		size_t _get_allocation_count() const;
+
+	public:
+		PhaseProfiler(allocation_count_func_t new_allocation_count_func = nullptr);
+
+		std::vector<phase_t> const& get_phases() const;
+		bool has_allocation_counts() const;
+
+		// Statistics use nearest-rank percentiles.
+		static statistics_t get_statistics(phase_t const& phase);
+
+		void clear();
+	};
+}
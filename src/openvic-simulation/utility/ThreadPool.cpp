@@ -0,0 +1,242 @@
+#include "ThreadPool.hpp"
+
+#include "openvic-simulation/utility/Logger.hpp"
+
+using namespace OpenVic;
+
+static thread_local size_t current_worker_index = 0;
+// Whether this thread, from outside the pool, holds external_caller_lock.
+static thread_local bool holds_external_caller_lock = false;
+
+bool ThreadPool::task_queue_t::push_bottom(task_t const& task) {
+	const std::lock_guard<std::mutex> lock_guard { lock };
+	if (bottom - top >= CAPACITY) {
+		return false;
+	}
+	tasks[bottom % CAPACITY] = task;
+	++bottom;
+	return true;
+}
+
+bool ThreadPool::task_queue_t::pop_bottom(task_t& task) {
+	const std::lock_guard<std::mutex> lock_guard { lock };
+	if (bottom == top) {
+		return false;
+	}
+	--bottom;
+	task = tasks[bottom % CAPACITY];
+	return true;
+}
+
+bool ThreadPool::task_queue_t::steal_top(task_t& task) {
+	const std::lock_guard<std::mutex> lock_guard { lock };
+	if (bottom == top) {
+		return false;
+	}
+	task = tasks[top % CAPACITY];
+	++top;
+	return true;
+}
+
+ThreadPool::ThreadPool() {
+	start(0);
+}
+
+ThreadPool::~ThreadPool() {
+	stop();
+}
+
+ThreadPool& ThreadPool::get_instance() {
+	static ThreadPool instance;
+	return instance;
+}
+
+void ThreadPool::start(size_t new_worker_count) {
+	if (new_worker_count == 0) {
+		new_worker_count = std::thread::hardware_concurrency();
+		if (new_worker_count == 0) {
+			new_worker_count = 1;
+		}
+	}
+
+	worker_count = new_worker_count;
+	stopping = false;
+
+	queues.reserve(worker_count);
+	for (size_t index = 0; index < worker_count; ++index) {
+		queues.emplace_back(std::make_unique<task_queue_t>());
+	}
+
+	threads.reserve(worker_count - 1);
+	for (size_t index = 1; index < worker_count; ++index) {
+		threads.emplace_back(&ThreadPool::worker_loop, this, index);
+	}
+}
+
+void ThreadPool::stop() {
+	{
+		const std::lock_guard<std::mutex> lock_guard { sleep_lock };
+		stopping = true;
+	}
+	sleep_condition.notify_all();
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	threads.clear();
+	queues.clear();
+	pending_tasks = 0;
+	sleeping_threads = 0;
+	worker_count = 0;
+}
+
+void ThreadPool::set_worker_count(size_t new_worker_count) {
+	if (new_worker_count != 0 && new_worker_count == worker_count) {
+		return;
+	}
+
+	stop();
+	start(new_worker_count);
+
+	Logger::info("Thread pool running with ", worker_count, " worker(s)");
+}
+
+size_t ThreadPool::get_worker_count() const {
+	return worker_count;
+}
+
+size_t ThreadPool::get_current_worker_index() {
+	return current_worker_index;
+}
+
+void ThreadPool::worker_loop(size_t worker_index) {
+	current_worker_index = worker_index;
+
+	task_t task;
+	while (true) {
+		if (try_get_task(worker_index, task)) {
+			execute_task(worker_index, task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock { sleep_lock };
+		// Paired with the sequentially consistent increment of pending_tasks in push_task: either the pusher sees
+		// this thread as sleeping and notifies it, or this thread sees the pending task and doesn't go to sleep.
+		++sleeping_threads;
+		sleep_condition.wait(lock, [this]() -> bool {
+			return stopping || pending_tasks > 0;
+		});
+		--sleeping_threads;
+
+		if (stopping) {
+			return;
+		}
+	}
+}
+
+bool ThreadPool::push_task(size_t worker_index, task_t const& task) {
+	// Counted before the push so a thief can never decrement it below zero
+	++pending_tasks;
+	if (!queues[worker_index]->push_bottom(task)) {
+		--pending_tasks;
+		return false;
+	}
+
+	if (sleeping_threads > 0) {
+		{
+			const std::lock_guard<std::mutex> lock_guard { sleep_lock };
+		}
+		sleep_condition.notify_one();
+	}
+	return true;
+}
+
+bool ThreadPool::try_get_task(size_t worker_index, task_t& task) {
+	if (queues[worker_index]->pop_bottom(task)) {
+		--pending_tasks;
+		return true;
+	}
+
+	if (pending_tasks == 0) {
+		return false;
+	}
+
+	for (size_t offset = 1; offset < queues.size(); ++offset) {
+		if (queues[(worker_index + offset) % queues.size()]->steal_top(task)) {
+			--pending_tasks;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void run_split(ThreadPool::range_func_t func, size_t grain, size_t begin, size_t end) {
+	if (end - begin > grain) {
+		const size_t middle = begin + (end - begin) / 2;
+		run_split(func, grain, begin, middle);
+		run_split(func, grain, middle, end);
+	} else {
+		func(begin, end);
+	}
+}
+
+void ThreadPool::execute_task(size_t worker_index, task_t task) {
+	job_t& job = *task.job;
+
+	while (task.end - task.begin > job.grain) {
+		const size_t middle = task.begin + (task.end - task.begin) / 2;
+		if (!push_task(worker_index, { &job, middle, task.end })) {
+			// Queue is full, run_split below handles the rest of the range here with the same chunk boundaries
+			break;
+		}
+		task.end = middle;
+	}
+
+	run_split(job.func, job.grain, task.begin, task.end);
+
+	// Last access to the job, which may be destroyed by its owner as soon as remaining reaches 0.
+	job.remaining.fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+}
+
+void ThreadPool::parallel_for(size_t count, size_t grain, range_func_t func) {
+	if (current_worker_index != 0 || holds_external_caller_lock) {
+		_parallel_for(count, grain, func);
+		return;
+	}
+
+	const std::lock_guard<std::mutex> lock_guard { external_caller_lock };
+	holds_external_caller_lock = true;
+	_parallel_for(count, grain, func);
+	holds_external_caller_lock = false;
+}
+
+void ThreadPool::_parallel_for(size_t count, size_t grain, range_func_t func) {
+	if (count == 0) {
+		return;
+	}
+
+	if (grain == 0) {
+		grain = 1;
+	}
+
+	if (worker_count <= 1 || count <= grain) {
+		run_split(func, grain, 0, count);
+		return;
+	}
+
+	const size_t worker_index = get_current_worker_index();
+
+	job_t job { func, grain, count };
+	execute_task(worker_index, { &job, 0, count });
+
+	task_t task;
+	while (job.remaining.load(std::memory_order_acquire) != 0) {
+		if (try_get_task(worker_index, task)) {
+			execute_task(worker_index, task);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
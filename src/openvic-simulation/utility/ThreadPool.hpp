@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "openvic-simulation/types/FunctionRef.hpp"
+
+namespace OpenVic {
+	/* Exception-free work-stealing thread pool used to run the simulation's data parallel loops.
+	 *
+	 * Every worker owns a bounded task deque: it pushes and pops work at the bottom, while idle workers steal from the top.
+	 * Index ranges are split in half down to their grain size, with the upper half pushed as a new task, so thieves
+	 * always take the largest remaining piece of work. Any thread waiting for a range to finish keeps executing tasks,
+	 * which means nested parallel loops (e.g. pops inside provinces) cannot deadlock.
+	 *
+	 * Chunk boundaries only depend on the range size and grain, never on the number of workers or on scheduling, so as
+	 * long as the per-chunk work doesn't depend on execution order the results are identical for any worker count. */
+	struct ThreadPool {
+		// Called with a half-open [begin, end) range of indices.
+		using range_func_t = FunctionRef<void(size_t, size_t)>;
+
+	private:
+		struct job_t {
+			range_func_t func;
+			const size_t grain;
+			std::atomic<size_t> remaining;
+		};
+
+		struct task_t {
+			job_t* job;
+			size_t begin;
+			size_t end;
+		};
+
+		/* Fixed capacity ring buffer, so queueing work never allocates. When it is full, tasks are
+		 * simply executed without further splitting. Ranges are split in half, so each job only
+		 * needs log2(size / grain) slots per worker. */
+		struct task_queue_t {
+			static constexpr size_t CAPACITY = 1024;
+
+			std::mutex lock;
+			std::array<task_t, CAPACITY> tasks;
+			size_t top = 0, bottom = 0;
+
+			bool push_bottom(task_t const& task);
+			bool pop_bottom(task_t& task);
+			bool steal_top(task_t& task);
+		};
+
+		// Queue 0 belongs to threads outside the pool (e.g. the simulation thread), queues 1+ to the pool's own threads.
+		std::vector<std::unique_ptr<task_queue_t>> queues;
+		std::vector<std::thread> threads;
+
+		std::atomic<size_t> pending_tasks = 0;
+		std::atomic<size_t> sleeping_threads = 0;
+		std::atomic<bool> stopping = false;
+		std::mutex sleep_lock;
+		std::condition_variable sleep_condition;
+
+		// Held by the outermost parallel_for of a thread outside the pool, as all such threads share worker index 0.
+		std::mutex external_caller_lock;
+
+		size_t worker_count = 0;
+
+		void start(size_t new_worker_count);
+		void stop();
+
+		void worker_loop(size_t worker_index);
+		bool push_task(size_t worker_index, task_t const& task);
+		bool try_get_task(size_t worker_index, task_t& task);
+		void execute_task(size_t worker_index, task_t task);
+		void _parallel_for(size_t count, size_t grain, range_func_t func);
+
+		ThreadPool();
+
+	public:
+		// Upper bound on the number of chunks a range is split into when no grain is specified.
+		static constexpr size_t DEFAULT_MAX_CHUNK_COUNT = 128;
+
+		ThreadPool(ThreadPool const&) = delete;
+		ThreadPool& operator=(ThreadPool const&) = delete;
+		~ThreadPool();
+
+		static ThreadPool& get_instance();
+
+		/* Number of threads executing tasks, including the thread calling parallel_for. 0 means one per hardware thread,
+		 * 1 runs everything on the calling thread. Must not be called while a parallel_for is in progress. */
+		void set_worker_count(size_t new_worker_count);
+		size_t get_worker_count() const;
+
+		/* Index in [0, get_worker_count()) of the pool thread calling this, 0 for threads outside the pool. While a
+		 * parallel_for chunk runs, no other thread shares its index, so it can select per-thread scratch data. This holds
+		 * for index 0 too, as threads outside the pool take turns running their parallel_for calls. */
+		static size_t get_current_worker_index();
+
+		static constexpr size_t get_default_grain(size_t count) {
+			const size_t grain = count / DEFAULT_MAX_CHUNK_COUNT;
+			return grain > 0 ? grain : 1;
+		}
+
+		/* Calls func on disjoint sub-ranges covering [0, count), each at most grain long,
+		 * returning once all of them have completed. A thread outside the pool waits for any other such thread's
+		 * parallel_for to finish first, while nested calls from inside a chunk never wait. */
+		void parallel_for(size_t count, size_t grain, range_func_t func);
+
+		void parallel_for(size_t count, range_func_t func) {
+			parallel_for(count, get_default_grain(count), func);
+		}
+	};
+}
@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+#include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/modifier/Modifier.hpp"
+#include "openvic-simulation/modifier/ModifierManager.hpp"
+#include "openvic-simulation/modifier/ModifierSum.hpp"
+#include "openvic-simulation/types/Date.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include "scripts/TestGame.hpp"
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+using namespace OpenVic::testing;
+
+namespace {
+	size_t count_entries(ModifierSum const& modifier_sum, Modifier const& modifier) {
+		return std::count_if(
+			modifier_sum.get_modifiers().begin(), modifier_sum.get_modifiers().end(),
+			[&modifier](modifier_entry_t const& entry) -> bool {
+				return &entry.modifier == &modifier;
+			}
+		);
+	}
+}
+
+TEST_CASE("CountryInstance Event modifiers", "[CountryInstance][CountryInstance-modifiers]") {
+	test_game_t game;
+	ModifierManager& modifier_manager = game.definition_manager.get_modifier_manager();
+	for (const std::string_view identifier : { "test_event_modifier_short", "test_event_modifier_long" }) {
+		modifier_manager.add_event_modifier(identifier, {}, 0);
+	}
+	Modifier const& short_modifier = *modifier_manager.get_event_modifier_by_identifier("test_event_modifier_short");
+	Modifier const& long_modifier = *modifier_manager.get_event_modifier_by_identifier("test_event_modifier_long");
+
+	CountryInstance& england = game.get_country("ENG");
+	StaticModifierCache const& static_modifier_cache = modifier_manager.get_static_modifier_cache();
+	const Date today = game.instance_manager->get_today();
+
+	// Both the persistent sum and a full rebuild include added modifiers.
+	england.add_event_modifier(short_modifier, today + 1);
+	england.add_event_modifier(long_modifier, today + 10);
+	CHECK(england.check_persistent_modifier_sum());
+	england.update_modifier_sum(today, static_modifier_cache);
+	CHECK(england.get_event_modifiers().size() == 2);
+	CHECK(count_entries(england.get_modifier_sum(), short_modifier) == 1);
+	CHECK(count_entries(england.get_modifier_sum(), long_modifier) == 1);
+
+	// Adding a modifier again only moves its expiry date.
+	england.add_event_modifier(short_modifier, today + 2);
+	CHECK(england.check_persistent_modifier_sum());
+	england.update_modifier_sum(today + 2, static_modifier_cache);
+	CHECK(england.get_event_modifiers().size() == 2);
+	CHECK(count_entries(england.get_modifier_sum(), short_modifier) == 1);
+
+	// Expired modifiers are removed from the persistent sum, and only them.
+	england.update_modifier_sum(today + 3, static_modifier_cache);
+	CHECK(england.check_persistent_modifier_sum());
+	CHECK(england.get_event_modifiers().size() == 1);
+	CHECK(count_entries(england.get_modifier_sum(), short_modifier) == 0);
+	CHECK(count_entries(england.get_modifier_sum(), long_modifier) == 1);
+
+	england.update_modifier_sum(today + 11, static_modifier_cache);
+	CHECK(england.check_persistent_modifier_sum());
+	CHECK(england.get_event_modifiers().empty());
+	CHECK(count_entries(england.get_modifier_sum(), long_modifier) == 0);
+
+	// Other countries are unaffected.
+	CHECK(game.get_country("FRA").get_event_modifiers().empty());
+}
@@ -0,0 +1,125 @@
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "openvic-simulation/dataloader/DefinitionsCache.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	static constexpr DefinitionsCache::section_tag_t TEST_SECTION = 0x54534554; // "TEST"
+
+	// Fresh empty directory under the system temporary directory, removed on destruction.
+	struct temporary_directory_t {
+		fs::path path;
+
+		temporary_directory_t(std::string_view name) : path { fs::temp_directory_path() / name } {
+			fs::remove_all(path);
+			fs::create_directories(path);
+		}
+
+		~temporary_directory_t() {
+			std::error_code ec;
+			fs::remove_all(path, ec);
+		}
+	};
+
+	void write_file(fs::path const& path, std::string_view contents) {
+		fs::create_directories(path.parent_path());
+		std::ofstream { path, std::ios::binary | std::ios::trunc } << contents;
+	}
+}
+
+TEST_CASE("DefinitionsCache Read write", "[definitions-cache][definitions-cache-read-write]") {
+	DefinitionsCache::writer_t writer;
+	writer.begin_section(TEST_SECTION);
+	writer.write<int32_t>(-7);
+	writer.write_span<uint16_t>(std::vector<uint16_t> { 1, 2, 3 });
+	writer.write_string("abc");
+
+	DefinitionsCache::reader_t reader { writer.get_data() };
+	int32_t value = 0;
+	std::vector<uint16_t> values;
+	std::string string;
+	CHECK(reader.read_section(TEST_SECTION));
+	CHECK(reader.read(value));
+	CHECK(reader.read_vector(values));
+	CHECK(reader.read_string(string));
+	CHECK(value == -7);
+	CHECK(values == std::vector<uint16_t> { 1, 2, 3 });
+	CHECK(string == "abc");
+	CHECK_FALSE(reader.has_failed());
+
+	// Reading past the end fails, as does everything after it.
+	CHECK_FALSE(reader.read(value));
+	CHECK(reader.has_failed());
+
+	DefinitionsCache::reader_t wrong_section_reader { writer.get_data() };
+	CHECK_FALSE(wrong_section_reader.read_section(TEST_SECTION + 1));
+	CHECK_FALSE(wrong_section_reader.read(value));
+}
+
+TEST_CASE("DefinitionsCache Invalidation", "[definitions-cache][definitions-cache-invalidation]") {
+	const temporary_directory_t directory { "openvic_definitions_cache_test" };
+	const std::vector<fs::path> roots { directory.path / "base" };
+	const fs::path cache_path = directory.path / "cache" / "definitions.bin";
+
+	write_file(roots[0] / "common" / "goods.txt", "goods = {}");
+	write_file(roots[0] / "map" / "default.map", "max_provinces = 1");
+
+	const DefinitionsCache::key_t key = DefinitionsCache::compute_key(roots);
+	CHECK(key == DefinitionsCache::compute_key(roots));
+
+	DefinitionsCache cache;
+	CHECK_FALSE(cache.open(cache_path, key));
+
+	DefinitionsCache::writer_t writer;
+	writer.begin_section(TEST_SECTION);
+	writer.write<uint64_t>(42);
+	CHECK(cache.save(writer));
+
+	CHECK_OR_RETURN(cache.open(cache_path, key));
+	DefinitionsCache::reader_t reader = cache.get_reader();
+	uint64_t value = 0;
+	CHECK(reader.read_section(TEST_SECTION));
+	CHECK(reader.read(value));
+	CHECK(value == 42);
+	cache.close();
+
+	// Changing, adding or removing any file changes the key.
+	write_file(roots[0] / "common" / "goods.txt", "goods = { a = {} }");
+	const DefinitionsCache::key_t changed_key = DefinitionsCache::compute_key(roots);
+	CHECK(changed_key != key);
+	CHECK_FALSE(cache.open(cache_path, changed_key));
+
+	write_file(roots[0] / "common" / "new.txt", "");
+	const DefinitionsCache::key_t added_key = DefinitionsCache::compute_key(roots);
+	CHECK(added_key != changed_key);
+
+	fs::remove(roots[0] / "common" / "new.txt");
+	CHECK(DefinitionsCache::compute_key(roots) == changed_key);
+}
+
+TEST_CASE("DefinitionsCache Modification time", "[definitions-cache][definitions-cache-invalidation]") {
+	const temporary_directory_t directory { "openvic_definitions_cache_mtime_test" };
+	const std::vector<fs::path> roots { directory.path / "base" };
+	const fs::path file_path = roots[0] / "map" / "provinces.bmp";
+
+	write_file(file_path, "BM");
+	const fs::file_time_type modification_time = fs::last_write_time(file_path);
+	const DefinitionsCache::key_t key = DefinitionsCache::compute_key(roots);
+
+	// Touching a file without changing its size or contents still invalidates the key, and restoring the time reverts it.
+	fs::last_write_time(file_path, modification_time + std::chrono::hours { 1 });
+	CHECK(DefinitionsCache::compute_key(roots) != key);
+
+	fs::last_write_time(file_path, modification_time);
+	CHECK(DefinitionsCache::compute_key(roots) == key);
+}
@@ -0,0 +1,80 @@
+#include <vector>
+
+#include "openvic-simulation/diplomacy/CountryRelation.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+TEST_CASE("CountryRelationManager Symmetric access", "[CountryRelationManager][CountryRelationManager-access]") {
+	CountryRelationManager manager;
+	manager.setup(4);
+
+	CHECK(manager.get_country_relation(0, 3) == 0);
+
+	CHECK(manager.set_country_relation(3, 1, 50));
+	CHECK(manager.get_country_relation(3, 1) == 50);
+	CHECK(manager.get_country_relation(1, 3) == 50);
+	CHECK(manager.get_country_relation(1, 2) == 0);
+
+	CHECK(manager.change_country_relation(1, 3, 1000));
+	CHECK(manager.get_country_relation(3, 1) == CountryRelationManager::MAX_RELATION);
+
+	CHECK_FALSE(manager.set_country_relation(2, 2, 10));
+	CHECK_FALSE(manager.set_country_relation(4, 0, 10));
+	CHECK(manager.get_country_relation_ptr(0, 0) == nullptr);
+
+	CHECK(manager.set_country_relation(2, 0, -30));
+	CHECK(manager.reset_country(2));
+	CHECK(manager.get_country_relation(0, 2) == 0);
+	CHECK(manager.get_country_relation(1, 3) == CountryRelationManager::MAX_RELATION);
+}
+
+TEST_CASE("CountryRelationManager Drift and decay", "[CountryRelationManager][CountryRelationManager-drift]") {
+	CountryRelationManager manager;
+	manager.setup(3);
+
+	CHECK(manager.set_country_relation(0, 1, 10));
+	CHECK(manager.set_country_relation(0, 2, -3));
+
+	CHECK(manager.decay_relations(5));
+	CHECK(manager.get_country_relation(0, 1) == 5);
+	CHECK(manager.get_country_relation(0, 2) == 0);
+	CHECK(manager.get_country_relation(1, 2) == 0);
+
+	CHECK(manager.drift_relations(100, 20));
+	CHECK(manager.get_country_relation(0, 1) == 25);
+	CHECK(manager.get_country_relation(1, 2) == 20);
+
+	// Negative steps are rejected rather than moving relations away from the target.
+	CHECK_FALSE(manager.decay_relations(-5));
+	CHECK_FALSE(manager.drift_relations(100, -1));
+	CHECK(manager.get_country_relation(0, 1) == 25);
+	CHECK(manager.get_country_relation(1, 2) == 20);
+
+	// Targets outside the relation range are clamped to it.
+	CHECK(manager.drift_relations(1000, 1000));
+	CHECK(manager.get_country_relation(0, 1) == CountryRelationManager::MAX_RELATION);
+	CHECK(manager.drift_relations(-1000, 1000));
+	CHECK(manager.get_country_relation(0, 2) == CountryRelationManager::MIN_RELATION);
+}
+
+TEST_CASE("CountryRelationManager Sparse relations", "[CountryRelationManager][CountryRelationManager-sparse]") {
+	CountryRelationManager manager;
+	manager.setup(5);
+
+	CHECK(manager.set_country_relation(4, 0, 120));
+	CHECK(manager.set_country_relation(1, 2, -45));
+
+	const std::vector<CountryRelationManager::sparse_relation_t> sparse = manager.get_sparse_relations();
+	CHECK(sparse.size() == 2);
+
+	CountryRelationManager loaded;
+	loaded.setup(5);
+	CHECK(loaded.set_sparse_relations(sparse));
+	CHECK(loaded.get_country_relation(0, 4) == 120);
+	CHECK(loaded.get_country_relation(2, 1) == -45);
+	CHECK(loaded.get_country_relation(3, 4) == 0);
+}
@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "openvic-simulation/economy/GoodDefinition.hpp"
+#include "openvic-simulation/economy/trading/GoodMarket.hpp"
+#include "openvic-simulation/misc/GameRulesManager.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	struct order_t {
+		fixed_point_t max_quantity;
+		fixed_point_t money_to_spend;
+	};
+
+	struct clearing_t {
+		std::vector<fixed_point_t> quantity_bought, money_spent, quantity_sold, money_gained;
+		fixed_point_t new_price;
+	};
+
+	struct market_fixture_t {
+		GoodDefinitionManager good_definition_manager;
+		GameRulesManager game_rules_manager;
+
+		market_fixture_t(bool use_optimal_pricing) {
+			game_rules_manager.set_use_exponential_price_changes(use_optimal_pricing);
+			good_definition_manager.add_good_category("test_goods", 1);
+			good_definition_manager.add_good_definition(
+				"test_good", colour_t {}, good_definition_manager.get_back_good_category(), fixed_point_t::_2(), true,
+				true, false, false
+			);
+		}
+
+		GoodMarket make_market() const {
+			return { game_rules_manager, good_definition_manager.get_back_good_definition() };
+		}
+	};
+
+	/* The clearing GoodMarket::execute_orders did before it sorted orders by their saturation thresholds, rescanning
+	 * every unsaturated order until none changed. Only covers the case with at least one sell order. The price drop
+	 * with optimal pricing starts from max_next_price, as it used to divide by an unset price of 0. */
+	clearing_t reference_clearing(
+		std::vector<order_t> const& orders, std::vector<fixed_point_t> const& supplies, fixed_point_t price,
+		fixed_point_t max_next_price, fixed_point_t min_next_price, bool use_optimal_pricing
+	) {
+		clearing_t result;
+		result.quantity_bought.resize(orders.size());
+		result.money_spent.resize(orders.size());
+
+		fixed_point_t demand_sum = fixed_point_t::_0(), supply_sum = fixed_point_t::_0();
+		for (const fixed_point_t supply : supplies) {
+			supply_sum += supply;
+		}
+
+		std::vector<fixed_point_t> purchasing_power_per_order(orders.size());
+		std::vector<fixed_point_t>& quantity_bought_per_order = result.quantity_bought;
+
+		fixed_point_t money_left_to_spend_sum = fixed_point_t::_0();
+		fixed_point_t max_quantity_to_buy_sum = fixed_point_t::_0();
+		fixed_point_t purchasing_power_sum = fixed_point_t::_0();
+		fixed_point_t remaining_supply = supply_sum;
+		for (size_t i = 0; i < orders.size(); i++) {
+			order_t const& order = orders[i];
+			if (use_optimal_pricing) {
+				const fixed_point_t affordable_price = order.money_to_spend / order.max_quantity;
+				if (affordable_price > min_next_price) {
+					min_next_price = affordable_price;
+				}
+			}
+
+			demand_sum += order.max_quantity;
+			const fixed_point_t purchasing_power = purchasing_power_per_order[i] = order.money_to_spend / max_next_price;
+			if (purchasing_power >= order.max_quantity) {
+				quantity_bought_per_order[i] = order.max_quantity;
+				max_quantity_to_buy_sum += order.max_quantity;
+				remaining_supply -= order.max_quantity;
+			} else {
+				quantity_bought_per_order[i] = fixed_point_t::_0();
+				max_quantity_to_buy_sum += purchasing_power;
+				money_left_to_spend_sum += order.money_to_spend;
+				purchasing_power_sum += purchasing_power;
+			}
+		}
+
+		fixed_point_t new_price = price;
+		if (max_quantity_to_buy_sum >= supply_sum) {
+			new_price = max_next_price;
+
+			bool someone_bought_max_quantity;
+			do {
+				someone_bought_max_quantity = false;
+				for (size_t i = 0; i < orders.size(); i++) {
+					if (quantity_bought_per_order[i] == orders[i].max_quantity) {
+						continue;
+					}
+
+					const fixed_point_t distributed_supply = quantity_bought_per_order[i] = fixed_point_t::mul_div(
+						remaining_supply, purchasing_power_per_order[i], purchasing_power_sum
+					);
+					if (distributed_supply >= orders[i].max_quantity) {
+						someone_bought_max_quantity = true;
+						quantity_bought_per_order[i] = orders[i].max_quantity;
+						remaining_supply -= orders[i].max_quantity;
+						purchasing_power_sum -= purchasing_power_per_order[i];
+					}
+				}
+			} while (someone_bought_max_quantity);
+		} else {
+			if (use_optimal_pricing) {
+				new_price = max_next_price;
+				while (remaining_supply > fixed_point_t::_0()) {
+					const fixed_point_t possible_price = money_left_to_spend_sum / remaining_supply;
+
+					if (possible_price >= new_price) {
+						break;
+					}
+
+					if (possible_price < min_next_price) {
+						new_price = min_next_price;
+						break;
+					}
+
+					new_price = possible_price;
+
+					for (size_t i = 0; i < orders.size(); i++) {
+						if (quantity_bought_per_order[i] == orders[i].max_quantity) {
+							continue;
+						}
+
+						if (orders[i].money_to_spend >= new_price * orders[i].max_quantity) {
+							quantity_bought_per_order[i] = orders[i].max_quantity;
+							remaining_supply -= orders[i].max_quantity;
+							money_left_to_spend_sum -= orders[i].money_to_spend;
+						}
+					}
+				}
+			} else {
+				new_price = supply_sum > demand_sum ? min_next_price : price;
+			}
+
+			for (size_t i = 0; i < orders.size(); i++) {
+				quantity_bought_per_order[i] = std::min(orders[i].max_quantity, orders[i].money_to_spend / new_price);
+			}
+		}
+
+		fixed_point_t quantity_traded = fixed_point_t::_0();
+		for (size_t i = 0; i < orders.size(); i++) {
+			quantity_traded += quantity_bought_per_order[i];
+			result.money_spent[i] = quantity_bought_per_order[i] * new_price;
+		}
+
+		for (const fixed_point_t supply : supplies) {
+			const fixed_point_t quantity_sold = fixed_point_t::mul_div(supply, quantity_traded, supply_sum);
+			result.quantity_sold.push_back(quantity_sold);
+			result.money_gained.push_back(quantity_sold * new_price);
+		}
+
+		result.new_price = new_price;
+		return result;
+	}
+
+	// Adds orders to market which record their results in result, once the market's orders are executed.
+	void place_orders(
+		GoodMarket& market, std::vector<order_t> const& orders, std::vector<fixed_point_t> const& supplies,
+		clearing_t& result
+	) {
+		result.quantity_bought.resize(orders.size());
+		result.money_spent.resize(orders.size());
+		result.quantity_sold.resize(supplies.size());
+		result.money_gained.resize(supplies.size());
+
+		std::vector<GoodBuyUpToOrder> buy_up_to_orders;
+		for (size_t i = 0; i < orders.size(); i++) {
+			buy_up_to_orders.emplace_back(
+				orders[i].max_quantity, orders[i].money_to_spend,
+				[&result, i](const BuyResult buy_result) -> void {
+					result.quantity_bought[i] = buy_result.get_quantity_bought();
+					result.money_spent[i] = buy_result.get_money_spent();
+				}
+			);
+		}
+
+		std::vector<GoodMarketSellOrder> market_sell_orders;
+		for (size_t i = 0; i < supplies.size(); i++) {
+			market_sell_orders.emplace_back(
+				supplies[i],
+				[&result, i](const SellResult sell_result) -> void {
+					result.quantity_sold[i] = sell_result.get_quantity_sold();
+					result.money_gained[i] = sell_result.get_money_gained();
+				}
+			);
+		}
+
+		market.add_buy_up_to_orders(buy_up_to_orders);
+		market.add_market_sell_orders(market_sell_orders);
+	}
+
+	clearing_t execute_clearing(
+		GoodMarket& market, std::vector<order_t> const& orders, std::vector<fixed_point_t> const& supplies
+	) {
+		clearing_t result;
+		place_orders(market, orders, supplies, result);
+		market.execute_orders();
+		result.new_price = market.get_price();
+		return result;
+	}
+
+	// Random orders with raw fixed point values, so rounding at every step is exercised.
+	std::vector<order_t> random_orders(size_t count, std::mt19937& rand) {
+		std::vector<order_t> orders;
+		for (size_t i = 0; i < count; i++) {
+			orders.push_back({
+				fixed_point_t::parse_raw(fixed_point_t::ONE / 100 + rand() % (100 * fixed_point_t::ONE)),
+				fixed_point_t::parse_raw(fixed_point_t::ONE / 100 + rand() % (400 * fixed_point_t::ONE))
+			});
+		}
+		return orders;
+	}
+
+	// Supply as a proportion of the orders' total max_quantity, split across a few sellers.
+	std::vector<fixed_point_t> random_supplies(std::vector<order_t> const& orders, fixed_point_t proportion, std::mt19937& rand) {
+		fixed_point_t demand_sum = fixed_point_t::_0();
+		for (order_t const& order : orders) {
+			demand_sum += order.max_quantity;
+		}
+
+		const size_t seller_count = 1 + rand() % 4;
+		std::vector<fixed_point_t> supplies(seller_count, demand_sum * proportion / static_cast<int32_t>(seller_count));
+		return supplies;
+	}
+
+	bool clearings_equal(clearing_t const& lhs, clearing_t const& rhs) {
+		return lhs.quantity_bought == rhs.quantity_bought && lhs.money_spent == rhs.money_spent &&
+			lhs.quantity_sold == rhs.quantity_sold && lhs.money_gained == rhs.money_gained &&
+			lhs.new_price == rhs.new_price;
+	}
+}
+
+TEST_CASE("GoodMarket Matches rescanning clearing", "[GoodMarket][GoodMarket-execute-orders]") {
+	static constexpr size_t CASES_PER_SETTING = 50;
+
+	// Proportions below the total purchasing power take the water-filling path, the others the price dropping path.
+	const fixed_point_t supply_proportions[] {
+		fixed_point_t::_0_10(), fixed_point_t::_0_50(), fixed_point_t::_1(), fixed_point_t::_2(), fixed_point_t::_4()
+	};
+
+	std::mt19937 rand { 1 };
+
+	for (const bool use_optimal_pricing : { false, true }) {
+		const market_fixture_t fixture { use_optimal_pricing };
+
+		for (const fixed_point_t supply_proportion : supply_proportions) {
+			for (size_t test_case = 0; test_case < CASES_PER_SETTING; test_case++) {
+				const std::vector<order_t> orders = random_orders(1 + rand() % 200, rand);
+				const std::vector<fixed_point_t> supplies = random_supplies(orders, supply_proportion, rand);
+
+				GoodMarket market = fixture.make_market();
+				const clearing_t expected = reference_clearing(
+					orders, supplies, market.get_price(), market.get_max_next_price(), market.get_min_next_price(),
+					use_optimal_pricing
+				);
+				const clearing_t actual = execute_clearing(market, orders, supplies);
+
+				CHECK(clearings_equal(expected, actual));
+			}
+		}
+	}
+}
+
+TEST_CASE("GoodMarket Saturation price", "[GoodMarket][GoodMarket-saturation-price]") {
+	// The highest price at which an order can afford its max_quantity, matching the check the rescanning clearing did.
+	const auto is_saturation_price = [](fixed_point_t price, order_t const& order) -> bool {
+		return order.money_to_spend >= price * order.max_quantity &&
+			order.money_to_spend < (price + fixed_point_t::epsilon()) * order.max_quantity;
+	};
+
+	std::mt19937 rand { 3 };
+	for (order_t const& order : random_orders(1000, rand)) {
+		CHECK(is_saturation_price(GoodMarket::get_saturation_price(order.money_to_spend, order.max_quantity), order));
+	}
+
+	CHECK(GoodMarket::get_saturation_price(fixed_point_t::_1(), fixed_point_t::_1()) == fixed_point_t::_1());
+	CHECK(GoodMarket::get_saturation_price(fixed_point_t::_0(), fixed_point_t::_1()) == fixed_point_t::_0());
+
+	// Budgets from about 2^31 up overflowed int64 when the money was shifted before dividing.
+	const fixed_point_t large_money = fixed_point_t::parse_raw(int64_t { 1 } << 50);
+	CHECK(GoodMarket::get_saturation_price(large_money, fixed_point_t { 16 }) == fixed_point_t::parse_raw(int64_t { 1 } << 46));
+	CHECK(GoodMarket::get_saturation_price(large_money - fixed_point_t::epsilon(), fixed_point_t::_1()) == large_money - fixed_point_t::epsilon());
+	CHECK(GoodMarket::get_saturation_price(large_money, fixed_point_t::epsilon()) == fixed_point_t::max());
+	CHECK(GoodMarket::get_saturation_price(fixed_point_t::max(), fixed_point_t::_1()) == fixed_point_t::max());
+}
+
+TEST_CASE("GoodMarket Benchmark", "[.][GoodMarket][GoodMarket-benchmark]") {
+	using clock_t = std::chrono::steady_clock;
+
+	const auto millis = [](clock_t::duration time) -> double {
+		return std::chrono::duration<double, std::milli>(time).count();
+	};
+
+	std::mt19937 rand { 2 };
+
+	for (const bool use_optimal_pricing : { false, true }) {
+		const market_fixture_t fixture { use_optimal_pricing };
+
+		for (const size_t order_count : { 1000, 10000, 100000 }) {
+			const std::vector<order_t> orders = random_orders(order_count, rand);
+			// A shortage and a surplus, taking the water-filling and the price dropping paths respectively.
+			for (const fixed_point_t supply_proportion : { fixed_point_t::_0_50(), fixed_point_t::_2() }) {
+				const std::vector<fixed_point_t> supplies = random_supplies(orders, supply_proportion, rand);
+
+				GoodMarket market = fixture.make_market();
+				const fixed_point_t price = market.get_price();
+				const fixed_point_t max_next_price = market.get_max_next_price();
+				const fixed_point_t min_next_price = market.get_min_next_price();
+
+				const clock_t::time_point reference_start = clock_t::now();
+				const clearing_t expected = reference_clearing(
+					orders, supplies, price, max_next_price, min_next_price, use_optimal_pricing
+				);
+				const clock_t::duration reference_time = clock_t::now() - reference_start;
+
+				clearing_t actual;
+				place_orders(market, orders, supplies, actual);
+				const clock_t::time_point sorted_start = clock_t::now();
+				market.execute_orders();
+				const clock_t::duration sorted_time = clock_t::now() - sorted_start;
+				actual.new_price = market.get_price();
+
+				CHECK(clearings_equal(expected, actual));
+
+				fmt::print(
+					"{} orders, {}, supply {}x demand: rescanning {:.3f} ms, sorted {:.3f} ms\n", order_count,
+					use_optimal_pricing ? "optimal pricing" : "simple pricing", supply_proportion.to_double(),
+					millis(reference_time), millis(sorted_time)
+				);
+			}
+		}
+	}
+}
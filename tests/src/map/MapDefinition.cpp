@@ -0,0 +1,228 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <openvic-dataloader/v2script/Parser.hpp>
+
+#include "openvic-simulation/map/MapDefinition.hpp"
+#include "openvic-simulation/map/ProvinceDefinition.hpp"
+#include "openvic-simulation/map/TerrainType.hpp"
+#include "openvic-simulation/modifier/ModifierManager.hpp"
+#include "openvic-simulation/types/Colour.hpp"
+#include "openvic-simulation/types/Vector.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPointMap.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	/* Terrain values 0 and 1 are textured plains, 2 is textured hills beyond the texture limit and 3 is untextured
+	 * hills, so only 0 and 1 have a shape image terrain value. Values from 4 upwards have no mapping. */
+	constexpr std::string_view TERRAIN_SCRIPT = R"(
+		terrain = 2
+		categories = {
+			plains = { color = { 1 2 3 } movement_cost = 1 }
+			hills = { color = { 4 5 6 } movement_cost = 1.5 }
+		}
+		plains_texture = { type = plains color = { 0 1 } }
+		hills_texture = { type = hills color = { 2 } }
+		hills_untextured = { type = hills color = { 3 } has_texture = no }
+	)";
+	constexpr uint8_t TERRAIN_VALUE_COUNT = 6;
+	constexpr uint8_t PLAINS = 1, HILLS = 3, UNMAPPED = 5;
+
+	constexpr int32_t WIDTH = 64, HEIGHT = 300;
+	/* Provinces up to CELL_PROVINCE_COUNT cover the image, the next two only have the pixels of the terrain type ties
+	 * and the last one is never drawn, so it is missing from the map. */
+	constexpr size_t CELL_PROVINCE_COUNT = 21, TIE_PROVINCE_A = 22, TIE_PROVINCE_B = 23, PROVINCE_COUNT = 24;
+
+	colour_t get_province_colour(size_t province) {
+		return { static_cast<uint8_t>(province * 10 + 5), static_cast<uint8_t>(250 - province), 7 };
+	}
+
+	void write_bmp(std::filesystem::path const& path, uint16_t bits_per_pixel, std::vector<uint8_t> const& pixel_data) {
+		const uint32_t palette_size = bits_per_pixel == 8 ? 256 : 0;
+		const uint32_t offset = 54 + palette_size * 4;
+
+		std::vector<uint8_t> file;
+		const auto write = [&file](uint32_t value, size_t bytes) -> void {
+			for (size_t byte = 0; byte < bytes; ++byte) {
+				file.push_back(value >> (byte * 8));
+			}
+		};
+		write(0x4d42, 2);
+		write(offset + pixel_data.size(), 4);
+		write(0, 4);
+		write(offset, 4);
+		write(40, 4);
+		write(WIDTH, 4);
+		write(HEIGHT, 4);
+		write(1, 2);
+		write(bits_per_pixel, 2);
+		write(0, 4); // Compression
+		write(0, 4); // Image size, unchecked when 0
+		write(0, 4);
+		write(0, 4);
+		write(0, 4); // Colour count, defaulting to the full palette for 8 bits per pixel
+		write(0, 4);
+		file.resize(offset);
+		file.insert(file.end(), pixel_data.begin(), pixel_data.end());
+
+		std::ofstream stream { path, std::ios::binary };
+		stream.write(reinterpret_cast<char const*>(file.data()), file.size());
+	}
+
+	bool setup_map(MapDefinition& map_definition, ModifierManager const& modifier_manager) {
+		bool ret = true;
+		for (size_t province = 1; province <= PROVINCE_COUNT; ++province) {
+			ret &= map_definition.add_province_definition("prov_" + std::to_string(province), get_province_colour(province));
+		}
+		map_definition.lock_province_definitions();
+
+		ovdl::v2script::Parser parser;
+		parser.load_from_string(TERRAIN_SCRIPT);
+		parser.simple_parse();
+		ret &= map_definition.get_terrain_type_manager().load_terrain_types(modifier_manager, parser.get_file_node());
+		return ret;
+	}
+}
+
+/* Compares the parallel shape pass against a single top to bottom pass, as load_map_images did before it was
+ * parallelised, on an image whose rows are split into chunks of a few rows. */
+TEST_CASE("MapDefinition Shape image", "[MapDefinition][MapDefinition-shape]") {
+	std::vector<colour_t> province_pixels(WIDTH * HEIGHT);
+	std::vector<uint8_t> terrain_pixels(WIDTH * HEIGHT);
+
+	// Provinces are the cells around random points, so runs and colours continue across chunk boundaries.
+	std::mt19937 rand { 4 };
+	std::vector<ivec2_t> cell_points;
+	for (size_t province = 1; province <= CELL_PROVINCE_COUNT; ++province) {
+		cell_points.push_back({ static_cast<int32_t>(rand() % WIDTH), static_cast<int32_t>(rand() % HEIGHT) });
+	}
+	const std::vector<colour_t> unrecognised_colours { { 1, 2, 3 }, { 200, 200, 200 } };
+	for (int32_t y = 0; y < HEIGHT; ++y) {
+		for (int32_t x = 0; x < WIDTH; ++x) {
+			size_t nearest = 0;
+			for (size_t cell = 1; cell < cell_points.size(); ++cell) {
+				if ((cell_points[cell] - ivec2_t { x, y }).length_squared() <
+					(cell_points[nearest] - ivec2_t { x, y }).length_squared()) {
+					nearest = cell;
+				}
+			}
+			colour_t& colour = province_pixels[y * WIDTH + x];
+			colour = rand() % 20 == 0 ? unrecognised_colours[rand() % unrecognised_colours.size()]
+				: get_province_colour(rand() % 10 == 0 ? rand() % CELL_PROVINCE_COUNT + 1 : nearest + 1);
+			terrain_pixels[y * WIDTH + x] = rand() % (nearest % 3 + 2) == 0 ? rand() % TERRAIN_VALUE_COUNT : nearest % 4;
+		}
+	}
+
+	// Ties between terrain types go to the one seen first, even when the tied pixels are far apart.
+	const auto fill = [&](size_t province, int32_t y, int32_t x_begin, int32_t x_end, uint8_t terrain) -> void {
+		for (int32_t x = x_begin; x < x_end; ++x) {
+			province_pixels[y * WIDTH + x] = get_province_colour(province);
+			terrain_pixels[y * WIDTH + x] = terrain;
+		}
+	};
+	fill(TIE_PROVINCE_A, 200, 0, 4, HILLS);
+	fill(TIE_PROVINCE_A, 201, 0, 4, PLAINS);
+	fill(TIE_PROVINCE_B, 20, 60, 64, HILLS);
+	fill(TIE_PROVINCE_B, 290, 60, 64, PLAINS);
+	fill(TIE_PROVINCE_B, 291, 60, 62, UNMAPPED);
+
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "openvic_test_map_definition";
+	std::filesystem::create_directories(directory);
+	const std::filesystem::path province_path = directory / "provinces.bmp";
+	const std::filesystem::path terrain_path = directory / "terrain.bmp";
+	const std::filesystem::path rivers_path = directory / "rivers.bmp";
+
+	std::vector<uint8_t> province_data;
+	for (colour_t const& colour : province_pixels) {
+		province_data.insert(province_data.end(), { colour.blue, colour.green, colour.red });
+	}
+	write_bmp(province_path, 24, province_data);
+	write_bmp(terrain_path, 8, terrain_pixels);
+	// Values from 12 upwards aren't rivers.
+	write_bmp(rivers_path, 8, std::vector<uint8_t>(WIDTH * HEIGHT, 255));
+
+	ModifierManager modifier_manager;
+
+	for (const size_t worker_count : { 1, 4 }) {
+		ThreadPool::get_instance().set_worker_count(worker_count);
+
+		MapDefinition map_definition;
+		REQUIRE(setup_map(map_definition, modifier_manager));
+		CHECK(map_definition.load_map_images(province_path, terrain_path, rivers_path, true));
+		REQUIRE(map_definition.get_width() == WIDTH);
+		REQUIRE(map_definition.get_height() == HEIGHT);
+
+		TerrainTypeManager const& terrain_type_manager = map_definition.get_terrain_type_manager();
+
+		// The serial pass, with each province's terrain types counted in the order they appear in the image.
+		std::vector<fixed_point_map_t<TerrainType const*>> terrain_type_pixels_list(PROVINCE_COUNT);
+		std::vector<fixed_point_t> pixels_per_province(PROVINCE_COUNT);
+		std::vector<fvec2_t> pixel_position_sum_per_province(PROVINCE_COUNT);
+		size_t wrong_pixels = 0;
+
+		for (ivec2_t pos {}; pos.y < HEIGHT; ++pos.y) {
+			for (pos.x = 0; pos.x < WIDTH; ++pos.x) {
+				const size_t pixel_index = pos.y * WIDTH + pos.x;
+				ProvinceDefinition::index_t province_index = ProvinceDefinition::NULL_INDEX;
+				for (size_t province = 1; province <= PROVINCE_COUNT; ++province) {
+					if (province_pixels[pixel_index] == get_province_colour(province)) {
+						province_index = province;
+					}
+				}
+
+				const TerrainTypeMapping::index_t terrain = terrain_pixels[pixel_index];
+				const TerrainTypeMapping::index_t shape_terrain = terrain < 2 ? terrain + 1 : 0;
+
+				MapDefinition::shape_pixel_t const& shape_pixel = map_definition.get_province_shape_image()[pixel_index];
+				if (shape_pixel.index != province_index || shape_pixel.terrain != shape_terrain) {
+					wrong_pixels++;
+				}
+
+				if (province_index != ProvinceDefinition::NULL_INDEX) {
+					pixels_per_province[province_index - 1]++;
+					pixel_position_sum_per_province[province_index - 1] += static_cast<fvec2_t>(pos);
+
+					TerrainTypeMapping const* mapping = terrain_type_manager.get_terrain_type_mapping_for(terrain);
+					if (mapping != nullptr) {
+						terrain_type_pixels_list[province_index - 1][&mapping->get_type()]++;
+					}
+				}
+			}
+		}
+		CHECK(wrong_pixels == 0);
+
+		for (size_t array_index = 0; array_index < PROVINCE_COUNT; ++array_index) {
+			ProvinceDefinition const& province = *map_definition.get_province_definition_by_index(array_index + 1);
+
+			fixed_point_map_t<TerrainType const*> const& terrain_type_pixels = terrain_type_pixels_list[array_index];
+			const fixed_point_map_const_iterator_t<TerrainType const*> largest = get_largest_item(terrain_type_pixels);
+			CHECK(province.get_default_terrain_type() == (largest != terrain_type_pixels.end() ? largest->first : nullptr));
+
+			CHECK(province.get_on_map() == (pixels_per_province[array_index] > 0));
+			if (province.get_on_map()) {
+				CHECK(province.get_centre() == pixel_position_sum_per_province[array_index] / pixels_per_province[array_index]);
+			}
+		}
+
+		// The tie-breaks and missing province are actually exercised.
+		TerrainType const* hills = terrain_type_manager.get_terrain_type_by_identifier("hills");
+		CHECK(map_definition.get_province_definition_by_index(TIE_PROVINCE_A)->get_default_terrain_type() == hills);
+		CHECK(map_definition.get_province_definition_by_index(TIE_PROVINCE_B)->get_default_terrain_type() == hills);
+		CHECK_FALSE(map_definition.get_province_definition_by_index(PROVINCE_COUNT)->get_on_map());
+	}
+
+	ThreadPool::get_instance().set_worker_count(0);
+	std::filesystem::remove_all(directory);
+}
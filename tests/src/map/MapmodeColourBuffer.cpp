@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <utility>
+
+#include "openvic-simulation/map/MapInstance.hpp"
+#include "openvic-simulation/map/Mapmode.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include "scripts/TestGame.hpp"
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+using namespace OpenVic::testing;
+
+using enum Mapmode::inputs_t;
+
+namespace {
+	struct test_mapmodes_t {
+		MapmodeManager mapmode_manager;
+		Mapmode const* definitions_only;
+		Mapmode const* selection;
+		Mapmode const* gamestate;
+		Mapmode const* all_inputs;
+
+		test_mapmodes_t() {
+			for (auto const& [identifier, inputs] : {
+				std::pair { "test_definitions_only", DEFINITIONS_ONLY },
+				std::pair { "test_selection", SELECTION },
+				std::pair { "test_gamestate", GAMESTATE },
+				std::pair { "test_all_inputs", ALL_INPUTS }
+			}) {
+				mapmode_manager.add_mapmode(
+					identifier,
+					[](
+						MapInstance const&, ProvinceInstance const&, CountryInstance const*, ProvinceInstance const*
+					) -> Mapmode::base_stripe_t {
+						return colour_argb_t::null();
+					},
+					{}, true, inputs
+				);
+			}
+			definitions_only = mapmode_manager.get_mapmode_by_identifier("test_definitions_only");
+			selection = mapmode_manager.get_mapmode_by_identifier("test_selection");
+			gamestate = mapmode_manager.get_mapmode_by_identifier("test_gamestate");
+			all_inputs = mapmode_manager.get_mapmode_by_identifier("test_all_inputs");
+		}
+	};
+
+	void update_gamestate(test_game_t& game) {
+		game.instance_manager->get_map_instance().update_gamestate(
+			game.instance_manager->get_today(), game.definition_manager.get_define_manager()
+		);
+	}
+}
+
+TEST_CASE("MapmodeColourBuffer Definitions only", "[MapmodeColourBuffer][MapmodeColourBuffer-inputs]") {
+	test_game_t game;
+	test_mapmodes_t mapmodes;
+	MapInstance const& map_instance = game.instance_manager->get_map_instance();
+	CountryInstance const* england = &game.get_country("ENG");
+	CountryInstance const* france = &game.get_country("FRA");
+
+	MapmodeColourBuffer buffer;
+	CHECK(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.definitions_only, england, nullptr));
+	CHECK(buffer.get_colours().size() == map_instance.get_map_definition().get_province_definition_count() + 1);
+
+	// Neither selection nor gamestate changes recolour it.
+	CHECK_FALSE(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.definitions_only, england, nullptr));
+	CHECK_FALSE(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.definitions_only, france, nullptr));
+	update_gamestate(game);
+	CHECK_FALSE(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.definitions_only, france, nullptr));
+
+	// Switching mapmode or invalidating the buffer always does.
+	CHECK(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.gamestate, france, nullptr));
+	CHECK(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.definitions_only, france, nullptr));
+	buffer.invalidate();
+	CHECK(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.definitions_only, france, nullptr));
+}
+
+TEST_CASE("MapmodeColourBuffer Selection", "[MapmodeColourBuffer][MapmodeColourBuffer-inputs]") {
+	test_game_t game;
+	test_mapmodes_t mapmodes;
+	MapInstance const& map_instance = game.instance_manager->get_map_instance();
+	CountryInstance const* england = &game.get_country("ENG");
+	CountryInstance const* france = &game.get_country("FRA");
+
+	MapmodeColourBuffer buffer;
+	CHECK(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.selection, england, nullptr));
+	CHECK_FALSE(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.selection, england, nullptr));
+
+	// Gamestate changes are ignored, but not a change of player country.
+	update_gamestate(game);
+	CHECK_FALSE(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.selection, england, nullptr));
+	CHECK(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.selection, france, nullptr));
+	CHECK(buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.selection, nullptr, nullptr));
+}
+
+TEST_CASE("MapmodeColourBuffer Gamestate", "[MapmodeColourBuffer][MapmodeColourBuffer-inputs]") {
+	test_game_t game;
+	test_mapmodes_t mapmodes;
+	MapInstance const& map_instance = game.instance_manager->get_map_instance();
+	CountryInstance const* england = &game.get_country("ENG");
+	CountryInstance const* france = &game.get_country("FRA");
+
+	MapmodeColourBuffer gamestate_buffer, all_inputs_buffer;
+	CHECK(gamestate_buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.gamestate, england, nullptr));
+	CHECK(all_inputs_buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.all_inputs, england, nullptr));
+
+	// Selection changes are ignored unless the mapmode also depends on the selection.
+	CHECK_FALSE(gamestate_buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.gamestate, france, nullptr));
+	CHECK(all_inputs_buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.all_inputs, france, nullptr));
+
+	// Every gamestate update makes them stale, once.
+	const uint32_t revision = map_instance.get_gamestate_revision();
+	update_gamestate(game);
+	CHECK(map_instance.get_gamestate_revision() != revision);
+	CHECK(gamestate_buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.gamestate, france, nullptr));
+	CHECK(all_inputs_buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.all_inputs, france, nullptr));
+	CHECK_FALSE(gamestate_buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.gamestate, france, nullptr));
+	CHECK_FALSE(all_inputs_buffer.update(mapmodes.mapmode_manager, map_instance, mapmodes.all_inputs, france, nullptr));
+}
@@ -0,0 +1,175 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "openvic-simulation/misc/EventScheduler.hpp"
+#include "openvic-simulation/modifier/Modifier.hpp"
+#include "openvic-simulation/types/Date.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include "scripts/TestGame.hpp"
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+using namespace OpenVic::testing;
+
+TEST_CASE("EventScheduler Interval probability", "[EventScheduler][EventScheduler-probability]") {
+	CHECK(EventScheduler::get_interval_probability(fixed_point_t::_0_50()) == fixed_point_t::_1());
+	CHECK(EventScheduler::get_interval_probability(fixed_point_t::_1()) == fixed_point_t::_1());
+
+	// Within one unit of the exact value, including typical mean times to happen and ones beyond 65536 days, where
+	// 1 / mean_time_to_happen is 0 with fixed_point_t's precision.
+	fixed_point_t previous_probability = fixed_point_t::_1();
+	for (const int32_t mean_time_to_happen : { 20, 100, 365, 1000, 3600, 36500, 73000, 100000 }) {
+		const fixed_point_t probability = EventScheduler::get_interval_probability(mean_time_to_happen);
+		const double expected = 1.0 - std::pow(1.0 - 1.0 / mean_time_to_happen, EventScheduler::CHECK_INTERVAL);
+
+		CHECK(std::abs(probability.to_double() - expected) <= fixed_point_t::epsilon().to_double());
+		CHECK(probability < previous_probability);
+		CHECK(probability > fixed_point_t::_0());
+		previous_probability = probability;
+	}
+
+	// About 0.00554, or 363 units, where truncating 1 / 3600 to 18 units alone would give 359.
+	CHECK(EventScheduler::get_interval_probability(3600) == fixed_point_t::parse_raw(363));
+
+	// Too small to represent, but still not 0 so the event can fire.
+	CHECK(EventScheduler::get_interval_probability(1000000000) == fixed_point_t::epsilon());
+}
+
+TEST_CASE("EventScheduler Event rolls", "[EventScheduler][EventScheduler-roll]") {
+	static constexpr size_t EVENT_COUNT = 100, SCOPE_COUNT = 100;
+	static constexpr Timespan::day_t DAY = 1000;
+
+	size_t below_quarter = 0, changed_next_day = 0;
+	double roll_sum = 0.0;
+
+	for (size_t event_index = 0; event_index < EVENT_COUNT; ++event_index) {
+		for (size_t scope_index = 0; scope_index < SCOPE_COUNT; ++scope_index) {
+			const fixed_point_t roll = EventScheduler::get_event_roll(event_index, scope_index, DAY);
+
+			CHECK(roll >= fixed_point_t::_0());
+			CHECK(roll < fixed_point_t::_1());
+			// Rolls only depend on their inputs.
+			CHECK(roll == EventScheduler::get_event_roll(event_index, scope_index, DAY));
+
+			below_quarter += roll < fixed_point_t::_0_25();
+			changed_next_day += roll != EventScheduler::get_event_roll(event_index, scope_index, DAY + 1);
+			roll_sum += roll.to_double();
+		}
+	}
+
+	static constexpr double ROLL_COUNT = EVENT_COUNT * SCOPE_COUNT;
+	CHECK(std::abs(below_quarter / ROLL_COUNT - 0.25) < 0.02);
+	CHECK(std::abs(roll_sum / ROLL_COUNT - 0.5) < 0.02);
+	CHECK(changed_next_day > ROLL_COUNT * 0.99);
+}
+
+TEST_CASE("EventScheduler Staggered checks", "[EventScheduler][EventScheduler-stagger]") {
+	static constexpr size_t SCOPE_COUNT = 50, INTERVAL_COUNT = 3;
+
+	std::vector<size_t> check_counts(SCOPE_COUNT);
+	Date today { 1836, 1, 1 };
+	size_t previous_first_scope = EventScheduler::get_first_checked_scope(today);
+
+	for (size_t day = 0; day < EventScheduler::CHECK_INTERVAL * INTERVAL_COUNT; ++day) {
+		++today;
+		const size_t first_scope = EventScheduler::get_first_checked_scope(today);
+		CHECK(first_scope < EventScheduler::CHECK_INTERVAL);
+		// Consecutive days check consecutive scopes.
+		CHECK(first_scope == (previous_first_scope + 1) % EventScheduler::CHECK_INTERVAL);
+		previous_first_scope = first_scope;
+
+		for (size_t scope = first_scope; scope < SCOPE_COUNT; scope += EventScheduler::CHECK_INTERVAL) {
+			check_counts[scope]++;
+		}
+	}
+
+	// Every scope is checked exactly once per interval.
+	for (const size_t check_count : check_counts) {
+		CHECK(check_count == INTERVAL_COUNT);
+	}
+}
+
+TEST_CASE("EventScheduler Prerequisites", "[EventScheduler][EventScheduler-prerequisites]") {
+	test_game_t game;
+	ModifierManager& modifier_manager = game.definition_manager.get_modifier_manager();
+	modifier_manager.add_event_modifier("test_modifier", {}, 0);
+	Modifier const* modifier = modifier_manager.get_event_modifier_by_identifier("test_modifier");
+	CountryDefinition const* france = game.get_country("FRA").get_country_definition();
+
+	const EventScheduler::prerequisites_t all = EventScheduler::get_prerequisites(
+		game.parse_condition(
+			"tag = FRA has_country_flag = f has_country_modifier = test_modifier year = 1850 has_global_flag = g"
+		).get_condition_root(),
+		true
+	);
+	CHECK(all.tag == france);
+	CHECK(all.modifier == modifier);
+	CHECK(all.flag == "f");
+	CHECK(all.min_year == 1850);
+	REQUIRE(all.global_flags.size() == 1);
+	CHECK(all.global_flags[0] == "g");
+
+	// Nested ANDs are searched, but not ORs or NOTs as their children needn't hold.
+	const EventScheduler::prerequisites_t nested = EventScheduler::get_prerequisites(
+		game.parse_condition(
+			"AND = { has_country_flag = f } OR = { tag = FRA always = no } NOT = { has_global_flag = g }"
+		).get_condition_root(),
+		true
+	);
+	CHECK(nested.flag == "f");
+	CHECK(nested.tag == nullptr);
+	CHECK(nested.global_flags.empty());
+
+	// Province events take their flag from province conditions, and the owner scope's conditions aren't ANDed in.
+	const EventScheduler::prerequisites_t province = EventScheduler::get_prerequisites(
+		game.parse_condition(
+			"has_province_flag = p owner = { has_country_flag = f }", scope_type_t::PROVINCE
+		).get_condition_root(),
+		false
+	);
+	CHECK(province.flag == "p");
+	CHECK(province.tag == nullptr);
+}
+
+TEST_CASE("EventScheduler Prerequisite index", "[EventScheduler][EventScheduler-prerequisites]") {
+	test_game_t game;
+	ModifierManager& modifier_manager = game.definition_manager.get_modifier_manager();
+	modifier_manager.add_event_modifier("test_modifier", {}, 0);
+	Modifier const& modifier = *modifier_manager.get_event_modifier_by_identifier("test_modifier");
+	CountryInstance& england = game.get_country("ENG");
+	CountryInstance& france = game.get_country("FRA");
+
+	EventScheduler::event_index_t event_index;
+	event_index.add_event({}, 0);
+	event_index.add_event({ .tag = france.get_country_definition() }, 1);
+	event_index.add_event({ .flag = "f" }, 2);
+	event_index.add_event({ .modifier = &modifier }, 3);
+	// Only listed under its tag, as that is the most selective.
+	event_index.add_event({ .tag = england.get_country_definition(), .flag = "f" }, 4);
+
+	std::vector<size_t> candidates;
+	event_index.get_candidates(england.get_country_definition(), england, {}, candidates);
+	CHECK(candidates == std::vector<size_t> { 0, 4 });
+
+	england.set_flag("f", false);
+	event_index.get_candidates(england.get_country_definition(), england, {}, candidates);
+	CHECK(candidates == std::vector<size_t> { 0, 2, 4 });
+
+	// Modifiers applied more than once only make their events candidates once.
+	const std::vector<ModifierInstance> event_modifiers { { modifier, {} }, { modifier, {} } };
+	event_index.get_candidates(france.get_country_definition(), france, event_modifiers, candidates);
+	CHECK(candidates == std::vector<size_t> { 0, 1, 3 });
+
+	// Province scopes have no tag.
+	event_index.get_candidates(nullptr, england, {}, candidates);
+	CHECK(candidates == std::vector<size_t> { 0, 2 });
+
+	event_index.clear();
+	event_index.get_candidates(england.get_country_definition(), england, event_modifiers, candidates);
+	CHECK(candidates.empty());
+}
@@ -0,0 +1,222 @@
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "openvic-simulation/modifier/ModifierManager.hpp"
+#include "openvic-simulation/modifier/TriggeredModifierCache.hpp"
+#include "openvic-simulation/scripts/ConditionBytecode.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include "scripts/TestGame.hpp"
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+using namespace OpenVic::testing;
+
+using enum ConditionBytecode::opcode_t;
+using dependency_t = TriggeredModifierCache::dependency_t;
+
+namespace {
+	uint64_t get_count(ConditionBytecode::profile_t const& profile, ConditionBytecode::opcode_t opcode) {
+		return profile[static_cast<size_t>(opcode)];
+	}
+
+	// Adds a triggered modifier to the game's definitions for each trigger, in order, and sets up cache with them.
+	void setup_cache(
+		test_game_t& game, TriggeredModifierCache& cache, std::initializer_list<std::string_view> triggers
+	) {
+		ModifierManager& modifier_manager = game.definition_manager.get_modifier_manager();
+		for (const std::string_view trigger : triggers) {
+			const std::string identifier = "test_triggered_modifier_" + std::to_string(
+				modifier_manager.get_triggered_modifier_count()
+			);
+			modifier_manager.add_triggered_modifier(identifier, {}, 0, game.parse_condition(trigger));
+		}
+		cache.setup(modifier_manager.get_triggered_modifiers());
+	}
+}
+
+TEST_CASE("TriggeredModifierCache Dependencies", "[TriggeredModifierCache][TriggeredModifierCache-setup]") {
+	test_game_t game;
+	TriggeredModifierCache cache;
+	setup_cache(game, cache, {
+		"has_country_flag = a",
+		"has_global_flag = a",
+		"literacy = 0.5 OR = { literacy = 0.25 literacy = 0.5 }",
+		"year = 1836",
+		"tag = ENG"
+	});
+
+	REQUIRE(cache.get_trigger_count() == 5);
+	CHECK(cache.get_dependencies(0) == dependency_t::COUNTRY_FLAGS);
+	CHECK(cache.get_dependencies(1) == dependency_t::GLOBAL_FLAGS);
+	CHECK(cache.get_dependencies(2) == dependency_t::LITERACY);
+	CHECK(cache.get_dependencies(3) == dependency_t::VOLATILE);
+	CHECK(cache.get_dependencies(4) == dependency_t::NO_DEPENDENCIES);
+
+	// Thresholds are sorted and deduplicated.
+	CHECK(
+		std::vector<fixed_point_t>(cache.get_literacy_thresholds(2).begin(), cache.get_literacy_thresholds(2).end()) ==
+		std::vector<fixed_point_t> { fixed_point_t::_0_25(), fixed_point_t::_0_50() }
+	);
+	CHECK(cache.get_literacy_thresholds(0).empty());
+}
+
+TEST_CASE("TriggeredModifierCache Revisions", "[TriggeredModifierCache][TriggeredModifierCache-update]") {
+	test_game_t game;
+	TriggeredModifierCache cache;
+	setup_cache(game, cache, { "has_country_flag = a", "has_global_flag = a", "literacy = 0.5", "tag = ENG" });
+
+	CountryInstance& england = game.get_country("ENG");
+	TriggeredModifierCache::country_state_t state;
+	std::vector<size_t> changed;
+	ConditionBytecode::profile_t profile {};
+
+	// Every trigger is evaluated on the first update.
+	cache.update_country(*game.instance_manager, england, state, changed, &profile);
+	CHECK(changed == std::vector<size_t> { 3 });
+	CHECK(get_count(profile, HAS_COUNTRY_FLAG) == 1);
+	CHECK(get_count(profile, HAS_GLOBAL_FLAG) == 1);
+	CHECK(get_count(profile, LITERACY) == 1);
+	CHECK(get_count(profile, TAG) == 1);
+	CHECK(state.is_active(3));
+	CHECK_FALSE(state.is_active(0));
+
+	// Nothing is re-evaluated while the inputs are unchanged.
+	changed.clear();
+	profile = {};
+	cache.update_country(*game.instance_manager, england, state, changed, &profile);
+	CHECK(changed.empty());
+	CHECK(profile == ConditionBytecode::profile_t {});
+
+	// Only the triggers depending on a changed revision are re-evaluated.
+	england.set_flag("a", false);
+	profile = {};
+	cache.update_country(*game.instance_manager, england, state, changed, &profile);
+	CHECK(changed == std::vector<size_t> { 0 });
+	CHECK(state.is_active(0));
+	CHECK(get_count(profile, HAS_COUNTRY_FLAG) == 1);
+	CHECK(get_count(profile, HAS_GLOBAL_FLAG) == 0);
+	CHECK(get_count(profile, TAG) == 0);
+
+	// Any change to the flags bumps the revision, even if the trigger's result stays the same.
+	changed.clear();
+	england.set_flag("b", false);
+	profile = {};
+	cache.update_country(*game.instance_manager, england, state, changed, &profile);
+	CHECK(changed.empty());
+	CHECK(get_count(profile, HAS_COUNTRY_FLAG) == 1);
+
+	game.instance_manager->get_global_flags().set_flag("a", false);
+	profile = {};
+	cache.update_country(*game.instance_manager, england, state, changed, &profile);
+	CHECK(changed == std::vector<size_t> { 1 });
+	CHECK(get_count(profile, HAS_GLOBAL_FLAG) == 1);
+	CHECK(get_count(profile, HAS_COUNTRY_FLAG) == 0);
+
+	// Deactivated triggers are reported as changed too.
+	changed.clear();
+	england.clear_flag("a", false);
+	cache.update_country(*game.instance_manager, england, state, changed);
+	CHECK(changed == std::vector<size_t> { 0 });
+	CHECK_FALSE(state.is_active(0));
+
+	// Each country has its own state.
+	TriggeredModifierCache::country_state_t france_state;
+	changed.clear();
+	cache.update_country(*game.instance_manager, game.get_country("FRA"), france_state, changed);
+	CHECK(changed == std::vector<size_t> { 1 });
+}
+
+TEST_CASE("TriggeredModifierCache Volatile triggers", "[TriggeredModifierCache][TriggeredModifierCache-update]") {
+	test_game_t game;
+	TriggeredModifierCache cache;
+	// year reads the date, which isn't tracked, and so is re-evaluated on every update.
+	setup_cache(game, cache, { "year = 0", "has_country_flag = a year = 0" });
+	REQUIRE(cache.get_dependencies(0) == dependency_t::VOLATILE);
+	REQUIRE(cache.get_dependencies(1) == (dependency_t::COUNTRY_FLAGS | dependency_t::VOLATILE));
+
+	CountryInstance const& england = game.get_country("ENG");
+	TriggeredModifierCache::country_state_t state;
+	std::vector<size_t> changed;
+
+	cache.update_country(*game.instance_manager, england, state, changed);
+	CHECK(changed == std::vector<size_t> { 0 });
+
+	for (size_t update = 0; update < 3; ++update) {
+		ConditionBytecode::profile_t profile {};
+		changed.clear();
+		cache.update_country(*game.instance_manager, england, state, changed, &profile);
+		CHECK(changed.empty());
+		CHECK(get_count(profile, YEAR) == 1);
+		CHECK(get_count(profile, HAS_COUNTRY_FLAG) == 1);
+	}
+}
+
+TEST_CASE("TriggeredModifierCache Literacy thresholds", "[TriggeredModifierCache][TriggeredModifierCache-literacy]") {
+	const std::vector<fixed_point_t> thresholds { fixed_point_t::_0_25(), fixed_point_t::_0_50() };
+	const auto is_crossed = [&thresholds](fixed_point_t old_literacy, fixed_point_t new_literacy) -> bool {
+		return TriggeredModifierCache::is_literacy_threshold_crossed(thresholds, old_literacy, new_literacy);
+	};
+
+	// A literacy >= threshold leaf changes when literacy reaches the threshold from below, or drops below it.
+	CHECK(is_crossed(fixed_point_t::_0(), fixed_point_t::_0_25()));
+	CHECK(is_crossed(fixed_point_t::_0_25(), fixed_point_t::_0_20()));
+	CHECK(is_crossed(fixed_point_t::_0_20(), fixed_point_t::_1()));
+	CHECK(is_crossed(fixed_point_t::_1(), fixed_point_t::_0_25() + fixed_point_t::_0_10()));
+
+	// Staying on one side of every threshold, including moving away from one it equals, changes nothing.
+	CHECK_FALSE(is_crossed(fixed_point_t::_0(), fixed_point_t::_0_20()));
+	CHECK_FALSE(is_crossed(fixed_point_t::_0_25(), fixed_point_t::_0_25() + fixed_point_t::_0_10()));
+	CHECK_FALSE(is_crossed(fixed_point_t::_0_50(), fixed_point_t::_1()));
+	CHECK_FALSE(is_crossed(fixed_point_t::_0_50(), fixed_point_t::_0_50()));
+	CHECK_FALSE(TriggeredModifierCache::is_literacy_threshold_crossed({}, fixed_point_t::_0(), fixed_point_t::_1()));
+
+	test_game_t game;
+	TriggeredModifierCache cache;
+	setup_cache(game, cache, { "literacy = 0" });
+	CountryInstance const& england = game.get_country("ENG");
+	TriggeredModifierCache::country_state_t state;
+	std::vector<size_t> changed;
+
+	// Literacy 0 meets a threshold of 0, and with literacy unchanged the leaf isn't re-evaluated.
+	cache.update_country(*game.instance_manager, england, state, changed);
+	CHECK(changed == std::vector<size_t> { 0 });
+	ConditionBytecode::profile_t profile {};
+	cache.update_country(*game.instance_manager, england, state, changed, &profile);
+	CHECK(get_count(profile, LITERACY) == 0);
+}
+
+TEST_CASE("TriggeredModifierCache Unsupported triggers", "[TriggeredModifierCache][TriggeredModifierCache-update]") {
+	test_game_t game;
+	TriggeredModifierCache cache;
+	// ai is a valid condition without an implementation, which would make a negated trigger hold if it were evaluated.
+	setup_cache(game, cache, { "NOT = { ai = yes }", "OR = { ai = yes always = yes }", "always = yes" });
+	CHECK_FALSE(cache.is_supported(0));
+	CHECK_FALSE(cache.is_supported(1));
+	CHECK(cache.is_supported(2));
+
+	CountryInstance& england = game.get_country("ENG");
+	TriggeredModifierCache::country_state_t state;
+	std::vector<size_t> changed;
+	ConditionBytecode::profile_t profile {};
+
+	// Unsupported triggers are never evaluated, not even on the first update, so they are never active.
+	cache.update_country(*game.instance_manager, england, state, changed, &profile);
+	CHECK(changed == std::vector<size_t> { 2 });
+	CHECK(get_count(profile, UNSUPPORTED) == 0);
+	CHECK_FALSE(state.is_active(0));
+	CHECK_FALSE(state.is_active(1));
+
+	england.set_flag("a", false);
+	game.instance_manager->get_global_flags().set_flag("a", false);
+	changed.clear();
+	cache.update_country(*game.instance_manager, england, state, changed);
+	CHECK(changed.empty());
+	CHECK_FALSE(state.is_active(0));
+}
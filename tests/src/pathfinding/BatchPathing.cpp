@@ -0,0 +1,144 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "openvic-simulation/pathfinding/BatchPathing.hpp"
+#include "openvic-simulation/pathfinding/FlatAStarPathing.hpp"
+#include "openvic-simulation/pathfinding/PointMap.hpp"
+#include "openvic-simulation/types/Vector.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	using point_id_t = PointMap::points_key_type;
+
+	// Grid with randomly missing links and some disabled points.
+	struct RandomGrid final : public PointMap {
+		static constexpr point_id_t WIDTH = 30, HEIGHT = 20;
+
+		RandomGrid(uint32_t seed) : PointMap() {
+			std::mt19937 rand { seed };
+
+			for (point_id_t y = 0; y < HEIGHT; ++y) {
+				for (point_id_t x = 0; x < WIDTH; ++x) {
+					add_point(y * WIDTH + x, ivec2_t(x * 10 + rand() % 5, y * 10 + rand() % 5));
+				}
+			}
+			for (point_id_t y = 0; y < HEIGHT; ++y) {
+				for (point_id_t x = 0; x < WIDTH; ++x) {
+					const point_id_t id = y * WIDTH + x;
+					if (x + 1 < WIDTH && rand() % 4 != 0) {
+						connect_points(id, id + 1);
+					}
+					if (y + 1 < HEIGHT && rand() % 4 != 0) {
+						connect_points(id, id + WIDTH);
+					}
+					if (rand() % 20 == 0) {
+						set_point_disabled(id);
+					}
+				}
+			}
+		}
+	};
+}
+
+TEST_CASE("BatchPathing Find paths", "[batch-pathing][batch-pathing-find-paths]") {
+	RandomGrid grid { 1 };
+	FlatAStarPathing<> single { grid };
+	BatchPathing<> batch { grid };
+
+	std::mt19937 rand { 2 };
+	std::vector<BatchPathing<>::path_query_t> queries;
+	for (size_t query = 0; query < 2000; ++query) {
+		queries.push_back({ rand() % grid.get_point_count(), rand() % grid.get_point_count() });
+	}
+
+	for (const bool allow_partial_path : { false, true }) {
+		for (const size_t worker_count : { 1, 4 }) {
+			ThreadPool::get_instance().set_worker_count(worker_count);
+
+			BatchPathing<>::path_batch_t result;
+			batch.find_paths(queries, result, allow_partial_path);
+			CHECK_OR_CONTINUE(result.get_query_count() == queries.size());
+
+			size_t wrong_paths = 0, found_paths = 0;
+			for (size_t query = 0; query < queries.size(); ++query) {
+				const std::vector<point_id_t> expected =
+					single.get_id_path(queries[query].from, queries[query].to, allow_partial_path);
+				const std::span<const point_id_t> path = result.get_path(query);
+				if (!std::equal(path.begin(), path.end(), expected.begin(), expected.end())) {
+					wrong_paths++;
+				}
+				if (!path.empty()) {
+					found_paths++;
+				} else if (result.costs[query] != BatchPathing<>::NO_PATH_COST) {
+					wrong_paths++;
+				}
+			}
+			CHECK(wrong_paths == 0);
+			CHECK(found_paths > 0);
+		}
+	}
+
+	ThreadPool::get_instance().set_worker_count(0);
+}
+
+TEST_CASE("BatchPathing Find reachable", "[batch-pathing][batch-pathing-find-reachable]") {
+	RandomGrid grid { 3 };
+	BatchPathing<> batch { grid };
+
+	std::vector<BatchPathing<>::reachable_query_t> queries;
+	for (point_id_t from = 0; from < grid.get_point_count(); from += 7) {
+		queries.push_back({ from, 25 + static_cast<int32_t>(from % 50) });
+	}
+
+	BatchPathing<>::path_batch_t all_paths;
+	std::vector<BatchPathing<>::path_query_t> path_queries;
+
+	for (const size_t worker_count : { 1, 4 }) {
+		ThreadPool::get_instance().set_worker_count(worker_count);
+
+		BatchPathing<>::reachable_batch_t result;
+		batch.find_reachable(queries, result);
+		CHECK_OR_CONTINUE(result.get_query_count() == queries.size());
+
+		for (size_t query = 0; query < queries.size(); ++query) {
+			const std::span<const point_id_t> point_ids = result.get_point_ids(query);
+			const std::span<const fixed_point_t> costs = result.get_costs(query);
+			CAPTURE(query);
+			CHECK_OR_CONTINUE(!point_ids.empty());
+			CHECK(point_ids.front() == queries[query].from);
+			CHECK(costs.front() == 0);
+			CHECK(std::is_sorted(costs.begin(), costs.end()));
+			CHECK(costs.back() <= queries[query].max_cost);
+
+			// Every enabled point is either reported at its shortest path cost, or is further than max_cost.
+			path_queries.clear();
+			for (point_id_t to = 0; to < grid.get_point_count(); ++to) {
+				path_queries.push_back({ queries[query].from, to });
+			}
+			batch.find_paths(path_queries, all_paths);
+
+			size_t wrong_points = 0;
+			for (point_id_t to = 0; to < grid.get_point_count(); ++to) {
+				const auto it = std::find(point_ids.begin(), point_ids.end(), to);
+				const bool reachable = to == queries[query].from ||
+					(grid.is_point_disabled(to) == false && all_paths.costs[to] <= queries[query].max_cost);
+				if (reachable != (it != point_ids.end())) {
+					wrong_points++;
+				} else if (reachable && costs[it - point_ids.begin()] != all_paths.costs[to]) {
+					wrong_points++;
+				}
+			}
+			CHECK(wrong_points == 0);
+		}
+	}
+
+	ThreadPool::get_instance().set_worker_count(0);
+}
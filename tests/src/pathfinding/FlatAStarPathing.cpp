@@ -0,0 +1,71 @@
+#include "openvic-simulation/pathfinding/FlatAStarPathing.hpp"
+
+#include "openvic-simulation/pathfinding/PointMap.hpp"
+#include "openvic-simulation/types/Vector.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#include "Helper.hpp"
+#include "pathfinding/Pathing.hpp"
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	enum { A, B, C, D };
+
+	// Disable heuristic completely.
+	struct ABCCostPolicy {
+		static fixed_point_t estimate_cost(ivec2_t const& from, ivec2_t const& to) {
+			return 0;
+		}
+
+		static fixed_point_t compute_cost(ivec2_t const& from, ivec2_t const& to) {
+			if (from == ivec2_t(0, 0) && to == ivec2_t(0, 1)) {
+				return 1000;
+			}
+			return 100;
+		}
+	};
+
+	struct ABC final : public PointMap {
+		ABC() : PointMap() {
+			add_point(A, ivec2_t(0, 0));
+			add_point(B, ivec2_t(1, 0));
+			add_point(C, ivec2_t(0, 1));
+			add_point(D, ivec2_t(1, 1));
+			connect_points(A, B);
+			connect_points(A, C);
+			connect_points(B, C);
+			connect_points(D, A);
+		}
+	};
+}
+
+TEST_CASE("FlatAStarPathing ABC path", "[flat-astar-pathing][flat-astar-pathing-abc-path]") {
+	ABC abc;
+	FlatAStarPathing<ABCCostPolicy> pathing { abc };
+	std::vector<PointMap::points_key_type> path = pathing.get_id_path(A, C);
+	CHECK_IF(path.size() == 3) {
+		CHECK(path[0] == A);
+		CHECK(path[1] == B);
+		CHECK(path[2] == C);
+	}
+}
+
+TEST_CASE("FlatAStarPathing Partial path", "[flat-astar-pathing][flat-astar-pathing-partial-path]") {
+	ABC abc;
+	abc.set_point_disabled(C);
+	FlatAStarPathing<> pathing { abc };
+	CHECK(pathing.get_id_path(A, C).empty());
+
+	std::vector<PointMap::points_key_type> path = pathing.get_id_path(B, C, true);
+	CHECK_IF(path.size() == 2) {
+		CHECK(path[0] == B);
+		CHECK(path[1] == A);
+	}
+}
+
+TEST_CASE("FlatAStarPathing Stress Find paths", "[flat-astar-pathing][flat-astar-pathing-stress-find-paths]") {
+	OpenVic::testing::_stress_test<OpenVic::FlatAStarPathing<>>();
+}
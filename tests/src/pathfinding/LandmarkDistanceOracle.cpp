@@ -0,0 +1,181 @@
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "openvic-simulation/pathfinding/FlatAStarPathing.hpp"
+#include "openvic-simulation/pathfinding/LandmarkDistanceOracle.hpp"
+#include "openvic-simulation/pathfinding/PointMap.hpp"
+#include "openvic-simulation/types/Vector.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	using node_t = LandmarkDistanceOracle::node_t;
+	using edge_t = LandmarkDistanceOracle::edge_t;
+
+	// Jittered grid with randomly missing links, giving an irregular graph with a few disconnected islands.
+	struct random_graph_t {
+		std::vector<ivec2_t> positions;
+		std::vector<std::vector<edge_t>> adjacency;
+
+		random_graph_t(int32_t width, int32_t height, uint32_t seed, uint32_t tag_count = 0) {
+			std::mt19937 rand { seed };
+
+			for (int32_t y = 0; y < height; ++y) {
+				for (int32_t x = 0; x < width; ++x) {
+					positions.emplace_back(x * 10 + static_cast<int32_t>(rand() % 7), y * 10 + static_cast<int32_t>(rand() % 7));
+				}
+			}
+			adjacency.resize(positions.size());
+
+			const auto link = [this, &rand, tag_count](node_t a, node_t b) -> void {
+				const fixed_point_t distance = fixed_point_t { positions[a].distance_squared(positions[b]) }.sqrt();
+				const LandmarkDistanceOracle::tag_t tag = tag_count > 0 && rand() % 8 == 0 ? 1 + rand() % tag_count : 0;
+				adjacency[a].push_back({ b, distance, tag });
+				adjacency[b].push_back({ a, distance, tag });
+			};
+
+			for (int32_t y = 0; y < height; ++y) {
+				for (int32_t x = 0; x < width; ++x) {
+					const node_t node = y * width + x;
+					if (x + 1 < width && rand() % 5 != 0) {
+						link(node, node + 1);
+					}
+					if (y + 1 < height && rand() % 5 != 0) {
+						link(node, node + width);
+					}
+					if (x + 1 < width && y + 1 < height && rand() % 4 == 0) {
+						link(node, node + width + 1);
+					}
+				}
+			}
+		}
+
+		bool build(LandmarkDistanceOracle& oracle, size_t landmark_count) const {
+			std::vector<node_t> edge_offsets;
+			std::vector<edge_t> edges;
+			for (std::vector<edge_t> const& node_edges : adjacency) {
+				edge_offsets.push_back(edges.size());
+				edges.insert(edges.end(), node_edges.begin(), node_edges.end());
+			}
+			edge_offsets.push_back(edges.size());
+			return oracle.build(std::move(edge_offsets), std::move(edges), landmark_count);
+		}
+	};
+}
+
+TEST_CASE("LandmarkDistanceOracle Matches Dijkstra", "[landmark-distance-oracle][landmark-distance-oracle-dijkstra]") {
+	const random_graph_t graph { 40, 30, 1, 3 };
+
+	LandmarkDistanceOracle oracle, dijkstra;
+	CHECK_OR_RETURN(graph.build(oracle, 8));
+	CHECK_OR_RETURN(graph.build(dijkstra, 0));
+	CHECK(oracle.get_landmarks().size() > 0);
+	CHECK(dijkstra.get_landmarks().empty());
+
+	LandmarkDistanceOracle::blocked_tags_t blocked_tags;
+	blocked_tags.set(2);
+
+	LandmarkDistanceOracle::search_state_t oracle_state, dijkstra_state;
+	std::vector<node_t> path;
+	std::mt19937 rand { 2 };
+
+	for (size_t query = 0; query < 500; ++query) {
+		const node_t from = rand() % oracle.get_node_count();
+		const node_t to = rand() % oracle.get_node_count();
+		CAPTURE(from);
+		CAPTURE(to);
+
+		const fixed_point_t expected = dijkstra.get_distance(from, to, dijkstra_state);
+		CHECK(oracle.get_distance(from, to, oracle_state) == expected);
+		CHECK(oracle.get_lower_bound(from, to) <= expected);
+		CHECK(oracle.is_reachable(from, to) == (expected != LandmarkDistanceOracle::NO_PATH));
+
+		CHECK(
+			oracle.get_distance(from, to, oracle_state, &blocked_tags) ==
+			dijkstra.get_distance(from, to, dijkstra_state, &blocked_tags)
+		);
+
+		const fixed_point_t path_distance = oracle.get_path(from, to, oracle_state, path);
+		CHECK(path_distance == expected);
+		if (expected != LandmarkDistanceOracle::NO_PATH) {
+			CHECK_OR_CONTINUE(!path.empty());
+			CHECK(path.front() == from);
+			CHECK(path.back() == to);
+		} else {
+			CHECK(path.empty());
+		}
+	}
+}
+
+TEST_CASE("LandmarkDistanceOracle Benchmark", "[.][landmark-distance-oracle][landmark-distance-oracle-benchmark]") {
+	using clock_t = std::chrono::steady_clock;
+	static constexpr size_t QUERY_COUNT = 10000;
+
+	// About the size of the province map.
+	const random_graph_t graph { 60, 50, 3 };
+
+	const clock_t::time_point build_start = clock_t::now();
+	LandmarkDistanceOracle oracle;
+	CHECK_OR_RETURN(graph.build(oracle, LandmarkDistanceOracle::DEFAULT_LANDMARK_COUNT));
+	const clock_t::duration build_time = clock_t::now() - build_start;
+
+	PointMap point_map;
+	for (node_t node = 0; node < graph.positions.size(); ++node) {
+		point_map.add_point(node, graph.positions[node]);
+	}
+	for (node_t node = 0; node < graph.adjacency.size(); ++node) {
+		for (edge_t const& edge : graph.adjacency[node]) {
+			point_map.connect_points(node, edge.to, false);
+		}
+	}
+	FlatAStarPathing<> astar { point_map };
+
+	std::mt19937 rand { 4 };
+	std::vector<std::pair<node_t, node_t>> queries;
+	for (size_t query = 0; query < QUERY_COUNT; ++query) {
+		queries.emplace_back(rand() % oracle.get_node_count(), rand() % oracle.get_node_count());
+	}
+
+	LandmarkDistanceOracle::search_state_t state;
+	size_t settled_node_count = 0, found_count = 0;
+	const clock_t::time_point oracle_start = clock_t::now();
+	for (auto const& [from, to] : queries) {
+		if (oracle.get_distance(from, to, state) != LandmarkDistanceOracle::NO_PATH) {
+			++found_count;
+		}
+		settled_node_count += state.get_settled_node_count();
+	}
+	const clock_t::duration oracle_time = clock_t::now() - oracle_start;
+
+	size_t astar_found_count = 0;
+	const clock_t::time_point astar_start = clock_t::now();
+	for (auto const& [from, to] : queries) {
+		if (!astar.get_id_path(from, to).empty()) {
+			++astar_found_count;
+		}
+	}
+	const clock_t::duration astar_time = clock_t::now() - astar_start;
+
+	CHECK(found_count == astar_found_count);
+
+	const auto micros_per_query = [](clock_t::duration time) -> double {
+		return std::chrono::duration<double, std::micro>(time).count() / QUERY_COUNT;
+	};
+	fmt::print(
+		"{} nodes, {} landmarks, built in {:.2f} ms\n"
+		"ALT oracle: {:.2f} us/query, {:.1f} settled nodes/query\n"
+		"Plain A*: {:.2f} us/query\n",
+		oracle.get_node_count(), oracle.get_landmarks().size(),
+		std::chrono::duration<double, std::milli>(build_time).count(), micros_per_query(oracle_time),
+		static_cast<double>(settled_node_count) / QUERY_COUNT, micros_per_query(astar_time)
+	);
+}
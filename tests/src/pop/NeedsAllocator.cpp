@@ -0,0 +1,187 @@
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "openvic-simulation/pop/NeedsAllocator.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	// One entry of a pop type's need list, with the market's prices already applied.
+	struct need_t {
+		fixed_point_t max_money_to_spend;
+		fixed_point_t price_inverse;
+	};
+
+	struct allocation_t {
+		std::vector<fixed_point_t> money_to_spend_per_need;
+		fixed_point_t price_inverse_sum;
+
+		friend bool operator==(allocation_t const&, allocation_t const&) = default;
+	};
+
+	fixed_point_t get_price_inverse_sum(std::vector<need_t> const& needs) {
+		fixed_point_t price_inverse_sum = fixed_point_t::_0();
+		for (need_t const& need : needs) {
+			price_inverse_sum += need.price_inverse;
+		}
+		return price_inverse_sum;
+	}
+
+	// How Pop::allocate_for_needs spread cash before it sorted needs, restarting over all needs whenever one saturated.
+	allocation_t restarting_allocation(std::vector<need_t> const& needs, fixed_point_t cash_left_to_spend) {
+		allocation_t result { std::vector<fixed_point_t>(needs.size()), get_price_inverse_sum(needs) };
+
+		for (size_t i = 0; i < needs.size(); i++) {
+			need_t const& need = needs[i];
+			if (result.money_to_spend_per_need[i] >= need.max_money_to_spend) {
+				continue;
+			}
+
+			const fixed_point_t cash_available_for_good = fixed_point_t::mul_div(
+				cash_left_to_spend, need.price_inverse, result.price_inverse_sum
+			);
+
+			if (cash_available_for_good >= need.max_money_to_spend) {
+				cash_left_to_spend -= need.max_money_to_spend;
+				result.money_to_spend_per_need[i] = need.max_money_to_spend;
+				result.price_inverse_sum -= need.price_inverse;
+				i = -1;
+			} else {
+				result.money_to_spend_per_need[i] = cash_available_for_good;
+			}
+		}
+
+		return result;
+	}
+
+	allocation_t sorted_allocation(
+		NeedsAllocator& needs_allocator, std::vector<need_t> const& needs, fixed_point_t cash_left_to_spend
+	) {
+		allocation_t result { std::vector<fixed_point_t>(needs.size()), get_price_inverse_sum(needs) };
+
+		needs_allocator.clear();
+		for (size_t i = 0; i < needs.size(); i++) {
+			needs_allocator.add_need(i, needs[i].max_money_to_spend, needs[i].price_inverse);
+		}
+		needs_allocator.allocate(cash_left_to_spend, result.price_inverse_sum, result.money_to_spend_per_need);
+
+		return result;
+	}
+
+	/* Needs with raw fixed point prices and quantities so rounding is exercised. A few share the same price and
+	 * quantity, giving equal saturation thresholds. */
+	std::vector<need_t> random_needs(size_t count, std::mt19937& rand) {
+		std::vector<need_t> needs;
+		for (size_t i = 0; i < count; i++) {
+			if (!needs.empty() && rand() % 8 == 0) {
+				needs.push_back(needs[rand() % needs.size()]);
+				continue;
+			}
+
+			const fixed_point_t price = fixed_point_t::parse_raw(
+				fixed_point_t::ONE / 10 + rand() % (50 * fixed_point_t::ONE)
+			);
+			const fixed_point_t quantity = fixed_point_t::parse_raw(rand() % (10 * fixed_point_t::ONE));
+			needs.push_back({ quantity * price, fixed_point_t::_1() / price });
+		}
+		return needs;
+	}
+
+	fixed_point_t get_max_money_to_spend_sum(std::vector<need_t> const& needs) {
+		fixed_point_t max_money_to_spend_sum = fixed_point_t::_0();
+		for (need_t const& need : needs) {
+			max_money_to_spend_sum += need.max_money_to_spend;
+		}
+		return max_money_to_spend_sum;
+	}
+}
+
+TEST_CASE("NeedsAllocator Matches restarting allocation", "[NeedsAllocator][NeedsAllocator-allocate]") {
+	static constexpr size_t CASES_PER_SIZE = 200;
+
+	std::mt19937 rand { 1 };
+	NeedsAllocator needs_allocator;
+
+	// Either side of MAX_RESTARTING_NEED_COUNT, so both ways of allocating are covered.
+	for (const size_t need_count : { 1, 2, 5, 8, 9, 12, 40 }) {
+		for (size_t test_case = 0; test_case < CASES_PER_SIZE; test_case++) {
+			const std::vector<need_t> needs = random_needs(need_count, rand);
+			// From far too little cash for any need to saturate up to enough for all of them.
+			const fixed_point_t cash = get_max_money_to_spend_sum(needs) * static_cast<int32_t>(rand() % 12) / 10;
+
+			CHECK(sorted_allocation(needs_allocator, needs, cash) == restarting_allocation(needs, cash));
+		}
+	}
+}
+
+TEST_CASE("NeedsAllocator Saturated needs", "[NeedsAllocator][NeedsAllocator-allocate]") {
+	NeedsAllocator needs_allocator;
+
+	// The cheap need saturates, and the cash it doesn't take goes to the other need.
+	const std::vector<need_t> needs {
+		{ fixed_point_t::_1(), fixed_point_t::_1() },
+		{ fixed_point_t { 100 }, fixed_point_t::_1() },
+		{ fixed_point_t::_0(), fixed_point_t::_1() }
+	};
+	const allocation_t allocation = sorted_allocation(needs_allocator, needs, fixed_point_t { 10 });
+
+	CHECK(allocation.money_to_spend_per_need[0] == fixed_point_t::_1());
+	CHECK(allocation.money_to_spend_per_need[2] == fixed_point_t::_0());
+	CHECK(allocation.price_inverse_sum == fixed_point_t::_2());
+	// The need with nothing to buy keeps its price inverse in the sum, and so its share of the cash.
+	CHECK(allocation.money_to_spend_per_need[1] == fixed_point_t { 9 } / 2);
+	CHECK(allocation == restarting_allocation(needs, fixed_point_t { 10 }));
+}
+
+TEST_CASE("NeedsAllocator Benchmark", "[.][NeedsAllocator][NeedsAllocator-benchmark]") {
+	using clock_t = std::chrono::steady_clock;
+	static constexpr size_t POP_COUNT = 10000;
+
+	std::mt19937 rand { 2 };
+	NeedsAllocator needs_allocator;
+
+	/* Need lists from the size of a life needs list up to a long luxury needs list. Up to MAX_RESTARTING_NEED_COUNT
+	 * the allocator restarts too, the sizes around it show where sorting starts to pay off. */
+	for (const size_t need_count : { 4, 8, 10, 12, 16, 48 }) {
+		std::vector<std::vector<need_t>> need_lists;
+		std::vector<fixed_point_t> cash_per_pop;
+		for (size_t pop = 0; pop < POP_COUNT; pop++) {
+			need_lists.push_back(random_needs(need_count, rand));
+			cash_per_pop.push_back(
+				get_max_money_to_spend_sum(need_lists.back()) * static_cast<int32_t>(rand() % 12) / 10
+			);
+		}
+
+		fixed_point_t checksum = fixed_point_t::_0();
+		const clock_t::time_point restarting_start = clock_t::now();
+		for (size_t pop = 0; pop < POP_COUNT; pop++) {
+			checksum += restarting_allocation(need_lists[pop], cash_per_pop[pop]).price_inverse_sum;
+		}
+		const clock_t::duration restarting_time = clock_t::now() - restarting_start;
+
+		const clock_t::time_point sorted_start = clock_t::now();
+		for (size_t pop = 0; pop < POP_COUNT; pop++) {
+			checksum -= sorted_allocation(needs_allocator, need_lists[pop], cash_per_pop[pop]).price_inverse_sum;
+		}
+		const clock_t::duration sorted_time = clock_t::now() - sorted_start;
+
+		CHECK(checksum == fixed_point_t::_0());
+
+		const auto micros_per_pop = [](clock_t::duration time) -> double {
+			return std::chrono::duration<double, std::micro>(time).count() / POP_COUNT;
+		};
+		fmt::print(
+			"{} needs: restarting {:.3f} us/pop, allocator {:.3f} us/pop\n", need_count, micros_per_pop(restarting_time),
+			micros_per_pop(sorted_time)
+		);
+	}
+}
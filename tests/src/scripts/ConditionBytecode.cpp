@@ -0,0 +1,194 @@
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "openvic-simulation/scripts/ConditionBytecode.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include "scripts/TestGame.hpp"
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+using namespace OpenVic::testing;
+
+using enum ConditionBytecode::opcode_t;
+
+namespace {
+	uint64_t get_count(ConditionBytecode::profile_t const& profile, ConditionBytecode::opcode_t opcode) {
+		return profile[static_cast<size_t>(opcode)];
+	}
+}
+
+TEST_CASE("ConditionBytecode AND short circuit", "[ConditionBytecode][ConditionBytecode-control]") {
+	test_game_t game;
+	FlagStrings& global_flags = game.instance_manager->get_global_flags();
+	CountryInstance const& england = game.get_country("ENG");
+
+	// The root of a script is an AND, which jumps past its remaining children once one fails.
+	const ConditionBytecode bytecode = game.compile_condition("has_global_flag = a has_global_flag = b");
+	REQUIRE(bytecode.get_instructions().size() == 3);
+	CHECK(bytecode.get_instructions()[0].opcode == HAS_GLOBAL_FLAG);
+	CHECK(bytecode.get_instructions()[1].opcode == JUMP_IF_FALSE);
+	CHECK(bytecode.get_instructions()[1].argument == 3);
+	CHECK(bytecode.get_instructions()[2].opcode == HAS_GLOBAL_FLAG);
+	CHECK(bytecode.get_unsupported_count() == 0);
+
+	ConditionBytecode::profile_t profile {};
+	CHECK_FALSE(bytecode.evaluate(game.get_context(), &england, &profile));
+	CHECK(get_count(profile, HAS_GLOBAL_FLAG) == 1);
+
+	global_flags.set_flag("a", false);
+	profile = {};
+	CHECK_FALSE(bytecode.evaluate(game.get_context(), &england, &profile));
+	CHECK(get_count(profile, HAS_GLOBAL_FLAG) == 2);
+
+	global_flags.set_flag("b", false);
+	CHECK(bytecode.evaluate(game.get_context(), &england));
+}
+
+TEST_CASE("ConditionBytecode OR and NOT short circuit", "[ConditionBytecode][ConditionBytecode-control]") {
+	test_game_t game;
+	FlagStrings& global_flags = game.instance_manager->get_global_flags();
+	CountryInstance const& england = game.get_country("ENG");
+
+	const ConditionBytecode or_bytecode = game.compile_condition("OR = { has_global_flag = a has_global_flag = b }");
+	REQUIRE(or_bytecode.get_instructions().size() == 3);
+	CHECK(or_bytecode.get_instructions()[1].opcode == JUMP_IF_TRUE);
+	CHECK(or_bytecode.get_instructions()[1].argument == 3);
+
+	// NOT is an OR whose result is inverted, so it also stops at the first child that holds.
+	const ConditionBytecode not_bytecode = game.compile_condition("NOT = { has_global_flag = a has_global_flag = b }");
+	REQUIRE(not_bytecode.get_instructions().size() == 4);
+	CHECK(not_bytecode.get_instructions()[1].opcode == JUMP_IF_TRUE);
+	CHECK(not_bytecode.get_instructions()[1].argument == 3);
+	CHECK(not_bytecode.get_instructions()[3].opcode == NOT);
+
+	ConditionBytecode::profile_t profile {};
+	CHECK_FALSE(or_bytecode.evaluate(game.get_context(), &england, &profile));
+	CHECK(get_count(profile, HAS_GLOBAL_FLAG) == 2);
+	CHECK(not_bytecode.evaluate(game.get_context(), &england));
+
+	global_flags.set_flag("b", false);
+	CHECK(or_bytecode.evaluate(game.get_context(), &england));
+	CHECK_FALSE(not_bytecode.evaluate(game.get_context(), &england));
+
+	global_flags.set_flag("a", false);
+	profile = {};
+	CHECK(or_bytecode.evaluate(game.get_context(), &england, &profile));
+	CHECK_FALSE(not_bytecode.evaluate(game.get_context(), &england, &profile));
+	CHECK(get_count(profile, HAS_GLOBAL_FLAG) == 2);
+	CHECK(get_count(profile, NOT) == 1);
+}
+
+TEST_CASE("ConditionBytecode Scope changes", "[ConditionBytecode][ConditionBytecode-scope]") {
+	test_game_t game;
+	CountryInstance& england = game.get_country("ENG");
+	CountryInstance& france = game.get_country("FRA");
+	france.set_flag("test", false);
+
+	// A scope change's argument is the end of its body, where evaluation continues in the original scope.
+	const ConditionBytecode this_bytecode =
+		game.compile_condition("THIS = { has_country_flag = test } has_global_flag = a");
+	REQUIRE(this_bytecode.get_instructions().size() == 4);
+	CHECK(this_bytecode.get_instructions()[0].opcode == SCOPE_THIS);
+	CHECK(this_bytecode.get_instructions()[0].argument == 2);
+	CHECK(this_bytecode.get_instructions()[1].opcode == HAS_COUNTRY_FLAG);
+	CHECK(this_bytecode.get_instructions()[2].opcode == JUMP_IF_FALSE);
+
+	game.instance_manager->get_global_flags().set_flag("a", false);
+	CHECK(this_bytecode.evaluate(game.get_context(&france, &england), &england));
+	CHECK_FALSE(this_bytecode.evaluate(game.get_context(&england, &france), &france));
+
+	// Without a THIS scope the body is skipped and the scope change fails.
+	ConditionBytecode::profile_t profile {};
+	CHECK_FALSE(this_bytecode.evaluate(game.get_context({}, &france), &france, &profile));
+	CHECK(get_count(profile, SCOPE_THIS) == 1);
+	CHECK(get_count(profile, HAS_COUNTRY_FLAG) == 0);
+
+	const ConditionBytecode from_bytecode = game.compile_condition("FROM = { has_country_flag = test }");
+	CHECK(from_bytecode.get_instructions()[0].opcode == SCOPE_FROM);
+	CHECK(from_bytecode.evaluate(game.get_context(&england, &france), &england));
+	CHECK_FALSE(from_bytecode.evaluate(game.get_context(&france, &england), &france));
+
+	// A country's owner is itself.
+	const ConditionBytecode owner_bytecode = game.compile_condition("owner = { has_country_flag = test }");
+	CHECK(owner_bytecode.get_instructions()[0].opcode == SCOPE_OWNER);
+	CHECK(owner_bytecode.evaluate(game.get_context(), &france));
+	CHECK_FALSE(owner_bytecode.evaluate(game.get_context(), &england));
+
+	const ConditionBytecode tag_bytecode = game.compile_condition("FRA = { has_country_flag = test }");
+	CHECK(tag_bytecode.get_instructions()[0].opcode == SCOPE_COUNTRY);
+	CHECK(tag_bytecode.evaluate(game.get_context(), &england));
+
+	// Country operands can also refer to the THIS and FROM scopes.
+	const ConditionBytecode tag_this_bytecode = game.compile_condition("tag = THIS");
+	CHECK(tag_this_bytecode.get_instructions()[0].argument == ConditionBytecode::THIS_COUNTRY);
+	CHECK(tag_this_bytecode.evaluate(game.get_context(&england, &france), &england));
+	CHECK_FALSE(tag_this_bytecode.evaluate(game.get_context(&france, &england), &england));
+}
+
+TEST_CASE("ConditionBytecode Comparison leaves", "[ConditionBytecode][ConditionBytecode-leaf]") {
+	test_game_t game;
+	CountryInstance const& england = game.get_country("ENG");
+
+	const ConditionBytecode literacy_bytecode = game.compile_condition("literacy = 0.5");
+	REQUIRE(literacy_bytecode.get_instructions().size() == 1);
+	CHECK(literacy_bytecode.get_instructions()[0].opcode == LITERACY);
+	CHECK(literacy_bytecode.get_instructions()[0].value == fixed_point_t::_0_50());
+
+	// Comparisons are inclusive, and a country without pops has a national literacy of 0.
+	CHECK(england.get_national_literacy() == fixed_point_t::_0());
+	CHECK_FALSE(literacy_bytecode.evaluate(game.get_context(), &england));
+	CHECK(game.compile_condition("literacy = 0").evaluate(game.get_context(), &england));
+	CHECK_FALSE(literacy_bytecode.evaluate(game.get_context(), {}));
+
+	// Without a bookmark the date is the start of year 0, and months in scripts count from 0.
+	CHECK(game.compile_condition("year = 0").evaluate(game.get_context(), &england));
+	CHECK_FALSE(game.compile_condition("year = 1").evaluate(game.get_context(), &england));
+	CHECK(game.compile_condition("month = 0").evaluate(game.get_context(), &england));
+	CHECK_FALSE(game.compile_condition("month = 1").evaluate(game.get_context(), &england));
+}
+
+TEST_CASE("ConditionBytecode Unsupported leaves", "[ConditionBytecode][ConditionBytecode-leaf]") {
+	test_game_t game;
+	CountryInstance const& england = game.get_country("ENG");
+
+	// ai is a valid condition without an implementation.
+	const ConditionBytecode unsupported_bytecode = game.compile_condition("ai = yes always = yes");
+	CHECK(unsupported_bytecode.get_instructions()[0].opcode == UNSUPPORTED);
+	CHECK(unsupported_bytecode.get_unsupported_count() == 1);
+	CHECK_FALSE(unsupported_bytecode.evaluate(game.get_context(), &england));
+
+	// Reaching an unsupported leaf makes the whole condition false, so neither NOT nor OR can make it hold.
+	const ConditionBytecode not_bytecode = game.compile_condition("NOT = { ai = yes }");
+	CHECK(not_bytecode.get_unsupported_count() == 1);
+	CHECK_FALSE(not_bytecode.evaluate(game.get_context(), &england));
+	CHECK_FALSE(game.compile_condition("NOT = { NOT = { ai = yes } }").evaluate(game.get_context(), &england));
+	CHECK_FALSE(game.compile_condition("NOT = { OR = { ai = yes always = no } }").evaluate(game.get_context(), &england));
+	CHECK_FALSE(game.compile_condition("FRA = { NOT = { ai = yes } }").evaluate(game.get_context(), &england));
+
+	ConditionBytecode::profile_t profile {};
+	const ConditionBytecode or_bytecode = game.compile_condition("OR = { ai = yes always = yes }");
+	CHECK_FALSE(or_bytecode.evaluate(game.get_context(), &england, &profile));
+	CHECK(get_count(profile, UNSUPPORTED) == 1);
+	CHECK(get_count(profile, ALWAYS_TRUE) == 0);
+
+	// Unsupported leaves which short-circuiting skips don't affect the result.
+	profile = {};
+	const ConditionBytecode skipped_bytecode = game.compile_condition("OR = { always = yes ai = yes }");
+	CHECK(skipped_bytecode.evaluate(game.get_context(), &england, &profile));
+	CHECK(get_count(profile, UNSUPPORTED) == 0);
+
+	// Integer operands outside the argument's range are not clamped, and negative ones don't parse.
+	for (const std::string_view text : { "year = 4294967296", "year = -1" }) {
+		const ConditionBytecode year_bytecode = game.compile_condition(text);
+		CHECK(year_bytecode.get_instructions()[0].opcode == UNSUPPORTED);
+		CHECK(year_bytecode.get_unsupported_count() == 1);
+		CHECK_FALSE(year_bytecode.evaluate(game.get_context(), &england));
+	}
+	const ConditionBytecode max_year_bytecode = game.compile_condition("year = 4294967295");
+	CHECK(max_year_bytecode.get_instructions()[0].opcode == YEAR);
+	CHECK(max_year_bytecode.get_unsupported_count() == 0);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+#include <openvic-dataloader/v2script/Parser.hpp>
+
+#include "openvic-simulation/country/CountryDefinition.hpp"
+#include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/DefinitionManager.hpp"
+#include "openvic-simulation/InstanceManager.hpp"
+#include "openvic-simulation/misc/GameRulesManager.hpp"
+#include "openvic-simulation/pop/Culture.hpp"
+#include "openvic-simulation/scripts/ConditionBytecode.hpp"
+#include "openvic-simulation/scripts/ConditionScript.hpp"
+
+namespace OpenVic::testing {
+	/* A game instance with no map whose definitions are the countries ENG and FRA, plus any a test adds itself before
+	 * parsing, for evaluating hand written condition scripts. */
+	struct test_game_t {
+		GameRulesManager game_rules_manager;
+		DefinitionManager definition_manager;
+		std::optional<InstanceManager> instance_manager;
+
+		test_game_t() {
+			CultureManager& culture_manager = definition_manager.get_pop_manager().get_culture_manager();
+			culture_manager.add_graphical_culture_type("test_graphical_culture");
+			GraphicalCultureType const* graphical_culture =
+				culture_manager.get_graphical_culture_type_by_identifier("test_graphical_culture");
+
+			CountryDefinitionManager& country_definition_manager = definition_manager.get_country_definition_manager();
+			for (const std::string_view tag : { "ENG", "FRA" }) {
+				country_definition_manager.add_country(
+					tag, colour_t::null(), graphical_culture, IdentifierRegistry<CountryParty> { "country parties" },
+					{}, false, {}
+				);
+			}
+			country_definition_manager.lock_country_definitions();
+
+			// Conditions for country tags are only added for the countries defined when they are set up.
+			definition_manager.get_script_manager().get_condition_manager().setup_conditions(definition_manager);
+
+			instance_manager.emplace(game_rules_manager, definition_manager, nullptr, nullptr);
+			instance_manager->setup();
+		}
+
+		test_game_t(test_game_t const&) = delete;
+		test_game_t& operator=(test_game_t const&) = delete;
+
+		CountryInstance& get_country(std::string_view tag) {
+			return *instance_manager->get_country_instance_manager().get_country_instance_by_identifier(tag);
+		}
+
+		/* Parses text as the body of a condition script, e.g. a trigger or limit. Conditions which fail to parse are
+		 * still compiled, as UNSUPPORTED. */
+		ConditionScript parse_condition(
+			std::string_view text, scope_type_t initial_scope = scope_type_t::COUNTRY,
+			scope_type_t this_scope = scope_type_t::COUNTRY, scope_type_t from_scope = scope_type_t::COUNTRY
+		) const {
+			ovdl::v2script::Parser parser;
+			parser.load_from_string(text);
+			parser.simple_parse();
+
+			ConditionScript condition { initial_scope, this_scope, from_scope };
+			condition.expect_script()(parser.get_file_node());
+			condition.parse_script(false, definition_manager);
+			return condition;
+		}
+
+		ConditionBytecode compile_condition(
+			std::string_view text, scope_type_t initial_scope = scope_type_t::COUNTRY,
+			scope_type_t this_scope = scope_type_t::COUNTRY, scope_type_t from_scope = scope_type_t::COUNTRY
+		) const {
+			return parse_condition(text, initial_scope, this_scope, from_scope).get_bytecode();
+		}
+
+		ConditionBytecode::context_t get_context(
+			ConditionBytecode::scope_t this_scope = {}, ConditionBytecode::scope_t from_scope = {}
+		) const {
+			return { *instance_manager, this_scope, from_scope };
+		}
+	};
+}
@@ -0,0 +1,53 @@
+#include <cstdint>
+#include <string>
+
+#include "openvic-simulation/types/InplaceFunction.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+TEST_CASE("InplaceFunction Constructor method", "[InplaceFunction][InplaceFunction-constructor]") {
+	using func_t = InplaceFunction<int32_t(int32_t)>;
+
+	const func_t empty {};
+	CHECK_FALSE(static_cast<bool>(empty));
+
+	const int32_t offset = 5;
+	int32_t calls = 0;
+	int32_t* calls_ptr = &calls;
+	const func_t add = [offset, calls_ptr](int32_t value) -> int32_t {
+		(*calls_ptr)++;
+		return value + offset;
+	};
+
+	CHECK(static_cast<bool>(add));
+	CHECK(add(10) == 15);
+
+	const func_t copy = add;
+	CHECK(copy(-5) == 0);
+	CHECK(calls == 2);
+}
+
+TEST_CASE("InplaceFunction Storage limits", "[InplaceFunction][InplaceFunction-storage]") {
+	using func_t = InplaceFunction<void()>;
+
+	struct small_t {
+		void* pointers[func_t::CAPACITY / sizeof(void*)];
+		void operator()() const {}
+	};
+	struct large_t {
+		void* pointers[func_t::CAPACITY / sizeof(void*) + 1];
+		void operator()() const {}
+	};
+	struct non_trivial_t {
+		std::string text;
+		void operator()() const {}
+	};
+
+	CHECK(func_t::can_store<small_t>);
+	CHECK_FALSE(func_t::can_store<large_t>);
+	CHECK_FALSE(func_t::can_store<non_trivial_t>);
+}
@@ -0,0 +1,84 @@
+#include <cstdint>
+
+#include "openvic-simulation/types/SlotMap.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	struct item_t {
+		uint64_t handle;
+		int32_t value;
+	};
+}
+
+TEST_CASE("SlotMap Insert and get", "[SlotMap][SlotMap-insert]") {
+	using slot_map_t = SlotMap<item_t>;
+
+	slot_map_t slot_map { 3 };
+	CHECK(slot_map.empty());
+	CHECK(slot_map.get(slot_map_t::NULL_HANDLE) == nullptr);
+
+	item_t& first = slot_map.insert([](slot_map_t::handle_t handle) -> item_t {
+		return { handle, 1 };
+	});
+	item_t& second = slot_map.insert([](slot_map_t::handle_t handle) -> item_t {
+		return { handle, 2 };
+	});
+
+	CHECK(slot_map.size() == 2);
+	CHECK(first.handle != slot_map_t::NULL_HANDLE);
+	CHECK(first.handle != second.handle);
+	CHECK(slot_map_t::get_tag(first.handle) == 3);
+	CHECK(slot_map.get(first.handle) == &first);
+	CHECK(slot_map.get(second.handle) == &second);
+
+	// Handles from a map with a different tag never resolve.
+	const slot_map_t other { 4 };
+	CHECK_FALSE(other.contains(first.handle));
+}
+
+TEST_CASE("SlotMap Erase and reuse", "[SlotMap][SlotMap-erase]") {
+	using slot_map_t = SlotMap<item_t>;
+
+	slot_map_t slot_map;
+
+	const slot_map_t::handle_t first = slot_map.insert([](slot_map_t::handle_t handle) -> item_t {
+		return { handle, 1 };
+	}).handle;
+	item_t& second = slot_map.insert([](slot_map_t::handle_t handle) -> item_t {
+		return { handle, 2 };
+	});
+	const slot_map_t::handle_t second_handle = second.handle;
+
+	CHECK(slot_map.erase(first));
+	CHECK_FALSE(slot_map.erase(first));
+	CHECK_FALSE(slot_map.contains(first));
+	CHECK(slot_map.size() == 1);
+	// Erasing does not move the remaining items.
+	CHECK(slot_map.get(second_handle) == &second);
+
+	// The freed slot is reused with a new generation, so the stale handle stays invalid.
+	const slot_map_t::handle_t third = slot_map.insert([](slot_map_t::handle_t handle) -> item_t {
+		return { handle, 3 };
+	}).handle;
+	CHECK(slot_map_t::get_index(third) == slot_map_t::get_index(first));
+	CHECK(slot_map_t::get_generation(third) != slot_map_t::get_generation(first));
+	CHECK(slot_map.get(first) == nullptr);
+	REQUIRE(slot_map.get(third) != nullptr);
+	CHECK(slot_map.get(third)->value == 3);
+
+	int32_t total = 0;
+	for (item_t const& item : slot_map) {
+		total += item.value;
+	}
+	CHECK(total == 5);
+
+	slot_map.clear();
+	CHECK(slot_map.empty());
+	CHECK_FALSE(slot_map.contains(second_handle));
+	CHECK_FALSE(slot_map.contains(third));
+}
@@ -0,0 +1,85 @@
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "openvic-simulation/utility/Logger.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+TEST_CASE("Logger threads", "[Logger][Logger-threads]") {
+	static constexpr size_t THREAD_COUNT = 4, MESSAGES_PER_THREAD = 2000;
+
+	std::vector<std::string> messages;
+	Logger::set_warning_func([&messages](std::string&& message) -> void {
+		messages.push_back(std::move(message));
+	});
+
+	for (const bool async : { false, true }) {
+		Logger::set_async(async);
+		messages.clear();
+		const size_t count_before = Logger::get_warning_count();
+
+		std::vector<std::thread> threads;
+		for (size_t thread = 0; thread < THREAD_COUNT; ++thread) {
+			threads.emplace_back([thread]() -> void {
+				for (size_t message = 0; message < MESSAGES_PER_THREAD; ++message) {
+					Logger::warning("thread ", thread, " message ", message);
+				}
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		Logger::set_async(false);
+
+		CHECK(messages.size() == THREAD_COUNT * MESSAGES_PER_THREAD);
+		CHECK(Logger::get_warning_count() - count_before == THREAD_COUNT * MESSAGES_PER_THREAD);
+
+		// Each thread's messages are printed in the order it logged them.
+		std::vector<size_t> next_message(THREAD_COUNT, 0);
+		size_t out_of_order = 0;
+		for (std::string const& message : messages) {
+			const size_t thread_pos = message.find("thread ") + 7;
+			const size_t message_pos = message.find(" message ") + 9;
+			const size_t thread = std::stoul(message.substr(thread_pos));
+			if (std::stoul(message.substr(message_pos)) != next_message[thread]++) {
+				out_of_order++;
+			}
+		}
+		CHECK(out_of_order == 0);
+	}
+
+	Logger::set_warning_func({});
+}
+
+TEST_CASE("Logger repeated messages", "[Logger][Logger-repeated-messages]") {
+	std::vector<std::string> messages;
+	Logger::set_warning_func([&messages](std::string&& message) -> void {
+		messages.push_back(std::move(message));
+	});
+	messages.clear();
+	const size_t count_before = Logger::get_warning_count();
+
+	// Messages are only repeats if they are logged from the same line.
+	for (size_t repeat = 0; repeat < 3; ++repeat) {
+		Logger::warning("repeated");
+	}
+	for (size_t repeat = 0; repeat < 2; ++repeat) {
+		Logger::warning("different");
+	}
+	Logger::flush();
+
+	CHECK_OR_RETURN(messages.size() == 4);
+	CHECK(messages[0].ends_with("repeated\n"));
+	CHECK(messages[1] == "Previous message repeated 2 times\n");
+	CHECK(messages[2].ends_with("different\n"));
+	CHECK(messages[3] == "Previous message repeated 1 time\n");
+	CHECK(Logger::get_warning_count() - count_before == 5);
+
+	Logger::set_warning_func({});
+}
@@ -0,0 +1,66 @@
+#include <cstddef>
+
+#include "openvic-simulation/utility/PhaseProfiler.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	size_t fake_allocation_count = 0;
+}
+
+TEST_CASE("PhaseProfiler phases", "[PhaseProfiler][PhaseProfiler-phases]") {
+	PhaseProfiler profiler { []() -> size_t {
+		return fake_allocation_count;
+	} };
+
+	for (size_t run = 0; run < 3; ++run) {
+		const PhaseProfiler::scope_t outer_scope { &profiler, "outer" };
+		{
+			const PhaseProfiler::scope_t inner_scope { &profiler, "inner" };
+			fake_allocation_count += run;
+		}
+	}
+	{
+		// A null profiler records nothing.
+		const PhaseProfiler::scope_t scope { nullptr, "unprofiled" };
+	}
+
+	CHECK_OR_RETURN(profiler.get_phases().size() == 2);
+	CHECK(profiler.get_phases()[0].name == "outer");
+	CHECK(profiler.get_phases()[1].name == "inner");
+
+	for (PhaseProfiler::phase_t const& phase : profiler.get_phases()) {
+		const PhaseProfiler::statistics_t statistics = PhaseProfiler::get_statistics(phase);
+		CHECK(statistics.run_count == 3);
+		CHECK(statistics.total_allocations == 3);
+		CHECK(statistics.mean_allocations == 1);
+		CHECK(statistics.max_allocations == 2);
+		CHECK(statistics.min_ns <= statistics.p50_ns);
+		CHECK(statistics.p50_ns <= statistics.p90_ns);
+		CHECK(statistics.p90_ns <= statistics.p99_ns);
+		CHECK(statistics.p99_ns == statistics.max_ns);
+	}
+}
+
+TEST_CASE("PhaseProfiler percentiles", "[PhaseProfiler][PhaseProfiler-percentiles]") {
+	PhaseProfiler::phase_t phase { "phase", {}, {} };
+	for (uint64_t duration = 100; duration > 0; --duration) {
+		phase.durations_ns.push_back(duration);
+	}
+
+	const PhaseProfiler::statistics_t statistics = PhaseProfiler::get_statistics(phase);
+	CHECK(statistics.run_count == 100);
+	CHECK(statistics.total_ns == 5050);
+	CHECK(statistics.mean_ns == 50);
+	CHECK(statistics.min_ns == 1);
+	CHECK(statistics.p50_ns == 50);
+	CHECK(statistics.p90_ns == 90);
+	CHECK(statistics.p99_ns == 99);
+	CHECK(statistics.max_ns == 100);
+	CHECK(statistics.total_allocations == 0);
+	CHECK(statistics.mean_allocations == 0);
+}
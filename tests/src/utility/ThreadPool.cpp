@@ -0,0 +1,112 @@
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "openvic-simulation/utility/ThreadPool.hpp"
+
+#include "Helper.hpp" // IWYU pragma: keep
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+TEST_CASE("ThreadPool parallel_for", "[ThreadPool][ThreadPool-parallel_for]") {
+	ThreadPool& thread_pool = ThreadPool::get_instance();
+
+	for (const size_t worker_count : { 1, 2, 4, 0 }) {
+		thread_pool.set_worker_count(worker_count);
+		CHECK(thread_pool.get_worker_count() > 0);
+
+		std::vector<size_t> visits(10000, 0);
+		thread_pool.parallel_for(visits.size(), [&visits](size_t begin, size_t end) -> void {
+			for (size_t index = begin; index < end; ++index) {
+				visits[index]++;
+			}
+		});
+
+		size_t wrong_visits = 0;
+		for (const size_t visit_count : visits) {
+			if (visit_count != 1) {
+				wrong_visits++;
+			}
+		}
+		CHECK(wrong_visits == 0);
+	}
+
+	thread_pool.set_worker_count(0);
+}
+
+TEST_CASE("ThreadPool chunking", "[ThreadPool][ThreadPool-chunking]") {
+	ThreadPool& thread_pool = ThreadPool::get_instance();
+
+	static constexpr size_t count = 1000, grain = 7;
+
+	std::atomic<size_t> chunk_count = 0, oversized_chunk_count = 0;
+	thread_pool.parallel_for(count, grain, [&chunk_count, &oversized_chunk_count](size_t begin, size_t end) -> void {
+		chunk_count++;
+		if (end - begin > grain) {
+			oversized_chunk_count++;
+		}
+	});
+
+	CHECK(chunk_count >= count / grain);
+	CHECK(oversized_chunk_count == 0);
+}
+
+TEST_CASE("ThreadPool nested parallel_for", "[ThreadPool][ThreadPool-nested]") {
+	ThreadPool& thread_pool = ThreadPool::get_instance();
+
+	std::atomic<size_t> total = 0;
+	thread_pool.parallel_for(64, 1, [&thread_pool, &total](size_t begin, size_t end) -> void {
+		for (size_t index = begin; index < end; ++index) {
+			thread_pool.parallel_for(100, 3, [&total](size_t inner_begin, size_t inner_end) -> void {
+				total += inner_end - inner_begin;
+			});
+		}
+	});
+
+	CHECK(total == 64 * 100);
+}
+
+TEST_CASE("ThreadPool External callers", "[ThreadPool][ThreadPool-external]") {
+	ThreadPool& thread_pool = ThreadPool::get_instance();
+	thread_pool.set_worker_count(4);
+
+	static constexpr size_t caller_count = 4, call_count = 50;
+
+	// Chunks running with worker index 0 must never overlap, even with several threads outside the pool.
+	std::atomic<size_t> index_0_users = 0, overlap_count = 0, nested_total = 0;
+	const auto caller = [&thread_pool, &index_0_users, &overlap_count, &nested_total]() -> void {
+		for (size_t call = 0; call < call_count; ++call) {
+			thread_pool.parallel_for(
+				64, 1, [&thread_pool, &index_0_users, &overlap_count, &nested_total](size_t begin, size_t end) -> void {
+					if (ThreadPool::get_current_worker_index() == 0) {
+						if (index_0_users++ != 0) {
+							overlap_count++;
+						}
+						std::this_thread::yield();
+						index_0_users--;
+					}
+					// Nested calls from the thread holding index 0 don't wait for it.
+					thread_pool.parallel_for(end - begin, 1, [&nested_total](size_t inner_begin, size_t inner_end) -> void {
+						nested_total += inner_end - inner_begin;
+					});
+				}
+			);
+		}
+	};
+
+	std::vector<std::thread> callers;
+	for (size_t index = 0; index < caller_count; ++index) {
+		callers.emplace_back(caller);
+	}
+	for (std::thread& thread : callers) {
+		thread.join();
+	}
+
+	CHECK(overlap_count == 0);
+	CHECK(nested_total == caller_count * call_count * 64);
+
+	thread_pool.set_worker_count(0);
+}